@@ -0,0 +1,108 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_BENCH_BENCH_H__
+#define HILBERT_BENCH_BENCH_H__
+
+/**
+ * Helpers shared by the benchmarks.
+ *
+ * Each benchmark writes one tab separated line per measurement to standard output:
+ * benchmark name, variant, size, operations, seconds, operations per second.
+ * The meaning of the size column depends on the benchmark (object count, thread count, …).
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+
+#include"hilbert.h"
+
+/**
+ * Smallest object count of the synthetic modules used by the benchmarks.
+ * Benchmarks run with object counts growing by factors of ten up to <code>#BENCH_MAXSIZE</code>.
+ */
+#define BENCH_MINSIZE ((size_t) 1000)
+
+/**
+ * Largest object count of the synthetic modules used by the benchmarks.
+ */
+#define BENCH_MAXSIZE ((size_t) 1000000)
+
+/**
+ * Returns the current value of a monotonic clock.
+ *
+ * @return Current time in seconds.
+ */
+static inline double bench_now(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * Writes the result of a measurement to standard output.
+ *
+ * @param bench Name of the benchmark.
+ * @param variant Name of the measured variant.
+ * @param size Size parameter of the measurement.
+ * @param ops Number of operations performed.
+ * @param seconds Time taken by the operations, in seconds.
+ */
+static inline void bench_report(const char * bench, const char * variant, size_t size, double ops, double seconds) {
+	printf("%s\t%s\t%zu\t%.0f\t%.6f\t%.0f\n", bench, variant, size, ops, seconds, seconds > 0 ? ops / seconds : 0);
+	fflush(stdout);
+}
+
+/**
+ * Aborts the benchmark if an error occurred.
+ *
+ * @param errcode Error code returned by the library.
+ * @param what Description of the failed operation.
+ */
+static inline void bench_check(int errcode, const char * what) {
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to %s, errcode=%i\n", what, errcode);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Creates a module, aborting the benchmark on failure.
+ *
+ * @param type Module type.
+ *
+ * @return A pointer to the new module.
+ */
+static inline HilbertModule * bench_module(enum HilbertModuleType type) {
+	HilbertModule * module = hilbert_module_create(type);
+	if (module == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return module;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Benchmark measuring object creation in interface modules, one object at a time and in batches.
+ * The size column is the number of objects created.
+ */
+
+#include<stdlib.h>
+
+#include"bench.h"
+
+#define N_KINDS 16
+
+/* creates the kinds used as variable, result and input kinds */
+static void setup(HilbertModule * module, HilbertHandle * kinds) {
+	bench_check(hilbert_kind_create_n(module, N_KINDS, kinds), "create kinds");
+}
+
+static void kinds_single(size_t n) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	int errcode;
+
+	double start = bench_now();
+	for (size_t i = 0; i != n; ++i) {
+		hilbert_kind_create(module, &errcode);
+		bench_check(errcode, "create kind");
+	}
+	bench_report("create", "kind", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+static void kinds_batch(size_t n, HilbertHandle * handles) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+
+	double start = bench_now();
+	bench_check(hilbert_kind_create_n(module, n, handles), "create kinds");
+	bench_report("create", "kind_n", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+static void vars_single(size_t n) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	HilbertHandle kinds[N_KINDS];
+	int errcode;
+
+	setup(module, kinds);
+	double start = bench_now();
+	for (size_t i = 0; i != n; ++i) {
+		hilbert_var_create(module, kinds[i % N_KINDS], &errcode);
+		bench_check(errcode, "create variable");
+	}
+	bench_report("create", "var", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+static void vars_batch(size_t n, HilbertHandle * handles, HilbertHandle * varkinds) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	HilbertHandle kinds[N_KINDS];
+
+	setup(module, kinds);
+	for (size_t i = 0; i != n; ++i)
+		varkinds[i] = kinds[i % N_KINDS];
+	double start = bench_now();
+	bench_check(hilbert_var_create_n(module, n, varkinds, handles), "create variables");
+	bench_report("create", "var_n", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+static void functors_single(size_t n) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	HilbertHandle kinds[N_KINDS];
+	int errcode;
+
+	setup(module, kinds);
+	double start = bench_now();
+	for (size_t i = 0; i != n; ++i) {
+		hilbert_functor_create(module, kinds[i % N_KINDS], i % 5, kinds + i % (N_KINDS - 4), &errcode);
+		bench_check(errcode, "create functor");
+	}
+	bench_report("create", "functor", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+static void functors_batch(size_t n, HilbertHandle * handles, HilbertHandle * rkinds, size_t * placecounts, HilbertHandle * ikinds) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	HilbertHandle kinds[N_KINDS];
+
+	setup(module, kinds);
+	size_t ikindcount = 0;
+	for (size_t i = 0; i != n; ++i) {
+		rkinds[i] = kinds[i % N_KINDS];
+		placecounts[i] = i % 5;
+		for (size_t j = 0; j != placecounts[i]; ++j)
+			ikinds[ikindcount++] = kinds[(i + j) % N_KINDS];
+	}
+	double start = bench_now();
+	bench_check(hilbert_functor_create_n(module, n, rkinds, placecounts, ikinds, handles), "create functors");
+	bench_report("create", "functor_n", n, n, bench_now() - start);
+
+	hilbert_module_free(module);
+}
+
+int main(void) {
+	HilbertHandle * handles = malloc(BENCH_MAXSIZE * sizeof(*handles));
+	HilbertHandle * kinds = malloc(BENCH_MAXSIZE * sizeof(*kinds));
+	size_t * placecounts = malloc(BENCH_MAXSIZE * sizeof(*placecounts));
+	HilbertHandle * ikinds = malloc(4 * BENCH_MAXSIZE * sizeof(*ikinds));
+	if ((handles == NULL) || (kinds == NULL) || (placecounts == NULL) || (ikinds == NULL)) {
+		fputs("Unable to allocate buffers\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	for (size_t n = BENCH_MINSIZE; n <= BENCH_MAXSIZE; n *= 10) {
+		kinds_single(n);
+		kinds_batch(n, handles);
+		vars_single(n);
+		vars_batch(n, handles, kinds);
+		functors_single(n);
+		functors_batch(n, handles, kinds, placecounts, ikinds);
+	}
+
+	free(ikinds);
+	free(placecounts);
+	free(kinds);
+	free(handles);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,109 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Benchmark measuring kind identification and equivalence queries.
+ * The size column is the number of kinds in the module.
+ */
+
+#include<stdlib.h>
+
+#include"bench.h"
+
+/* returns the next pseudo random number */
+static size_t next(unsigned int * seed) {
+	*seed = *seed * 1103515245u + 12345u;
+	return *seed >> 8;
+}
+
+/* performs n equivalence queries on random pairs of kinds */
+static void queries(HilbertModule * module, const char * variant, const HilbertHandle * kinds, size_t n) {
+	unsigned int seed = 2;
+	size_t sink = 0;
+	int errcode;
+
+	double start = bench_now();
+	for (size_t i = 0; i != n; ++i) {
+		sink += hilbert_kind_isequivalent(module, kinds[next(&seed) % n], kinds[next(&seed) % n], &errcode);
+		bench_check(errcode, "check kind equivalence");
+	}
+	bench_report("identify", variant, n, n, bench_now() - start);
+	if (sink > n)
+		abort();
+}
+
+/* obtains the equivalence classes of all kinds, as views if the module is immutable */
+static void classes(HilbertModule * module, const char * variant, int view, const HilbertHandle * kinds, size_t n) {
+	HilbertHandle buffer[64];
+	size_t total = 0;
+	size_t count;
+	int errcode;
+
+	double start = bench_now();
+	for (size_t i = 0; i != n; ++i) {
+		if (view)
+			hilbert_kind_equivalenceclass_view(module, kinds[i], &count, &errcode);
+		else
+			count = hilbert_kind_equivalenceclass_buf(module, kinds[i], buffer, 64, &errcode);
+		bench_check(errcode, "obtain equivalence class");
+		total += count;
+	}
+	bench_report("identify", variant, n, n, bench_now() - start);
+	if (total < n)
+		abort();
+}
+
+static void run(size_t n, HilbertHandle * kinds) {
+	HilbertModule * module = bench_module(HILBERT_INTERFACE_MODULE);
+	unsigned int seed = 1;
+
+	bench_check(hilbert_kind_create_n(module, n, kinds), "create kinds");
+
+	/* identify every other kind with a random earlier one, yielding classes of varying size */
+	double start = bench_now();
+	for (size_t i = 1; i < n; i += 2)
+		bench_check(hilbert_kind_identify(module, kinds[i], kinds[next(&seed) % i]), "identify kinds");
+	bench_report("identify", "identify", n, n / 2, bench_now() - start);
+
+	queries(module, "isequivalent", kinds, n);
+	classes(module, "equivalenceclass_buf", 0, kinds, n);
+	bench_check(hilbert_module_makeimmutable(module), "make module immutable");
+	queries(module, "isequivalent_immutable", kinds, n);
+	classes(module, "equivalenceclass_view", 1, kinds, n);
+
+	hilbert_module_free(module);
+}
+
+int main(void) {
+	HilbertHandle * kinds = malloc(BENCH_MAXSIZE * sizeof(*kinds));
+	if (kinds == NULL) {
+		fputs("Unable to allocate buffers\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	for (size_t n = BENCH_MINSIZE; n <= BENCH_MAXSIZE; n *= 10)
+		run(n, kinds);
+
+	free(kinds);
+
+	exit(EXIT_SUCCESS);
+}
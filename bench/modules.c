@@ -0,0 +1,130 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Benchmark measuring parameterisation, import and export of synthetic modules.
+ * The size column is the number of objects in the source module, and each operation handles one object.
+ */
+
+#include<stdlib.h>
+
+#include"bench.h"
+
+/* source module */
+static HilbertModule * src;
+
+/* handles of the source module, kinds first */
+static HilbertHandle * handles;
+
+/* destination handles of the source objects, indexed by source handle */
+static HilbertHandle * desthandles;
+
+/* mapper returning the precomputed destination handles */
+static HilbertHandle mapper(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject, void * userdata, int * restrict errcode) {
+	(void) dest;
+	(void) src;
+	(void) userdata;
+
+	*errcode = 0;
+	return desthandles[srcObject];
+}
+
+/* creates an immutable interface module with n objects, half kinds and half functors */
+static void setup(size_t n, size_t * placecounts, HilbertHandle * ikinds) {
+	size_t kindcount = n / 2;
+	size_t functorcount = n - kindcount;
+	unsigned int seed = 1;
+
+	src = bench_module(HILBERT_INTERFACE_MODULE);
+	bench_check(hilbert_kind_create_n(src, kindcount, handles), "create kinds");
+	for (size_t i = 1; i < kindcount; i += 4) {
+		seed = seed * 1103515245u + 12345u;
+		bench_check(hilbert_kind_identify(src, handles[i], handles[(seed >> 8) % i]), "identify kinds");
+	}
+
+	HilbertHandle * rkinds = handles + kindcount;
+	size_t ikindcount = 0;
+	for (size_t i = 0; i != functorcount; ++i) {
+		rkinds[i] = handles[i % kindcount];
+		placecounts[i] = i % 5;
+		for (size_t j = 0; j != placecounts[i]; ++j)
+			ikinds[ikindcount++] = handles[(i + j) % kindcount];
+	}
+	bench_check(hilbert_functor_create_n(src, functorcount, rkinds, placecounts, ikinds, handles + kindcount),
+			"create functors");
+	bench_check(hilbert_module_makeimmutable(src), "make module immutable");
+}
+
+static void run(size_t n, size_t * placecounts, HilbertHandle * ikinds) {
+	int errcode;
+
+	setup(n, placecounts, ikinds);
+
+	/* parameterisation */
+	HilbertModule * dest = bench_module(HILBERT_INTERFACE_MODULE);
+	double start = bench_now();
+	hilbert_module_param(dest, src, 0, NULL, NULL, NULL, &errcode);
+	bench_report("modules", "param", n, n, bench_now() - start);
+	bench_check(errcode, "parameterise module");
+	hilbert_module_free(dest);
+
+	/* import */
+	dest = bench_module(HILBERT_PROOF_MODULE);
+	start = bench_now();
+	HilbertHandle param = hilbert_module_import(dest, src, 0, NULL, NULL, NULL, &errcode);
+	bench_report("modules", "import", n, n, bench_now() - start);
+	bench_check(errcode, "import module");
+
+	/* export back onto the imported objects */
+	for (size_t i = 0; i != n; ++i) {
+		desthandles[handles[i]] = hilbert_object_getdesthandle(dest, param, handles[i], &errcode);
+		bench_check(errcode, "obtain destination handle");
+	}
+	start = bench_now();
+	hilbert_module_export(dest, src, 0, NULL, mapper, NULL, &errcode);
+	bench_report("modules", "export", n, n, bench_now() - start);
+	bench_check(errcode, "export module");
+
+	hilbert_module_free(dest);
+	hilbert_module_free(src);
+}
+
+int main(void) {
+	handles = malloc(BENCH_MAXSIZE * sizeof(*handles));
+	desthandles = malloc(BENCH_MAXSIZE * sizeof(*desthandles));
+	size_t * placecounts = malloc(BENCH_MAXSIZE * sizeof(*placecounts));
+	HilbertHandle * ikinds = malloc(4 * BENCH_MAXSIZE * sizeof(*ikinds));
+	if ((handles == NULL) || (desthandles == NULL) || (placecounts == NULL) || (ikinds == NULL)) {
+		fputs("Unable to allocate buffers\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	for (size_t n = BENCH_MINSIZE; n <= BENCH_MAXSIZE; n *= 10)
+		run(n, placecounts, ikinds);
+
+	free(ikinds);
+	free(placecounts);
+	free(desthandles);
+	free(handles);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,198 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Benchmark measuring proof checking throughput on generated proofs in propositional logic.
+ * The operations column is the number of proof steps checked.
+ * In the identity variant, each proof shows |- A -> A from the axioms in twelve steps,
+ * and the size column is the number of nodes of the term A.
+ * In the chain variant, each proof shows a_n from the hypotheses a_0, a_0 -> a_1, …, a_(n-1) -> a_n
+ * by modus ponens, and the size column is n.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"bench.h"
+
+#define N_VARS  64
+#define N_STEPS (1 << 20)
+
+static HilbertModule * iface, * proof;
+static HilbertHandle imp, ax1, ax2, mp;
+static HilbertHandle vars[N_VARS];
+static unsigned int seed = 1;
+
+/* returns a pseudo random number */
+static unsigned int rnd(void) {
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 8;
+}
+
+/* creates the term functor(arg0, arg1) */
+static HilbertHandle apply(HilbertModule * module, HilbertHandle functor, HilbertHandle arg0, HilbertHandle arg1) {
+	int errcode;
+	HilbertHandle args[2] = { arg0, arg1 };
+
+	HilbertHandle result = hilbert_term_create(module, functor, 2, args, &errcode);
+	bench_check(errcode, "create term");
+
+	return result;
+}
+
+/* creates a variable term */
+static HilbertHandle var(HilbertModule * module, HilbertHandle kind) {
+	int errcode;
+
+	HilbertHandle v = hilbert_var_create(module, kind, &errcode);
+	bench_check(errcode, "create variable");
+	HilbertHandle result = hilbert_term_var(module, v, &errcode);
+	bench_check(errcode, "create term");
+
+	return result;
+}
+
+/* creates a random implication term with the given odd number of nodes */
+static HilbertHandle random_term(size_t size) {
+	if (size <= 1)
+		return vars[rnd() % N_VARS];
+	size_t left = 2 * (rnd() % (size / 2)) + 1;
+
+	return apply(proof, imp, random_term(left), random_term(size - 1 - left));
+}
+
+/* creates the axioms and imports them into the proof module */
+static void setup(void) {
+	int errcode;
+
+	iface = bench_module(HILBERT_INTERFACE_MODULE);
+	HilbertHandle k = hilbert_kind_create(iface, &errcode);
+	bench_check(errcode, "create kind");
+	HilbertHandle ikinds[2] = { k, k };
+	HilbertHandle iimp = hilbert_functor_create(iface, k, 2, ikinds, &errcode);
+	bench_check(errcode, "create functor");
+	HilbertHandle p = var(iface, k);
+	HilbertHandle q = var(iface, k);
+	HilbertHandle r = var(iface, k);
+	HilbertHandle iax1 = hilbert_statement_create(iface, 0, NULL, apply(iface, iimp, p, apply(iface, iimp, q, p)),
+			&errcode);
+	bench_check(errcode, "create statement");
+	HilbertHandle conclusion = apply(iface, iimp, apply(iface, iimp, p, apply(iface, iimp, q, r)),
+			apply(iface, iimp, apply(iface, iimp, p, q), apply(iface, iimp, p, r)));
+	HilbertHandle iax2 = hilbert_statement_create(iface, 0, NULL, conclusion, &errcode);
+	bench_check(errcode, "create statement");
+	HilbertHandle hyps[2] = { p, apply(iface, iimp, p, q) };
+	HilbertHandle imp_rule = hilbert_statement_create(iface, 2, hyps, q, &errcode);
+	bench_check(errcode, "create statement");
+	bench_check(hilbert_module_makeimmutable(iface), "make module immutable");
+
+	proof = bench_module(HILBERT_PROOF_MODULE);
+	HilbertHandle param = hilbert_module_import(proof, iface, 0, NULL, NULL, NULL, &errcode);
+	bench_check(errcode, "import module");
+	HilbertHandle srchandles[4] = { iimp, iax1, iax2, imp_rule };
+	HilbertHandle * desthandles[4] = { &imp, &ax1, &ax2, &mp };
+	for (size_t i = 0; i != 4; ++i) {
+		*desthandles[i] = hilbert_object_getdesthandle(proof, param, srchandles[i], &errcode);
+		bench_check(errcode, "obtain destination handle");
+	}
+	HilbertHandle dk = hilbert_object_getdesthandle(proof, param, k, &errcode);
+	bench_check(errcode, "obtain destination handle");
+	for (size_t i = 0; i != N_VARS; ++i)
+		vars[i] = var(proof, dk);
+}
+
+/* proves |- A -> A for random terms A of the given size */
+static void identity(size_t size) {
+	size_t count = N_STEPS / 12;
+	HilbertHandle * terms = malloc(2 * count * sizeof(*terms));
+	if (terms == NULL) {
+		fputs("Out of memory\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != count; ++i) {
+		terms[2 * i] = random_term(size);
+		terms[2 * i + 1] = apply(proof, imp, terms[2 * i], terms[2 * i]);
+	}
+
+	double start = bench_now();
+	for (size_t i = 0; i != count; ++i) {
+		HilbertHandle a = terms[2 * i], aa = terms[2 * i + 1];
+		HilbertProofStep steps[12] = {
+			{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, a }, { HILBERT_STEP_APPLY, ax1 },
+			{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, aa }, { HILBERT_STEP_APPLY, ax1 },
+			{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, aa }, { HILBERT_STEP_TERM, a }, { HILBERT_STEP_APPLY, ax2 },
+			{ HILBERT_STEP_APPLY, mp }, { HILBERT_STEP_APPLY, mp }
+		};
+		int errcode;
+		hilbert_theorem_create(proof, 0, NULL, aa, 12, steps, &errcode);
+		bench_check(errcode, "check proof");
+	}
+	bench_report("proof", "identity", size, 12.0 * count, bench_now() - start);
+
+	free(terms);
+}
+
+/* proves a_n from a_0 and the implications a_(i-1) -> a_i */
+static void chain(size_t length) {
+	size_t count = N_STEPS / (2 * length + 1);
+	HilbertHandle * hyps = malloc((length + 1) * sizeof(*hyps));
+	HilbertProofStep * steps = malloc((2 * length + 1) * sizeof(*steps));
+	if ((hyps == NULL) || (steps == NULL)) {
+		fputs("Out of memory\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	HilbertHandle previous = random_term(3);
+	hyps[0] = previous;
+	steps[0] = (HilbertProofStep) { HILBERT_STEP_HYP, 0 };
+	for (size_t i = 1; i <= length; ++i) {
+		HilbertHandle next = random_term(3);
+		hyps[i] = apply(proof, imp, previous, next);
+		steps[2 * i - 1] = (HilbertProofStep) { HILBERT_STEP_HYP, i };
+		steps[2 * i] = (HilbertProofStep) { HILBERT_STEP_APPLY, mp };
+		previous = next;
+	}
+
+	double start = bench_now();
+	for (size_t i = 0; i != count; ++i) {
+		int errcode;
+		hilbert_theorem_create(proof, length + 1, hyps, previous, 2 * length + 1, steps, &errcode);
+		bench_check(errcode, "check proof");
+	}
+	bench_report("proof", "chain", length, (2.0 * length + 1) * count, bench_now() - start);
+
+	free(steps);
+	free(hyps);
+}
+
+int main(void) {
+	setup();
+
+	for (size_t size = 1; size <= 256; size *= 4)
+		identity(size - (size % 2 == 0));
+	for (size_t length = 10; length <= 100000; length *= 10)
+		chain(length);
+
+	hilbert_module_free(proof);
+	hilbert_module_free(iface);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,138 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Benchmark measuring read throughput on a shared module with an increasing number of threads.
+ * The variant column is the module state and the size column is the number of threads.
+ */
+
+#include<pthread.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<unistd.h>
+
+#include"bench.h"
+
+#define N_KINDS     1024
+#define N_FUNCTORS  1024
+#define N_OPS       (1 << 20)
+#define MAX_THREADS 64
+
+static HilbertModule * module;
+static HilbertHandle kinds[N_KINDS];
+static HilbertHandle functors[N_FUNCTORS];
+
+/* performs N_OPS read accesses */
+static void * reader(void * arg) {
+	unsigned int seed = (unsigned int) (size_t) arg;
+	int errcode;
+	size_t sink = 0;
+
+	for (size_t i = 0; i != N_OPS; ++i) {
+		seed = seed * 1103515245u + 12345u;
+		size_t k1 = (seed >> 8) % N_KINDS;
+		size_t k2 = (seed >> 18) % N_KINDS;
+		switch (i % 4) {
+			case 0:
+				sink += hilbert_kind_isequivalent(module, kinds[k1], kinds[k2], &errcode);
+				break;
+			case 1:
+				sink += hilbert_object_gettype(module, kinds[k1], &errcode);
+				break;
+			case 2:
+				sink += hilbert_functor_getkind(module, functors[k2 % N_FUNCTORS], &errcode);
+				break;
+			default:
+				sink += hilbert_object_gettype(module, functors[k1 % N_FUNCTORS], &errcode);
+				break;
+		}
+		if (errcode != 0) {
+			fprintf(stderr, "Read access failed, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	return (void *) sink;
+}
+
+/* runs the benchmark with the given number of threads */
+static void run(const char * state, long nthreads) {
+	pthread_t threads[MAX_THREADS];
+
+	double start = bench_now();
+	for (long i = 0; i != nthreads; ++i) {
+		if (pthread_create(&threads[i], NULL, reader, (void *) (size_t) (i + 1)) != 0) {
+			fputs("Unable to create thread\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (long i = 0; i != nthreads; ++i)
+		pthread_join(threads[i], NULL);
+	bench_report("readers", state, nthreads, (double) N_OPS * nthreads, bench_now() - start);
+}
+
+int main(void) {
+	int errcode;
+
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (ncpus < 1)
+		ncpus = 1;
+	if (ncpus > MAX_THREADS)
+		ncpus = MAX_THREADS;
+
+	module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (module == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != N_KINDS; ++i) {
+		kinds[i] = hilbert_kind_create(module, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+		if ((i % 3 == 2) && (hilbert_kind_identify(module, kinds[i], kinds[i / 2]) != 0)) {
+			fputs("Unable to identify kinds\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (size_t i = 0; i != N_FUNCTORS; ++i) {
+		functors[i] = hilbert_functor_create(module, kinds[i % N_KINDS], 2, kinds + i % (N_KINDS - 1), &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create functor, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (long n = 1; n <= ncpus; n *= 2)
+		run("mutable", n);
+	if (hilbert_module_makeimmutable(module) != 0) {
+		fputs("Unable to make module immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (long n = 1; n <= ncpus; n *= 2)
+		run("immutable", n);
+
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,117 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Generates a synthetic theory and drives it through parameterisation, import and export.
+ * Without options, a theory of moderate size is generated, see <code>#theory_config_default()</code>.
+ * The size column is the total number of objects in the interface modules of the theory,
+ * and the operations column is the number of objects created or source objects handled, respectively.
+ *
+ * Options:
+ * 	-s seed: seed of the pseudo random number generator
+ * 	-m count: number of interface modules
+ * 	-k count: kinds per module
+ * 	-f count: functors per module
+ * 	-p count: maximum place count of functors
+ * 	-d count: direct parameters per module
+ * 	-w count: window of preceding modules from which direct parameters are chosen
+ * 	-a count: kind aliases per thousand kinds
+ * 	-i count: kind identifications per thousand visible kinds
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<unistd.h>
+
+#include"theory.h"
+
+/* parses a numeric option argument */
+static unsigned long long number(const char * arg) {
+	char * end;
+	unsigned long long result = strtoull(arg, &end, 10);
+	if ((*arg == '\0') || (*end != '\0')) {
+		fprintf(stderr, "Invalid number: %s\n", arg);
+		exit(EXIT_FAILURE);
+	}
+
+	return result;
+}
+
+/* reports the cost of one kind of operation */
+static void report(const struct Theory * theory, const char * variant, const struct TheoryCost * cost) {
+	bench_report("theory", variant, theory->objectcount, cost->objects, cost->seconds);
+}
+
+int main(int argc, char * argv[]) {
+	struct TheoryConfig config = theory_config_default();
+	struct Theory theory;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:m:k:f:p:d:w:a:i:")) != -1) {
+		switch (opt) {
+			case 's':
+				config.seed = number(optarg);
+				break;
+			case 'm':
+				config.modules = number(optarg);
+				break;
+			case 'k':
+				config.kinds = number(optarg);
+				break;
+			case 'f':
+				config.functors = number(optarg);
+				break;
+			case 'p':
+				config.maxplaces = number(optarg);
+				break;
+			case 'd':
+				config.fanin = number(optarg);
+				break;
+			case 'w':
+				config.window = number(optarg);
+				break;
+			case 'a':
+				config.aliases = number(optarg);
+				break;
+			case 'i':
+				config.identifications = number(optarg);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-s seed] [-m modules] [-k kinds] [-f functors] [-p maxplaces] "
+						"[-d fanin] [-w window] [-a aliases] [-i identifications]\n", argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	theory_generate(&theory, &config);
+	theory_import(&theory);
+	theory_export(&theory);
+
+	report(&theory, "create", &theory.create);
+	report(&theory, "param", &theory.param);
+	report(&theory, "import", &theory.import);
+	report(&theory, "export", &theory.export);
+
+	theory_free(&theory);
+
+	exit(EXIT_SUCCESS);
+}
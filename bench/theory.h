@@ -0,0 +1,536 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_BENCH_THEORY_H__
+#define HILBERT_BENCH_THEORY_H__
+
+/**
+ * Synthetic theory generator.
+ *
+ * A theory is a DAG of immutable interface modules built with the public API only.
+ * Each module parameterises a few earlier modules (and, transitively, everything those modules are parameterised with),
+ * creates its own kinds, aliases and identifies some of the kinds it sees, and creates functors over them.
+ * The theory can then be imported into a proof module, and its modules exported from there again.
+ * The same configuration and seed always yield the same theory.
+ */
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"bench.h"
+
+/**
+ * Shape and size of a theory.
+ */
+struct TheoryConfig {
+	/**
+	 * Seed of the pseudo random number generator.
+	 */
+	uint64_t seed;
+
+	/**
+	 * Number of interface modules.
+	 */
+	size_t modules;
+
+	/**
+	 * Number of kinds each module creates.
+	 */
+	size_t kinds;
+
+	/**
+	 * Number of functors each module creates.
+	 */
+	size_t functors;
+
+	/**
+	 * Maximum place count of a functor.
+	 */
+	size_t maxplaces;
+
+	/**
+	 * Number of earlier modules each module is directly parameterised with.
+	 */
+	size_t fanin;
+
+	/**
+	 * Direct parameters are chosen among this many immediately preceding modules.
+	 * A window of <code>1</code> yields a single chain, larger windows yield wider DAGs.
+	 */
+	size_t window;
+
+	/**
+	 * Number of kind aliases per thousand kinds created.
+	 */
+	unsigned int aliases;
+
+	/**
+	 * Number of kind identifications per thousand kinds visible in a module.
+	 */
+	unsigned int identifications;
+};
+
+/**
+ * Generated interface module.
+ */
+struct TheoryModule {
+	/**
+	 * The module.
+	 */
+	HilbertModule * module;
+
+	/**
+	 * Number of parameters of <code>module</code>.
+	 */
+	size_t paramcount;
+
+	/**
+	 * Indices of the parameter modules in the theory, in ascending order.
+	 */
+	size_t * parammodules;
+
+	/**
+	 * Parameter handles in <code>module</code>, corresponding to <code>parammodules</code>.
+	 */
+	HilbertHandle * params;
+
+	/**
+	 * Number of objects in <code>module</code>.
+	 */
+	size_t objectcount;
+};
+
+/**
+ * Cumulative cost of one kind of module operation.
+ */
+struct TheoryCost {
+	/**
+	 * Number of calls.
+	 */
+	size_t calls;
+
+	/**
+	 * Number of source objects handled by the calls.
+	 */
+	size_t objects;
+
+	/**
+	 * Time spent in the calls, in seconds.
+	 */
+	double seconds;
+};
+
+/**
+ * Synthetic theory.
+ */
+struct Theory {
+	/**
+	 * Configuration the theory was generated with.
+	 */
+	struct TheoryConfig config;
+
+	/**
+	 * State of the pseudo random number generator.
+	 */
+	uint64_t state;
+
+	/**
+	 * Array of <code>config.modules</code> interface modules.
+	 */
+	struct TheoryModule * modules;
+
+	/**
+	 * Proof module into which the theory is imported, or <code>NULL</code>.
+	 */
+	HilbertModule * proof;
+
+	/**
+	 * Import parameter handles in <code>proof</code>, indexed like <code>modules</code>.
+	 */
+	HilbertHandle * imports;
+
+	/**
+	 * Total number of objects in the interface modules.
+	 */
+	size_t objectcount;
+
+	/**
+	 * Cost of object creation, parameterisation, import and export, respectively.
+	 */
+	struct TheoryCost create, param, import, export;
+};
+
+/**
+ * Returns the default theory configuration, which generates a theory of moderate size within a few seconds.
+ *
+ * @return The default configuration.
+ */
+static inline struct TheoryConfig theory_config_default(void) {
+	return (struct TheoryConfig) {
+		.seed = 1,
+		.modules = 32,
+		.kinds = 200,
+		.functors = 200,
+		.maxplaces = 4,
+		.fanin = 2,
+		.window = 8,
+		.aliases = 100,
+		.identifications = 50
+	};
+}
+
+/**
+ * Allocates memory, aborting on failure.
+ *
+ * @param count Number of elements.
+ * @param size Size of an element.
+ *
+ * @return Pointer to zero-initialised memory for <code>count</code> elements of size <code>size</code>.
+ */
+static inline void * theory_alloc(size_t count, size_t size) {
+	void * result = calloc(count == 0 ? 1 : count, size);
+	if (result == NULL) {
+		fputs("Unable to allocate theory memory\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return result;
+}
+
+/**
+ * Returns the next pseudo random number of a theory.
+ *
+ * @param theory Pointer to a theory.
+ * @param bound Exclusive upper bound, which must be positive.
+ *
+ * @return A pseudo random number smaller than <code>bound</code>.
+ */
+static inline size_t theory_random(struct Theory * theory, size_t bound) {
+	assert (bound != 0);
+
+	theory->state = theory->state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+	return (size_t) ((theory->state >> 33) % bound);
+}
+
+/**
+ * Mapper callback looking up destination handles in a table indexed by source handle.
+ * The table is passed as user data.
+ */
+static inline HilbertHandle theory_mapper(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject,
+		void * userdata, int * restrict errcode) {
+	(void) dest;
+	(void) src;
+
+	*errcode = 0;
+	return ((const HilbertHandle *) userdata)[srcObject];
+}
+
+/**
+ * Builds the mapper table for parameterising or importing a theory module.
+ * The table maps each external kind and functor of the source module to the corresponding object
+ * reached through the argument parameters in the destination module.
+ * Since the mapper callback runs while the destination module is locked, the table must be built beforehand.
+ *
+ * @param dest Pointer to the destination module.
+ * @param src Pointer to the source theory module.
+ * @param argv Parameter handles in <code>dest</code> serving as arguments to the parameters of <code>src</code>.
+ *
+ * @return A pointer to the table, which must be freed with <code>free()</code>.
+ */
+static inline HilbertHandle * theory_argtable(HilbertModule * dest, const struct TheoryModule * src, const HilbertHandle * argv) {
+	HilbertHandle * table = theory_alloc(src->objectcount, sizeof(*table));
+	int errcode;
+
+	for (HilbertHandle object = 0; object != src->objectcount; ++object) {
+		unsigned int type = hilbert_object_gettype(src->module, object, &errcode);
+		bench_check(errcode, "obtain object type");
+		if (!(type & HILBERT_TYPE_EXTERNAL) || !(type & (HILBERT_TYPE_KIND | HILBERT_TYPE_FUNCTOR)))
+			continue;
+		HilbertHandle param = hilbert_object_getparam(src->module, object, &errcode);
+		bench_check(errcode, "obtain object parameter");
+		/* parameter handles are ascending */
+		size_t lo = 0, hi = src->paramcount;
+		while (hi - lo > 1) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (src->params[mid] <= param)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		assert (src->params[lo] == param);
+		HilbertHandle srchandle = hilbert_object_getsourcehandle(src->module, object, &errcode);
+		bench_check(errcode, "obtain source handle");
+		table[object] = hilbert_object_getdesthandle(dest, argv[lo], srchandle, &errcode);
+		bench_check(errcode, "obtain destination handle");
+	}
+
+	return table;
+}
+
+/**
+ * Parameterises a module under construction with a theory module.
+ *
+ * @param theory Pointer to the theory.
+ * @param dest Pointer to the module under construction.
+ * @param paramof Parameter handles in <code>dest</code>, indexed by theory module, for all parameters of the source module.
+ * @param srcindex Index of the source module in the theory.
+ *
+ * @return The new parameter handle.
+ */
+static inline HilbertHandle theory_param(struct Theory * theory, HilbertModule * dest, const HilbertHandle * paramof,
+		size_t srcindex) {
+	const struct TheoryModule * src = &theory->modules[srcindex];
+	HilbertHandle * argv = theory_alloc(src->paramcount, sizeof(*argv));
+	int errcode;
+
+	for (size_t l = 0; l != src->paramcount; ++l)
+		argv[l] = paramof[src->parammodules[l]];
+	HilbertHandle * table = theory_argtable(dest, src, argv);
+	double start = bench_now();
+	HilbertHandle result = hilbert_module_param(dest, src->module, src->paramcount, argv, theory_mapper, table, &errcode);
+	theory->param.seconds += bench_now() - start;
+	bench_check(errcode, "parameterise module");
+	++theory->param.calls;
+	theory->param.objects += src->objectcount;
+	free(table);
+	free(argv);
+
+	return result;
+}
+
+/**
+ * Collects the kinds of a module.
+ *
+ * @param module Pointer to a module.
+ * @param count Pointer to a location where the number of kinds is stored.
+ *
+ * @return A pointer to an array of kind handles, which must be freed with <code>free()</code>.
+ */
+static inline HilbertHandle * theory_kinds(HilbertModule * module, size_t * count) {
+	int errcode;
+	size_t objectcount = hilbert_module_getobjects_buf(module, NULL, 0, &errcode);
+	bench_check(errcode, "count objects");
+	HilbertHandle * result = theory_alloc(objectcount, sizeof(*result));
+
+	*count = 0;
+	for (HilbertHandle object = 0; object != objectcount; ++object) {
+		unsigned int type = hilbert_object_gettype(module, object, &errcode);
+		bench_check(errcode, "obtain object type");
+		if (type & HILBERT_TYPE_KIND)
+			result[(*count)++] = object;
+	}
+
+	return result;
+}
+
+/**
+ * Generates a theory module.
+ *
+ * @param theory Pointer to the theory, whose modules with smaller indices have already been generated.
+ * @param index Index of the module to be generated.
+ */
+static inline void theory_module(struct Theory * theory, size_t index) {
+	const struct TheoryConfig * config = &theory->config;
+	struct TheoryModule * result = &theory->modules[index];
+	char * required = theory_alloc(index, sizeof(*required));
+	HilbertHandle * paramof = theory_alloc(index, sizeof(*paramof));
+	int errcode;
+
+	result->module = bench_module(HILBERT_INTERFACE_MODULE);
+
+	/* direct parameters, then their parameters */
+	size_t window = config->window < index ? config->window : index;
+	for (size_t i = 0; (i != config->fanin) && (window != 0); ++i)
+		required[index - 1 - theory_random(theory, window)] = 1;
+	for (size_t j = index; j-- != 0;) {
+		if (!required[j])
+			continue;
+		for (size_t l = 0; l != theory->modules[j].paramcount; ++l)
+			required[theory->modules[j].parammodules[l]] = 1;
+	}
+	for (size_t j = 0; j != index; ++j)
+		result->paramcount += required[j];
+	result->parammodules = theory_alloc(result->paramcount, sizeof(*result->parammodules));
+	result->params = theory_alloc(result->paramcount, sizeof(*result->params));
+	for (size_t j = 0, l = 0; j != index; ++j) {
+		if (!required[j])
+			continue;
+		paramof[j] = theory_param(theory, result->module, paramof, j);
+		result->parammodules[l] = j;
+		result->params[l++] = paramof[j];
+	}
+
+	/* own kinds and aliases */
+	double start = bench_now();
+	HilbertHandle * kinds = theory_alloc(config->kinds, sizeof(*kinds));
+	bench_check(hilbert_kind_create_n(result->module, config->kinds, kinds), "create kinds");
+	theory->create.objects += config->kinds;
+	/* aliases of external kinds would be external objects without a source, so only own kinds are aliased */
+	size_t aliascount = config->kinds * config->aliases / 1000;
+	for (size_t i = 0; (i != aliascount) && (config->kinds != 0); ++i) {
+		hilbert_kind_alias(result->module, kinds[theory_random(theory, config->kinds)], &errcode);
+		bench_check(errcode, "alias kind");
+	}
+	theory->create.objects += aliascount;
+	free(kinds);
+
+	/* identifications among all visible kinds */
+	size_t kindcount;
+	kinds = theory_kinds(result->module, &kindcount);
+	size_t idcount = kindcount * config->identifications / 1000;
+	for (size_t i = 0; i != idcount; ++i) {
+		bench_check(hilbert_kind_identify(result->module, kinds[theory_random(theory, kindcount)],
+				kinds[theory_random(theory, kindcount)]), "identify kinds");
+	}
+
+	/* functors */
+	if ((config->functors != 0) && (kindcount != 0)) {
+		HilbertHandle * rkinds = theory_alloc(config->functors, sizeof(*rkinds));
+		size_t * placecounts = theory_alloc(config->functors, sizeof(*placecounts));
+		HilbertHandle * ikinds = theory_alloc(config->functors * config->maxplaces, sizeof(*ikinds));
+		HilbertHandle * functors = theory_alloc(config->functors, sizeof(*functors));
+		size_t ikindcount = 0;
+		for (size_t i = 0; i != config->functors; ++i) {
+			rkinds[i] = kinds[theory_random(theory, kindcount)];
+			placecounts[i] = theory_random(theory, config->maxplaces + 1);
+			for (size_t j = 0; j != placecounts[i]; ++j)
+				ikinds[ikindcount++] = kinds[theory_random(theory, kindcount)];
+		}
+		bench_check(hilbert_functor_create_n(result->module, config->functors, rkinds, placecounts, ikinds, functors),
+				"create functors");
+		theory->create.objects += config->functors;
+		free(functors);
+		free(ikinds);
+		free(placecounts);
+		free(rkinds);
+	}
+	free(kinds);
+
+	bench_check(hilbert_module_makeimmutable(result->module), "make module immutable");
+	theory->create.seconds += bench_now() - start;
+	++theory->create.calls;
+	result->objectcount = hilbert_module_getobjects_buf(result->module, NULL, 0, &errcode);
+	bench_check(errcode, "count objects");
+	theory->objectcount += result->objectcount;
+
+	free(paramof);
+	free(required);
+}
+
+/**
+ * Generates a theory.
+ *
+ * @param theory Pointer to the theory to be initialised.
+ * @param config Pointer to the configuration of the theory.
+ */
+static inline void theory_generate(struct Theory * theory, const struct TheoryConfig * config) {
+	*theory = (struct Theory) { .config = *config, .state = config->seed };
+	theory->modules = theory_alloc(config->modules, sizeof(*theory->modules));
+
+	for (size_t i = 0; i != config->modules; ++i)
+		theory_module(theory, i);
+}
+
+/**
+ * Imports all modules of a theory into a new proof module, in dependency order.
+ *
+ * @param theory Pointer to a generated theory.
+ */
+static inline void theory_import(struct Theory * theory) {
+	int errcode;
+
+	assert (theory->proof == NULL);
+	theory->proof = bench_module(HILBERT_PROOF_MODULE);
+	theory->imports = theory_alloc(theory->config.modules, sizeof(*theory->imports));
+
+	for (size_t i = 0; i != theory->config.modules; ++i) {
+		const struct TheoryModule * src = &theory->modules[i];
+		HilbertHandle * argv = theory_alloc(src->paramcount, sizeof(*argv));
+		for (size_t l = 0; l != src->paramcount; ++l)
+			argv[l] = theory->imports[src->parammodules[l]];
+		HilbertHandle * table = theory_argtable(theory->proof, src, argv);
+		double start = bench_now();
+		theory->imports[i] = hilbert_module_import(theory->proof, src->module, src->paramcount, argv, theory_mapper, table,
+				&errcode);
+		theory->import.seconds += bench_now() - start;
+		bench_check(errcode, "import module");
+		++theory->import.calls;
+		theory->import.objects += src->objectcount;
+		free(table);
+		free(argv);
+	}
+}
+
+/**
+ * Exports all modules of a theory from the proof module it was imported into, onto the imported objects.
+ *
+ * @param theory Pointer to a theory previously imported with <code>#theory_import()</code>.
+ */
+static inline void theory_export(struct Theory * theory) {
+	int errcode;
+
+	assert (theory->proof != NULL);
+	for (size_t i = 0; i != theory->config.modules; ++i) {
+		const struct TheoryModule * src = &theory->modules[i];
+		HilbertHandle * argv = theory_alloc(src->paramcount, sizeof(*argv));
+		for (size_t l = 0; l != src->paramcount; ++l)
+			argv[l] = theory->imports[src->parammodules[l]];
+		HilbertHandle * table = theory_alloc(src->objectcount, sizeof(*table));
+		for (HilbertHandle object = 0; object != src->objectcount; ++object) {
+			unsigned int type = hilbert_object_gettype(src->module, object, &errcode);
+			bench_check(errcode, "obtain object type");
+			if (!(type & (HILBERT_TYPE_KIND | HILBERT_TYPE_FUNCTOR)))
+				continue;
+			table[object] = hilbert_object_getdesthandle(theory->proof, theory->imports[i], object, &errcode);
+			bench_check(errcode, "obtain destination handle");
+		}
+		double start = bench_now();
+		hilbert_module_export(theory->proof, src->module, src->paramcount, argv, theory_mapper, table, &errcode);
+		theory->export.seconds += bench_now() - start;
+		bench_check(errcode, "export module");
+		++theory->export.calls;
+		theory->export.objects += src->objectcount;
+		free(table);
+		free(argv);
+	}
+}
+
+/**
+ * Frees a theory and all of its modules.
+ *
+ * @param theory Pointer to a theory.
+ */
+static inline void theory_free(struct Theory * theory) {
+	if (theory->proof != NULL)
+		hilbert_module_free(theory->proof);
+	free(theory->imports);
+	for (size_t i = theory->config.modules; i-- != 0;) {
+		hilbert_module_free(theory->modules[i].module);
+		free(theory->modules[i].params);
+		free(theory->modules[i].parammodules);
+	}
+	free(theory->modules);
+}
+
+#endif
@@ -0,0 +1,256 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_ARENA_H__
+#define HILBERT_CL_ARENA_H__
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdlib.h>
+
+/**
+ * Size of the first chunk of an arena, in bytes.
+ */
+#define CL_ARENA_MINCHUNK ((size_t) 1024)
+
+/**
+ * Maximum size of a regular chunk of an arena, in bytes.
+ * Larger chunks are only allocated for larger requests.
+ */
+#define CL_ARENA_MAXCHUNK ((size_t) 65536)
+
+/**
+ * Union of types with strict alignment requirements.
+ * Blocks returned by the arena are aligned suitably for any of these types.
+ */
+union ArenaAlign {
+	long double ld;
+	long long ll;
+	void * p;
+	void (*fp)(void);
+};
+
+/**
+ * Memory chunk of an arena.
+ */
+struct ArenaChunk {
+	/**
+	 * Previously allocated chunk, or <code>NULL</code>.
+	 */
+	struct ArenaChunk * prev;
+
+	/**
+	 * Size of the chunk data in units of <code>union ArenaAlign</code>.
+	 */
+	size_t size;
+
+	/**
+	 * Number of units in use.
+	 */
+	size_t used;
+
+	/**
+	 * Chunk data.
+	 */
+	union ArenaAlign data[];
+};
+
+/**
+ * Arena (bump allocator).
+ *
+ * Memory is handed out from chunks of geometrically growing size.
+ * Blocks cannot be freed individually.
+ * Instead, the arena can be rewound to an earlier mark, or released as a whole.
+ */
+struct Arena {
+	/**
+	 * Chunk from which memory is currently handed out, or <code>NULL</code>.
+	 */
+	struct ArenaChunk * current;
+};
+
+typedef struct Arena Arena;
+
+/**
+ * Position in an arena, to which the arena can be rewound.
+ */
+struct ArenaMark {
+	/**
+	 * Current chunk at the time of marking.
+	 */
+	struct ArenaChunk * chunk;
+
+	/**
+	 * Units in use in <code>chunk</code> at the time of marking.
+	 */
+	size_t used;
+};
+
+typedef struct ArenaMark ArenaMark;
+
+/**
+ * Creates a new, empty arena.
+ *
+ * @return On success, a pointer to a new, empty arena is returned.
+ * 	On error, <code>NULL</code> is returned.
+ */
+static inline Arena * cl_arena_new(void) {
+	Arena * result = malloc(sizeof(*result));
+	if (result == NULL)
+		return NULL;
+
+	result->current = NULL;
+
+	return result;
+}
+
+/**
+ * Deletes an arena, releasing all memory allocated from it.
+ *
+ * @param arena Pointer to the arena to be deleted.
+ */
+static inline void cl_arena_del(Arena * arena) {
+	assert (arena != NULL);
+
+	struct ArenaChunk * chunk = arena->current;
+	while (chunk != NULL) {
+		struct ArenaChunk * prev = chunk->prev;
+		free(chunk);
+		chunk = prev;
+	}
+	free(arena);
+}
+
+/**
+ * Allocates a block of memory from an arena.
+ * The block remains valid until the arena is rewound to a mark obtained before the allocation,
+ * or the arena is deleted.
+ *
+ * @param arena Pointer to an arena.
+ * @param size Size of the block in bytes.
+ *
+ * @return On success, a pointer to a suitably aligned block of at least <code>size</code> bytes is returned.
+ * 	On error, <code>NULL</code> is returned.
+ */
+static inline void * cl_arena_alloc(Arena * arena, size_t size) {
+	assert (arena != NULL);
+
+	size_t units = size / sizeof(union ArenaAlign) + (size % sizeof(union ArenaAlign) != 0);
+	struct ArenaChunk * chunk = arena->current;
+	if ((chunk == NULL) || (chunk->size - chunk->used < units)) {
+		size_t chunkunits = CL_ARENA_MINCHUNK / sizeof(union ArenaAlign);
+		if (chunk != NULL) {
+			chunkunits = 2 * chunk->size;
+			if (chunkunits > CL_ARENA_MAXCHUNK / sizeof(union ArenaAlign))
+				chunkunits = CL_ARENA_MAXCHUNK / sizeof(union ArenaAlign);
+		}
+		if (chunkunits < units)
+			chunkunits = units;
+		if (chunkunits > (SIZE_MAX - sizeof(*chunk)) / sizeof(union ArenaAlign))
+			return NULL;
+		chunk = malloc(sizeof(*chunk) + chunkunits * sizeof(union ArenaAlign));
+		if (chunk == NULL)
+			return NULL;
+		chunk->prev = arena->current;
+		chunk->size = chunkunits;
+		chunk->used = 0;
+		arena->current = chunk;
+	}
+	void * result = chunk->data + chunk->used;
+	chunk->used += units;
+
+	return result;
+}
+
+/**
+ * Returns the amount of memory held by an arena.
+ *
+ * @param arena Pointer to an arena.
+ *
+ * @return The total size of the chunks of the arena in bytes, including unused space.
+ */
+static inline size_t cl_arena_memsize(const Arena * arena) {
+	assert (arena != NULL);
+
+	size_t result = 0;
+	for (const struct ArenaChunk * chunk = arena->current; chunk != NULL; chunk = chunk->prev)
+		result += sizeof(*chunk) + chunk->size * sizeof(union ArenaAlign);
+
+	return result;
+}
+
+/**
+ * Marks the current position of an arena.
+ *
+ * @param arena Pointer to an arena.
+ *
+ * @return A mark which can later be passed to <code>#cl_arena_rewind()</code>.
+ */
+static inline ArenaMark cl_arena_mark(const Arena * arena) {
+	assert (arena != NULL);
+
+	return (ArenaMark) { .chunk = arena->current, .used = arena->current == NULL ? 0 : arena->current->used };
+}
+
+/**
+ * Rewinds an arena to a mark, releasing all blocks allocated after the mark was obtained.
+ * Marks obtained after <code>mark</code> become invalid.
+ *
+ * @param arena Pointer to an arena.
+ * @param mark A mark previously obtained from <code>#cl_arena_mark()</code> on this arena.
+ */
+static inline void cl_arena_rewind(Arena * arena, ArenaMark mark) {
+	assert (arena != NULL);
+
+	while (arena->current != mark.chunk) {
+		assert (arena->current != NULL);
+		struct ArenaChunk * prev = arena->current->prev;
+		free(arena->current);
+		arena->current = prev;
+	}
+	if (mark.chunk != NULL) {
+		assert (mark.used <= mark.chunk->used);
+		mark.chunk->used = mark.used;
+	}
+}
+
+/**
+ * Releases all blocks allocated from an arena, but keeps the current chunk for reuse.
+ * All marks obtained on the arena become invalid.
+ *
+ * @param arena Pointer to an arena.
+ */
+static inline void cl_arena_reset(Arena * arena) {
+	assert (arena != NULL);
+
+	struct ArenaChunk * chunk = arena->current;
+	if (chunk == NULL)
+		return;
+	while (chunk->prev != NULL) {
+		struct ArenaChunk * prev = chunk->prev->prev;
+		free(chunk->prev);
+		chunk->prev = prev;
+	}
+	chunk->used = 0;
+}
+
+#endif
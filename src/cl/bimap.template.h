@@ -21,33 +21,41 @@
  */
 
 /**
- * Replacements from bimap template:
- * - <code>BIMAP</code>:
+ * Bimap container template.
+ * A container type is instantiated by defining the following parameters and including this file.
+ * The parameters are undefined again at the end of this file.
+ * - <code>CL_BIMAP_TYPE</code>:
  *   Bimap typename.
- * - <code>DOM_TYPE</code>:
- *   Type of the bimap's domain.
- * - <code>COD_TYPE</code>:
- *   Type of the bimap's codomain.
- * - <code>ENTRY_TYPE</code>:
- *   Type of the bimap entries.
- * - <code>BMITER</code>:
- *   Bimap iterator type.
- * - <code>PREFIX</code>:
+ * - <code>CL_BIMAP_DOM</code>:
+ *   Type of the domain of the bimap.
+ * - <code>CL_BIMAP_COD</code>:
+ *   Type of the codomain of the bimap.
+ * - <code>CL_BIMAP_ENTRY</code>:
+ *   Struct tag of the bimap entries.
+ * - <code>CL_BIMAP_ITERATOR</code>:
+ *   Bimap iterator typename.
+ * - <code>CL_BIMAP_PREFIX</code>:
  *   Function name prefix.
- * - <code>DOM_HASH</code>:
- *   Name of domain hash function.
- * - <code>COD_HASH</code>:
- *   Name of codomain hash function.
+ * - <code>CL_BIMAP_DOM_HASH</code>:
+ *   Hash function for the domain.
+ * - <code>CL_BIMAP_COD_HASH</code>:
+ *   Hash function for the codomain.
+ * - <code>CL_BIMAP_DOM_EQUAL</code> (optional):
+ *   Equality of preimages. Defaults to <code>==</code>.
+ * - <code>CL_BIMAP_COD_EQUAL</code> (optional):
+ *   Equality of images. Defaults to <code>==</code>.
  */
 
-#ifndef HILBERT_CL_BIMAP_H__
-#define HILBERT_CL_BIMAP_H__
+#ifndef HILBERT_CL_BIMAP_TEMPLATE_H__
+#define HILBERT_CL_BIMAP_TEMPLATE_H__
 
 #include<assert.h>
 #include<stdint.h>
 #include<stdlib.h>
 
 #include"hash.h"
+#include"stats.h"
+#include"template.h"
 
 /**
  * Initial number of buckets.
@@ -61,13 +69,36 @@
 
 /**
  * Bucket states.
+ * Entries are removed by shifting back the rest of their cluster, so there are no deleted buckets.
  */
-enum CLBIMAPBucketState {
+enum CLBimapBucketState {
 	CL_BIMAP_BUCKET_EMPTY = 0,
-	CL_BIMAP_BUCKET_OCCUPIED,
-	CL_BIMAP_BUCKET_DELETED
+	CL_BIMAP_BUCKET_OCCUPIED
 };
 
+#endif
+
+#ifndef CL_BIMAP_DOM_EQUAL
+#define CL_BIMAP_DOM_EQUAL(a, b) ((a) == (b))
+#endif
+
+#ifndef CL_BIMAP_COD_EQUAL
+#define CL_BIMAP_COD_EQUAL(a, b) ((a) == (b))
+#endif
+
+/* short names used within this file */
+#define BIMAP CL_BIMAP_TYPE
+#define DOM_TYPE CL_BIMAP_DOM
+#define COD_TYPE CL_BIMAP_COD
+#define ENTRY_TYPE CL_BIMAP_ENTRY
+#define BMITER CL_BIMAP_ITERATOR
+#define PREFIX(name) CL_CAT(CL_BIMAP_PREFIX, _ ## name)
+#define DOM_HASH CL_BIMAP_DOM_HASH
+#define COD_HASH CL_BIMAP_COD_HASH
+#define DOM_EQUAL CL_BIMAP_DOM_EQUAL
+#define COD_EQUAL CL_BIMAP_COD_EQUAL
+#define BUCKET CL_CAT(CL_BIMAP_TYPE, Bucket)
+
 /**
  * Bimap entry.
  */
@@ -86,7 +117,7 @@ struct ENTRY_TYPE {
 /**
  * Bucket type.
  */
-struct BIMAPBucket {
+struct BUCKET {
 	/**
 	 * Bimap entry.
 	 */
@@ -95,7 +126,7 @@ struct BIMAPBucket {
 	/**
 	 * Current bucket state.
 	 */
-	enum CLBIMAPBucketState state;
+	enum CLBimapBucketState state;
 };
 
 /**
@@ -120,12 +151,17 @@ struct BIMAP {
 	/**
 	 * Domain based mapping buckets.
 	 */
-	struct BIMAPBucket * dom_buckets;
+	struct BUCKET * dom_buckets;
 
 	/**
 	 * Codomain based mapping buckets.
 	 */
-	struct BIMAPBucket * cod_buckets;
+	struct BUCKET * cod_buckets;
+
+	/**
+	 * Lookup statistics, counting probed buckets.
+	 */
+	CL_STATS_DECL(stats)
 };
 
 typedef struct BIMAP BIMAP;
@@ -153,7 +189,7 @@ typedef struct BMITER BMITER;
  * @return On success, a pointer to a new, empty bimap is returned.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline BIMAP * PREFIX_new(void) {
+static inline BIMAP * PREFIX(new)(void) {
 	BIMAP * result;
 
 	result = malloc(sizeof(*result));
@@ -163,6 +199,7 @@ static inline BIMAP * PREFIX_new(void) {
 	result->count = 0;
 	result->threshold = (CL_BIMAP_MAXLOAD - 1) * CL_BIMAP_NUMBUCKETS / CL_BIMAP_MAXLOAD;
 	result->sizemask = CL_BIMAP_NUMBUCKETS - 1;
+	cl_stats_init(result->stats);
 
 	result->dom_buckets = calloc(CL_BIMAP_NUMBUCKETS, sizeof(*result->dom_buckets));
 	if (result->dom_buckets == NULL)
@@ -187,7 +224,7 @@ nomapmem:
  *
  * @param bimap Pointer to a bimap.
  */
-static inline void PREFIX_del(BIMAP * bimap) {
+static inline void PREFIX(del)(BIMAP * bimap) {
 	assert (bimap != NULL);
 
 	free(bimap->cod_buckets);
@@ -204,7 +241,7 @@ static inline void PREFIX_del(BIMAP * bimap) {
  * 	bucket array) must be present in any of the occupied buckets.
  * @param hash Hash code of the key (preimage or postimage) of <code>mapping</code>.
  */
-static inline void PREFIX_store(struct BIMAPBucket * buckets, size_t sizemask, struct ENTRY_TYPE entry, size_t hash) {
+static inline void PREFIX(store)(struct BUCKET * buckets, size_t sizemask, struct ENTRY_TYPE entry, size_t hash) {
 	assert (buckets != NULL);
 	assert (sizemask > 0);
 	assert (sizemask < SIZE_MAX);
@@ -231,40 +268,17 @@ static inline void PREFIX_store(struct BIMAPBucket * buckets, size_t sizemask, s
  * 	If the element is occupied, it is occupied with a mapping with preimage <code>pre</code>.
  * 	Otherwise, the element is suitable for storing a mapping with preimage <code>pre</code>.
  */
-static inline struct BIMAPBucket * PREFIX_find_pre(struct BIMAPBucket * buckets, size_t sizemask, DOM_TYPE pre,
+static inline struct BUCKET * PREFIX(find_pre)(struct BUCKET * buckets, size_t sizemask, DOM_TYPE pre,
 		size_t hash) {
 	assert (buckets != NULL);
 	assert (sizemask > 0);
 	assert (sizemask < SIZE_MAX);
 	assert ((sizemask & (sizemask + 1)) == 0);
 
-	int deletedfound = 0;
-	struct BIMAPBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_BIMAP_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_BIMAP_BUCKET_OCCUPIED:
-				if (buckets[i].entry.pre == pre)
-					return &buckets[i];
-				break;
-			case CL_BIMAP_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
-		}
+	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
+		if ((buckets[i].state == CL_BIMAP_BUCKET_EMPTY) || (DOM_EQUAL(buckets[i].entry.pre, pre)))
+			return &buckets[i];
 	}
-
-	assert (deletedfound);
-	return firstdeleted;
 }
 
 /**
@@ -279,40 +293,85 @@ static inline struct BIMAPBucket * PREFIX_find_pre(struct BIMAPBucket * buckets,
  * 	If the element is occupied, it is occupied with a mapping with postimage <code>post</code>.
  * 	Otherwise, the element is suitable for storing a mapping with postimage <code>post</code>.
  */
-static inline struct BIMAPBucket * PREFIX_find_post(struct BIMAPBucket * buckets, size_t sizemask, COD_TYPE post,
+static inline struct BUCKET * PREFIX(find_post)(struct BUCKET * buckets, size_t sizemask, COD_TYPE post,
 		size_t hash) {
 	assert (buckets != NULL);
 	assert (sizemask > 0);
 	assert (sizemask < SIZE_MAX);
 	assert ((sizemask & (sizemask + 1)) == 0);
 
-	int deletedfound = 0;
-	struct BIMAPBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_BIMAP_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_BIMAP_BUCKET_OCCUPIED:
-				if (buckets[i].entry.post == post)
-					return &buckets[i];
-				break;
-			case CL_BIMAP_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
+	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
+		if ((buckets[i].state == CL_BIMAP_BUCKET_EMPTY) || (COD_EQUAL(buckets[i].entry.post, post)))
+			return &buckets[i];
+	}
+}
+
+/**
+ * Removes the entry of a bucket by shifting back the subsequent entries of its cluster (private).
+ * This leaves no deleted markers behind, so that removals never lengthen probe sequences.
+ *
+ * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
+ * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
+ * @param bucket Pointer to an occupied element of the array pointed to by <code>buckets</code>.
+ * @param dom Nonzero if the buckets are preimage based, zero if they are postimage based.
+ */
+static inline void PREFIX(erase)(struct BUCKET * buckets, size_t sizemask, struct BUCKET * bucket, int dom) {
+	assert (buckets != NULL);
+	assert (bucket != NULL);
+	assert (bucket->state == CL_BIMAP_BUCKET_OCCUPIED);
+
+	size_t i = bucket - buckets;
+	for (size_t j = (i + 1) & sizemask; buckets[j].state == CL_BIMAP_BUCKET_OCCUPIED; j = (j + 1) & sizemask) {
+		size_t home = (dom ? DOM_HASH(buckets[j].entry.pre) : COD_HASH(buckets[j].entry.post)) & sizemask;
+		/* the entry may fill the gap unless its home bucket lies cyclically between the gap and itself */
+		if (((j - home) & sizemask) >= ((j - i) & sizemask)) {
+			buckets[i] = buckets[j];
+			i = j;
+		}
+	}
+	buckets[i].state = CL_BIMAP_BUCKET_EMPTY;
+}
+
+/**
+ * Rebuilds the bucket arrays of a bimap with a new size (private).
+ *
+ * @param bimap Pointer to a bimap.
+ * @param size New number of buckets. Must be a power of two, and large enough to hold the entries of the bimap.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the bimap remains unchanged.
+ */
+static inline int PREFIX(rebuild)(BIMAP * bimap, size_t size) {
+	assert (bimap != NULL);
+	assert (size > 1);
+	assert ((size & (size - 1)) == 0);
+
+	size_t newsizemask = size - 1;
+	size_t newthreshold = (CL_BIMAP_MAXLOAD - 1) * size / CL_BIMAP_MAXLOAD;
+	assert (bimap->count <= newthreshold);
+	struct BUCKET * newdombuckets = calloc(size, sizeof(*newdombuckets));
+	struct BUCKET * newcodbuckets = calloc(size, sizeof(*newcodbuckets));
+	if ((newdombuckets == NULL) || (newcodbuckets == NULL)) {
+		free(newdombuckets);
+		free(newcodbuckets);
+		return -1;
+	}
+	for (size_t i = 0; i <= bimap->sizemask; ++i) {
+		if (bimap->dom_buckets[i].state == CL_BIMAP_BUCKET_OCCUPIED) {
+			struct ENTRY_TYPE entry = bimap->dom_buckets[i].entry;
+			PREFIX(store)(newdombuckets, newsizemask, entry, DOM_HASH(entry.pre));
+			PREFIX(store)(newcodbuckets, newsizemask, entry, COD_HASH(entry.post));
 		}
 	}
+	free(bimap->cod_buckets);
+	free(bimap->dom_buckets);
+	bimap->sizemask = newsizemask;
+	bimap->threshold = newthreshold;
+	bimap->dom_buckets = newdombuckets;
+	bimap->cod_buckets = newcodbuckets;
+	cl_stats_rehash(bimap->stats);
 
-	assert (deletedfound);
-	return firstdeleted;
+	return 0;
 }
 
 /**
@@ -328,7 +387,7 @@ static inline struct BIMAPBucket * PREFIX_find_post(struct BIMAPBucket * buckets
  * @return On success, <code>0</code> is returned.
  * 	On error, <code>-1</code> is returned and the bimap remains unchanged.
  */
-static inline int PREFIX_add(BIMAP * bimap, DOM_TYPE pre, COD_TYPE post) {
+static inline int PREFIX(add)(BIMAP * bimap, DOM_TYPE pre, COD_TYPE post) {
 	assert (bimap != NULL);
 
 	struct ENTRY_TYPE entry = { .pre = pre, .post = post };
@@ -336,22 +395,22 @@ static inline int PREFIX_add(BIMAP * bimap, DOM_TYPE pre, COD_TYPE post) {
 	size_t post_hash = COD_HASH(post);
 
 	/* delete old entries if present */
-	struct BIMAPBucket * pre_cand = PREFIX_find_pre(bimap->dom_buckets, bimap->sizemask, pre, pre_hash);
+	struct BUCKET * pre_cand = PREFIX(find_pre)(bimap->dom_buckets, bimap->sizemask, pre, pre_hash);
 	if (pre_cand->state == CL_BIMAP_BUCKET_OCCUPIED) {
-		struct BIMAPBucket * post = PREFIX_find_post(bimap->cod_buckets, bimap->sizemask,
+		struct BUCKET * post = PREFIX(find_post)(bimap->cod_buckets, bimap->sizemask,
 				pre_cand->entry.post, COD_HASH(pre_cand->entry.post));
 		assert (post->state == CL_BIMAP_BUCKET_OCCUPIED);
-		pre_cand->state = CL_BIMAP_BUCKET_DELETED;
-		post->state = CL_BIMAP_BUCKET_DELETED;
+		PREFIX(erase)(bimap->dom_buckets, bimap->sizemask, pre_cand, 1);
+		PREFIX(erase)(bimap->cod_buckets, bimap->sizemask, post, 0);
 		--bimap->count;
 	}
-	struct BIMAPBucket * post_cand = PREFIX_find_post(bimap->cod_buckets, bimap->sizemask, post, post_hash);
+	struct BUCKET * post_cand = PREFIX(find_post)(bimap->cod_buckets, bimap->sizemask, post, post_hash);
 	if (post_cand->state == CL_BIMAP_BUCKET_OCCUPIED) {
-		struct BIMAPBucket * pre = PREFIX_find_pre(bimap->dom_buckets, bimap->sizemask,
+		struct BUCKET * pre = PREFIX(find_pre)(bimap->dom_buckets, bimap->sizemask,
 				post_cand->entry.pre, DOM_HASH(post_cand->entry.pre));
 		assert (pre->state == CL_BIMAP_BUCKET_OCCUPIED);
-		post_cand->state = CL_BIMAP_BUCKET_DELETED;
-		pre->state = CL_BIMAP_BUCKET_DELETED;
+		PREFIX(erase)(bimap->cod_buckets, bimap->sizemask, post_cand, 0);
+		PREFIX(erase)(bimap->dom_buckets, bimap->sizemask, pre, 1);
 		--bimap->count;
 	}
 
@@ -359,54 +418,51 @@ static inline int PREFIX_add(BIMAP * bimap, DOM_TYPE pre, COD_TYPE post) {
 	assert (bimap->count < SIZE_MAX);
 	size_t newcount = bimap->count + 1;
 	if (newcount > bimap->threshold) { /* this can only happen if we didn't delete anything above */
-		/* rebuild tables */
-		size_t oldalloc = (bimap->sizemask + 1) * sizeof(*bimap->dom_buckets);
-		size_t newalloc = 2 * oldalloc;
-		if (newalloc <= oldalloc)
-			return -1;
-		size_t newsize = newalloc / sizeof(*bimap->dom_buckets);
-		size_t newsizemask = newsize - 1;
-		size_t newthreshold = (CL_BIMAP_MAXLOAD - 1) * newsize / CL_BIMAP_MAXLOAD;
-		struct BIMAPBucket * newdombuckets = calloc(1, newalloc);
-		struct BIMAPBucket * newcodbuckets = calloc(1, newalloc);
-		if ((newdombuckets == NULL) || (newcodbuckets == NULL)) {
-			free(newdombuckets);
-			free(newcodbuckets);
+		size_t size = bimap->sizemask + 1;
+		if ((size > SIZE_MAX / 2) || (PREFIX(rebuild)(bimap, 2 * size) != 0))
 			return -1;
-		}
-		for (size_t i = 0; i <= bimap->sizemask; ++i) {
-			if (bimap->dom_buckets[i].state == CL_BIMAP_BUCKET_OCCUPIED) {
-				PREFIX_store(newdombuckets, newsizemask, bimap->dom_buckets[i].entry,
-						DOM_HASH(bimap->dom_buckets[i].entry.pre));
-			}
-			if (bimap->cod_buckets[i].state == CL_BIMAP_BUCKET_OCCUPIED) {
-				PREFIX_store(newcodbuckets, newsizemask, bimap->cod_buckets[i].entry,
-						COD_HASH(bimap->cod_buckets[i].entry.post));
-			}
-		}
-		free(bimap->cod_buckets);
-		free(bimap->dom_buckets);
-		bimap->sizemask = newsizemask;
-		bimap->threshold = newthreshold;
-		bimap->dom_buckets = newdombuckets;
-		bimap->cod_buckets = newcodbuckets;
-
-		/* store mapping */
-		PREFIX_store(bimap->dom_buckets, bimap->sizemask, entry, pre_hash);
-		PREFIX_store(bimap->cod_buckets, bimap->sizemask, entry, post_hash);
-		bimap->count = newcount;
-		return 0;
 	}
 
 	/* store mapping */
-	pre_cand->entry = entry;
-	pre_cand->state = CL_BIMAP_BUCKET_OCCUPIED;
-	post_cand->entry = entry;
-	post_cand->state = CL_BIMAP_BUCKET_OCCUPIED;
+	PREFIX(store)(bimap->dom_buckets, bimap->sizemask, entry, pre_hash);
+	PREFIX(store)(bimap->cod_buckets, bimap->sizemask, entry, post_hash);
 	bimap->count = newcount;
 	return 0;
 }
 
+/**
+ * Removes the entry with a given preimage from a bimap.
+ * If the load of the bimap becomes low, its bucket arrays are shrunk.
+ * Iterators over the bimap become invalid.
+ *
+ * @param bimap Pointer to a bimap.
+ * @param pre Preimage.
+ *
+ * @return If an entry with preimage <code>pre</code> was present, <code>1</code> is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int PREFIX(remove)(BIMAP * bimap, DOM_TYPE pre) {
+	assert (bimap != NULL);
+
+	struct BUCKET * pre_cand = PREFIX(find_pre)(bimap->dom_buckets, bimap->sizemask, pre, DOM_HASH(pre));
+	if (pre_cand->state != CL_BIMAP_BUCKET_OCCUPIED)
+		return 0;
+	struct BUCKET * post = PREFIX(find_post)(bimap->cod_buckets, bimap->sizemask,
+			pre_cand->entry.post, COD_HASH(pre_cand->entry.post));
+	assert (post->state == CL_BIMAP_BUCKET_OCCUPIED);
+	PREFIX(erase)(bimap->dom_buckets, bimap->sizemask, pre_cand, 1);
+	PREFIX(erase)(bimap->cod_buckets, bimap->sizemask, post, 0);
+	assert (bimap->count > 0);
+	--bimap->count;
+
+	/* shrink on low load; failure to do so is harmless */
+	size_t size = bimap->sizemask + 1;
+	if ((size > CL_BIMAP_NUMBUCKETS) && (bimap->count < bimap->threshold / 4))
+		PREFIX(rebuild)(bimap, size / 2);
+
+	return 1;
+}
+
 /**
  * Obtains the image for a given preimage.
  *
@@ -414,15 +470,17 @@ static inline int PREFIX_add(BIMAP * bimap, DOM_TYPE pre, COD_TYPE post) {
  * @param pre Preimage.
  *
  * @return If a mapping for the given preimage exists, a pointer to the associated image is returned.
- * 	The value being pointed to may not be altered (use <code>#PREFIX_add()</code> for this purpose).
+ * 	The value being pointed to may not be altered (use <code>add()</code> for this purpose).
  * 	The returned pointer is guaranteed to be valid only until the next call to one of the bimap
  * 	functions with <code>bimap</code> as argument.
  * 	If no mapping for the given preimage exists, <code>NULL</code> is returned.
  */
-static inline const COD_TYPE * PREFIX_post(const BIMAP * bimap, DOM_TYPE pre) {
+static inline const COD_TYPE * PREFIX(post)(const BIMAP * bimap, DOM_TYPE pre) {
 	assert (bimap != NULL);
 
-	struct BIMAPBucket * candidate = PREFIX_find_pre(bimap->dom_buckets, bimap->sizemask, pre, DOM_HASH(pre));
+	size_t hash = DOM_HASH(pre);
+	struct BUCKET * candidate = PREFIX(find_pre)(bimap->dom_buckets, bimap->sizemask, pre, hash);
+	cl_stats_probe(bimap->stats, (((size_t) (candidate - bimap->dom_buckets) - hash) & bimap->sizemask) + 1);
 	if (candidate->state == CL_BIMAP_BUCKET_OCCUPIED)
 		return &candidate->entry.post;
 
@@ -436,21 +494,50 @@ static inline const COD_TYPE * PREFIX_post(const BIMAP * bimap, DOM_TYPE pre) {
  * @param post Image.
  *
  * @return If a mapping for the given image exists, a pointer to the associated preimage is returned.
- * The value being pointed to may not be altered (use <code>#PREFIX_add()</code> for this purpose).
+ * The value being pointed to may not be altered (use <code>add()</code> for this purpose).
  * The returned pointer is guaranteed to be valid only until the next call to one of the bimap
  * functions with <code>bimap</code> as argument.
  * If no mapping for the given image exists, <code>NULL</code> is returned.
  */
-static inline const DOM_TYPE * PREFIX_pre(const BIMAP * bimap, COD_TYPE post) {
+static inline const DOM_TYPE * PREFIX(pre)(const BIMAP * bimap, COD_TYPE post) {
 	assert (bimap != NULL);
 
-	struct BIMAPBucket * candidate = PREFIX_find_post(bimap->cod_buckets, bimap->sizemask, post, COD_HASH(post));
+	size_t hash = COD_HASH(post);
+	struct BUCKET * candidate = PREFIX(find_post)(bimap->cod_buckets, bimap->sizemask, post, hash);
+	cl_stats_probe(bimap->stats, (((size_t) (candidate - bimap->cod_buckets) - hash) & bimap->sizemask) + 1);
 	if (candidate->state == CL_BIMAP_BUCKET_OCCUPIED)
 		return &candidate->entry.pre;
 
 	return NULL;
 }
 
+/**
+ * Returns the number of entries of a bimap.
+ *
+ * @param bimap Pointer to a bimap.
+ *
+ * @return The number of entries in the bimap is returned.
+ */
+static inline size_t PREFIX(count)(const BIMAP * bimap) {
+	assert (bimap != NULL);
+
+	return bimap->count;
+}
+
+/**
+ * Returns the lookup statistics of a bimap.
+ *
+ * @param bimap Pointer to a bimap.
+ *
+ * @return The statistics gathered since the bimap was created.
+ */
+static inline struct CLStats PREFIX(stats)(const BIMAP * bimap) {
+	assert (bimap != NULL);
+	(void) bimap;
+
+	return cl_stats_get(bimap->stats);
+}
+
 /**
  * Creates a new bimap iterator.
  *
@@ -458,7 +545,7 @@ static inline const DOM_TYPE * PREFIX_pre(const BIMAP * bimap, COD_TYPE post) {
  *
  * @return An iterator for the map pointed to by <code>bimap</code> is returned.
  */
-static inline BMITER PREFIX_iterator_new(BIMAP * bimap) {
+static inline BMITER PREFIX(iterator_new)(BIMAP * bimap) {
 	assert (bimap != NULL);
 
 	return (BMITER) { .bimap = bimap, .index = 0 };
@@ -472,7 +559,7 @@ static inline BMITER PREFIX_iterator_new(BIMAP * bimap) {
  * @return If there is a next element in the iteration, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_iterator_hasnext(BMITER * i) {
+static inline int PREFIX(iterator_hasnext)(BMITER * i) {
 	assert (i != NULL);
 
 	for (; i->index <= i->bimap->sizemask; ++i->index) {
@@ -491,7 +578,7 @@ static inline int PREFIX_iterator_hasnext(BMITER * i) {
  * @return the next mapping in the iteration is returned.
  * 	If there is no next mapping, the behaviour is undefined.
  */
-static inline struct ENTRY_TYPE PREFIX_iterator_next(BMITER * i) {
+static inline struct ENTRY_TYPE PREFIX(iterator_next)(BMITER * i) {
 	assert (i != NULL);
 
 	for (;; ++i->index) {
@@ -501,4 +588,24 @@ static inline struct ENTRY_TYPE PREFIX_iterator_next(BMITER * i) {
 	}
 }
 
-#endif
+#undef BIMAP
+#undef DOM_TYPE
+#undef COD_TYPE
+#undef ENTRY_TYPE
+#undef BMITER
+#undef PREFIX
+#undef DOM_HASH
+#undef COD_HASH
+#undef DOM_EQUAL
+#undef COD_EQUAL
+#undef BUCKET
+#undef CL_BIMAP_TYPE
+#undef CL_BIMAP_DOM
+#undef CL_BIMAP_COD
+#undef CL_BIMAP_ENTRY
+#undef CL_BIMAP_ITERATOR
+#undef CL_BIMAP_PREFIX
+#undef CL_BIMAP_DOM_HASH
+#undef CL_BIMAP_COD_HASH
+#undef CL_BIMAP_DOM_EQUAL
+#undef CL_BIMAP_COD_EQUAL
@@ -0,0 +1,124 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_GROUP_H__
+#define HILBERT_CL_GROUP_H__
+
+#include<stddef.h>
+
+#ifdef __SSE2__
+#include<emmintrin.h>
+#endif
+
+/**
+ * Control byte groups for open addressing hash tables.
+ *
+ * Each slot of a table has a control byte.
+ * Control bytes of occupied slots have the high bit clear and hold seven bits of the hash code of the slot value.
+ * Control bytes of free slots have the high bit set, distinguishing empty slots from deleted ones.
+ * Lookups examine the control bytes of <code>#CL_GROUP_WIDTH</code> slots at once,
+ * with SSE2 instructions if available, and only compare values whose control byte matches.
+ */
+
+/**
+ * Number of slots in a group.
+ */
+#define CL_GROUP_WIDTH 16
+
+/**
+ * Control byte of an empty slot.
+ */
+#define CL_GROUP_EMPTY ((unsigned char) 0x80)
+
+/**
+ * Control byte of a deleted slot.
+ */
+#define CL_GROUP_DELETED ((unsigned char) 0xfe)
+
+/**
+ * Returns the control byte of an occupied slot.
+ *
+ * @param hash Hash code of the slot value.
+ *
+ * @return The control byte for <code>hash</code> is returned.
+ */
+static inline unsigned char cl_group_tag(size_t hash) {
+	return hash & 0x7f;
+}
+
+/**
+ * Finds the slots of a group whose control byte equals a given byte.
+ *
+ * @param ctrl Pointer to the control bytes of a group.
+ * @param tag Control byte to be searched for.
+ *
+ * @return A mask with bit <code>i</code> set if and only if <code>ctrl[i] == tag</code> is returned.
+ */
+static inline unsigned int cl_group_match(const unsigned char * ctrl, unsigned char tag) {
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) tag)));
+#else
+	unsigned int mask = 0;
+	for (unsigned int i = 0; i != CL_GROUP_WIDTH; ++i)
+		mask |= (unsigned int) (ctrl[i] == tag) << i;
+	return mask;
+#endif
+}
+
+/**
+ * Finds the free (empty or deleted) slots of a group.
+ *
+ * @param ctrl Pointer to the control bytes of a group.
+ *
+ * @return A mask with bit <code>i</code> set if and only if slot <code>i</code> is free is returned.
+ */
+static inline unsigned int cl_group_match_free(const unsigned char * ctrl) {
+#ifdef __SSE2__
+	return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ctrl));
+#else
+	unsigned int mask = 0;
+	for (unsigned int i = 0; i != CL_GROUP_WIDTH; ++i)
+		mask |= (unsigned int) (ctrl[i] >> 7) << i;
+	return mask;
+#endif
+}
+
+/**
+ * Returns the index of the lowest set bit of a mask.
+ *
+ * @param mask A nonzero mask, as returned by the matching functions.
+ *
+ * @return The index of the lowest set bit of <code>mask</code> is returned.
+ */
+static inline unsigned int cl_group_first(unsigned int mask) {
+#ifdef __GNUC__
+	return __builtin_ctz(mask);
+#else
+	unsigned int i = 0;
+	for (; !(mask & 1); mask >>= 1)
+		++i;
+	return i;
+#endif
+}
+
+#endif
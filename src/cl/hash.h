@@ -45,7 +45,26 @@ static inline size_t cl_hash32(register uint_fast32_t a) {
 	return (size_t) a;
 }
 
-// FIXME: are there good free 64-bit hash functions?
+/**
+ * 64-bit hash.
+ * This is the finalisation mix of MurmurHash3. Each input bit affects each output bit with a probability close
+ * to one half, so that the low and the high bits of the result are equally suitable for indexing.
+ *
+ * @author Austin Appleby, public domain code
+ *
+ * @param k 64-bit value to be hashed.
+ *
+ * @return A hash value for <code>k</code> is returned.
+ * 	If <code>size_t</code> is narrower than 64 bits, the hash value is truncated.
+ */
+static inline size_t cl_hash64(register uint_fast64_t k) {
+	k ^= k >> 33;
+	k = (k * UINT64_C(0xff51afd7ed558ccd)) & UINT64_C(0xffffffffffffffff);
+	k ^= k >> 33;
+	k = (k * UINT64_C(0xc4ceb9fe1a85ec53)) & UINT64_C(0xffffffffffffffff);
+	k ^= k >> 33;
+	return (size_t) k;
+}
 
 /**
  * Mix macro for Jenkins hashing
@@ -169,7 +188,11 @@ static inline size_t cl_jenkins_hash(register const void * key, register size_t
  * @return A hash value for <code>value</code> is returned.
  */
 static inline size_t cl_hash_index(register size_t value) {
+#if (SIZE_MAX <= UINT32_MAX)
 	return cl_hash32((uint_fast32_t) value);
+#else
+	return cl_hash64((uint_fast64_t) value);
+#endif
 }
 
 /**
@@ -180,8 +203,10 @@ static inline size_t cl_hash_index(register size_t value) {
  * @return A hash value for <code>p</code> is returned.
  */
 static inline size_t cl_hash_pointer(register const void * p) {
-#if (defined(UINTPTR_MAX) && (UINTPTR_MAX <= UINT_FAST32_MAX))
+#if (defined(UINTPTR_MAX) && (UINTPTR_MAX <= UINT32_MAX))
 	return cl_hash32((uint_fast32_t) (uintptr_t) p);
+#elif (defined(UINTPTR_MAX) && (UINTPTR_MAX <= UINT64_MAX))
+	return cl_hash64((uint_fast64_t) (uintptr_t) p);
 #else
 	/* do it the hard way */
 	return cl_jenkins_hash(&p, sizeof(p), 0);
@@ -21,31 +21,37 @@
  */
 
 /**
- * Replacements from map template:
- * - <code>MAP</code>:
+ * Map container template.
+ * A container type is instantiated by defining the following parameters and including this file.
+ * The parameters are undefined again at the end of this file.
+ * - <code>CL_MAP_TYPE</code>:
  *   Map typename.
- * - <code>KEY_TYPE</code>:
+ * - <code>CL_MAP_KEY</code>:
  *   Type of the mapping keys.
- * - <code>VALUE_TYPE</code>:
+ * - <code>CL_MAP_VALUE</code>:
  *   Type of the mapping values.
- * - <code>ENTRY_TYPE</code>:
- *   Type of the map entries.
- * - <code>MITER</code>:
- *   Map iterator type.
- * - <code>PREFIX</code>:
+ * - <code>CL_MAP_ENTRY</code>:
+ *   Struct tag of the map entries.
+ * - <code>CL_MAP_ITERATOR</code>:
+ *   Map iterator typename.
+ * - <code>CL_MAP_PREFIX</code>:
  *   Function name prefix.
- * - <code>HASH</code>:
- *   Name of hash function to be used.
+ * - <code>CL_MAP_HASH</code>:
+ *   Hash function for keys.
+ * - <code>CL_MAP_EQUAL</code> (optional):
+ *   Equality of keys. Defaults to <code>==</code>.
  */
 
-#ifndef HILBERT_CL_MAP_H__
-#define HILBERT_CL_MAP_H__
+#ifndef HILBERT_CL_MAP_TEMPLATE_H__
+#define HILBERT_CL_MAP_TEMPLATE_H__
 
 #include<assert.h>
 #include<stdint.h>
 #include<stdlib.h>
 
 #include"hash.h"
+#include"stats.h"
+#include"template.h"
 
 /**
  * Initial number of buckets.
@@ -59,13 +65,30 @@
 
 /**
  * Bucket states.
+ * Entries are removed by shifting back the rest of their cluster, so there are no deleted buckets.
  */
-enum CLMAPBucketState {
+enum CLMapBucketState {
 	CL_MAP_BUCKET_EMPTY = 0,
-	CL_MAP_BUCKET_OCCUPIED,
-	CL_MAP_BUCKET_DELETED
+	CL_MAP_BUCKET_OCCUPIED
 };
 
+#endif
+
+#ifndef CL_MAP_EQUAL
+#define CL_MAP_EQUAL(a, b) ((a) == (b))
+#endif
+
+/* short names used within this file */
+#define MAP CL_MAP_TYPE
+#define KEY_TYPE CL_MAP_KEY
+#define VALUE_TYPE CL_MAP_VALUE
+#define ENTRY_TYPE CL_MAP_ENTRY
+#define MITER CL_MAP_ITERATOR
+#define PREFIX(name) CL_CAT(CL_MAP_PREFIX, _ ## name)
+#define HASH CL_MAP_HASH
+#define EQUAL CL_MAP_EQUAL
+#define BUCKET CL_CAT(CL_MAP_TYPE, Bucket)
+
 /**
  * Map entry.
  */
@@ -84,7 +107,7 @@ struct ENTRY_TYPE {
 /**
  * Bucket type.
  */
-struct MAPBucket {
+struct BUCKET {
 	/**
 	 * Map entry.
 	 */
@@ -93,7 +116,7 @@ struct MAPBucket {
 	/**
 	 * Current bucket state.
 	 */
-	enum CLMAPBucketState state;
+	enum CLMapBucketState state;
 };
 
 /**
@@ -118,7 +141,12 @@ struct MAP {
 	/**
 	 * Mapping buckets.
 	 */
-	struct MAPBucket * buckets;
+	struct BUCKET * buckets;
+
+	/**
+	 * Lookup statistics, counting probed buckets.
+	 */
+	CL_STATS_DECL(stats)
 };
 
 typedef struct MAP MAP;
@@ -146,7 +174,7 @@ typedef struct MITER MITER;
  * @return On success, a pointer to a new, empty map is returned.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline MAP * PREFIX_new(void) {
+static inline MAP * PREFIX(new)(void) {
 	MAP * result;
 
 	result = malloc(sizeof(*result));
@@ -156,6 +184,7 @@ static inline MAP * PREFIX_new(void) {
 	result->count = 0;
 	result->threshold = (CL_MAP_MAXLOAD - 1) * CL_MAP_NUMBUCKETS / CL_MAP_MAXLOAD;
 	result->sizemask = CL_MAP_NUMBUCKETS - 1;
+	cl_stats_init(result->stats);
 
 	result->buckets = calloc(CL_MAP_NUMBUCKETS, sizeof(*result->buckets));
 	if (result->buckets == NULL)
@@ -174,7 +203,7 @@ nomapmem:
  *
  * @param map Pointer to a map.
  */
-static inline void PREFIX_del(struct MAP * map) {
+static inline void PREFIX(del)(struct MAP * map) {
 	assert (map != NULL);
 
 	free(map->buckets);
@@ -189,7 +218,7 @@ static inline void PREFIX_del(struct MAP * map) {
  * @param entry Mapping entry to be stored. No entry with the same key must be present in any of the occupied buckets.
  * @param hash Hash code of the key of <code>mapping</code>.
  */
-static inline void PREFIX_store(struct MAPBucket * buckets, size_t sizemask, struct ENTRY_TYPE entry, size_t hash) {
+static inline void PREFIX(store)(struct BUCKET * buckets, size_t sizemask, struct ENTRY_TYPE entry, size_t hash) {
 	assert (buckets != NULL);
 	assert (sizemask != 0);
 
@@ -214,39 +243,74 @@ static inline void PREFIX_store(struct MAPBucket * buckets, size_t sizemask, str
  * 	If the element is occupied, it is occupied with a mapping with key <code>key</code>.
  * 	Otherwise, the element is suitable for storing a mapping with key <code>key</code>.
  */
-static inline struct MAPBucket * PREFIX_find(struct MAPBucket * buckets, size_t sizemask, KEY_TYPE key, size_t hash) {
+static inline struct BUCKET * PREFIX(find)(struct BUCKET * buckets, size_t sizemask, KEY_TYPE key, size_t hash) {
 	assert (buckets != NULL);
 	assert (sizemask > 0);
 	assert (sizemask < SIZE_MAX);
 	assert ((sizemask & (sizemask + 1)) == 0);
 
-	int deletedfound = 0;
-	struct MAPBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_MAP_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_MAP_BUCKET_OCCUPIED:
-				if (buckets[i].entry.key == key)
-					return &buckets[i];
-				break;
-			case CL_MAP_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
+	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
+		if ((buckets[i].state == CL_MAP_BUCKET_EMPTY) || (EQUAL(buckets[i].entry.key, key)))
+			return &buckets[i];
+	}
+}
+
+/**
+ * Removes the entry of a bucket by shifting back the subsequent entries of its cluster (private).
+ * This leaves no deleted markers behind, so that removals never lengthen probe sequences.
+ *
+ * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
+ * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
+ * @param bucket Pointer to an occupied element of the array pointed to by <code>buckets</code>.
+ */
+static inline void PREFIX(erase)(struct BUCKET * buckets, size_t sizemask, struct BUCKET * bucket) {
+	assert (buckets != NULL);
+	assert (bucket != NULL);
+	assert (bucket->state == CL_MAP_BUCKET_OCCUPIED);
+
+	size_t i = bucket - buckets;
+	for (size_t j = (i + 1) & sizemask; buckets[j].state == CL_MAP_BUCKET_OCCUPIED; j = (j + 1) & sizemask) {
+		size_t home = HASH(buckets[j].entry.key) & sizemask;
+		/* the entry may fill the gap unless its home bucket lies cyclically between the gap and itself */
+		if (((j - home) & sizemask) >= ((j - i) & sizemask)) {
+			buckets[i] = buckets[j];
+			i = j;
 		}
 	}
+	buckets[i].state = CL_MAP_BUCKET_EMPTY;
+}
+
+/**
+ * Rebuilds the bucket array of a map with a new size (private).
+ *
+ * @param map Pointer to a map.
+ * @param size New number of buckets. Must be a power of two, and large enough to hold the entries of the map.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the map remains unchanged.
+ */
+static inline int PREFIX(rebuild)(MAP * map, size_t size) {
+	assert (map != NULL);
+	assert (size > 1);
+	assert ((size & (size - 1)) == 0);
+
+	size_t newsizemask = size - 1;
+	size_t newthreshold = (CL_MAP_MAXLOAD - 1) * size / CL_MAP_MAXLOAD;
+	assert (map->count <= newthreshold);
+	struct BUCKET * newbuckets = calloc(size, sizeof(*newbuckets));
+	if (newbuckets == NULL)
+		return -1;
+	for (size_t i = 0; i <= map->sizemask; ++i) {
+		if (map->buckets[i].state == CL_MAP_BUCKET_OCCUPIED)
+			PREFIX(store)(newbuckets, newsizemask, map->buckets[i].entry, HASH(map->buckets[i].entry.key));
+	}
+	free(map->buckets);
+	map->sizemask = newsizemask;
+	map->threshold = newthreshold;
+	map->buckets = newbuckets;
+	cl_stats_rehash(map->stats);
 
-	assert (deletedfound);
-	return firstdeleted;
+	return 0;
 }
 
 /**
@@ -260,12 +324,12 @@ static inline struct MAPBucket * PREFIX_find(struct MAPBucket * buckets, size_t
  * @return On success, <code>0</code> is returned.
  * 	On error, <code>-1</code> is returned.
  */
-static inline int PREFIX_set(MAP * map, KEY_TYPE key, VALUE_TYPE value) {
+static inline int PREFIX(set)(MAP * map, KEY_TYPE key, VALUE_TYPE value) {
 	assert (map != NULL);
 
 	struct ENTRY_TYPE entry = { .key = key, .value = value };
 	size_t hash = HASH(key);
-	struct MAPBucket * candidate = PREFIX_find(map->buckets, map->sizemask, key, hash);
+	struct BUCKET * candidate = PREFIX(find)(map->buckets, map->sizemask, key, hash);
 	if (candidate->state == CL_MAP_BUCKET_OCCUPIED) { /* mapping already present */
 		candidate->entry.value = value;
 		return 0;
@@ -274,32 +338,10 @@ static inline int PREFIX_set(MAP * map, KEY_TYPE key, VALUE_TYPE value) {
 	assert (map->count < SIZE_MAX);
 	size_t newcount = map->count + 1;
 	if (newcount > map->threshold) {
-		/* rebuild table */
-		size_t oldalloc = (map->sizemask + 1) * sizeof(*map->buckets);
-		size_t newalloc = 2 * oldalloc;
-		if (newalloc <= oldalloc)
-			return -1;
-		size_t newsize = newalloc / sizeof(*map->buckets);
-		size_t newsizemask = newsize - 1;
-		size_t newthreshold = (CL_MAP_MAXLOAD - 1) * newsize / CL_MAP_MAXLOAD;
-		struct MAPBucket * newbuckets = calloc(1, newalloc);
-		if (newbuckets == NULL)
+		size_t size = map->sizemask + 1;
+		if ((size > SIZE_MAX / 2) || (PREFIX(rebuild)(map, 2 * size) != 0))
 			return -1;
-		for (size_t i = 0; i <= map->sizemask; ++i) {
-			if (map->buckets[i].state == CL_MAP_BUCKET_OCCUPIED) {
-				PREFIX_store(newbuckets, newsizemask, map->buckets[i].entry,
-						HASH(map->buckets[i].entry.key));
-			}
-		}
-		free(map->buckets);
-		map->sizemask = newsizemask;
-		map->threshold = newthreshold;
-		map->buckets = newbuckets;
-
-		/* store mapping */
-		PREFIX_store(map->buckets, map->sizemask, entry, hash);
-		map->count = newcount;
-		return 0;
+		candidate = PREFIX(find)(map->buckets, map->sizemask, key, hash);
 	}
 
 	/* store mapping */
@@ -309,6 +351,35 @@ static inline int PREFIX_set(MAP * map, KEY_TYPE key, VALUE_TYPE value) {
 	return 0;
 }
 
+/**
+ * Removes the mapping for a key from a map.
+ * If the load of the map becomes low, its bucket array is shrunk.
+ * Iterators over the map become invalid.
+ *
+ * @param map Pointer to a map.
+ * @param key Key whose mapping is to be removed.
+ *
+ * @return If a mapping with key <code>key</code> was present, <code>1</code> is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int PREFIX(remove)(MAP * map, KEY_TYPE key) {
+	assert (map != NULL);
+
+	struct BUCKET * candidate = PREFIX(find)(map->buckets, map->sizemask, key, HASH(key));
+	if (candidate->state != CL_MAP_BUCKET_OCCUPIED)
+		return 0;
+	PREFIX(erase)(map->buckets, map->sizemask, candidate);
+	assert (map->count > 0);
+	--map->count;
+
+	/* shrink on low load; failure to do so is harmless */
+	size_t size = map->sizemask + 1;
+	if ((size > CL_MAP_NUMBUCKETS) && (map->count < map->threshold / 4))
+		PREFIX(rebuild)(map, size / 2);
+
+	return 1;
+}
+
 /**
  * Obtains the value for a key.
  *
@@ -320,16 +391,32 @@ static inline int PREFIX_set(MAP * map, KEY_TYPE key, VALUE_TYPE value) {
  * 	only until the next call to one of the map functions with <code>map</code> as argument.
  * 	If no mapping with key <code>key</code> exists, <code>NULL</code> is returned.
  */
-static inline VALUE_TYPE * PREFIX_get(const MAP * map, KEY_TYPE key) {
+static inline VALUE_TYPE * PREFIX(get)(const MAP * map, KEY_TYPE key) {
 	assert (map != NULL);
 
-	struct MAPBucket * candidate = PREFIX_find(map->buckets, map->sizemask, key, HASH(key));
+	size_t hash = HASH(key);
+	struct BUCKET * candidate = PREFIX(find)(map->buckets, map->sizemask, key, hash);
+	cl_stats_probe(map->stats, (((size_t) (candidate - map->buckets) - hash) & map->sizemask) + 1);
 	if (candidate->state != CL_MAP_BUCKET_OCCUPIED)
 		return NULL;
 
 	return &candidate->entry.value;
 }
 
+/**
+ * Returns the lookup statistics of a map.
+ *
+ * @param map Pointer to a map.
+ *
+ * @return The statistics gathered since the map was created.
+ */
+static inline struct CLStats PREFIX(stats)(const MAP * map) {
+	assert (map != NULL);
+	(void) map;
+
+	return cl_stats_get(map->stats);
+}
+
 /**
  * Creates a new map iterator.
  *
@@ -337,7 +424,7 @@ static inline VALUE_TYPE * PREFIX_get(const MAP * map, KEY_TYPE key) {
  *
  * @return An iterator for the map pointed to by <code>map</code> is returned.
  */
-static inline MITER PREFIX_iterator_new(MAP * map) {
+static inline MITER PREFIX(iterator_new)(MAP * map) {
 	assert (map != NULL);
 
 	return (MITER) { .map = map, .index = 0 };
@@ -351,7 +438,7 @@ static inline MITER PREFIX_iterator_new(MAP * map) {
  * @return If there is a next element in the iteration, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_iterator_hasnext(MITER * i) {
+static inline int PREFIX(iterator_hasnext)(MITER * i) {
 	assert (i != NULL);
 
 	for(; i->index <= i->map->sizemask; ++i->index)
@@ -368,7 +455,7 @@ static inline int PREFIX_iterator_hasnext(MITER * i) {
  * @return the next mapping in the iteration is returned.
  * 	If there is no next mapping, the behaviour is undefined.
  */
-static inline struct ENTRY_TYPE PREFIX_iterator_next(MITER * i) {
+static inline struct ENTRY_TYPE PREFIX(iterator_next)(MITER * i) {
 	assert (i != NULL);
 
 	for (;; ++i->index) {
@@ -378,4 +465,20 @@ static inline struct ENTRY_TYPE PREFIX_iterator_next(MITER * i) {
 	}
 }
 
-#endif
+#undef MAP
+#undef KEY_TYPE
+#undef VALUE_TYPE
+#undef ENTRY_TYPE
+#undef MITER
+#undef PREFIX
+#undef HASH
+#undef EQUAL
+#undef BUCKET
+#undef CL_MAP_TYPE
+#undef CL_MAP_KEY
+#undef CL_MAP_VALUE
+#undef CL_MAP_ENTRY
+#undef CL_MAP_ITERATOR
+#undef CL_MAP_PREFIX
+#undef CL_MAP_HASH
+#undef CL_MAP_EQUAL
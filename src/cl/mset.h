@@ -1,4 +1,3 @@
-/* AUTOGENERATED FILE! DO NOT EDIT! */
 /*
  *  The Hilbert Kernel Library, a library for verifying formal proofs.
  *  Copyright © 2011 Alexander Klauer
@@ -21,456 +20,20 @@
  *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
  */
 
-/**
- * Replacements from set template:
- * - <code>ModuleSet</code>:
- *   Set typename.
- * - <code>struct HilbertModule *</code>:
- *   Type of the values stored.
- * - <code>ModuleSetIterator</code>:
- *   Set iterator type.
- * - <code>hilbert_mset</code>:
- *   Function name prefix.
- * - <code>cl_hash_pointer</code>:
- *   Name of hash function to be used.
- */
-
-#ifndef HILBERT_CL_ModuleSet_H__
-#define HILBERT_CL_ModuleSet_H__
-
-#include<assert.h>
-#include<stdint.h>
-#include<stdlib.h>
-#include<string.h>
+#ifndef HILBERT_CL_MSET_H__
+#define HILBERT_CL_MSET_H__
 
+#include"../hilbert.h"
 #include"hash.h"
 
 /**
- * Initial number of buckets
- */
-#define CL_ModuleSet_NUMBUCKETS 4
-
-/**
- * Maximum load coefficient.
- */
-#define CL_ModuleSet_MAXLOAD 4
-
-/**
- * Bucket states.
- */
-enum CLModuleSetBucketState {
-	CL_ModuleSet_BUCKET_EMPTY = 0,
-	CL_ModuleSet_BUCKET_OCCUPIED,
-	CL_ModuleSet_BUCKET_DELETED
-};
-
-/**
- * Bucket type.
- */
-struct ModuleSetBucket {
-	/**
-	 * Bucket value.
-	 */
-	struct HilbertModule * value;
-	/**
-	 * Bucket state.
-	 */
-	enum CLModuleSetBucketState state;
-};
-
-/**
- * Set structure.
+ * Set of modules.
  */
-struct ModuleSet {
-	/**
-	 * Set item count.
-	 */
-	size_t count;
-
-	/**
-	 * Load threshold.
-	 */
-	size_t threshold;
-
-	/**
-	 * Total number of buckets, minus one
-	 */
-	size_t sizemask;
-
-	/**
-	 * Buckets
-	 */
-	struct ModuleSetBucket * buckets;
-};
-
-typedef struct ModuleSet ModuleSet;
-
-/**
- * Set iterator structure.
- */
-struct ModuleSetIterator {
-	/**
-	 * Pointer to the set over which we are iterating.
-	 */
-	ModuleSet * set;
-	/**
-	 * Current index.
-	 */
-	size_t index;
-};
-
-typedef struct ModuleSetIterator ModuleSetIterator;
-
-/**
- * Creates a new, empty set.
- *
- * @return On success, a pointer to a new empty set is returned.
- * 	On error, <code>NULL</code> is returned.
- */
-static inline ModuleSet * hilbert_mset_new(void) {
-	ModuleSet * result;
-
-	result = malloc(sizeof(*result));
-	if (result == NULL)
-		goto nosetmem;
-	result->count = 0;
-	result->threshold = (CL_ModuleSet_MAXLOAD - 1) * CL_ModuleSet_NUMBUCKETS / CL_ModuleSet_MAXLOAD;
-	result->sizemask = CL_ModuleSet_NUMBUCKETS - 1;
-
-	result->buckets = calloc(CL_ModuleSet_NUMBUCKETS, sizeof(*result->buckets));
-	if (result->buckets == NULL)
-		goto nobucketmem;
-
-	return result;
-
-nobucketmem:
-	free(result);
-nosetmem:
-	return NULL;
-}
-
-/**
- * Deletes a set.
- *
- * @param set Pointer to a set.
- */
-static inline void hilbert_mset_del(ModuleSet * set) {
-	assert (set != NULL);
-
-	free(set->buckets);
-	free(set);
-}
-
-/**
- * Clones a set.
- *
- * @param set Pointer to set that is to be cloned.
- *
- * @return On success, a pointer to a new set is returned, containing precisely the elements of the old set.
- * 	On error, <code>NULL</code> is returned.
- */
-static inline ModuleSet * hilbert_mset_clone(const ModuleSet * set) {
-	assert (set != NULL);
-
-	ModuleSet * clone;
-	clone = malloc(sizeof(*clone));
-	if (clone == NULL)
-		return NULL;
-
-	clone->count = set->count;
-	clone->threshold = set->threshold;
-	clone->sizemask = set->sizemask;
-
-	size_t bucketalloc = (clone->sizemask + 1) * sizeof(*clone->buckets);
-	clone->buckets = malloc(bucketalloc);
-	if (clone->buckets == NULL) {
-		free(clone);
-		return NULL;
-	}
-	memcpy(clone->buckets, set->buckets, bucketalloc);
-
-	return clone;
-}
-
-/**
- * Stores a value in the correct bucket (private).
- *
- * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * @param value Value to be stored. The value must not be present in any of the buckets.
- * @param hash Hash code of <code>value</code>.
- */
-static inline void hilbert_mset_store(struct ModuleSetBucket * buckets, size_t sizemask, struct HilbertModule * value, size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
-		if (buckets[i].state != CL_ModuleSet_BUCKET_OCCUPIED) {
-			buckets[i].value = value;
-			buckets[i].state = CL_ModuleSet_BUCKET_OCCUPIED;
-			break;
-		}
-	}
-}
-
-/**
- * Finds a candidate bucket (private).
- *
- * @param buckets Pointer to an array of buckets.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * 	The array size must be a power of two.
- * @param value Value to be searched for/to be stored in the candidate bucket.
- * @param hash Hash code of <code>value</code>.
- *
- * @return A pointer to an element in the <code>buckets</code> array is returned.
- * 	If the element is occupied, it contains <code>value</code>.
- * 	Otherwise, the element is suitable for storing <code>value</code>.
- */
-static inline struct ModuleSetBucket * hilbert_mset_find(struct ModuleSetBucket * buckets, size_t sizemask, struct HilbertModule * value, size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	int deletedfound = 0;
-	struct ModuleSetBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_ModuleSet_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_ModuleSet_BUCKET_OCCUPIED:
-				if (buckets[i].value == value)
-					return &buckets[i];
-				break;
-			case CL_ModuleSet_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
-		}
-	}
-
-	assert (deletedfound);
-	return firstdeleted;
-}
-
-/**
- * Adds an element to a set.
- * 
- * @param set Pointer to a set to which an element is to be added.
- * @param value Value to be added to the set.
- *
- * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned.
- */
-static inline int hilbert_mset_add(ModuleSet * set, struct HilbertModule * value) {
-	assert (set != NULL);
-
-	size_t hash = cl_hash_pointer(value);
-	struct ModuleSetBucket * candidate = hilbert_mset_find(set->buckets, set->sizemask, value, hash);
-	if (candidate->state == CL_ModuleSet_BUCKET_OCCUPIED) /* already in set */
-		return 0;
-
-	assert (set->count < SIZE_MAX);
-
-	size_t newcount = set->count + 1;
-	if (newcount > set->threshold) {
-		/* rebuild table */
-		size_t oldalloc = (set->sizemask + 1) * sizeof(*set->buckets);
-		size_t newalloc = 2 * oldalloc;
-		if (newalloc <= oldalloc)
-			return -1;
-		size_t newsize = newalloc / sizeof(*set->buckets);
-		size_t newsizemask = newsize - 1;
-		size_t newthreshold = (CL_ModuleSet_MAXLOAD - 1) * newsize / CL_ModuleSet_MAXLOAD;
-		struct ModuleSetBucket * newbuckets = calloc(1, newalloc);
-		if (newbuckets == NULL)
-			return -1;
-		for (size_t i = 0; i <= set->sizemask; ++i) {
-			if (set->buckets[i].state == CL_ModuleSet_BUCKET_OCCUPIED)
-				hilbert_mset_store(newbuckets, newsizemask, set->buckets[i].value, cl_hash_pointer(set->buckets[i].value));
-		}
-		free (set->buckets);
-		set->sizemask = newsizemask;
-		set->threshold = newthreshold;
-		set->buckets = newbuckets;
-
-		/* store value */
-		hilbert_mset_store(set->buckets, set->sizemask, value, hash);
-		set->count = newcount;
-		return 0;
-	}
-
-	/* store value */
-	candidate->value = value;
-	candidate->state = CL_ModuleSet_BUCKET_OCCUPIED;
-	set->count = newcount;
-	return 0;
-}
-
-/**
- * Adds all values from one set to another.
- *
- * @param dest Pointer to destination set.
- * @param src Pointer to source set. Must be distinct from destrination set.
- *
- * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned.
- */
-static inline int hilbert_mset_addall(ModuleSet * restrict dest, const ModuleSet * restrict src) {
-	assert (dest != NULL);
-	assert (src != NULL);
-
-	int rc = -1;
-
-	/* first, create a backup set in case something goes wrong */
-	ModuleSet backup = *dest;
-	size_t allocsize = (backup.sizemask + 1) * sizeof(*backup.buckets);
-	backup.buckets = malloc(allocsize);
-	if (backup.buckets == NULL)
-		goto backupallocfail;
-	memcpy(backup.buckets, dest->buckets, allocsize);
-
-	/* Now add new elements */
-	for (size_t i = 0; i <= src->sizemask; ++i) {
-		if (src->buckets[i].state == CL_ModuleSet_BUCKET_OCCUPIED) {
-			if (hilbert_mset_add(dest, src->buckets[i].value) != 0) {
-				/* restore backup and bailout */
-				free(dest->buckets);
-				*dest = backup;
-				goto addfail;
-			}
-		}
-	}
-
-	free(backup.buckets);
-	rc = 0;
-
-addfail:
-backupallocfail:
-	return rc;
-}
-
-/**
- * Removes an element from a set.
- *
- * @param set Pointer to a set.
- * @param value Value to be removed.
- *
- * @return If <code>value</code> was present in the set pointed to by <code>set</code>, <code>1</code> is returned.
- * 	Otherwise, <code>0</code> is returned.
- */
-static inline int hilbert_mset_remove(ModuleSet * set, struct HilbertModule * value) {
-	assert (set != NULL);
-
-	struct ModuleSetBucket * candidate = hilbert_mset_find(set->buckets, set->sizemask, value, cl_hash_pointer(value));
-	if (candidate->state != CL_ModuleSet_BUCKET_OCCUPIED)
-		return 0;
-
-	candidate->state = CL_ModuleSet_BUCKET_DELETED;
-	assert (set->count > 0);
-	--set->count;
-
-	return 1;
-}
-
-/**
- * Clears a set.
- *
- * @param set Pointer to a set.
- */
-static inline void hilbert_mset_clear(ModuleSet * set) {
-	assert (set != NULL);
-
-	set->count = 0;
-	memset(set->buckets, 0, (set->sizemask + 1) * sizeof(*set->buckets));
-}
-
-/**
- * Checks whether a value is present in a set.
- *
- * @param set Pointer to a set.
- * @param value Value to be looked for.
- *
- * @return If <code>value</code> is present in the set pointed to by <code>set</code>, <code>1</code> is returned.
- * 	Otherwise, <code>0</code> is returned.
- */
-static inline int hilbert_mset_contains(const ModuleSet * set, struct HilbertModule * value) {
-	assert (set != NULL);
-
-	return (hilbert_mset_find(set->buckets, set->sizemask, value, cl_hash_pointer(value))->state == CL_ModuleSet_BUCKET_OCCUPIED);
-}
-
-/**
- * Returns the number of elements in a set.
- *
- * @param set Pointer to a set.
- *
- * @return The number of elements in the set is returned.
- */
-static inline size_t hilbert_mset_count(const ModuleSet * set) {
-	assert (set != NULL);
-
-	return set->count;
-}
-
-/**
- * Creates a new iterator for a set.
- *
- * @param set Pointer to a set.
- *
- * @return An iterator for the set pointed to by <code>set</code> is returned.
- */
-static inline ModuleSetIterator hilbert_mset_iterator_new(ModuleSet * set) {
-	assert (set != NULL);
-
-	return (ModuleSetIterator) { .set = set, .index = 0 };
-}
-
-/**
- * Checks whether an iterator has a next element.
- *
- * @param i Pointer to an iterator.
- *
- * @return If there is a next element in the iteration, <code>1</code> is returned.
- * 	Otherwise, <code>0</code> is returned.
- */
-static inline int hilbert_mset_iterator_hasnext(ModuleSetIterator * i) {
-	assert (i != NULL);
-
-	for(; i->index <= i->set->sizemask; ++i->index) {
-		if (i->set->buckets[i->index].state == CL_ModuleSet_BUCKET_OCCUPIED)
-			return 1;
-	}
-
-	return 0;
-}
-
-/**
- * Returns the next element in an iteration.
- *
- * @param i Pointer to an iterator.
- *
- * @return The next element in the iteration is returned.
- * 	If there is no next element in the iteration, the behaviour is undefined.
- */
-static inline struct HilbertModule * hilbert_mset_iterator_next(ModuleSetIterator * i) {
-	assert (i != NULL);
-
-	for (;; ++i->index) {
-		assert (i->index <= i->set->sizemask);
-		if (i->set->buckets[i->index].state == CL_ModuleSet_BUCKET_OCCUPIED)
-			return i->set->buckets[i->index++].value;
-	}
-}
+#define CL_SET_TYPE ModuleSet
+#define CL_SET_VALUE struct HilbertModule *
+#define CL_SET_ITERATOR ModuleSetIterator
+#define CL_SET_PREFIX hilbert_mset
+#define CL_SET_HASH cl_hash_pointer
+#include"set.template.h"
 
 #endif
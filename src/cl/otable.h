@@ -0,0 +1,509 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_OTABLE_H__
+#define HILBERT_CL_OTABLE_H__
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdlib.h>
+
+union Object;
+
+/**
+ * Row of an object table.
+ * Columns not applicable to an object type should be zero.
+ */
+struct ObjectRow {
+	/**
+	 * Object type.
+	 */
+	unsigned int type;
+
+	/**
+	 * Kind handle of a variable, or result kind handle of a functor.
+	 */
+	size_t kind;
+
+	/**
+	 * Index into the parameter handles of the module, for external objects.
+	 */
+	size_t paramindex;
+
+	/**
+	 * Index into the kind equivalence classes of the module, for kinds.
+	 */
+	size_t eqcindex;
+
+	/**
+	 * Pointer to an additional record, for functors and parameters.
+	 */
+	union Object * record;
+};
+
+/**
+ * Object table.
+ *
+ * Object data is stored column by column, each column being a dense array indexed by object handle.
+ * This way, checking the type of an object touches only the type column.
+ */
+struct ObjectTable {
+	/**
+	 * Number of rows.
+	 */
+	size_t count;
+
+	/**
+	 * Current maximum number of rows.
+	 */
+	size_t size;
+
+	/**
+	 * Type column.
+	 */
+	unsigned int * type;
+
+	/**
+	 * Kind column.
+	 */
+	size_t * kind;
+
+	/**
+	 * Parameter index column.
+	 */
+	size_t * paramindex;
+
+	/**
+	 * Equivalence class index column.
+	 */
+	size_t * eqcindex;
+
+	/**
+	 * Record column.
+	 */
+	union Object ** record;
+
+	/**
+	 * Whether all columns but the record column are borrowed from an external buffer
+	 * (see <code>#cl_otable_borrow()</code>).
+	 */
+	int borrowed;
+};
+
+typedef struct ObjectTable ObjectTable;
+
+/**
+ * Creates a new, empty object table.
+ *
+ * @return On success, a pointer to a new, empty object table is returned.
+ * 	On error, <code>NULL</code> is returned.
+ */
+static inline ObjectTable * cl_otable_new(void) {
+	ObjectTable * result;
+
+	result = malloc(sizeof(*result));
+	if (result == NULL)
+		goto nomem;
+
+	result->count = 0;
+	result->size = 1;
+	result->borrowed = 0;
+	result->type = malloc(result->size * sizeof(*result->type));
+	if (result->type == NULL)
+		goto notypemem;
+	result->kind = malloc(result->size * sizeof(*result->kind));
+	if (result->kind == NULL)
+		goto nokindmem;
+	result->paramindex = malloc(result->size * sizeof(*result->paramindex));
+	if (result->paramindex == NULL)
+		goto noparamindexmem;
+	result->eqcindex = malloc(result->size * sizeof(*result->eqcindex));
+	if (result->eqcindex == NULL)
+		goto noeqcindexmem;
+	result->record = malloc(result->size * sizeof(*result->record));
+	if (result->record == NULL)
+		goto norecordmem;
+
+	return result;
+
+norecordmem:
+	free(result->eqcindex);
+noeqcindexmem:
+	free(result->paramindex);
+noparamindexmem:
+	free(result->kind);
+nokindmem:
+	free(result->type);
+notypemem:
+	free(result);
+nomem:
+	return NULL;
+}
+
+/**
+ * Deletes an object table.
+ * Records referenced by the table are not freed.
+ *
+ * @param table Pointer to the object table to be deleted.
+ */
+static inline void cl_otable_del(ObjectTable * table) {
+	assert (table != NULL);
+
+	free(table->record);
+	if (!table->borrowed) {
+		free(table->eqcindex);
+		free(table->paramindex);
+		free(table->kind);
+		free(table->type);
+	}
+	free(table);
+}
+
+/**
+ * Ensures that an object table can hold a given number of rows without further allocation.
+ * If the table needs to be enlarged, its capacity is at least doubled.
+ *
+ * @param table Pointer to an object table.
+ * @param size Required capacity.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the table remains unchanged, save for its allocated space.
+ */
+static inline int cl_otable_reserve(ObjectTable * table, size_t size) {
+	assert (table != NULL);
+	assert (!table->borrowed);
+
+	if (size <= table->size)
+		return 0;
+	size_t newsize = table->size <= SIZE_MAX / 2 ? 2 * table->size : SIZE_MAX;
+	if (newsize < size)
+		newsize = size;
+	if (newsize > SIZE_MAX / sizeof(*table->kind))
+		return -1;
+
+	unsigned int * newtype = realloc(table->type, newsize * sizeof(*newtype));
+	if (newtype == NULL)
+		return -1;
+	table->type = newtype;
+	size_t * newkind = realloc(table->kind, newsize * sizeof(*newkind));
+	if (newkind == NULL)
+		return -1;
+	table->kind = newkind;
+	size_t * newparamindex = realloc(table->paramindex, newsize * sizeof(*newparamindex));
+	if (newparamindex == NULL)
+		return -1;
+	table->paramindex = newparamindex;
+	size_t * neweqcindex = realloc(table->eqcindex, newsize * sizeof(*neweqcindex));
+	if (neweqcindex == NULL)
+		return -1;
+	table->eqcindex = neweqcindex;
+	union Object ** newrecord = realloc(table->record, newsize * sizeof(*newrecord));
+	if (newrecord == NULL)
+		return -1;
+	table->record = newrecord;
+
+	table->size = newsize;
+
+	return 0;
+}
+
+/**
+ * Releases the allocated space of an object table beyond its rows.
+ * Failure to do so is harmless and is ignored.
+ *
+ * @param table Pointer to an object table.
+ */
+static inline void cl_otable_shrinktofit(ObjectTable * table) {
+	assert (table != NULL);
+
+	if (table->borrowed || (table->count == 0) || (table->count == table->size))
+		return;
+
+	/* a column which cannot be shrunk simply keeps more space than needed */
+	size_t count = table->count;
+	unsigned int * newtype = realloc(table->type, count * sizeof(*newtype));
+	if (newtype != NULL)
+		table->type = newtype;
+	size_t * newkind = realloc(table->kind, count * sizeof(*newkind));
+	if (newkind != NULL)
+		table->kind = newkind;
+	size_t * newparamindex = realloc(table->paramindex, count * sizeof(*newparamindex));
+	if (newparamindex != NULL)
+		table->paramindex = newparamindex;
+	size_t * neweqcindex = realloc(table->eqcindex, count * sizeof(*neweqcindex));
+	if (neweqcindex != NULL)
+		table->eqcindex = neweqcindex;
+	union Object ** newrecord = realloc(table->record, count * sizeof(*newrecord));
+	if (newrecord != NULL)
+		table->record = newrecord;
+
+	table->size = count;
+}
+
+/**
+ * Grows an object table (private).
+ *
+ * @param table Pointer to the object table to be grown.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the table remains unchanged, save for its allocated space.
+ */
+static inline int cl_otable_grow(ObjectTable * table) {
+	assert (table != NULL);
+
+	if (table->size == SIZE_MAX)
+		return -1;
+
+	return cl_otable_reserve(table, table->size + 1);
+}
+
+/**
+ * Turns an empty object table into one whose columns, save for the record column, are borrowed from external buffers.
+ * The buffers are not copied and must outlive the table. They are not freed along with the table.
+ * The records of all rows are set to <code>NULL</code>.
+ * A table with borrowed columns must not be grown, and its borrowed columns may be read-only.
+ *
+ * @param table Pointer to an empty object table.
+ * @param count Number of rows.
+ * @param type Pointer to the first element of the type column, an array of <code>count</code> elements.
+ * @param kind Pointer to the first element of the kind column, an array of <code>count</code> elements.
+ * @param paramindex Pointer to the first element of the parameter index column, an array of <code>count</code> elements.
+ * @param eqcindex Pointer to the first element of the equivalence class index column,
+ * 	an array of <code>count</code> elements.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the table remains unchanged.
+ */
+static inline int cl_otable_borrow(ObjectTable * table, size_t count, unsigned int * type, size_t * kind,
+		size_t * paramindex, size_t * eqcindex) {
+	assert (table != NULL);
+	assert (table->count == 0);
+	assert (!table->borrowed);
+
+	if ((count > table->size) && (count > SIZE_MAX / sizeof(*table->record)))
+		return -1;
+	if (count > table->size) {
+		union Object ** newrecord = realloc(table->record, count * sizeof(*newrecord));
+		if (newrecord == NULL)
+			return -1;
+		table->record = newrecord;
+	}
+	for (size_t i = 0; i != count; ++i)
+		table->record[i] = NULL;
+
+	free(table->eqcindex);
+	free(table->paramindex);
+	free(table->kind);
+	free(table->type);
+	table->type = type;
+	table->kind = kind;
+	table->paramindex = paramindex;
+	table->eqcindex = eqcindex;
+	if (count > table->size)
+		table->size = count;
+	table->count = count;
+	table->borrowed = 1;
+
+	return 0;
+}
+
+/**
+ * Adds a row to the end of an object table.
+ *
+ * @param table Pointer to an object table.
+ * @param row Row to be added.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int cl_otable_pushback(ObjectTable * table, struct ObjectRow row) {
+	assert (table != NULL);
+	assert (table->count < SIZE_MAX);
+
+	if (table->count == table->size) {
+		if (cl_otable_grow(table) != 0)
+			return -1;
+	}
+	size_t index = table->count++;
+	table->type[index] = row.type;
+	table->kind[index] = row.kind;
+	table->paramindex[index] = row.paramindex;
+	table->eqcindex[index] = row.eqcindex;
+	table->record[index] = row.record;
+
+	return 0;
+}
+
+/**
+ * Removes the last row from an object table.
+ *
+ * @param table Pointer to an object table.
+ * 	If the table does not have any rows, the behaviour is undefined.
+ */
+static inline void cl_otable_popback(ObjectTable * table) {
+	assert (table != NULL);
+	assert (table->count > 0);
+
+	--table->count;
+}
+
+/**
+ * Removes rows from the end of an object table.
+ *
+ * @param table Pointer to an object table.
+ * @param newcount New row count.
+ * 	It is an error if the new row count is larger than the current row count.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int cl_otable_downsize(ObjectTable * table, size_t newcount) {
+	assert (table != NULL);
+
+	if (newcount > table->count)
+		return -1;
+	table->count = newcount;
+
+	return 0;
+}
+
+/**
+ * Returns the number of rows of an object table.
+ *
+ * @param table Pointer to an object table.
+ *
+ * @return The number of rows of the table pointed to by <code>table</code>.
+ */
+static inline size_t cl_otable_count(const ObjectTable * table) {
+	assert (table != NULL);
+
+	return table->count;
+}
+
+/**
+ * Returns the amount of memory held by an object table.
+ *
+ * @param table Pointer to an object table.
+ *
+ * @return The size of the columns of the table in bytes, including unused rows.
+ * 	Borrowed columns are not included.
+ */
+static inline size_t cl_otable_memsize(const ObjectTable * table) {
+	assert (table != NULL);
+
+	size_t rowsize = sizeof(*table->record);
+	if (!table->borrowed)
+		rowsize += sizeof(*table->type) + sizeof(*table->kind) + sizeof(*table->paramindex) + sizeof(*table->eqcindex);
+
+	return sizeof(*table) + table->size * rowsize;
+}
+
+/**
+ * Returns the type of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ *
+ * @return The type column entry of the specified row.
+ */
+static inline unsigned int cl_otable_type(const ObjectTable * table, size_t index) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	return table->type[index];
+}
+
+/**
+ * Returns the kind of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ *
+ * @return The kind column entry of the specified row.
+ */
+static inline size_t cl_otable_kind(const ObjectTable * table, size_t index) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	return table->kind[index];
+}
+
+/**
+ * Returns the parameter index of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ *
+ * @return The parameter index column entry of the specified row.
+ */
+static inline size_t cl_otable_paramindex(const ObjectTable * table, size_t index) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	return table->paramindex[index];
+}
+
+/**
+ * Returns the equivalence class index of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ *
+ * @return The equivalence class index column entry of the specified row.
+ */
+static inline size_t cl_otable_eqcindex(const ObjectTable * table, size_t index) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	return table->eqcindex[index];
+}
+
+/**
+ * Returns the record of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ *
+ * @return The record column entry of the specified row.
+ */
+static inline union Object * cl_otable_record(const ObjectTable * table, size_t index) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	return table->record[index];
+}
+
+/**
+ * Replaces the record of an object.
+ *
+ * @param table Pointer to an object table.
+ * @param index Row index. If the index is out of range, the behaviour is undefined.
+ * @param record New record column entry of the specified row.
+ */
+static inline void cl_otable_setrecord(ObjectTable * table, size_t index, union Object * record) {
+	assert (table != NULL);
+	assert (index < table->count);
+
+	table->record[index] = record;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_PHMAP_H__
+#define HILBERT_CL_PHMAP_H__
+
+#include"../hilbert.h"
+#include"hash.h"
+
+/**
+ * Hash bimap of handles, used by <code>ParamMap</code> for entries outside its runs.
+ */
+#define CL_BIMAP_TYPE ParamHashMap
+#define CL_BIMAP_DOM HilbertHandle
+#define CL_BIMAP_COD HilbertHandle
+#define CL_BIMAP_ENTRY ParamHashMapEntry
+#define CL_BIMAP_ITERATOR ParamHashMapIterator
+#define CL_BIMAP_PREFIX hilbert_phmap
+#define CL_BIMAP_DOM_HASH cl_hash_index
+#define CL_BIMAP_COD_HASH cl_hash_index
+#include"bimap.template.h"
+
+#endif
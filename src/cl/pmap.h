@@ -1,4 +1,3 @@
-/* AUTOGENERATED FILE! DO NOT EDIT! */
 /*
  *  The Hilbert Kernel Library, a library for verifying formal proofs.
  *  Copyright © 2011 Alexander Klauer
@@ -21,454 +20,420 @@
  *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
  */
 
-/**
- * Replacements from bimap template:
- * - <code>ParamMap</code>:
- *   Bimap typename.
- * - <code>HilbertHandle</code>:
- *   Type of the bimap's domain.
- * - <code>HilbertHandle</code>:
- *   Type of the bimap's codomain.
- * - <code>ParamMapEntry</code>:
- *   Type of the bimap entries.
- * - <code>ParamMapIterator</code>:
- *   Bimap iterator type.
- * - <code>hilbert_pmap</code>:
- *   Function name prefix.
- * - <code>cl_hash32</code>:
- *   Name of domain hash function.
- * - <code>cl_hash32</code>:
- *   Name of codomain hash function.
- */
-
-#ifndef HILBERT_CL_ParamMap_H__
-#define HILBERT_CL_ParamMap_H__
+#ifndef HILBERT_CL_PMAP_H__
+#define HILBERT_CL_PMAP_H__
 
 #include<assert.h>
 #include<stdint.h>
 #include<stdlib.h>
 
-#include"hash.h"
+#include"../hilbert.h"
+#include"phmap.h"
 
 /**
- * Initial number of buckets.
+ * Marker for a run slot without an entry.
  */
-#define CL_ParamMap_NUMBUCKETS 4
+#define CL_PMAP_NONE ((HilbertHandle) SIZE_MAX)
 
 /**
- * Maximum load coefficient.
+ * Number of slots up to which a run may grow regardless of density.
  */
-#define CL_ParamMap_MAXLOAD 4
+#define CL_PMAP_MINRUN 16
 
 /**
- * Bucket states.
+ * Minimum density of a run: a run may grow only while it has at least one entry
+ * per <code>CL_PMAP_DENSITY</code> slots.
  */
-enum CLParamMapBucketState {
-	CL_ParamMap_BUCKET_EMPTY = 0,
-	CL_ParamMap_BUCKET_OCCUPIED,
-	CL_ParamMap_BUCKET_DELETED
-};
+#define CL_PMAP_DENSITY 4
 
 /**
- * Bimap entry.
+ * Contiguous run of keys, mapped by array lookup.
  */
-struct ParamMapEntry {
-	/**
-	 * Preimage.
-	 */
-	HilbertHandle pre;
-
+struct ParamMapRun {
 	/**
-	 * Image.
+	 * First key of the run.
 	 */
-	HilbertHandle post;
-};
+	HilbertHandle offset;
 
-/**
- * Bucket type.
- */
-struct ParamMapBucket {
 	/**
-	 * Bimap entry.
+	 * Values, indexed by key minus <code>offset</code>.
+	 * Slots without an entry hold <code>#CL_PMAP_NONE</code>.
 	 */
-	struct ParamMapEntry entry;
+	HilbertHandle * values;
 
 	/**
-	 * Current bucket state.
+	 * Number of slots.
 	 */
-	enum CLParamMapBucketState state;
+	size_t size;
 };
 
 /**
- * Map structure.
+ * Parameter handle map, a bijective map from destination handles (preimages) to source handles (postimages).
+ *
+ * The source handles of an import are the handles of the source module, and the destination handles
+ * of the objects created by an import form a contiguous run. Hence most entries are stored in two runs,
+ * one indexed by preimage and one indexed by postimage, and are looked up with a single array access.
+ * Entries which do not fit the runs, such as those for mapped externals, are stored in a hash bimap.
  */
 struct ParamMap {
 	/**
-	 * Number of entries.
+	 * Number of entries in the runs.
 	 */
 	size_t count;
 
 	/**
-	 * Load threshold.
+	 * Run mapping preimages to postimages.
 	 */
-	size_t threshold;
+	struct ParamMapRun dom;
 
 	/**
-	 * Total number of buckets minus one.
+	 * Run mapping postimages to preimages.
 	 */
-	size_t sizemask;
+	struct ParamMapRun cod;
 
 	/**
-	 * Domain based mapping buckets.
+	 * Hash bimap with the remaining entries, or <code>NULL</code> if there are none yet.
 	 */
-	struct ParamMapBucket * dom_buckets;
+	ParamHashMap * sparse;
+};
+
+typedef struct ParamMap ParamMap;
 
+/**
+ * Parameter map entry.
+ */
+struct ParamMapEntry {
 	/**
-	 * Codomain based mapping buckets.
+	 * Preimage.
 	 */
-	struct ParamMapBucket * cod_buckets;
-};
+	HilbertHandle pre;
 
-typedef struct ParamMap ParamMap;
+	/**
+	 * Postimage.
+	 */
+	HilbertHandle post;
+};
 
 /**
- * Bimap iterator structure.
+ * Parameter map iterator.
  */
 struct ParamMapIterator {
 	/**
-	 * Pointer to bimap over which we are iterating.
+	 * Map over which is iterated.
 	 */
-	ParamMap * bimap;
+	ParamMap * map;
 
 	/**
-	 * Current index (domain based).
+	 * Next slot of the preimage run to be examined.
 	 */
 	size_t index;
+
+	/**
+	 * Iterator over the hash bimap, if present.
+	 */
+	ParamHashMapIterator sparse;
 };
 
 typedef struct ParamMapIterator ParamMapIterator;
 
 /**
- * Creates a new, empty bimap.
+ * Looks up a key in a run (private).
  *
- * @return On success, a pointer to a new, empty bimap is returned.
- * 	On error, <code>NULL</code> is returned.
+ * @param run Pointer to a run.
+ * @param key Key to be looked up.
+ *
+ * @return If the run has an entry for <code>key</code>, a pointer to its value is returned.
+ * 	Otherwise, <code>NULL</code> is returned.
  */
-static inline ParamMap * hilbert_pmap_new(void) {
-	ParamMap * result;
-
-	result = malloc(sizeof(*result));
-	if (result == NULL)
-		goto nomapmem;
-
-	result->count = 0;
-	result->threshold = (CL_ParamMap_MAXLOAD - 1) * CL_ParamMap_NUMBUCKETS / CL_ParamMap_MAXLOAD;
-	result->sizemask = CL_ParamMap_NUMBUCKETS - 1;
+static inline HilbertHandle * hilbert_pmap_run_get(const struct ParamMapRun * run, HilbertHandle key) {
+	assert (run != NULL);
 
-	result->dom_buckets = calloc(CL_ParamMap_NUMBUCKETS, sizeof(*result->dom_buckets));
-	if (result->dom_buckets == NULL)
-		goto nodommem;
-
-	result->cod_buckets = calloc(CL_ParamMap_NUMBUCKETS, sizeof(*result->dom_buckets));
-	if (result->cod_buckets == NULL)
-		goto nocodmem;
-
-	return result;
+	if ((key < run->offset) || (key - run->offset >= run->size) || (run->values[key - run->offset] == CL_PMAP_NONE))
+		return NULL;
 
-nocodmem:
-	free(result->dom_buckets);
-nodommem:
-	free(result);
-nomapmem:
-	return NULL;
+	return &run->values[key - run->offset];
 }
 
 /**
- * Frees a bimap.
+ * Checks whether a run may hold a key (private).
  *
- * @param bimap Pointer to a bimap.
+ * @param run Pointer to a run.
+ * @param key Key to be checked.
+ * @param count Number of entries of the run.
+ *
+ * @return If the run holds <code>key</code> already, or may be grown to hold it without becoming too sparse,
+ * 	<code>1</code> is returned. Otherwise, <code>0</code> is returned.
  */
-static inline void hilbert_pmap_del(ParamMap * bimap) {
-	assert (bimap != NULL);
+static inline int hilbert_pmap_run_fits(const struct ParamMapRun * run, HilbertHandle key, size_t count) {
+	assert (run != NULL);
 
-	free(bimap->cod_buckets);
-	free(bimap->dom_buckets);
-	free(bimap);
+	if (run->size == 0)
+		return 1;
+	if (key < run->offset)
+		return 0;
+	size_t index = key - run->offset;
+	return (index < run->size) || (index < CL_PMAP_MINRUN) || (index / CL_PMAP_DENSITY <= count);
 }
 
 /**
- * Stores a mapping in the correct bucket (private).
+ * Grows a run to hold a key (private).
  *
- * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * @param entry Mapping entry to be stored. No entry with the same key (preimage or postimage, depending on
- * 	bucket array) must be present in any of the occupied buckets.
- * @param hash Hash code of the key (preimage or postimage) of <code>mapping</code>.
+ * @param run Pointer to a run for which <code>#hilbert_pmap_run_fits()</code> holds for <code>key</code>.
+ * @param key Key to be held.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the run remains unchanged.
  */
-static inline void hilbert_pmap_store(struct ParamMapBucket * buckets, size_t sizemask, struct ParamMapEntry entry, size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert (((sizemask + 1) & sizemask) == 0);
-
-	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
-		if (buckets[i].state != CL_ParamMap_BUCKET_OCCUPIED) {
-			buckets[i].entry = entry;
-			buckets[i].state = CL_ParamMap_BUCKET_OCCUPIED;
-			break;
-		}
-	}
+static inline int hilbert_pmap_run_grow(struct ParamMapRun * run, HilbertHandle key) {
+	assert (run != NULL);
+
+	HilbertHandle offset = run->size == 0 ? key : run->offset;
+	assert (key >= offset);
+	size_t needed = key - offset + 1;
+	if (needed <= run->size)
+		return 0;
+	size_t newsize = run->size < SIZE_MAX / 2 ? 2 * run->size : SIZE_MAX;
+	if (newsize < needed)
+		newsize = needed;
+	if (newsize < CL_PMAP_MINRUN)
+		newsize = CL_PMAP_MINRUN;
+	if (newsize > SIZE_MAX / sizeof(*run->values))
+		return -1;
+	HilbertHandle * newvalues = realloc(run->values, newsize * sizeof(*newvalues));
+	if (newvalues == NULL)
+		return -1;
+	for (size_t i = run->size; i != newsize; ++i)
+		newvalues[i] = CL_PMAP_NONE;
+	run->offset = offset;
+	run->values = newvalues;
+	run->size = newsize;
+
+	return 0;
 }
 
 /**
- * Finds a candidate bucket for preimage-based mapping (private).
+ * Removes the run entry with a given preimage or postimage (private).
  *
- * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * @param pre Preimage to search candidate bucket for.
- * @param hash Hash code of <code>pre</code>.
+ * @param map Pointer to a parameter map.
+ * @param key Preimage or postimage of the entry to be removed.
+ * @param dom Nonzero if <code>key</code> is a preimage, zero if it is a postimage.
  *
- * @return A pointer to an element of the array pointed to by <code>buckets</code> is returned.
- * 	If the element is occupied, it is occupied with a mapping with preimage <code>pre</code>.
- * 	Otherwise, the element is suitable for storing a mapping with preimage <code>pre</code>.
+ * @return If a run entry was removed, <code>1</code> is returned.
+ * 	Otherwise, <code>0</code> is returned.
  */
-static inline struct ParamMapBucket * hilbert_pmap_find_pre(struct ParamMapBucket * buckets, size_t sizemask, HilbertHandle pre,
-		size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	int deletedfound = 0;
-	struct ParamMapBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_ParamMap_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_ParamMap_BUCKET_OCCUPIED:
-				if (buckets[i].entry.pre == pre)
-					return &buckets[i];
-				break;
-			case CL_ParamMap_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
-		}
-	}
+static inline int hilbert_pmap_run_remove(ParamMap * map, HilbertHandle key, int dom) {
+	assert (map != NULL);
 
-	assert (deletedfound);
-	return firstdeleted;
+	struct ParamMapRun * run = dom ? &map->dom : &map->cod;
+	struct ParamMapRun * inverse = dom ? &map->cod : &map->dom;
+	HilbertHandle * value = hilbert_pmap_run_get(run, key);
+	if (value == NULL)
+		return 0;
+	HilbertHandle * inversevalue = hilbert_pmap_run_get(inverse, *value);
+	assert (inversevalue != NULL);
+	assert (*inversevalue == key);
+	*inversevalue = CL_PMAP_NONE;
+	*value = CL_PMAP_NONE;
+	assert (map->count > 0);
+	--map->count;
+
+	return 1;
 }
 
 /**
- * Finds a candidate bucket for postimage-based mapping (private).
- *
- * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * @param post Postimage to search candidate bucket for.
- * @param hash Hash code of <code>post</code>.
+ * Creates a new, empty parameter map.
  *
- * @return A pointer to an element of the array pointed to by <code>buckets</code> is returned.
- * 	If the element is occupied, it is occupied with a mapping with postimage <code>post</code>.
- * 	Otherwise, the element is suitable for storing a mapping with postimage <code>post</code>.
+ * @return On success, a pointer to a new, empty parameter map is returned.
+ * 	On error, <code>NULL</code> is returned.
  */
-static inline struct ParamMapBucket * hilbert_pmap_find_post(struct ParamMapBucket * buckets, size_t sizemask, HilbertHandle post,
-		size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	int deletedfound = 0;
-	struct ParamMapBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_ParamMap_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_ParamMap_BUCKET_OCCUPIED:
-				if (buckets[i].entry.post == post)
-					return &buckets[i];
-				break;
-			case CL_ParamMap_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
-		}
-	}
+static inline ParamMap * hilbert_pmap_new(void) {
+	ParamMap * result = malloc(sizeof(*result));
+	if (result == NULL)
+		return NULL;
 
-	assert (deletedfound);
-	return firstdeleted;
+	*result = (ParamMap) {
+		.count = 0,
+		.dom = { .offset = 0, .values = NULL, .size = 0 },
+		.cod = { .offset = 0, .values = NULL, .size = 0 },
+		.sparse = NULL
+	};
+
+	return result;
+}
+
+/**
+ * Deletes a parameter map.
+ *
+ * @param map Pointer to a parameter map.
+ */
+static inline void hilbert_pmap_del(ParamMap * map) {
+	assert (map != NULL);
+
+	if (map->sparse != NULL)
+		hilbert_phmap_del(map->sparse);
+	free(map->cod.values);
+	free(map->dom.values);
+	free(map);
 }
 
 /**
- * Adds an entry to the bimap.
+ * Adds an entry to a parameter map.
  * If an entry with the same preimage but a different postimage, or vice-versa, already exists,
  * it will be overwritten, ensuring that the entries continue to constitute a bijective map.
- * Warning: as a result of this policy, the bimap may end up with less entries than before the addition operation.
+ * Warning: as a result of this policy, the map may end up with less entries than before the addition operation.
  *
- * @param bimap Pointer to a bimap.
+ * @param map Pointer to a parameter map.
  * @param pre Preimage.
  * @param post Postimage.
  *
  * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned and the bimap remains unchanged.
+ * 	On error, <code>-1</code> is returned and the map remains unchanged.
  */
-static inline int hilbert_pmap_add(ParamMap * bimap, HilbertHandle pre, HilbertHandle post) {
-	assert (bimap != NULL);
-
-	struct ParamMapEntry entry = { .pre = pre, .post = post };
-	size_t pre_hash = cl_hash32(pre);
-	size_t post_hash = cl_hash32(post);
-
-	/* delete old entries if present */
-	struct ParamMapBucket * pre_cand = hilbert_pmap_find_pre(bimap->dom_buckets, bimap->sizemask, pre, pre_hash);
-	if (pre_cand->state == CL_ParamMap_BUCKET_OCCUPIED) {
-		struct ParamMapBucket * post = hilbert_pmap_find_post(bimap->cod_buckets, bimap->sizemask,
-				pre_cand->entry.post, cl_hash32(pre_cand->entry.post));
-		assert (post->state == CL_ParamMap_BUCKET_OCCUPIED);
-		pre_cand->state = CL_ParamMap_BUCKET_DELETED;
-		post->state = CL_ParamMap_BUCKET_DELETED;
-		--bimap->count;
-	}
-	struct ParamMapBucket * post_cand = hilbert_pmap_find_post(bimap->cod_buckets, bimap->sizemask, post, post_hash);
-	if (post_cand->state == CL_ParamMap_BUCKET_OCCUPIED) {
-		struct ParamMapBucket * pre = hilbert_pmap_find_pre(bimap->dom_buckets, bimap->sizemask,
-				post_cand->entry.pre, cl_hash32(post_cand->entry.pre));
-		assert (pre->state == CL_ParamMap_BUCKET_OCCUPIED);
-		post_cand->state = CL_ParamMap_BUCKET_DELETED;
-		pre->state = CL_ParamMap_BUCKET_DELETED;
-		--bimap->count;
-	}
-
-	/* add entry */
-	assert (bimap->count < SIZE_MAX);
-	size_t newcount = bimap->count + 1;
-	if (newcount > bimap->threshold) { /* this can only happen if we didn't delete anything above */
-		/* rebuild tables */
-		size_t oldalloc = (bimap->sizemask + 1) * sizeof(*bimap->dom_buckets);
-		size_t newalloc = 2 * oldalloc;
-		if (newalloc <= oldalloc)
-			return -1;
-		size_t newsize = newalloc / sizeof(*bimap->dom_buckets);
-		size_t newsizemask = newsize - 1;
-		size_t newthreshold = (CL_ParamMap_MAXLOAD - 1) * newsize / CL_ParamMap_MAXLOAD;
-		struct ParamMapBucket * newdombuckets = calloc(1, newalloc);
-		struct ParamMapBucket * newcodbuckets = calloc(1, newalloc);
-		if ((newdombuckets == NULL) || (newcodbuckets == NULL)) {
-			free(newdombuckets);
-			free(newcodbuckets);
+static inline int hilbert_pmap_add(ParamMap * map, HilbertHandle pre, HilbertHandle post) {
+	assert (map != NULL);
+	assert (pre != CL_PMAP_NONE);
+	assert (post != CL_PMAP_NONE);
+
+	if (hilbert_pmap_run_fits(&map->dom, pre, map->count) && hilbert_pmap_run_fits(&map->cod, post, map->count)) {
+		/* growing leaves the entries unchanged, so nothing needs to be undone on error */
+		if ((hilbert_pmap_run_grow(&map->dom, pre) != 0) || (hilbert_pmap_run_grow(&map->cod, post) != 0))
 			return -1;
+		hilbert_pmap_run_remove(map, pre, 1);
+		hilbert_pmap_run_remove(map, post, 0);
+		if (map->sparse != NULL) {
+			hilbert_phmap_remove(map->sparse, pre);
+			const HilbertHandle * sparsepre = hilbert_phmap_pre(map->sparse, post);
+			if (sparsepre != NULL)
+				hilbert_phmap_remove(map->sparse, *sparsepre);
 		}
-		for (size_t i = 0; i <= bimap->sizemask; ++i) {
-			if (bimap->dom_buckets[i].state == CL_ParamMap_BUCKET_OCCUPIED) {
-				hilbert_pmap_store(newdombuckets, newsizemask, bimap->dom_buckets[i].entry,
-						cl_hash32(bimap->dom_buckets[i].entry.pre));
-			}
-			if (bimap->cod_buckets[i].state == CL_ParamMap_BUCKET_OCCUPIED) {
-				hilbert_pmap_store(newcodbuckets, newsizemask, bimap->cod_buckets[i].entry,
-						cl_hash32(bimap->cod_buckets[i].entry.post));
-			}
-		}
-		free(bimap->cod_buckets);
-		free(bimap->dom_buckets);
-		bimap->sizemask = newsizemask;
-		bimap->threshold = newthreshold;
-		bimap->dom_buckets = newdombuckets;
-		bimap->cod_buckets = newcodbuckets;
-
-		/* store mapping */
-		hilbert_pmap_store(bimap->dom_buckets, bimap->sizemask, entry, pre_hash);
-		hilbert_pmap_store(bimap->cod_buckets, bimap->sizemask, entry, post_hash);
-		bimap->count = newcount;
+		map->dom.values[pre - map->dom.offset] = post;
+		map->cod.values[post - map->cod.offset] = pre;
+		++map->count;
 		return 0;
 	}
 
-	/* store mapping */
-	pre_cand->entry = entry;
-	pre_cand->state = CL_ParamMap_BUCKET_OCCUPIED;
-	post_cand->entry = entry;
-	post_cand->state = CL_ParamMap_BUCKET_OCCUPIED;
-	bimap->count = newcount;
+	if (map->sparse == NULL) {
+		map->sparse = hilbert_phmap_new();
+		if (map->sparse == NULL)
+			return -1;
+	}
+	/* the hash bimap overwrites its own entries */
+	if (hilbert_phmap_add(map->sparse, pre, post) != 0)
+		return -1;
+	hilbert_pmap_run_remove(map, pre, 1);
+	hilbert_pmap_run_remove(map, post, 0);
+
 	return 0;
 }
 
+/**
+ * Removes the entry with a given preimage from a parameter map.
+ *
+ * @param map Pointer to a parameter map.
+ * @param pre Preimage.
+ *
+ * @return If an entry with preimage <code>pre</code> was present, <code>1</code> is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int hilbert_pmap_remove(ParamMap * map, HilbertHandle pre) {
+	assert (map != NULL);
+
+	if (hilbert_pmap_run_remove(map, pre, 1))
+		return 1;
+
+	return (map->sparse != NULL) && hilbert_phmap_remove(map->sparse, pre);
+}
+
 /**
  * Obtains the image for a given preimage.
  *
- * @param bimap Pointer to a bimap.
+ * @param map Pointer to a parameter map.
  * @param pre Preimage.
  *
- * @return If a mapping for the given preimage exists, a pointer to the associated image is returned.
- * 	The value being pointed to may not be altered (use <code>#hilbert_pmap_add()</code> for this purpose).
- * 	The returned pointer is guaranteed to be valid only until the next call to one of the bimap
- * 	functions with <code>bimap</code> as argument.
- * 	If no mapping for the given preimage exists, <code>NULL</code> is returned.
+ * @return If the map contains an entry with preimage <code>pre</code>,
+ * 	a pointer to the postimage of that entry is returned. This pointer is valid until the next call
+ * 	to a function altering <code>map</code>.
+ * 	Otherwise, <code>NULL</code> is returned.
+ */
+static inline const HilbertHandle * hilbert_pmap_post(const ParamMap * map, HilbertHandle pre) {
+	assert (map != NULL);
+
+	const HilbertHandle * result = hilbert_pmap_run_get(&map->dom, pre);
+	if ((result == NULL) && (map->sparse != NULL))
+		result = hilbert_phmap_post(map->sparse, pre);
+
+	return result;
+}
+
+/**
+ * Obtains the preimage for a given postimage.
+ *
+ * @param map Pointer to a parameter map.
+ * @param post Postimage.
+ *
+ * @return If the map contains an entry with postimage <code>post</code>,
+ * 	a pointer to the preimage of that entry is returned. This pointer is valid until the next call
+ * 	to a function altering <code>map</code>.
+ * 	Otherwise, <code>NULL</code> is returned.
  */
-static inline const HilbertHandle * hilbert_pmap_post(const ParamMap * bimap, HilbertHandle pre) {
-	assert (bimap != NULL);
+static inline const HilbertHandle * hilbert_pmap_pre(const ParamMap * map, HilbertHandle post) {
+	assert (map != NULL);
 
-	struct ParamMapBucket * candidate = hilbert_pmap_find_pre(bimap->dom_buckets, bimap->sizemask, pre, cl_hash32(pre));
-	if (candidate->state == CL_ParamMap_BUCKET_OCCUPIED)
-		return &candidate->entry.post;
+	const HilbertHandle * result = hilbert_pmap_run_get(&map->cod, post);
+	if ((result == NULL) && (map->sparse != NULL))
+		result = hilbert_phmap_pre(map->sparse, post);
 
-	return NULL;
+	return result;
 }
 
 /**
- * Obtains the preimage for a given image.
+ * Returns the number of entries of a parameter map.
  *
- * @param bimap Pointer to a bimap.
- * @param post Image.
+ * @param map Pointer to a parameter map.
  *
- * @return If a mapping for the given image exists, a pointer to the associated preimage is returned.
- * The value being pointed to may not be altered (use <code>#hilbert_pmap_add()</code> for this purpose).
- * The returned pointer is guaranteed to be valid only until the next call to one of the bimap
- * functions with <code>bimap</code> as argument.
- * If no mapping for the given image exists, <code>NULL</code> is returned.
+ * @return The number of entries in the map is returned.
  */
-static inline const HilbertHandle * hilbert_pmap_pre(const ParamMap * bimap, HilbertHandle post) {
-	assert (bimap != NULL);
+static inline size_t hilbert_pmap_count(const ParamMap * map) {
+	assert (map != NULL);
 
-	struct ParamMapBucket * candidate = hilbert_pmap_find_post(bimap->cod_buckets, bimap->sizemask, post, cl_hash32(post));
-	if (candidate->state == CL_ParamMap_BUCKET_OCCUPIED)
-		return &candidate->entry.pre;
+	return map->count + (map->sparse != NULL ? hilbert_phmap_count(map->sparse) : 0);
+}
 
-	return NULL;
+/**
+ * Returns the hash table statistics of a parameter map.
+ * Only lookups falling through to the sparse hash map are counted.
+ *
+ * @param map Pointer to a parameter map.
+ *
+ * @return The statistics gathered since the map was created.
+ */
+static inline struct CLStats hilbert_pmap_stats(const ParamMap * map) {
+	assert (map != NULL);
+
+	return map->sparse != NULL ? hilbert_phmap_stats(map->sparse) : (struct CLStats) { .probes = 0, .rehashes = 0 };
 }
 
 /**
- * Creates a new bimap iterator.
+ * Creates a new parameter map iterator.
  *
- * @param bimap Pointer to a bimap.
+ * @param map Pointer to a parameter map.
  *
- * @return An iterator for the map pointed to by <code>bimap</code> is returned.
+ * @return An iterator for the map pointed to by <code>map</code> is returned.
  */
-static inline ParamMapIterator hilbert_pmap_iterator_new(ParamMap * bimap) {
-	assert (bimap != NULL);
+static inline ParamMapIterator hilbert_pmap_iterator_new(ParamMap * map) {
+	assert (map != NULL);
+
+	ParamMapIterator result = { .map = map, .index = 0 };
+	if (map->sparse != NULL)
+		result.sparse = hilbert_phmap_iterator_new(map->sparse);
 
-	return (ParamMapIterator) { .bimap = bimap, .index = 0 };
+	return result;
 }
 
 /**
  * Checks whether an iterator has a next element.
  *
- * @return i Pointer to bimap iterator.
+ * @param i Pointer to parameter map iterator.
  *
  * @return If there is a next element in the iteration, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
@@ -476,30 +441,36 @@ static inline ParamMapIterator hilbert_pmap_iterator_new(ParamMap * bimap) {
 static inline int hilbert_pmap_iterator_hasnext(ParamMapIterator * i) {
 	assert (i != NULL);
 
-	for (; i->index <= i->bimap->sizemask; ++i->index) {
-		if (i->bimap->dom_buckets[i->index].state == CL_ParamMap_BUCKET_OCCUPIED)
+	for (; i->index < i->map->dom.size; ++i->index) {
+		if (i->map->dom.values[i->index] != CL_PMAP_NONE)
 			return 1;
 	}
 
-	return 0;
+	return (i->map->sparse != NULL) && hilbert_phmap_iterator_hasnext(&i->sparse);
 }
 
 /**
- * Returns the next mapping in an iteration.
+ * Returns the next entry in an iteration.
  *
- * @param i Pointer to bimap iterator.
+ * @param i Pointer to parameter map iterator.
  *
- * @return the next mapping in the iteration is returned.
- * 	If there is no next mapping, the behaviour is undefined.
+ * @return The next entry in the iteration is returned.
+ * 	If there is no next entry, the behaviour is undefined.
  */
 static inline struct ParamMapEntry hilbert_pmap_iterator_next(ParamMapIterator * i) {
 	assert (i != NULL);
 
-	for (;; ++i->index) {
-		assert (i->index <= i->bimap->sizemask);
-		if (i->bimap->dom_buckets[i->index].state == CL_ParamMap_BUCKET_OCCUPIED)
-			return i->bimap->dom_buckets[i->index++].entry;
+	int rc = hilbert_pmap_iterator_hasnext(i);
+	assert (rc);
+	(void) rc;
+	if (i->index < i->map->dom.size) {
+		struct ParamMapEntry result = { .pre = i->map->dom.offset + i->index, .post = i->map->dom.values[i->index] };
+		++i->index;
+		return result;
 	}
+	struct ParamHashMapEntry entry = hilbert_phmap_iterator_next(&i->sparse);
+
+	return (struct ParamMapEntry) { .pre = entry.pre, .post = entry.post };
 }
 
 #endif
@@ -21,64 +21,61 @@
  */
 
 /**
- * Replacements from set template:
- * - <code>SET</code>:
+ * Set container template.
+ * A container type is instantiated by defining the following parameters and including this file.
+ * The parameters are undefined again at the end of this file.
+ * - <code>CL_SET_TYPE</code>:
  *   Set typename.
- * - <code>VALUE_TYPE</code>:
+ * - <code>CL_SET_VALUE</code>:
  *   Type of the values stored.
- * - <code>SITER</code>:
- *   Set iterator type.
- * - <code>PREFIX</code>:
+ * - <code>CL_SET_ITERATOR</code>:
+ *   Set iterator typename.
+ * - <code>CL_SET_PREFIX</code>:
  *   Function name prefix.
- * - <code>HASH</code>:
- *   Name of hash function to be used.
+ * - <code>CL_SET_HASH</code>:
+ *   Hash function for values.
+ * - <code>CL_SET_EQUAL</code> (optional):
+ *   Equality of values. Defaults to <code>==</code>.
  */
 
-#ifndef HILBERT_CL_SET_H__
-#define HILBERT_CL_SET_H__
+#ifndef HILBERT_CL_SET_TEMPLATE_H__
+#define HILBERT_CL_SET_TEMPLATE_H__
 
 #include<assert.h>
 #include<stdint.h>
 #include<stdlib.h>
 #include<string.h>
 
+#include"group.h"
 #include"hash.h"
+#include"stats.h"
+#include"template.h"
 
 /**
- * Initial number of buckets
+ * Initial number of slots.
  */
-#define CL_SET_NUMBUCKETS 4
+#define CL_SET_NUMBUCKETS CL_GROUP_WIDTH
 
-/**
- * Maximum load coefficient.
- */
-#define CL_SET_MAXLOAD 4
+#endif
 
-/**
- * Bucket states.
- */
-enum CLSETBucketState {
-	CL_SET_BUCKET_EMPTY = 0,
-	CL_SET_BUCKET_OCCUPIED,
-	CL_SET_BUCKET_DELETED
-};
+#ifndef CL_SET_EQUAL
+#define CL_SET_EQUAL(a, b) ((a) == (b))
+#endif
 
-/**
- * Bucket type.
- */
-struct SETBucket {
-	/**
-	 * Bucket value.
-	 */
-	VALUE_TYPE value;
-	/**
-	 * Bucket state.
-	 */
-	enum CLSETBucketState state;
-};
+/* short names used within this file */
+#define SET CL_SET_TYPE
+#define VALUE_TYPE CL_SET_VALUE
+#define SITER CL_SET_ITERATOR
+#define PREFIX(name) CL_CAT(CL_SET_PREFIX, _ ## name)
+#define HASH CL_SET_HASH
+#define EQUAL CL_SET_EQUAL
 
 /**
  * Set structure.
+ *
+ * The set is an open addressing hash table with separate control bytes (see <code>group.h</code>).
+ * Slots are probed group by group, visiting the groups in triangular order.
+ * At most seven eighths of the slots are ever filled, so that every probe sequence ends in a group with an empty slot.
  */
 struct SET {
 	/**
@@ -87,19 +84,30 @@ struct SET {
 	size_t count;
 
 	/**
-	 * Load threshold.
+	 * Number of empty slots which may still be filled before the table is rebuilt.
 	 */
-	size_t threshold;
+	size_t growth;
 
 	/**
-	 * Total number of buckets, minus one
+	 * Total number of slots, minus one.
+	 * The number of slots is a power of two and a multiple of <code>#CL_GROUP_WIDTH</code>.
 	 */
 	size_t sizemask;
 
 	/**
-	 * Buckets
+	 * Control bytes, one per slot.
+	 */
+	unsigned char * ctrl;
+
+	/**
+	 * Slot values. Only slots with a control byte of an occupied slot hold a value.
+	 */
+	VALUE_TYPE * slots;
+
+	/**
+	 * Lookup statistics, counting probed groups.
 	 */
-	struct SETBucket * buckets;
+	CL_STATS_DECL(stats)
 };
 
 typedef struct SET SET;
@@ -120,24 +128,69 @@ struct SITER {
 
 typedef struct SITER SITER;
 
+/**
+ * Returns the maximum number of filled slots of a table (private).
+ *
+ * @param size Number of slots.
+ *
+ * @return The number of slots which may be occupied or deleted before the table must be rebuilt is returned.
+ */
+static inline size_t PREFIX(maxload)(size_t size) {
+	return size - size / 8;
+}
+
+/**
+ * Allocates the control bytes and slots of a set (private).
+ * All slots are initially empty.
+ *
+ * @param set Pointer to a set whose control bytes and slots are to be replaced.
+ * 	The old control bytes and slots are not freed.
+ * @param size Number of slots. Must be a power of two and a multiple of <code>#CL_GROUP_WIDTH</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the set remains unchanged.
+ */
+static inline int PREFIX(alloc)(SET * set, size_t size) {
+	assert (set != NULL);
+	assert (size % CL_GROUP_WIDTH == 0);
+	assert ((size & (size - 1)) == 0);
+
+	if (size > SIZE_MAX / sizeof(*set->slots))
+		return -1;
+	unsigned char * ctrl = malloc(size);
+	if (ctrl == NULL)
+		return -1;
+	VALUE_TYPE * slots = malloc(size * sizeof(*slots));
+	if (slots == NULL) {
+		free(ctrl);
+		return -1;
+	}
+	memset(ctrl, CL_GROUP_EMPTY, size);
+
+	set->ctrl = ctrl;
+	set->slots = slots;
+	set->sizemask = size - 1;
+	set->growth = PREFIX(maxload)(size);
+
+	return 0;
+}
+
 /**
  * Creates a new, empty set.
  *
  * @return On success, a pointer to a new empty set is returned.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline SET * PREFIX_new(void) {
+static inline SET * PREFIX(new)(void) {
 	SET * result;
 
 	result = malloc(sizeof(*result));
 	if (result == NULL)
 		goto nosetmem;
 	result->count = 0;
-	result->threshold = (CL_SET_MAXLOAD - 1) * CL_SET_NUMBUCKETS / CL_SET_MAXLOAD;
-	result->sizemask = CL_SET_NUMBUCKETS - 1;
+	cl_stats_init(result->stats);
 
-	result->buckets = calloc(CL_SET_NUMBUCKETS, sizeof(*result->buckets));
-	if (result->buckets == NULL)
+	if (PREFIX(alloc)(result, CL_SET_NUMBUCKETS) != 0)
 		goto nobucketmem;
 
 	return result;
@@ -153,10 +206,11 @@ nosetmem:
  *
  * @param set Pointer to a set.
  */
-static inline void PREFIX_del(SET * set) {
+static inline void PREFIX(del)(SET * set) {
 	assert (set != NULL);
 
-	free(set->buckets);
+	free(set->slots);
+	free(set->ctrl);
 	free(set);
 }
 
@@ -168,7 +222,7 @@ static inline void PREFIX_del(SET * set) {
  * @return On success, a pointer to a new set is returned, containing precisely the elements of the old set.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline SET * PREFIX_clone(const SET * set) {
+static inline SET * PREFIX(clone)(const SET * set) {
 	assert (set != NULL);
 
 	SET * clone;
@@ -176,90 +230,137 @@ static inline SET * PREFIX_clone(const SET * set) {
 	if (clone == NULL)
 		return NULL;
 
-	clone->count = set->count;
-	clone->threshold = set->threshold;
-	clone->sizemask = set->sizemask;
-
-	size_t bucketalloc = (clone->sizemask + 1) * sizeof(*clone->buckets);
-	clone->buckets = malloc(bucketalloc);
-	if (clone->buckets == NULL) {
+	size_t size = set->sizemask + 1;
+	if (PREFIX(alloc)(clone, size) != 0) {
 		free(clone);
 		return NULL;
 	}
-	memcpy(clone->buckets, set->buckets, bucketalloc);
+	memcpy(clone->ctrl, set->ctrl, size);
+	memcpy(clone->slots, set->slots, size * sizeof(*clone->slots));
+	clone->count = set->count;
+	clone->growth = set->growth;
+	cl_stats_init(clone->stats);
 
 	return clone;
 }
 
 /**
- * Stores a value in the correct bucket (private).
+ * Finds the slot holding a value (private).
  *
- * @param buckets Pointer to an array of buckets. At least one bucket in the array must be unoccupied.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * @param value Value to be stored. The value must not be present in any of the buckets.
+ * @param set Pointer to a set.
+ * @param value Value to be searched for.
  * @param hash Hash code of <code>value</code>.
+ *
+ * @return If <code>value</code> is present in the set, the index of its slot is returned.
+ * 	Otherwise, <code>SIZE_MAX</code> is returned.
  */
-static inline void PREFIX_store(struct SETBucket * buckets, size_t sizemask, VALUE_TYPE value, size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	for (size_t i = hash & sizemask; 1; i = (i + 1) & sizemask) {
-		if (buckets[i].state != CL_SET_BUCKET_OCCUPIED) {
-			buckets[i].value = value;
-			buckets[i].state = CL_SET_BUCKET_OCCUPIED;
-			break;
+static inline size_t PREFIX(find)(const SET * set, VALUE_TYPE value, size_t hash) {
+	assert (set != NULL);
+
+	unsigned char tag = cl_group_tag(hash);
+	size_t groupmask = set->sizemask / CL_GROUP_WIDTH;
+	size_t group = (hash >> 7) & groupmask;
+	for (size_t step = 1; 1; group = (group + step++) & groupmask) {
+		const unsigned char * ctrl = set->ctrl + group * CL_GROUP_WIDTH;
+		for (unsigned int match = cl_group_match(ctrl, tag); match != 0; match &= match - 1) {
+			size_t index = group * CL_GROUP_WIDTH + cl_group_first(match);
+			if (EQUAL(set->slots[index], value)) {
+				cl_stats_probe(set->stats, step);
+				return index;
+			}
+		}
+		if (cl_group_match(ctrl, CL_GROUP_EMPTY) != 0) {
+			cl_stats_probe(set->stats, step);
+			return SIZE_MAX;
 		}
+		assert (step <= groupmask + 1);
 	}
 }
 
 /**
- * Finds a candidate bucket (private).
+ * Finds a free slot for a value (private).
  *
- * @param buckets Pointer to an array of buckets.
- * @param sizemask Size of the array pointed to by <code>buckets</code>, minus one.
- * 	The array size must be a power of two.
- * @param value Value to be searched for/to be stored in the candidate bucket.
- * @param hash Hash code of <code>value</code>.
+ * @param ctrl Pointer to the control bytes of a table.
+ * @param sizemask Number of slots of the table, minus one.
+ * @param hash Hash code of the value.
  *
- * @return A pointer to an element in the <code>buckets</code> array is returned.
- * 	If the element is occupied, it contains <code>value</code>.
- * 	Otherwise, the element is suitable for storing <code>value</code>.
+ * @return The index of the first free slot in the probe sequence of <code>hash</code> is returned.
  */
-static inline struct SETBucket * PREFIX_find(struct SETBucket * buckets, size_t sizemask, VALUE_TYPE value, size_t hash) {
-	assert (buckets != NULL);
-	assert (sizemask > 0);
-	assert (sizemask < SIZE_MAX);
-	assert ((sizemask & (sizemask + 1)) == 0);
-
-	int deletedfound = 0;
-	struct SETBucket * firstdeleted;
-	size_t count = 0;
-	for (size_t i = hash & sizemask; count <= sizemask; i = (i + 1) & sizemask, ++count) {
-		switch (buckets[i].state) {
-			case CL_SET_BUCKET_EMPTY:
-				if (deletedfound) {
-					return firstdeleted;
-				} else {
-					return &buckets[i];
-				}
-				break;
-			case CL_SET_BUCKET_OCCUPIED:
-				if (buckets[i].value == value)
-					return &buckets[i];
-				break;
-			case CL_SET_BUCKET_DELETED:
-				if (!deletedfound) {
-					deletedfound = 1;
-					firstdeleted = &buckets[i];
-				}
-				break;
-		}
+static inline size_t PREFIX(findfree)(const unsigned char * ctrl, size_t sizemask, size_t hash) {
+	assert (ctrl != NULL);
+
+	size_t groupmask = sizemask / CL_GROUP_WIDTH;
+	size_t group = (hash >> 7) & groupmask;
+	for (size_t step = 1; 1; group = (group + step++) & groupmask) {
+		unsigned int match = cl_group_match_free(ctrl + group * CL_GROUP_WIDTH);
+		if (match != 0)
+			return group * CL_GROUP_WIDTH + cl_group_first(match);
+		assert (step <= groupmask + 1);
 	}
+}
 
-	assert (deletedfound);
-	return firstdeleted;
+/**
+ * Rebuilds a set with a new number of slots, dropping deleted slots (private).
+ *
+ * @param set Pointer to a set.
+ * @param size New number of slots. Must be a power of two and a multiple of <code>#CL_GROUP_WIDTH</code>,
+ * 	and large enough to hold the elements of the set.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the set remains unchanged.
+ */
+static inline int PREFIX(rebuild)(SET * set, size_t size) {
+	assert (set != NULL);
+	assert (set->count <= PREFIX(maxload)(size));
+
+	SET old = *set;
+	if (PREFIX(alloc)(set, size) != 0)
+		return -1;
+	for (size_t i = 0; i <= old.sizemask; ++i) {
+		if (old.ctrl[i] & CL_GROUP_EMPTY)
+			continue;
+		size_t hash = HASH(old.slots[i]);
+		size_t index = PREFIX(findfree)(set->ctrl, set->sizemask, hash);
+		set->ctrl[index] = cl_group_tag(hash);
+		set->slots[index] = old.slots[i];
+	}
+	set->growth -= set->count;
+	free(old.slots);
+	free(old.ctrl);
+	cl_stats_rehash(set->stats);
+
+	return 0;
+}
+
+/**
+ * Ensures that a number of elements can be added to a set without rebuilding it.
+ *
+ * @param set Pointer to a set.
+ * @param count Number of elements to be added.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the set remains unchanged.
+ */
+static inline int PREFIX(reserve)(SET * set, size_t count) {
+	assert (set != NULL);
+
+	if (count <= set->growth)
+		return 0;
+	if (count > SIZE_MAX - set->count)
+		return -1;
+	size_t needed = set->count + count;
+
+	/* drop deleted slots if that makes enough room, otherwise grow */
+	size_t size = set->sizemask + 1;
+	while (PREFIX(maxload)(size) < needed) {
+		if (size > SIZE_MAX / 2)
+			return -1;
+		size *= 2;
+	}
+	if ((size == set->sizemask + 1) && (needed > PREFIX(maxload)(size) / 2) && (size <= SIZE_MAX / 2))
+		size *= 2;
+
+	return PREFIX(rebuild)(set, size);
 }
 
 /**
@@ -271,48 +372,30 @@ static inline struct SETBucket * PREFIX_find(struct SETBucket * buckets, size_t
  * @return On success, <code>0</code> is returned.
  * 	On error, <code>-1</code> is returned.
  */
-static inline int PREFIX_add(SET * set, VALUE_TYPE value) {
+static inline int PREFIX(add)(SET * set, VALUE_TYPE value) {
 	assert (set != NULL);
 
 	size_t hash = HASH(value);
-	struct SETBucket * candidate = PREFIX_find(set->buckets, set->sizemask, value, hash);
-	if (candidate->state == CL_SET_BUCKET_OCCUPIED) /* already in set */
+	if (PREFIX(find)(set, value, hash) != SIZE_MAX) /* already in set */
 		return 0;
 
 	assert (set->count < SIZE_MAX);
 
-	size_t newcount = set->count + 1;
-	if (newcount > set->threshold) {
-		/* rebuild table */
-		size_t oldalloc = (set->sizemask + 1) * sizeof(*set->buckets);
-		size_t newalloc = 2 * oldalloc;
-		if (newalloc <= oldalloc)
-			return -1;
-		size_t newsize = newalloc / sizeof(*set->buckets);
-		size_t newsizemask = newsize - 1;
-		size_t newthreshold = (CL_SET_MAXLOAD - 1) * newsize / CL_SET_MAXLOAD;
-		struct SETBucket * newbuckets = calloc(1, newalloc);
-		if (newbuckets == NULL)
-			return -1;
-		for (size_t i = 0; i <= set->sizemask; ++i) {
-			if (set->buckets[i].state == CL_SET_BUCKET_OCCUPIED)
-				PREFIX_store(newbuckets, newsizemask, set->buckets[i].value, HASH(set->buckets[i].value));
+	size_t index = PREFIX(findfree)(set->ctrl, set->sizemask, hash);
+	if (set->ctrl[index] == CL_GROUP_EMPTY) {
+		if (set->growth == 0) {
+			if (PREFIX(reserve)(set, 1) != 0)
+				return -1;
+			index = PREFIX(findfree)(set->ctrl, set->sizemask, hash);
 		}
-		free (set->buckets);
-		set->sizemask = newsizemask;
-		set->threshold = newthreshold;
-		set->buckets = newbuckets;
-
-		/* store value */
-		PREFIX_store(set->buckets, set->sizemask, value, hash);
-		set->count = newcount;
-		return 0;
+		if (set->ctrl[index] == CL_GROUP_EMPTY)
+			--set->growth;
 	}
 
 	/* store value */
-	candidate->value = value;
-	candidate->state = CL_SET_BUCKET_OCCUPIED;
-	set->count = newcount;
+	set->ctrl[index] = cl_group_tag(hash);
+	set->slots[index] = value;
+	++set->count;
 	return 0;
 }
 
@@ -323,44 +406,30 @@ static inline int PREFIX_add(SET * set, VALUE_TYPE value) {
  * @param src Pointer to source set. Must be distinct from destrination set.
  *
  * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned.
+ * 	On error, <code>-1</code> is returned and the destination set remains unchanged.
  */
-static inline int PREFIX_addall(SET * restrict dest, const SET * restrict src) {
+static inline int PREFIX(addall)(SET * restrict dest, const SET * restrict src) {
 	assert (dest != NULL);
 	assert (src != NULL);
 
-	int rc = -1;
-
-	/* first, create a backup set in case something goes wrong */
-	SET backup = *dest;
-	size_t allocsize = (backup.sizemask + 1) * sizeof(*backup.buckets);
-	backup.buckets = malloc(allocsize);
-	if (backup.buckets == NULL)
-		goto backupallocfail;
-	memcpy(backup.buckets, dest->buckets, allocsize);
-
-	/* Now add new elements */
+	/* after reserving, adding cannot fail */
+	if (PREFIX(reserve)(dest, src->count) != 0)
+		return -1;
 	for (size_t i = 0; i <= src->sizemask; ++i) {
-		if (src->buckets[i].state == CL_SET_BUCKET_OCCUPIED) {
-			if (PREFIX_add(dest, src->buckets[i].value) != 0) {
-				/* restore backup and bailout */
-				free(dest->buckets);
-				*dest = backup;
-				goto addfail;
-			}
+		if (!(src->ctrl[i] & CL_GROUP_EMPTY)) {
+			int rc = PREFIX(add)(dest, src->slots[i]);
+			assert (rc == 0);
+			(void) rc;
 		}
 	}
 
-	free(backup.buckets);
-	rc = 0;
-
-addfail:
-backupallocfail:
-	return rc;
+	return 0;
 }
 
 /**
  * Removes an element from a set.
+ * If the load of the set becomes low, its slot arrays are shrunk.
+ * Iterators over the set become invalid.
  *
  * @param set Pointer to a set.
  * @param value Value to be removed.
@@ -368,17 +437,29 @@ backupallocfail:
  * @return If <code>value</code> was present in the set pointed to by <code>set</code>, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_remove(SET * set, VALUE_TYPE value) {
+static inline int PREFIX(remove)(SET * set, VALUE_TYPE value) {
 	assert (set != NULL);
 
-	struct SETBucket * candidate = PREFIX_find(set->buckets, set->sizemask, value, HASH(value));
-	if (candidate->state != CL_SET_BUCKET_OCCUPIED)
+	size_t index = PREFIX(find)(set, value, HASH(value));
+	if (index == SIZE_MAX)
 		return 0;
 
-	candidate->state = CL_SET_BUCKET_DELETED;
+	/* Probes never continue past a group with an empty slot,
+	 * so in such a group the slot can be emptied instead of being marked as deleted. */
+	if (cl_group_match(set->ctrl + (index & ~(size_t) (CL_GROUP_WIDTH - 1)), CL_GROUP_EMPTY) != 0) {
+		set->ctrl[index] = CL_GROUP_EMPTY;
+		++set->growth;
+	} else {
+		set->ctrl[index] = CL_GROUP_DELETED;
+	}
 	assert (set->count > 0);
 	--set->count;
 
+	/* Shrink on low load. Rebuilding also purges deleted slots. Failure to shrink is harmless. */
+	size_t size = set->sizemask + 1;
+	if ((size > CL_SET_NUMBUCKETS) && (set->count < PREFIX(maxload)(size) / 4))
+		PREFIX(rebuild)(set, size / 2);
+
 	return 1;
 }
 
@@ -387,11 +468,12 @@ static inline int PREFIX_remove(SET * set, VALUE_TYPE value) {
  *
  * @param set Pointer to a set.
  */
-static inline void PREFIX_clear(SET * set) {
+static inline void PREFIX(clear)(SET * set) {
 	assert (set != NULL);
 
 	set->count = 0;
-	memset(set->buckets, 0, (set->sizemask + 1) * sizeof(*set->buckets));
+	set->growth = PREFIX(maxload)(set->sizemask + 1);
+	memset(set->ctrl, CL_GROUP_EMPTY, set->sizemask + 1);
 }
 
 /**
@@ -403,10 +485,34 @@ static inline void PREFIX_clear(SET * set) {
  * @return If <code>value</code> is present in the set pointed to by <code>set</code>, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_contains(const SET * set, VALUE_TYPE value) {
+static inline int PREFIX(contains)(const SET * set, VALUE_TYPE value) {
 	assert (set != NULL);
 
-	return (PREFIX_find(set->buckets, set->sizemask, value, HASH(value))->state == CL_SET_BUCKET_OCCUPIED);
+	return PREFIX(find)(set, value, HASH(value)) != SIZE_MAX;
+}
+
+/**
+ * Obtains the element of a set equal to a value.
+ * This is useful if <code>CL_SET_EQUAL</code> is coarser than identity.
+ *
+ * @param set Pointer to a set.
+ * @param value Value to be looked for.
+ * @param element Pointer to a location to which the element equal to <code>value</code> is written, if any.
+ *
+ * @return If an element equal to <code>value</code> is present in the set pointed to by <code>set</code>,
+ * 	<code>1</code> is returned and the element is stored in <code>*element</code>.
+ * 	Otherwise, <code>0</code> is returned and <code>*element</code> remains unchanged.
+ */
+static inline int PREFIX(get)(const SET * set, VALUE_TYPE value, VALUE_TYPE * element) {
+	assert (set != NULL);
+	assert (element != NULL);
+
+	size_t index = PREFIX(find)(set, value, HASH(value));
+	if (index == SIZE_MAX)
+		return 0;
+	*element = set->slots[index];
+
+	return 1;
 }
 
 /**
@@ -416,12 +522,26 @@ static inline int PREFIX_contains(const SET * set, VALUE_TYPE value) {
  *
  * @return The number of elements in the set is returned.
  */
-static inline size_t PREFIX_count(const SET * set) {
+static inline size_t PREFIX(count)(const SET * set) {
 	assert (set != NULL);
 
 	return set->count;
 }
 
+/**
+ * Returns the lookup statistics of a set.
+ *
+ * @param set Pointer to a set.
+ *
+ * @return The statistics gathered since the set was created.
+ */
+static inline struct CLStats PREFIX(stats)(const SET * set) {
+	assert (set != NULL);
+	(void) set;
+
+	return cl_stats_get(set->stats);
+}
+
 /**
  * Creates a new iterator for a set.
  *
@@ -429,7 +549,7 @@ static inline size_t PREFIX_count(const SET * set) {
  *
  * @return An iterator for the set pointed to by <code>set</code> is returned.
  */
-static inline SITER PREFIX_iterator_new(SET * set) {
+static inline SITER PREFIX(iterator_new)(SET * set) {
 	assert (set != NULL);
 
 	return (SITER) { .set = set, .index = 0 };
@@ -443,11 +563,11 @@ static inline SITER PREFIX_iterator_new(SET * set) {
  * @return If there is a next element in the iteration, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_iterator_hasnext(SITER * i) {
+static inline int PREFIX(iterator_hasnext)(SITER * i) {
 	assert (i != NULL);
 
 	for(; i->index <= i->set->sizemask; ++i->index) {
-		if (i->set->buckets[i->index].state == CL_SET_BUCKET_OCCUPIED)
+		if (!(i->set->ctrl[i->index] & CL_GROUP_EMPTY))
 			return 1;
 	}
 
@@ -462,14 +582,25 @@ static inline int PREFIX_iterator_hasnext(SITER * i) {
  * @return The next element in the iteration is returned.
  * 	If there is no next element in the iteration, the behaviour is undefined.
  */
-static inline VALUE_TYPE PREFIX_iterator_next(SITER * i) {
+static inline VALUE_TYPE PREFIX(iterator_next)(SITER * i) {
 	assert (i != NULL);
 
 	for (;; ++i->index) {
 		assert (i->index <= i->set->sizemask);
-		if (i->set->buckets[i->index].state == CL_SET_BUCKET_OCCUPIED)
-			return i->set->buckets[i->index++].value;
+		if (!(i->set->ctrl[i->index] & CL_GROUP_EMPTY))
+			return i->set->slots[i->index++];
 	}
 }
 
-#endif
+#undef SET
+#undef VALUE_TYPE
+#undef SITER
+#undef PREFIX
+#undef HASH
+#undef EQUAL
+#undef CL_SET_TYPE
+#undef CL_SET_VALUE
+#undef CL_SET_ITERATOR
+#undef CL_SET_PREFIX
+#undef CL_SET_HASH
+#undef CL_SET_EQUAL
@@ -0,0 +1,107 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_STATS_H__
+#define HILBERT_CL_STATS_H__
+
+#include<stddef.h>
+
+#include"../threads/hthreads.h"
+
+/**
+ * Hash table statistics.
+ *
+ * Hash table containers gather these only if the library is built with <code>HILBERT_STATS</code> defined.
+ * Otherwise, the macros below compile to nothing and the statistics read as zero.
+ * Lookups may run concurrently under a read lock, so the counters are updated atomically.
+ */
+struct CLStats {
+	/**
+	 * Number of slots (or slot groups) inspected by lookups.
+	 */
+	size_t probes;
+
+	/**
+	 * Number of times the table was rebuilt.
+	 */
+	size_t rehashes;
+};
+
+#ifdef HILBERT_STATS
+
+/**
+ * Declares a statistics member of a container structure, including the terminating semicolon.
+ */
+#define CL_STATS_DECL(x) struct CLStats x;
+
+/**
+ * Resets statistics.
+ */
+#define cl_stats_init(stats) ((void) ((stats) = (struct CLStats) { .probes = 0, .rehashes = 0 }))
+
+/**
+ * Records <code>n</code> probes.
+ * The statistics may be part of a constant container.
+ */
+#define cl_stats_probe(stats, n) \
+	((void) atomic_fetch_add_explicit((size_t *) &(stats).probes, (n), memory_order_relaxed))
+
+/**
+ * Records a rebuild.
+ */
+#define cl_stats_rehash(stats) ((void) atomic_fetch_add_explicit(&(stats).rehashes, 1, memory_order_relaxed))
+
+/**
+ * Returns a snapshot of statistics.
+ */
+#define cl_stats_get(stats) ((struct CLStats) { \
+	.probes = atomic_load_explicit(&(stats).probes, memory_order_relaxed), \
+	.rehashes = atomic_load_explicit(&(stats).rehashes, memory_order_relaxed) \
+})
+
+#else /* HILBERT_STATS is not defined */
+
+#define CL_STATS_DECL(x)
+
+#define cl_stats_init(stats) ((void) 0)
+
+#define cl_stats_probe(stats, n) ((void) 0)
+
+#define cl_stats_rehash(stats) ((void) 0)
+
+#define cl_stats_get(stats) ((struct CLStats) { .probes = 0, .rehashes = 0 })
+
+#endif /* HILBERT_STATS */
+
+/**
+ * Adds statistics.
+ *
+ * @param a First summand.
+ * @param b Second summand.
+ *
+ * @return The sum of <code>a</code> and <code>b</code>.
+ */
+static inline struct CLStats cl_stats_sum(struct CLStats a, struct CLStats b) {
+	return (struct CLStats) { .probes = a.probes + b.probes, .rehashes = a.rehashes + b.rehashes };
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_TEMPLATE_H__
+#define HILBERT_CL_TEMPLATE_H__
+
+/**
+ * Support for the container templates.
+ *
+ * A container template is instantiated by defining its parameters as macros and then including the template.
+ * Since instantiation is done by the compiler, each instance is ordinary, fully typed code,
+ * and parameters such as hash and equality functions may be macros which are expanded inline.
+ * The template undefines its parameters at the end, so that it can be instantiated repeatedly.
+ */
+
+/**
+ * Pastes two tokens after macro expansion.
+ *
+ * @param a First token.
+ * @param b Second token.
+ */
+#define CL_CAT(a, b) CL_CAT_(a, b)
+
+/**
+ * Pastes two tokens (private).
+ *
+ * @param a First token.
+ * @param b Second token.
+ */
+#define CL_CAT_(a, b) a ## b
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_TSTORE_H__
+#define HILBERT_CL_TSTORE_H__
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include"../hilbert.h"
+#include"arena.h"
+#include"hash.h"
+
+/**
+ * Term node.
+ *
+ * A term is a functor applied to argument terms, or a variable.
+ * Nodes are hash-consed, so that structurally equal terms share one node, and hence one id.
+ */
+struct Term {
+	/**
+	 * Hash code of <code>head</code> and <code>args</code>.
+	 */
+	size_t hash;
+
+	/**
+	 * Term id.
+	 */
+	HilbertHandle id;
+
+	/**
+	 * Functor or variable handle.
+	 */
+	HilbertHandle head;
+
+	/**
+	 * Number of arguments. Zero for variables.
+	 */
+	size_t argc;
+
+	/**
+	 * Argument term ids.
+	 */
+	HilbertHandle args[];
+};
+
+/**
+ * Checks two term nodes for structural equality (private).
+ *
+ * @param a Pointer to a term node.
+ * @param b Pointer to a term node.
+ *
+ * @return If both nodes have the same head and arguments, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int cl_term_equal(const struct Term * a, const struct Term * b) {
+	return (a->hash == b->hash) && (a->head == b->head) && (a->argc == b->argc)
+			&& (memcmp(a->args, b->args, a->argc * sizeof(*a->args)) == 0);
+}
+
+/**
+ * Vector of term nodes, indexed by term id.
+ */
+#define CL_VECTOR_TYPE TermVector
+#define CL_VECTOR_VALUE const struct Term *
+#define CL_VECTOR_ITERATOR TermVectorIterator
+#define CL_VECTOR_PREFIX cl_tvector
+#include"vector.template.h"
+
+/**
+ * Hash set of term nodes, comparing nodes structurally.
+ */
+#define CL_SET_TYPE TermSet
+#define CL_SET_VALUE const struct Term *
+#define CL_SET_ITERATOR TermSetIterator
+#define CL_SET_PREFIX cl_tset
+#define CL_SET_HASH(term) ((term)->hash)
+#define CL_SET_EQUAL cl_term_equal
+#include"set.template.h"
+
+/**
+ * Term store.
+ *
+ * Holds the hash-consed term nodes of a module.
+ * The nodes themselves are allocated from an arena supplied by the caller,
+ * so that they stay in place until the arena is deleted.
+ */
+struct TermStore {
+	/**
+	 * Term nodes by id.
+	 */
+	TermVector * terms;
+
+	/**
+	 * Index of the term nodes by structure.
+	 */
+	TermSet * index;
+};
+
+typedef struct TermStore TermStore;
+
+/**
+ * Creates a new, empty term store.
+ *
+ * @return On success, a pointer to a new, empty term store is returned.
+ * 	On error, <code>NULL</code> is returned.
+ */
+static inline TermStore * cl_tstore_new(void) {
+	TermStore * result = malloc(sizeof(*result));
+	if (result == NULL)
+		goto nomem;
+
+	result->terms = cl_tvector_new();
+	if (result->terms == NULL)
+		goto novectormem;
+	result->index = cl_tset_new();
+	if (result->index == NULL)
+		goto nosetmem;
+
+	return result;
+
+nosetmem:
+	cl_tvector_del(result->terms);
+novectormem:
+	free(result);
+nomem:
+	return NULL;
+}
+
+/**
+ * Deletes a term store.
+ * The term nodes are released together with their arena.
+ *
+ * @param store Pointer to the term store to be deleted.
+ */
+static inline void cl_tstore_del(TermStore * store) {
+	assert (store != NULL);
+
+	cl_tset_del(store->index);
+	cl_tvector_del(store->terms);
+	free(store);
+}
+
+/**
+ * Returns the number of terms in a term store.
+ *
+ * @param store Pointer to a term store.
+ *
+ * @return The number of terms, which is also the smallest unused term id.
+ */
+static inline size_t cl_tstore_count(const TermStore * store) {
+	assert (store != NULL);
+
+	return cl_tvector_count(store->terms);
+}
+
+/**
+ * Returns the lookup statistics of a term store.
+ *
+ * @param store Pointer to a term store.
+ *
+ * @return The statistics of the structural index of the store.
+ */
+static inline struct CLStats cl_tstore_stats(const TermStore * store) {
+	assert (store != NULL);
+
+	return cl_tset_stats(store->index);
+}
+
+/**
+ * Returns a term node.
+ *
+ * @param store Pointer to a term store.
+ * @param id Term id. If it is not less than <code>cl_tstore_count(store)</code>, the behaviour is undefined.
+ *
+ * @return A pointer to the term node with the specified id.
+ */
+static inline const struct Term * cl_tstore_get(const TermStore * store, HilbertHandle id) {
+	assert (store != NULL);
+
+	return cl_tvector_get(store->terms, id);
+}
+
+/**
+ * Removes the most recently added terms from a term store.
+ * This must be done before the nodes of the removed terms are released from their arena.
+ *
+ * @param store Pointer to a term store.
+ * @param count New number of terms. If it exceeds <code>cl_tstore_count(store)</code>, the behaviour is undefined.
+ */
+static inline void cl_tstore_downsize(TermStore * store, size_t count) {
+	assert (store != NULL);
+	assert (count <= cl_tvector_count(store->terms));
+
+	for (size_t i = cl_tvector_count(store->terms); i != count; --i) {
+		int rc = cl_tset_remove(store->index, cl_tvector_get(store->terms, i - 1));
+		assert (rc);
+		(void) rc;
+	}
+	int rc = cl_tvector_downsize(store->terms, count);
+	assert (rc == 0);
+	(void) rc;
+}
+
+/**
+ * Interns a term, creating a new node only if no structurally equal term exists yet.
+ *
+ * @param store Pointer to a term store.
+ * @param arena Pointer to the arena from which new nodes are allocated.
+ * 	The same arena must be used for all terms of a store.
+ * @param head Functor or variable handle.
+ * @param argc Number of arguments.
+ * @param args Pointer to an array of <code>argc</code> argument term ids.
+ * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
+ * @param id Pointer to a location to which the term id is written.
+ *
+ * @return On success, <code>0</code> is returned and the id of the term is stored in <code>*id</code>.
+ * 	On error, <code>-1</code> is returned and the store and the arena remain unchanged.
+ */
+static inline int cl_tstore_intern(TermStore * restrict store, Arena * restrict arena, HilbertHandle head, size_t argc,
+		const HilbertHandle * restrict args, HilbertHandle * restrict id) {
+	assert (store != NULL);
+	assert (arena != NULL);
+	assert ((argc == 0) || (args != NULL));
+	assert (id != NULL);
+
+	if (argc > (SIZE_MAX - sizeof(struct Term)) / sizeof(*args))
+		return -1;
+
+	/* build the node in place, and drop it again if it turns out to be known */
+	ArenaMark mark = cl_arena_mark(arena);
+	struct Term * term = cl_arena_alloc(arena, sizeof(*term) + argc * sizeof(*args));
+	if (term == NULL)
+		goto nomem;
+	term->hash = cl_hash_index(head);
+	for (size_t i = 0; i != argc; ++i)
+		term->hash = cl_hash_index(term->hash ^ args[i]);
+	term->id = cl_tvector_count(store->terms);
+	term->head = head;
+	term->argc = argc;
+	if (argc != 0)
+		memcpy(term->args, args, argc * sizeof(*args));
+
+	const struct Term * known;
+	if (cl_tset_get(store->index, term, &known)) {
+		cl_arena_rewind(arena, mark);
+		*id = known->id;
+		return 0;
+	}
+
+	if (cl_tvector_pushback(store->terms, term) != 0)
+		goto novectormem;
+	if (cl_tset_add(store->index, term) != 0)
+		goto nosetmem;
+
+	*id = term->id;
+	return 0;
+
+nosetmem:
+	cl_tvector_popback(store->terms);
+novectormem:
+	cl_arena_rewind(arena, mark);
+nomem:
+	return -1;
+}
+
+#endif
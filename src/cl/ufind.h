@@ -0,0 +1,558 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_CL_UFIND_H__
+#define HILBERT_CL_UFIND_H__
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdlib.h>
+
+/**
+ * Journal entry recording a merge of two classes.
+ */
+struct UnionFindMerge {
+	/**
+	 * Representative of the merged class.
+	 */
+	size_t root;
+
+	/**
+	 * Former representative which has been linked below <code>root</code>.
+	 */
+	size_t child;
+
+	/**
+	 * Whether the rank of <code>root</code> has been incremented by the merge.
+	 */
+	int rankinc;
+};
+
+/**
+ * Union-find structure (disjoint set forest) over the indices <code>0, ..., count - 1</code>.
+ *
+ * Classes are merged by rank, and lookups compress paths by halving.
+ * In addition, the elements of each class are linked in a circular list,
+ * so that a class can be enumerated in time linear in its size.
+ *
+ * Changes can be grouped into a transaction, during which each merge is recorded in a journal.
+ * Rolling back a transaction undoes the recorded merges in reverse order.
+ * Path compression is suspended during a transaction, so that the journal remains sufficient for undoing it.
+ *
+ * Once frozen, a union-find structure can no longer be changed,
+ * and lookups do not write to it, so that they can be performed concurrently.
+ */
+struct UnionFind {
+	/**
+	 * Number of elements.
+	 */
+	size_t count;
+
+	/**
+	 * Current maximum number of elements.
+	 */
+	size_t size;
+
+	/**
+	 * Parent indices. An element is the representative of its class if and only if it is its own parent.
+	 */
+	size_t * parent;
+
+	/**
+	 * Successor indices in the circular list of class members.
+	 */
+	size_t * next;
+
+	/**
+	 * Ranks (upper bounds on the tree heights). Only meaningful for representatives.
+	 */
+	unsigned char * rank;
+
+	/**
+	 * Whether a transaction is in progress.
+	 */
+	int journaling;
+
+	/**
+	 * Whether this structure is frozen.
+	 * If so, every element is either a representative or a direct child of its representative.
+	 */
+	int frozen;
+
+	/**
+	 * Element count at the beginning of the current transaction.
+	 */
+	size_t mark;
+
+	/**
+	 * Number of journal entries.
+	 */
+	size_t jcount;
+
+	/**
+	 * Current maximum number of journal entries.
+	 */
+	size_t jsize;
+
+	/**
+	 * Journal of merges in the current transaction.
+	 */
+	struct UnionFindMerge * journal;
+
+	/**
+	 * Whether the parent indices are borrowed from an external buffer (see <code>#cl_ufind_borrow()</code>).
+	 */
+	int borrowed;
+};
+
+typedef struct UnionFind UnionFind;
+
+/**
+ * Creates a new, empty union-find structure.
+ *
+ * @return On success, a pointer to a new, empty union-find structure is returned.
+ * 	On error, <code>NULL</code> is returned.
+ */
+static inline UnionFind * cl_ufind_new(void) {
+	UnionFind * result;
+
+	result = malloc(sizeof(*result));
+	if (result == NULL)
+		goto nomem;
+
+	result->count = 0;
+	result->size = 1;
+	result->parent = malloc(result->size * sizeof(*result->parent));
+	if (result->parent == NULL)
+		goto noparentmem;
+	result->next = malloc(result->size * sizeof(*result->next));
+	if (result->next == NULL)
+		goto nonextmem;
+	result->rank = malloc(result->size * sizeof(*result->rank));
+	if (result->rank == NULL)
+		goto norankmem;
+	result->journaling = 0;
+	result->frozen = 0;
+	result->mark = 0;
+	result->jcount = 0;
+	result->jsize = 0;
+	result->journal = NULL;
+	result->borrowed = 0;
+
+	return result;
+
+norankmem:
+	free(result->next);
+nonextmem:
+	free(result->parent);
+noparentmem:
+	free(result);
+nomem:
+	return NULL;
+}
+
+/**
+ * Deletes a union-find structure.
+ *
+ * @param uf Pointer to the union-find structure to be deleted.
+ */
+static inline void cl_ufind_del(UnionFind * uf) {
+	assert (uf != NULL);
+
+	free(uf->journal);
+	free(uf->rank);
+	free(uf->next);
+	if (!uf->borrowed)
+		free(uf->parent);
+	free(uf);
+}
+
+/**
+ * Ensures that a union-find structure can hold a given number of elements without further allocation.
+ * The journal is not affected.
+ * If the structure needs to be enlarged, its capacity is at least doubled.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param size Required capacity.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the structure remains unchanged, save for its allocated space.
+ */
+static inline int cl_ufind_reserve(UnionFind * uf, size_t size) {
+	assert (uf != NULL);
+	assert (!uf->borrowed);
+
+	if (size <= uf->size)
+		return 0;
+	size_t newsize = uf->size <= SIZE_MAX / 2 ? 2 * uf->size : SIZE_MAX;
+	if (newsize < size)
+		newsize = size;
+	if (newsize > SIZE_MAX / sizeof(*uf->parent))
+		return -1;
+
+	size_t * newparent = realloc(uf->parent, newsize * sizeof(*newparent));
+	if (newparent == NULL)
+		return -1;
+	uf->parent = newparent;
+	size_t * newnext = realloc(uf->next, newsize * sizeof(*newnext));
+	if (newnext == NULL)
+		return -1;
+	uf->next = newnext;
+	unsigned char * newrank = realloc(uf->rank, newsize * sizeof(*newrank));
+	if (newrank == NULL)
+		return -1;
+	uf->rank = newrank;
+
+	uf->size = newsize;
+
+	return 0;
+}
+
+/**
+ * Grows a union-find structure (private).
+ *
+ * @param uf Pointer to the union-find structure to be grown.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the structure remains unchanged, save for its allocated space.
+ */
+static inline int cl_ufind_grow(UnionFind * uf) {
+	assert (uf != NULL);
+
+	if (uf->size == SIZE_MAX)
+		return -1;
+
+	return cl_ufind_reserve(uf, uf->size + 1);
+}
+
+/**
+ * Ensures that the journal of a union-find structure can hold a given number of entries (private).
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param jsize Required journal capacity.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the journal remains unchanged.
+ */
+static inline int cl_ufind_journal_reserve(UnionFind * uf, size_t jsize) {
+	assert (uf != NULL);
+
+	if (jsize <= uf->jsize)
+		return 0;
+	size_t newjsize = 2 * uf->jsize;
+	if (newjsize < jsize)
+		newjsize = jsize;
+	if (newjsize > SIZE_MAX / sizeof(*uf->journal))
+		return -1;
+	struct UnionFindMerge * newjournal = realloc(uf->journal, newjsize * sizeof(*newjournal));
+	if (newjournal == NULL)
+		return -1;
+	uf->journal = newjournal;
+	uf->jsize = newjsize;
+
+	return 0;
+}
+
+/**
+ * Adds a new singleton class to a union-find structure.
+ * The index of the new element is the element count prior to the addition.
+ *
+ * @param uf Pointer to a union-find structure.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int cl_ufind_add(UnionFind * uf) {
+	assert (uf != NULL);
+	assert (!uf->frozen);
+	assert (uf->count < SIZE_MAX);
+
+	if (uf->count == uf->size) {
+		if (cl_ufind_grow(uf) != 0)
+			return -1;
+	}
+	/* A transaction can merge at most count - 1 classes, so make sure the journal never overflows */
+	if (uf->journaling && (cl_ufind_journal_reserve(uf, uf->count) != 0))
+		return -1;
+	size_t index = uf->count++;
+	uf->parent[index] = index;
+	uf->next[index] = index;
+	uf->rank[index] = 0;
+
+	return 0;
+}
+
+/**
+ * Removes elements from the end of a union-find structure.
+ * None of the remaining elements must share a class with a removed element.
+ * This function must not be called during a transaction.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param newcount New element count.
+ * 	It is an error if the new element count is larger than the current element count.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int cl_ufind_downsize(UnionFind * uf, size_t newcount) {
+	assert (uf != NULL);
+	assert (!uf->journaling);
+
+	if (newcount > uf->count)
+		return -1;
+	uf->count = newcount;
+
+	return 0;
+}
+
+/**
+ * Returns the number of elements in a union-find structure.
+ *
+ * @param uf Pointer to a union-find structure.
+ *
+ * @return The number of elements is returned.
+ */
+static inline size_t cl_ufind_count(const UnionFind * uf) {
+	assert (uf != NULL);
+
+	return uf->count;
+}
+
+/**
+ * Finds the representative of the class of an element without writing to the structure.
+ * Unlike <code>#cl_ufind_find()</code>, this function may be called concurrently with other read-only lookups,
+ * at the price of not compressing paths.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param index Index of an element. If the index is out of bounds, the behaviour is undefined.
+ *
+ * @return The index of the representative of the class of <code>index</code> is returned.
+ */
+static inline size_t cl_ufind_find_readonly(const UnionFind * uf, size_t index) {
+	assert (uf != NULL);
+	assert (index < uf->count);
+
+	const size_t * parent = uf->parent;
+	if (uf->frozen)
+		return parent[index];
+	while (parent[index] != index)
+		index = parent[index];
+
+	return index;
+}
+
+/**
+ * Finds the representative of the class of an element, halving the path on the way
+ * unless a transaction is in progress or the structure is frozen.
+ * Since path halving writes to the structure, callers must have exclusive access to it.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param index Index of an element. If the index is out of bounds, the behaviour is undefined.
+ *
+ * @return The index of the representative of the class of <code>index</code> is returned.
+ */
+static inline size_t cl_ufind_find(UnionFind * uf, size_t index) {
+	assert (uf != NULL);
+	assert (index < uf->count);
+
+	size_t * parent = uf->parent;
+	if (uf->frozen) {
+		return parent[index];
+	} else if (uf->journaling) {
+		return cl_ufind_find_readonly(uf, index);
+	} else {
+		while (parent[index] != index) {
+			parent[index] = parent[parent[index]];
+			index = parent[index];
+		}
+	}
+
+	return index;
+}
+
+/**
+ * Merges the classes of two elements.
+ * If the elements are already in the same class, no operation is performed.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param index1 Index of an element. If the index is out of bounds, the behaviour is undefined.
+ * @param index2 Index of an element. If the index is out of bounds, the behaviour is undefined.
+ *
+ * @return The index of the representative of the merged class is returned.
+ */
+static inline size_t cl_ufind_union(UnionFind * uf, size_t index1, size_t index2) {
+	assert (uf != NULL);
+	assert (!uf->frozen);
+
+	size_t root1 = cl_ufind_find(uf, index1);
+	size_t root2 = cl_ufind_find(uf, index2);
+	if (root1 == root2)
+		return root1;
+
+	int rankinc = 0;
+	if (uf->rank[root1] < uf->rank[root2]) {
+		size_t tmp = root1;
+		root1 = root2;
+		root2 = tmp;
+	} else if (uf->rank[root1] == uf->rank[root2]) {
+		++uf->rank[root1];
+		rankinc = 1;
+	}
+	uf->parent[root2] = root1;
+	if (uf->journaling) {
+		assert (uf->jcount < uf->jsize);
+		uf->journal[uf->jcount++] = (struct UnionFindMerge) { .root = root1, .child = root2, .rankinc = rankinc };
+	}
+
+	/* splice the circular member lists */
+	size_t tmp = uf->next[root1];
+	uf->next[root1] = uf->next[root2];
+	uf->next[root2] = tmp;
+
+	return root1;
+}
+
+/**
+ * Returns the next member of the class of an element.
+ * Starting from any element and repeatedly calling this function enumerates the whole class,
+ * returning to the starting element after the last member.
+ *
+ * @param uf Pointer to a union-find structure.
+ * @param index Index of an element. If the index is out of bounds, the behaviour is undefined.
+ *
+ * @return The index of the next member of the class is returned.
+ */
+static inline size_t cl_ufind_next(const UnionFind * uf, size_t index) {
+	assert (uf != NULL);
+	assert (index < uf->count);
+
+	return uf->next[index];
+}
+
+/**
+ * Freezes a union-find structure.
+ * All paths are fully compressed, after which the structure can no longer be changed.
+ * Lookups in a frozen structure take constant time and do not write to the structure.
+ * This function must not be called during a transaction.
+ *
+ * @param uf Pointer to a union-find structure.
+ */
+static inline void cl_ufind_freeze(UnionFind * uf) {
+	assert (uf != NULL);
+	assert (!uf->journaling);
+
+	for (size_t i = 0; i != uf->count; ++i)
+		uf->parent[i] = cl_ufind_find(uf, i);
+	uf->frozen = 1;
+}
+
+/**
+ * Turns an empty union-find structure into a frozen one whose parent indices are borrowed from an external buffer.
+ * The buffer is not copied and must outlive the structure. It is not freed along with the structure.
+ * Since a frozen structure is never written to, the buffer may be read-only.
+ *
+ * @param uf Pointer to an empty union-find structure.
+ * @param parent Pointer to the first element of an array of <code>count</code> parent indices.
+ * 	Every element must be a representative or a direct child of one,
+ * 	as after <code>#cl_ufind_freeze()</code>. Otherwise, the behaviour is undefined.
+ * @param count Number of elements.
+ */
+static inline void cl_ufind_borrow(UnionFind * uf, size_t * parent, size_t count) {
+	assert (uf != NULL);
+	assert (uf->count == 0);
+	assert (!uf->journaling);
+	assert (!uf->borrowed);
+
+	free(uf->rank);
+	free(uf->next);
+	free(uf->parent);
+	uf->rank = NULL;
+	uf->next = NULL;
+	uf->parent = parent;
+	uf->count = count;
+	uf->size = count;
+	uf->frozen = 1;
+	uf->borrowed = 1;
+}
+
+/**
+ * Begins a transaction.
+ * Until the transaction is committed or rolled back, all merges are recorded in the journal.
+ * Transactions cannot be nested.
+ *
+ * @param uf Pointer to a union-find structure.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int cl_ufind_journal_begin(UnionFind * uf) {
+	assert (uf != NULL);
+	assert (!uf->journaling);
+	assert (!uf->frozen);
+
+	if (cl_ufind_journal_reserve(uf, uf->count) != 0)
+		return -1;
+	uf->journaling = 1;
+	uf->mark = uf->count;
+	uf->jcount = 0;
+
+	return 0;
+}
+
+/**
+ * Commits a transaction, keeping all changes made since its beginning.
+ *
+ * @param uf Pointer to a union-find structure with a transaction in progress.
+ */
+static inline void cl_ufind_journal_commit(UnionFind * uf) {
+	assert (uf != NULL);
+	assert (uf->journaling);
+
+	uf->journaling = 0;
+	uf->jcount = 0;
+}
+
+/**
+ * Rolls back a transaction.
+ * All merges recorded in the journal are undone in reverse order,
+ * and all elements added since the beginning of the transaction are removed.
+ *
+ * @param uf Pointer to a union-find structure with a transaction in progress.
+ */
+static inline void cl_ufind_journal_rollback(UnionFind * uf) {
+	assert (uf != NULL);
+	assert (uf->journaling);
+
+	while (uf->jcount != 0) {
+		struct UnionFindMerge merge = uf->journal[--uf->jcount];
+		size_t tmp = uf->next[merge.root];
+		uf->next[merge.root] = uf->next[merge.child];
+		uf->next[merge.child] = tmp;
+		uf->parent[merge.child] = merge.child;
+		if (merge.rankinc)
+			--uf->rank[merge.root];
+	}
+	uf->count = uf->mark;
+	uf->journaling = 0;
+}
+
+#endif
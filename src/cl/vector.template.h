@@ -21,25 +21,37 @@
  */
 
 /**
- * Replacements from vector container template:
- * - <code>VECTOR</code>:
- *   Vector type name,
- * - <code>VALUE_TYPE</code>:
- *   Type name of the value type,
- * - <code>VITER</code>:
- *   Vector iterator type name.
- * - <code>PREFIX</code>:
- *   Prefix of function names.
+ * Vector container template.
+ * A container type is instantiated by defining the following parameters and including this file.
+ * The parameters are undefined again at the end of this file.
+ * - <code>CL_VECTOR_TYPE</code>:
+ *   Vector typename.
+ * - <code>CL_VECTOR_VALUE</code>:
+ *   Type of the values stored.
+ * - <code>CL_VECTOR_ITERATOR</code>:
+ *   Vector iterator typename.
+ * - <code>CL_VECTOR_PREFIX</code>:
+ *   Function name prefix.
  */
 
-#ifndef HILBERT_CL_VECTOR_H__
-#define HILBERT_CL_VECTOR_H__
+#ifndef HILBERT_CL_VECTOR_TEMPLATE_H__
+#define HILBERT_CL_VECTOR_TEMPLATE_H__
 
 #include<assert.h>
 #include<stdint.h>
 #include<stdlib.h>
 #include<string.h>
 
+#include"template.h"
+
+#endif
+
+/* short names used within this file */
+#define VECTOR CL_VECTOR_TYPE
+#define VALUE_TYPE CL_VECTOR_VALUE
+#define VITER CL_VECTOR_ITERATOR
+#define PREFIX(name) CL_CAT(CL_VECTOR_PREFIX, _ ## name)
+
 /**
  * Vector structure.
  */
@@ -58,6 +70,11 @@ struct VECTOR {
 	 * Vector data array.
 	 */
 	VALUE_TYPE * data;
+
+	/**
+	 * Whether the data array is borrowed from an external buffer (see <code>borrow()</code>).
+	 */
+	int borrowed;
 };
 
 typedef struct VECTOR VECTOR;
@@ -85,7 +102,7 @@ typedef struct VITER VITER;
  * @return On success, a pointer to a new, empty vector is returned.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline VECTOR * PREFIX_new(void) {
+static inline VECTOR * PREFIX(new)(void) {
 	VECTOR * result;
 
 	result = malloc(sizeof(*result));
@@ -93,6 +110,7 @@ static inline VECTOR * PREFIX_new(void) {
 		return NULL;
 	result->count = 0;
 	result->size = 1;
+	result->borrowed = 0;
 	result->data = malloc(result->size * sizeof(*result->data));
 	if (result->data == NULL) {
 		free(result);
@@ -106,31 +124,38 @@ static inline VECTOR * PREFIX_new(void) {
  *
  * @param vector pointer to the vector which is to be deleted.
  */
-static inline void PREFIX_del(VECTOR * vector) {
+static inline void PREFIX(del)(VECTOR * vector) {
 	assert (vector != NULL);
 
-	free(vector->data);
+	if (!vector->borrowed)
+		free(vector->data);
 	free(vector);
 }
 
 /**
- * Grows a vector (private).
+ * Ensures that a vector can hold a given number of elements without further allocation.
+ * If the vector needs to be enlarged, its capacity is at least doubled,
+ * so that repeated reservations retain amortised constant cost per element.
  *
- * @param vector Pointer to the vector to be grown.
+ * @param vector Pointer to a vector.
+ * @param size Required capacity.
  *
  * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned.
+ * 	On error, <code>-1</code> is returned and the vector remains unchanged.
  */
-static inline int PREFIX_grow(VECTOR * vector) {
+static inline int PREFIX(reserve)(VECTOR * vector, size_t size) {
 	assert (vector != NULL);
-
-	size_t oldalloc = vector->size * sizeof(*vector->data);
-	size_t newalloc = 2 * oldalloc;
-	if (newalloc <= oldalloc)
+	assert (!vector->borrowed);
+
+	if (size <= vector->size)
+		return 0;
+	size_t newsize = vector->size <= SIZE_MAX / 2 ? 2 * vector->size : SIZE_MAX;
+	if (newsize < size)
+		newsize = size;
+	if (newsize > SIZE_MAX / sizeof(*vector->data))
 		return -1;
-	size_t newsize = newalloc / sizeof(*vector->data);
 
-	VALUE_TYPE * newdata = realloc(vector->data, newalloc);
+	VALUE_TYPE * newdata = realloc(vector->data, newsize * sizeof(*newdata));
 	if (newdata == NULL)
 		return -1;
 
@@ -140,6 +165,44 @@ static inline int PREFIX_grow(VECTOR * vector) {
 	return 0;
 }
 
+/**
+ * Grows a vector (private).
+ *
+ * @param vector Pointer to the vector to be grown.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned.
+ */
+static inline int PREFIX(grow)(VECTOR * vector) {
+	assert (vector != NULL);
+
+	if (vector->size == SIZE_MAX)
+		return -1;
+
+	return PREFIX(reserve)(vector, vector->size + 1);
+}
+
+/**
+ * Turns an empty vector into one whose data array is borrowed from an external buffer.
+ * The buffer is not copied and must outlive the vector. It is not freed along with the vector.
+ * A vector with borrowed data must not be grown, and if the buffer is read-only, it must not be written to.
+ *
+ * @param vector Pointer to an empty vector.
+ * @param data Pointer to the first element of an array of <code>count</code> elements.
+ * @param count Number of elements.
+ */
+static inline void PREFIX(borrow)(VECTOR * vector, VALUE_TYPE * data, size_t count) {
+	assert (vector != NULL);
+	assert (vector->count == 0);
+	assert (!vector->borrowed);
+
+	free(vector->data);
+	vector->data = data;
+	vector->count = count;
+	vector->size = count;
+	vector->borrowed = 1;
+}
+
 /**
  * Adds an element to the end of a vector.
  *
@@ -149,13 +212,13 @@ static inline int PREFIX_grow(VECTOR * vector) {
  * @return On success, <code>0</code> is returned.
  * 	On error, <code>-1</code> is returned.
  */
-static inline int PREFIX_pushback(VECTOR * vector, VALUE_TYPE elt) {
+static inline int PREFIX(pushback)(VECTOR * vector, VALUE_TYPE elt) {
 	assert (vector != NULL);
 	assert (vector->count < SIZE_MAX);
 
 	size_t newcount = vector->count + 1;
 	if (newcount > vector->size) {
-		if (PREFIX_grow(vector) != 0)
+		if (PREFIX(grow)(vector) != 0)
 			return -1;
 	}
 	vector->data[vector->count] = elt;
@@ -163,6 +226,58 @@ static inline int PREFIX_pushback(VECTOR * vector, VALUE_TYPE elt) {
 	return 0;
 }
 
+/**
+ * Adds elements to the end of a vector.
+ * The vector is grown at most once.
+ *
+ * @param vector Pointer to the vector to which elements are to be added.
+ * @param elts Pointer to the first element of an array of elements to be added.
+ * 	The array must not overlap the data of the vector.
+ * @param n Number of elements in the array pointed to by <code>elts</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>-1</code> is returned and the vector remains unchanged, save for its allocated space.
+ */
+static inline int PREFIX(pushback_n)(VECTOR * restrict vector, const VALUE_TYPE * restrict elts, size_t n) {
+	assert (vector != NULL);
+	assert ((n == 0) || (elts != NULL));
+
+	if (n > SIZE_MAX - vector->count)
+		return -1;
+	size_t newcount = vector->count + n;
+	if (PREFIX(reserve)(vector, newcount) != 0)
+		return -1;
+	if (n != 0)
+		memcpy(vector->data + vector->count, elts, n * sizeof(*elts));
+	vector->count = newcount;
+
+	return 0;
+}
+
+/**
+ * Releases the allocated space of a vector beyond its elements.
+ * Failure to do so is harmless and is ignored.
+ *
+ * @param vector Pointer to a vector.
+ */
+static inline void PREFIX(shrinktofit)(VECTOR * vector) {
+	assert (vector != NULL);
+
+	if (vector->borrowed || (vector->count == vector->size))
+		return;
+	if (vector->count == 0) {
+		free(vector->data);
+		vector->data = NULL;
+		vector->size = 0;
+		return;
+	}
+	VALUE_TYPE * newdata = realloc(vector->data, vector->count * sizeof(*newdata));
+	if (newdata == NULL)
+		return;
+	vector->data = newdata;
+	vector->size = vector->count;
+}
+
 /**
  * Removes an element from the end of a vector.
  *
@@ -171,7 +286,7 @@ static inline int PREFIX_pushback(VECTOR * vector, VALUE_TYPE elt) {
  *
  * @return The removed element is returned.
  */
-static inline VALUE_TYPE PREFIX_popback(VECTOR * vector) {
+static inline VALUE_TYPE PREFIX(popback)(VECTOR * vector) {
 	assert (vector != NULL);
 	assert (vector->count > 0);
 
@@ -183,31 +298,21 @@ static inline VALUE_TYPE PREFIX_popback(VECTOR * vector) {
  *
  * @param dest Pointer to the vector to which a copy of another vector is to be appended.
  * @param src Pointer to the vector a copy of which is to be appended to <code>dest</code>.
+ * 	Must be distinct from <code>dest</code>.
  *
  * @return On success, <code>0</code> is returned.
- * 	On error, <code>-1</code> is returned.
+ * 	On error, <code>-1</code> is returned and the destination vector remains unchanged, save for its allocated space.
  */
-static inline int PREFIX_append(VECTOR * dest, VECTOR * src) {
+static inline int PREFIX(append)(VECTOR * restrict dest, const VECTOR * restrict src) {
 	assert (dest != NULL);
 	assert (src != NULL);
 
-	size_t newcount = dest->count + src->count;
-	if (newcount < dest->count)
-		return -1;
-
-	while (newcount > dest->size) {
-		if (PREFIX_grow(dest) != 0)
-			return -1; // FIXME: doesn't return possibly grossly overallocated memory
-	}
-
-	memcpy(dest->data + dest->count, src->data, src->count * sizeof(*src->data));
-	dest->count = newcount;
-
-	return 0;
+	return PREFIX(pushback_n)(dest, src->data, src->count);
 }
 
 /**
  * Downsizes a vector.
+ * If less than a quarter of the allocated space remains in use, the allocated space is halved.
  *
  * @param vector Pointer to the vector which is to be downsized.
  * @param newcount New vector size.
@@ -216,12 +321,21 @@ static inline int PREFIX_append(VECTOR * dest, VECTOR * src) {
  * @return On success, <code>0</code> is returned.
  * 	On error, <code>-1</code> is returned.
  */
-static inline int PREFIX_downsize(VECTOR * vector, size_t newcount) {
+static inline int PREFIX(downsize)(VECTOR * vector, size_t newcount) {
 	assert (vector != NULL);
 	if (newcount > vector->count)
 		return -1;
 	vector->count = newcount;
-	// FIXME: Shrink allocated space?
+
+	/* shrink on low load; failure to do so is harmless */
+	if (!vector->borrowed && (newcount < vector->size / 4)) {
+		VALUE_TYPE * newdata = realloc(vector->data, vector->size / 2 * sizeof(*newdata));
+		if (newdata != NULL) {
+			vector->data = newdata;
+			vector->size /= 2;
+		}
+	}
+
 	return 0;
 }
 
@@ -232,7 +346,7 @@ static inline int PREFIX_downsize(VECTOR * vector, size_t newcount) {
  *
  * @return Number of elements in the vector.
  */
-static inline size_t PREFIX_count(const VECTOR * vector) {
+static inline size_t PREFIX(count)(const VECTOR * vector) {
 	assert (vector != NULL);
 
 	return vector->count;
@@ -247,7 +361,7 @@ static inline size_t PREFIX_count(const VECTOR * vector) {
  *
  * @return The element specified by <code>index</code> is returned.
  */
-static inline VALUE_TYPE PREFIX_get(const VECTOR * vector, size_t index) {
+static inline VALUE_TYPE PREFIX(get)(const VECTOR * vector, size_t index) {
 	assert (vector != NULL);
 	assert (index < vector->count);
 
@@ -262,7 +376,7 @@ static inline VALUE_TYPE PREFIX_get(const VECTOR * vector, size_t index) {
  *
  * @return The last element of the vector is returned.
  */
-static inline VALUE_TYPE PREFIX_last(const VECTOR * vector) {
+static inline VALUE_TYPE PREFIX(last)(const VECTOR * vector) {
 	assert (vector != 0);
 	assert (vector->count > 0);
 
@@ -279,7 +393,7 @@ static inline VALUE_TYPE PREFIX_last(const VECTOR * vector) {
  * 	The returned array must be freed by the user.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline VALUE_TYPE * PREFIX_toarray(const VECTOR * vector) {
+static inline VALUE_TYPE * PREFIX(toarray)(const VECTOR * vector) {
 	assert (vector != NULL);
 
 	size_t allocsize = vector->count * sizeof(*vector->data);
@@ -299,7 +413,7 @@ static inline VALUE_TYPE * PREFIX_toarray(const VECTOR * vector) {
  *
  * @return An iterator over the specified vector is returned.
  */
-static inline VITER PREFIX_iterator_new(VECTOR * vector) {
+static inline VITER PREFIX(iterator_new)(VECTOR * vector) {
 	assert (vector != NULL);
 
 	return (VITER) { .vector = vector, .index = 0 };
@@ -313,7 +427,7 @@ static inline VITER PREFIX_iterator_new(VECTOR * vector) {
  * @return If there is a next element in the iteration, <code>1</code> is returned.
  * 	Otherwise, <code>0</code> is returned.
  */
-static inline int PREFIX_iterator_hasnext(VITER * i) {
+static inline int PREFIX(iterator_hasnext)(VITER * i) {
 	assert (i != NULL);
 
 	return (i->index < i->vector->count);
@@ -327,10 +441,17 @@ static inline int PREFIX_iterator_hasnext(VITER * i) {
  * @return The next element in the iteration is returned.
  * 	If there is no next element, the behaviour is undefined.
  */
-static inline VALUE_TYPE PREFIX_iterator_next(VITER * i) {
+static inline VALUE_TYPE PREFIX(iterator_next)(VITER * i) {
 	assert (i != NULL);
 
 	return i->vector->data[i->index++];
 }
 
-#endif
+#undef VECTOR
+#undef VALUE_TYPE
+#undef VITER
+#undef PREFIX
+#undef CL_VECTOR_TYPE
+#undef CL_VECTOR_VALUE
+#undef CL_VECTOR_ITERATOR
+#undef CL_VECTOR_PREFIX
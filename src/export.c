@@ -27,15 +27,16 @@
 #include<stdlib.h>
 
 #include"cl/pmap.h"
-#include"cl/iset.h"
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+#include"cl/ufind.h"
 
 /**
  * Exports kinds of a source module from a destination module, checking the equivalence classes.
  *
  * @param dest Pointer to destination module, assumed to be locked.
- * @param src Pointer to source module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
  * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
  * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
  * @param mapper Pointer to parameter handle to argument handle mapper function.
@@ -53,37 +54,29 @@ static int export_kinds(struct HilbertModule * restrict dest, struct HilbertModu
 	assert (param != NULL);
 	int errcode;
 
-	/* Create index set for already handled kinds in equivalence check */
-	IndexSet * already_handled = hilbert_iset_new();
-	if (already_handled == NULL) {
-		errcode = HILBERT_ERR_NOMEM;
-		goto noahmem;
-	}
-
 	/* Inspect all source kinds */
 	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->kindhandles);
 			hilbert_ivector_iterator_hasnext(&i);) {
 		HilbertHandle srckindhandle = hilbert_ivector_iterator_next(&i);
-		union Object * srcobject = hilbert_ovector_get(src->objects, srckindhandle);
-		assert (srcobject->generic.type & HILBERT_TYPE_KIND);
+		unsigned int srctype = cl_otable_type(src->objects, srckindhandle);
+		assert (srctype & HILBERT_TYPE_KIND);
 		HilbertHandle destkindhandle = mapper(dest, src, srckindhandle, userdata, &errcode);
 		if (errcode != 0)
 			goto error;
-		union Object * destobject = hilbert_object_retrieve(dest, destkindhandle, HILBERT_TYPE_KIND);
-		if ((destobject == NULL) || ((srcobject->kind.type ^ destobject->kind.type) & HILBERT_TYPE_VKIND)) {
+		if ((!hilbert_object_check(dest, destkindhandle, HILBERT_TYPE_KIND))
+				|| ((srctype ^ cl_otable_type(dest->objects, destkindhandle)) & HILBERT_TYPE_VKIND)) {
 			errcode = HILBERT_ERR_INVALID_MAPPING;
 			goto error;
 		}
-		if (srcobject->generic.type & HILBERT_TYPE_EXTERNAL) {
+		if (srctype & HILBERT_TYPE_EXTERNAL) {
 			/* check externality */
-			if (!(destobject->generic.type & HILBERT_TYPE_EXTERNAL)) {
+			if (!(cl_otable_type(dest->objects, destkindhandle) & HILBERT_TYPE_EXTERNAL)) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
 			}
-			struct ExternalKind * srckind = &srcobject->external_kind;
-			HilbertHandle arghandle = argv[srckind->paramindex];
-			struct ExternalKind * destkind = &destobject->external_kind;
-			HilbertHandle destparamhandle = hilbert_ivector_get(dest->paramhandles, destkind->paramindex);
+			HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srckindhandle)];
+			HilbertHandle destparamhandle = hilbert_ivector_get(dest->paramhandles,
+					cl_otable_paramindex(dest->objects, destkindhandle));
 			if (destparamhandle != arghandle) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
@@ -100,43 +93,28 @@ static int export_kinds(struct HilbertModule * restrict dest, struct HilbertModu
 		}
 	}
 
-	/* check equivalence classes */
-	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->kindhandles);
-			hilbert_ivector_iterator_hasnext(&i);) {
-		HilbertHandle srckindhandle = hilbert_ivector_iterator_next(&i);
-		if (hilbert_iset_contains(already_handled, srckindhandle))
-			continue;
-		union Object * srcobject = hilbert_ovector_get(src->objects, srckindhandle);
-		assert (srcobject != NULL);
-		assert (srcobject->generic.type & HILBERT_TYPE_KIND);
-		struct Kind * srckind = &srcobject->kind;
-		if (srckind->equivalence_class == NULL)
+	/* check equivalence classes: each source kind must map to a kind equivalent to the image of its representative */
+	size_t srckindcount = hilbert_ivector_count(src->kindhandles);
+	for (size_t i = 0; i != srckindcount; ++i) {
+		size_t root = cl_ufind_find_readonly(src->kindeqc, i);
+		if (root == i)
 			continue;
-		const HilbertHandle * destkindhandle = hilbert_pmap_pre(param->handle_map, srckindhandle);
-		assert (destkindhandle != NULL);
-		for (IndexSetIterator j = hilbert_iset_iterator_new(srckind->equivalence_class);
-				hilbert_iset_iterator_hasnext(&j);) {
-			HilbertHandle srckindhandle2 = hilbert_iset_iterator_next(&j);
-			const HilbertHandle * destkindhandle2 = hilbert_pmap_pre(param->handle_map, srckindhandle2);
-			assert (destkindhandle2 != NULL);
-			int rc = hilbert_kind_isequivalent(dest, *destkindhandle, *destkindhandle2, &errcode);
-			assert (errcode == 0);
-			if (!rc) {
-				errcode = HILBERT_ERR_NO_EQUIVALENCE;
-				goto error;
-			}
-			if (hilbert_iset_add(already_handled, srckindhandle2) != 0) {
-				errcode = HILBERT_ERR_NOMEM;
-				goto error;
-			}
+		const HilbertHandle * destkindhandle1 = hilbert_pmap_pre(param->handle_map,
+				hilbert_ivector_get(src->kindhandles, i));
+		const HilbertHandle * destkindhandle2 = hilbert_pmap_pre(param->handle_map,
+				hilbert_ivector_get(src->kindhandles, root));
+		assert (destkindhandle1 != NULL);
+		assert (destkindhandle2 != NULL);
+		int rc = hilbert_kind_isequivalent_nocheck(dest, *destkindhandle1, *destkindhandle2);
+		if (!rc) {
+			errcode = HILBERT_ERR_NO_EQUIVALENCE;
+			goto error;
 		}
 	}
 
 	errcode = 0;
 
 error:
-	hilbert_iset_del(already_handled);
-noahmem:
 	return errcode;
 }
 
@@ -144,7 +122,7 @@ noahmem:
  * Exports functors of a source module from a destination module.
  *
  * @param dest Pointer to destination module, assumed to be locked.
- * @param src Pointer to source module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
  * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
  * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
  * @param mapper Pointer to parameter handle to argument handle mapper function.
@@ -166,38 +144,35 @@ static int export_functors(struct HilbertModule * restrict dest, struct HilbertM
 	/* Inspect all source functors */
 	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->functorhandles); hilbert_ivector_iterator_hasnext(&i);) {
 		HilbertHandle srcfunctorhandle = hilbert_ivector_iterator_next(&i);
-		union Object * srcobject = hilbert_ovector_get(src->objects, srcfunctorhandle);
-		assert (srcobject->generic.type & HILBERT_TYPE_FUNCTOR); // FIXME: abbrev, def?
+		unsigned int srctype = cl_otable_type(src->objects, srcfunctorhandle);
+		assert (srctype & HILBERT_TYPE_FUNCTOR); // FIXME: abbrev, def?
 		HilbertHandle destfunctorhandle = mapper(dest, src, srcfunctorhandle, userdata, &errcode);
 		if (errcode != 0)
 			goto error;
-		union Object * destobject = hilbert_object_retrieve(dest, destfunctorhandle, HILBERT_TYPE_FUNCTOR);
-		if (destobject == NULL) {
+		if (!hilbert_object_check(dest, destfunctorhandle, HILBERT_TYPE_FUNCTOR)) {
 			errcode = HILBERT_ERR_INVALID_MAPPING;
 			goto error;
 		}
-		if (srcobject->generic.type & HILBERT_TYPE_EXTERNAL) {
+		if (srctype & HILBERT_TYPE_EXTERNAL) {
 			/* check externality */
-			if (!(destobject->generic.type & HILBERT_TYPE_EXTERNAL)) {
+			if (!(cl_otable_type(dest->objects, destfunctorhandle) & HILBERT_TYPE_EXTERNAL)) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
 			}
-			struct ExternalBasicFunctor * srcfunctor = &srcobject->external_basic_functor;
-			HilbertHandle arghandle = argv[srcfunctor->paramindex];
-			struct ExternalBasicFunctor * destfunctor = &destobject->external_basic_functor;
-			HilbertHandle destparamhandle = hilbert_ivector_get(dest->paramhandles, destfunctor->paramindex);
+			HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srcfunctorhandle)];
+			HilbertHandle destparamhandle = hilbert_ivector_get(dest->paramhandles,
+					cl_otable_paramindex(dest->objects, destfunctorhandle));
 			if (destparamhandle != arghandle) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
 			}
 		}
 		/* check if functor data matches */
-		struct BasicFunctor * srcfunctor = &srcobject->basic_functor;
-		struct BasicFunctor * destfunctor = &destobject->basic_functor;
-		const HilbertHandle * kindp = hilbert_pmap_post(param->handle_map, destfunctor->result_kind);
+		struct BasicFunctor * srcfunctor = &cl_otable_record(src->objects, srcfunctorhandle)->basic_functor;
+		struct BasicFunctor * destfunctor = &cl_otable_record(dest->objects, destfunctorhandle)->basic_functor;
+		const HilbertHandle * kindp = hilbert_pmap_post(param->handle_map, cl_otable_kind(dest->objects, destfunctorhandle));
 		assert (kindp != NULL);
-		rc = hilbert_kind_isequivalent(src, *kindp, srcfunctor->result_kind, &errcode);
-		assert (errcode == 0);
+		rc = hilbert_kind_isequivalent_nocheck(src, *kindp, cl_otable_kind(src->objects, srcfunctorhandle));
 		if (!rc) {
 			errcode = HILBERT_ERR_INVALID_MAPPING;
 			goto error;
@@ -206,11 +181,12 @@ static int export_functors(struct HilbertModule * restrict dest, struct HilbertM
 			errcode = HILBERT_ERR_INVALID_MAPPING;
 			goto error;
 		}
+		const HilbertHandle * srckinds = hilbert_functor_inputkinds(srcfunctor);
+		const HilbertHandle * destkinds = hilbert_functor_inputkinds(destfunctor);
 		for (size_t i = 0; i != destfunctor->place_count; ++i) {
-			kindp = hilbert_pmap_post(param->handle_map, destfunctor->input_kinds[i]);
+			kindp = hilbert_pmap_post(param->handle_map, destkinds[i]);
 			assert (kindp != NULL);
-			rc = hilbert_kind_isequivalent(src, *kindp, srcfunctor->input_kinds[i], &errcode);
-			assert (errcode == 0);
+			rc = hilbert_kind_isequivalent_nocheck(src, *kindp, srckinds[i]);
 			if (!rc) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
@@ -234,6 +210,89 @@ error:
 	return errcode;
 }
 
+/**
+ * Exports statements of a source module from a destination module.
+ * Each source statement must be mapped to a destination statement matching it.
+ *
+ * @param dest Pointer to destination module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
+ * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
+ * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
+ * @param mapper Pointer to parameter handle to argument handle mapper function.
+ * @param userdata Pointer to user-defined data passed as an argument to the userdata parameter of <code>mapper</code>.
+ * @param param Pointer to the new parameter, whose handle map already contains the kinds and functors.
+ *
+ * @return On success, <code>0</code> is returned. On error, a nonzero value is returned.
+ */
+static int export_statements(struct HilbertModule * restrict dest, struct HilbertModule * restrict src,
+		const HilbertHandle * restrict argv, HilbertMapperCallback mapper, void * userdata,
+		struct Param * restrict param) {
+	assert (dest != NULL);
+	assert (src != NULL);
+	assert ((hilbert_ivector_count(src->paramhandles) == 0) || (argv != NULL));
+	assert (mapper != NULL);
+	assert (param != NULL);
+
+	int errcode;
+	struct StatementMatcher matcher;
+
+	if (hilbert_ivector_count(src->statementhandles) == 0)
+		return 0;
+	errcode = statement_matcher_init(&matcher, src);
+	if (errcode != 0)
+		goto nomatchermem;
+
+	/* Inspect all source statements */
+	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->statementhandles);
+			hilbert_ivector_iterator_hasnext(&i);) {
+		HilbertHandle srcstatementhandle = hilbert_ivector_iterator_next(&i);
+		unsigned int srctype = cl_otable_type(src->objects, srcstatementhandle);
+		assert (srctype & HILBERT_TYPE_STATEMENT);
+		HilbertHandle deststatementhandle = mapper(dest, src, srcstatementhandle, userdata, &errcode);
+		if (errcode != 0)
+			goto error;
+		if (!hilbert_object_check(dest, deststatementhandle, HILBERT_TYPE_STATEMENT)) {
+			errcode = HILBERT_ERR_INVALID_MAPPING;
+			goto error;
+		}
+		if (srctype & HILBERT_TYPE_EXTERNAL) {
+			/* check externality */
+			if (!(cl_otable_type(dest->objects, deststatementhandle) & HILBERT_TYPE_EXTERNAL)) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto error;
+			}
+			HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srcstatementhandle)];
+			HilbertHandle destparamhandle = hilbert_ivector_get(dest->paramhandles,
+					cl_otable_paramindex(dest->objects, deststatementhandle));
+			if (destparamhandle != arghandle) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto error;
+			}
+		}
+		/* check if statement data matches */
+		errcode = statement_match(&matcher, dest, src, param->handle_map, srcstatementhandle, deststatementhandle);
+		if (errcode != 0)
+			goto error;
+		/* add mapping */
+		const HilbertHandle * test = hilbert_pmap_post(param->handle_map, deststatementhandle);
+		if (test != NULL) {
+			errcode = HILBERT_ERR_MAPPING_CLASH;
+			goto error;
+		}
+		if (hilbert_pmap_add(param->handle_map, deststatementhandle, srcstatementhandle) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+	}
+
+	errcode = 0;
+
+error:
+	statement_matcher_fini(&matcher);
+nomatchermem:
+	return errcode;
+}
+
 HilbertHandle hilbert_module_export(struct HilbertModule * restrict dest, struct HilbertModule * restrict src,
 		size_t argc, const HilbertHandle * restrict argv, HilbertMapperCallback mapper, void * userdata,
 		int * restrict errcode) {
@@ -257,21 +316,18 @@ HilbertHandle hilbert_module_export(struct HilbertModule * restrict dest, struct
 		goto invalidmodule;
 	}
 
-	if (mtx_lock(&dest->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto nodestlock;
-	}
-
-	if (mtx_lock(&src->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto nosrclock;
-	}
-
+	/* src is immutable and hence read without locking it */
 	rc = hilbert_module_isimmutable(src, errcode);
 	if ((*errcode == 0) && (!rc))
 		*errcode = HILBERT_ERR_IMMUTABLE;
 	if (*errcode != 0)
-		goto immutable;
+		goto invalidmodule;
+
+	unsigned long long start = hilbert_stats_clock();
+	if (hilbert_module_wrlock(dest) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nodestlock;
+	}
 
 	if (hilbert_ivector_count(src->paramhandles) != argc) {
 		*errcode = HILBERT_ERR_COUNT_MISMATCH;
@@ -279,23 +335,24 @@ HilbertHandle hilbert_module_export(struct HilbertModule * restrict dest, struct
 	}
 
 	for (size_t i = 0; i != argc; ++i) {
-		if (hilbert_object_retrieve(dest, argv[i], HILBERT_TYPE_PARAM) == NULL) {
+		if (!hilbert_object_check(dest, argv[i], HILBERT_TYPE_PARAM)) {
 			*errcode = HILBERT_ERR_INVALID_HANDLE;
 			goto argerror;
 		}
 	}
 
 	/* parameter creation and export */
-	union Object * param = param_create(src);
+	ArenaMark mark = cl_arena_mark(dest->arena);
+	union Object * param = param_create(dest, src);
 	if (param == NULL) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparammem;
 	}
 
-	size_t oldcount = hilbert_ovector_count(dest->objects);
+	size_t oldcount = cl_otable_count(dest->objects);
 	result = oldcount;
 
-	if (hilbert_ovector_pushback(dest->objects, param) != 0) {
+	if (cl_otable_pushback(dest->objects, (struct ObjectRow) { .type = HILBERT_TYPE_PARAM, .record = param }) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
 	}
@@ -306,8 +363,10 @@ HilbertHandle hilbert_module_export(struct HilbertModule * restrict dest, struct
 	*errcode = export_functors(dest, src, argv, mapper, userdata, &param->param); // FIXME: abbrev, def?
 	if (*errcode != 0)
 		goto functorexporterror;
-	// FIXME: statements
-	
+	*errcode = export_statements(dest, src, argv, mapper, userdata, &param->param);
+	if (*errcode != 0)
+		goto statementexporterror;
+
 	if (hilbert_ivector_pushback(dest->paramhandles, result) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparamhandlemem;
@@ -317,28 +376,25 @@ HilbertHandle hilbert_module_export(struct HilbertModule * restrict dest, struct
 	if (*errcode != 0)
 		goto deperror;
 
+	hilbert_stats_add(dest, transfers, 1);
+	hilbert_stats_add(dest, transfernanos, hilbert_stats_clock() - start);
 	goto success;
 
 deperror:
+	hilbert_ivector_popback(dest->paramhandles);
 noparamhandlemem:
+statementexporterror:
 functorexporterror:
-kindexporterror:;
-		size_t newcount = hilbert_ovector_count(dest->objects);
-		for (size_t i = oldcount + 1; i < newcount; ++i) { /* param is freed below */
-			hilbert_object_free(hilbert_ovector_get(dest->objects, i));
-		}
-		if (hilbert_ovector_downsize(dest->objects, oldcount) != 0)
-			*errcode = HILBERT_ERR_INTERNAL;
+kindexporterror:
+	if (cl_otable_downsize(dest->objects, oldcount) != 0)
+		*errcode = HILBERT_ERR_INTERNAL;
 noobjectmem:
 	hilbert_param_free(param);
+	cl_arena_rewind(dest->arena, mark);
 noparammem:
 argerror:
-immutable:
 success:
-	if (mtx_unlock(&src->mutex) != thrd_success)
-		*errcode = HILBERT_ERR_INTERNAL;
-nosrclock:
-	if (mtx_unlock(&dest->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(dest) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nodestlock:
 invalidmodule:
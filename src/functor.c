@@ -27,7 +27,7 @@
 #include<string.h>
 
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
 
 #include"threads/hthreads.h"
 
@@ -37,7 +37,7 @@ HilbertHandle hilbert_functor_create(struct HilbertModule * restrict module, Hil
 	assert (errcode != NULL);
 
 	union Object * object;
-	union Object * kind;
+	HilbertHandle * ikinds = NULL;
 	int rc;
 	size_t result = 0;
 
@@ -46,7 +46,7 @@ HilbertHandle hilbert_functor_create(struct HilbertModule * restrict module, Hil
 		goto invalid_module;
 	}
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
@@ -59,8 +59,8 @@ HilbertHandle hilbert_functor_create(struct HilbertModule * restrict module, Hil
 		goto immutable;
 	}
 
-	kind = hilbert_object_retrieve(module, rkindhandle, HILBERT_TYPE_KIND);
-	if ((kind == NULL) || (kind->kind.type & HILBERT_TYPE_VKIND)) {
+	if ((!hilbert_object_check(module, rkindhandle, HILBERT_TYPE_KIND))
+			|| (cl_otable_type(module->objects, rkindhandle) & HILBERT_TYPE_VKIND)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wrongkind;
 	}
@@ -72,36 +72,40 @@ HilbertHandle hilbert_functor_create(struct HilbertModule * restrict module, Hil
 	size_t ikindssize = count * sizeof(*ikindhandles);
 
 	for (size_t i = 0; i != count; ++i) {
-		kind = hilbert_object_retrieve(module, ikindhandles[i], HILBERT_TYPE_KIND);
-		if (kind == NULL) {
+		if (!hilbert_object_check(module, ikindhandles[i], HILBERT_TYPE_KIND)) {
 			*errcode = HILBERT_ERR_INVALID_HANDLE;
 			goto wrongkind;
 		}
 	}
 
-	object = malloc(sizeof(*object));
+	ArenaMark mark = cl_arena_mark(module->arena);
+	object = cl_arena_alloc(module->arena, sizeof(*object));
 	if (object == NULL) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
 	}
-	object->basic_functor = (struct BasicFunctor) { .type = HILBERT_TYPE_FUNCTOR, .result_kind = rkindhandle, .place_count = count, .input_kinds = NULL };
-
-	if (ikindssize != 0) {
-		object->basic_functor.input_kinds = malloc(ikindssize);
-		if (object->basic_functor.input_kinds == NULL) {
+	if (count > HILBERT_FUNCTOR_INLINE) {
+		ikinds = cl_arena_alloc(module->arena, ikindssize);
+		if (ikinds == NULL) {
 			*errcode = HILBERT_ERR_NOMEM;
 			goto noikindsmem;
 		}
 	}
-	memcpy(object->basic_functor.input_kinds, ikindhandles, ikindssize);
+	ikinds = hilbert_functor_init(&object->basic_functor, count, ikinds);
+	if (ikindssize != 0)
+		memcpy(ikinds, ikindhandles, ikindssize);
 
-	result = hilbert_ovector_count(module->objects);
+	result = cl_otable_count(module->objects);
 	if (result > HILBERT_HANDLE_MAX) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nohandle;
 	}
 
-	*errcode = hilbert_ovector_pushback(module->objects, object);
+	*errcode = cl_otable_pushback(module->objects, (struct ObjectRow) {
+		.type = HILBERT_TYPE_FUNCTOR,
+		.kind = rkindhandle,
+		.record = object
+	});
 	if (*errcode != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noconsmem;
@@ -116,47 +120,162 @@ HilbertHandle hilbert_functor_create(struct HilbertModule * restrict module, Hil
 	goto success;
 
 nohandlemem:
-	hilbert_ovector_popback(module->objects);
+	cl_otable_popback(module->objects);
 noconsmem:
 nohandle:
-	free(object->basic_functor.input_kinds);
 noikindsmem:
-	free(object);
+	cl_arena_rewind(module->arena, mark);
 noobjectmem:
 wrongkind:
 counttoobig:
 immutable:
 success:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 invalid_module:
 	return result;
 }
 
+int hilbert_functor_create_n(struct HilbertModule * restrict module, size_t count, const HilbertHandle * restrict rkindhandles,
+		const size_t * restrict placecounts, const HilbertHandle * restrict ikindhandles, HilbertHandle * restrict functors) {
+	assert (module != NULL);
+	assert ((count == 0) || ((rkindhandles != NULL) && (placecounts != NULL) && (functors != NULL)));
+
+	union Object * objects;
+	HilbertHandle * ikinds = NULL;
+	int errcode;
+	int rc;
+
+	if (hilbert_module_gettype(module) != HILBERT_INTERFACE_MODULE) {
+		errcode = HILBERT_ERR_INVALID_MODULE;
+		goto invalid_module;
+	}
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, &errcode);
+	if (errcode != 0)
+		goto immutable;
+	if (rc) {
+		errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	/* validate all input up front */
+	size_t ikindcount = 0;
+	size_t externalcount = 0;
+	for (size_t i = 0; i != count; ++i) {
+		if ((!hilbert_object_check(module, rkindhandles[i], HILBERT_TYPE_KIND))
+				|| (cl_otable_type(module->objects, rkindhandles[i]) & HILBERT_TYPE_VKIND)) {
+			errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wrongkind;
+		}
+		if (placecounts[i] > SIZE_MAX / sizeof(*ikindhandles) - ikindcount) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto counttoobig;
+		}
+		ikindcount += placecounts[i];
+		if (placecounts[i] > HILBERT_FUNCTOR_INLINE)
+			externalcount += placecounts[i];
+	}
+	assert ((ikindcount == 0) || (ikindhandles != NULL));
+
+	for (size_t i = 0; i != ikindcount; ++i) {
+		if (!hilbert_object_check(module, ikindhandles[i], HILBERT_TYPE_KIND)) {
+			errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wrongkind;
+		}
+	}
+
+	/* reserve all space up front, so that the objects can be added without failure */
+	size_t first = cl_otable_count(module->objects);
+	size_t functorcount = hilbert_ivector_count(module->functorhandles);
+	if ((count > HILBERT_HANDLE_MAX - first) || (count > SIZE_MAX - functorcount)
+			|| (count > SIZE_MAX / sizeof(*objects))) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto counttoobig;
+	}
+	if ((cl_otable_reserve(module->objects, first + count) != 0)
+			|| (hilbert_ivector_reserve(module->functorhandles, functorcount + count) != 0)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noreservemem;
+	}
+
+	ArenaMark mark = cl_arena_mark(module->arena);
+	objects = cl_arena_alloc(module->arena, count * sizeof(*objects));
+	if (objects == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noobjectmem;
+	}
+	/* only input kind arrays too long to be stored in the functor records need extra space */
+	if (externalcount != 0) {
+		ikinds = cl_arena_alloc(module->arena, externalcount * sizeof(*ikinds));
+		if (ikinds == NULL) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto noikindsmem;
+		}
+	}
+
+	for (size_t i = 0, offset = 0; i != count; offset += placecounts[i++]) {
+		HilbertHandle * dest = hilbert_functor_init(&objects[i].basic_functor, placecounts[i], ikinds);
+		if (placecounts[i] != 0)
+			memcpy(dest, ikindhandles + offset, placecounts[i] * sizeof(*dest));
+		if (placecounts[i] > HILBERT_FUNCTOR_INLINE)
+			ikinds += placecounts[i];
+		rc = cl_otable_pushback(module->objects, (struct ObjectRow) {
+			.type = HILBERT_TYPE_FUNCTOR,
+			.kind = rkindhandles[i],
+			.record = objects + i
+		});
+		assert (rc == 0);
+		rc = hilbert_ivector_pushback(module->functorhandles, first + i);
+		assert (rc == 0);
+		functors[i] = first + i;
+	}
+
+	errcode = 0;
+	goto success;
+
+noikindsmem:
+	cl_arena_rewind(module->arena, mark);
+noobjectmem:
+noreservemem:
+counttoobig:
+wrongkind:
+immutable:
+success:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+nolock:
+invalid_module:
+	return errcode;
+}
+
 HilbertHandle hilbert_functor_getkind(struct HilbertModule * restrict module, HilbertHandle functorhandle, int * restrict errcode) {
 	assert (module != NULL);
 	assert (errcode != NULL);
 
-	union Object * object;
 	HilbertHandle result = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	object = hilbert_object_retrieve(module, functorhandle, HILBERT_TYPE_FUNCTOR);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, functorhandle, HILBERT_TYPE_FUNCTOR)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
-	result = object->basic_functor.result_kind;
+	result = cl_otable_kind(module->objects, functorhandle);
 
 	*errcode = 0;
 
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
@@ -170,16 +289,16 @@ HilbertHandle * hilbert_functor_getinputkinds(struct HilbertModule * restrict mo
 	union Object * object;
 	HilbertHandle * result = NULL;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	object = hilbert_object_retrieve(module, functorhandle, HILBERT_TYPE_FUNCTOR);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, functorhandle, HILBERT_TYPE_FUNCTOR)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
+	object = cl_otable_record(module->objects, functorhandle);
 	*size = object->basic_functor.place_count;
 
 	size_t resultalloc = *size * sizeof(*result);
@@ -189,14 +308,14 @@ HilbertHandle * hilbert_functor_getinputkinds(struct HilbertModule * restrict mo
 			*errcode = HILBERT_ERR_NOMEM;
 			goto noresultmem;
 		}
+		memcpy(result, hilbert_functor_inputkinds(&object->basic_functor), resultalloc);
 	}
-	memcpy(result, object->basic_functor.input_kinds, resultalloc);
 
 	*errcode = 0;
 
 noresultmem:
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdunlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		free(result);
 		result = NULL;
@@ -204,3 +323,69 @@ wronghandle:
 nolock:
 	return result;
 }
+
+const HilbertHandle * hilbert_functor_getinputkinds_view(struct HilbertModule * restrict module, HilbertHandle functorhandle,
+		size_t * restrict size, int * restrict errcode) {
+	assert (module != NULL);
+	assert (size != NULL);
+	assert (errcode != NULL);
+
+	const HilbertHandle * result = NULL;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (!hilbert_object_check(module, functorhandle, HILBERT_TYPE_FUNCTOR)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	/* functor records live in the module arena and never change, so the view remains valid after unlocking */
+	union Object * object = cl_otable_record(module->objects, functorhandle);
+	*size = object->basic_functor.place_count;
+	result = hilbert_functor_inputkinds(&object->basic_functor);
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		result = NULL;
+	}
+nolock:
+	return result;
+}
+
+size_t hilbert_functor_getinputkinds_buf(struct HilbertModule * restrict module, HilbertHandle functorhandle,
+		HilbertHandle * restrict buffer, size_t bufsize, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((bufsize == 0) || (buffer != NULL));
+	assert (errcode != NULL);
+
+	size_t result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (!hilbert_object_check(module, functorhandle, HILBERT_TYPE_FUNCTOR)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	union Object * object = cl_otable_record(module->objects, functorhandle);
+	result = object->basic_functor.place_count;
+	if (bufsize > result)
+		bufsize = result;
+	if (bufsize != 0)
+		memcpy(buffer, hilbert_functor_inputkinds(&object->basic_functor), bufsize * sizeof(*buffer));
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
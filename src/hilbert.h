@@ -25,6 +25,7 @@
 
 #include<limits.h>
 #include<stddef.h>
+#include<stdio.h>
 
 /**
  * Hilbert module types.
@@ -34,6 +35,31 @@ enum HilbertModuleType {
 	HILBERT_PROOF_MODULE
 };
 
+/**
+ * Proof step types.
+ *
+ * @sa #HilbertProofStep
+ */
+enum HilbertStepType {
+	/**
+	 * Pushes a hypothesis of the theorem being proven onto the proof stack, as a fact.
+	 * The step handle is the index of the hypothesis.
+	 */
+	HILBERT_STEP_HYP,
+
+	/**
+	 * Pushes a term onto the proof stack, as a substitution value.
+	 * The step handle is the term handle.
+	 */
+	HILBERT_STEP_TERM,
+
+	/**
+	 * Applies a statement to the top of the proof stack.
+	 * The step handle is the statement handle.
+	 */
+	HILBERT_STEP_APPLY
+};
+
 /**
  * Opaque Hilbert module type.
  */
@@ -51,10 +77,34 @@ typedef size_t HilbertHandle;
  */
 #define HILBERT_HANDLE_MAX SIZE_MAX
 
+/**
+ * Proof step, as passed to <code>#hilbert_theorem_create()</code>.
+ */
+struct HilbertProofStep {
+	/**
+	 * Step type.
+	 */
+	enum HilbertStepType type;
+
+	/**
+	 * Hypothesis index, term handle or statement handle, depending on <code>type</code>.
+	 */
+	HilbertHandle handle;
+};
+
+/**
+ * Proof step type.
+ */
+typedef struct HilbertProofStep HilbertProofStep;
+
 /**
  * Function pointer type for mapping objects between modules.
  * It is required by library functions responsible for parameterising, importing, and exporting Hilbert interface modules.
  *
+ * The callback is called while the calling thread holds the lock of <code>dest</code>.
+ * It may query <code>dest</code> and <code>src</code> with library functions,
+ * but must not modify <code>dest</code>: functions modifying <code>dest</code> fail with <code>#HILBERT_ERR_INTERNAL</code>.
+ *
  * @param dest Pointer to a Hilbert module that is the target of a parameterisation, an import, or an export.
  * @param src Pointer to a Hilbert module that is the source of a parameterisation, an import, or an export.
  * @param srcObject Hilbert handle of an object in <code>src</code> whose corresponding handle in <code>dest</code> is sought.
@@ -67,6 +117,112 @@ typedef size_t HilbertHandle;
  */
 typedef HilbertHandle (*HilbertMapperCallback)(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject, void * userdata, int * restrict errcode);
 
+/**
+ * Module statistics, as returned by <code>#hilbert_module_getstats()</code>.
+ *
+ * The object and memory figures are always available.
+ * The remaining counters are only gathered if the library was configured with <code>--enable-stats</code>,
+ * and are zero otherwise.
+ * Counters are cumulative over the lifetime of the module.
+ */
+struct HilbertStats {
+	/**
+	 * Number of objects in the module.
+	 */
+	unsigned long long objects;
+
+	/**
+	 * Bytes held by the object table and the object records of the module,
+	 * plus the size of the mapping if the module was created by <code>#hilbert_module_map()</code>.
+	 */
+	unsigned long long bytes;
+
+	/**
+	 * Number of read lock acquisitions.
+	 * Reads of immutable modules do not lock and are not counted.
+	 */
+	unsigned long long rdlocks;
+
+	/**
+	 * Number of write lock acquisitions.
+	 */
+	unsigned long long wrlocks;
+
+	/**
+	 * Number of lock acquisitions which had to wait for another thread.
+	 */
+	unsigned long long contended;
+
+	/**
+	 * Number of hash table probes in the parameter maps, module sets and term index of the module.
+	 */
+	unsigned long long probes;
+
+	/**
+	 * Number of hash table rebuilds in the parameter maps, module sets and term index of the module.
+	 */
+	unsigned long long rehashes;
+
+	/**
+	 * Number of kind equivalence class merges.
+	 */
+	unsigned long long merges;
+
+	/**
+	 * Number of successful parameterisations, imports, and exports into the module.
+	 */
+	unsigned long long transfers;
+
+	/**
+	 * Total duration of <code>transfers</code> in nanoseconds.
+	 */
+	unsigned long long transfernanos;
+
+	/**
+	 * Number of proof steps checked by <code>#hilbert_theorem_create()</code>, including those of rejected proofs.
+	 */
+	unsigned long long proofsteps;
+};
+
+/**
+ * Module statistics type.
+ */
+typedef struct HilbertStats HilbertStats;
+
+/**
+ * Number of buckets of a lock wait time histogram.
+ */
+#define HILBERT_LOCK_BUCKETS 16
+
+/**
+ * Maximum number of lock sites recorded per module.
+ */
+#define HILBERT_LOCK_SITES 64
+
+/**
+ * Lock wait time histogram of a call site, as returned by <code>#hilbert_module_getlocksites()</code>.
+ */
+struct HilbertLockSite {
+	/**
+	 * Name of the library function which acquired the lock.
+	 */
+	const char * name;
+
+	/**
+	 * Number of lock acquisitions by wait time.
+	 * Bucket <code>0</code> counts waits shorter than one microsecond, including uncontended acquisitions.
+	 * Bucket <code>i</code>, <code>0 < i < #HILBERT_LOCK_BUCKETS - 1</code>,
+	 * counts waits of at least <code>2^(i-1)</code> and less than <code>2^i</code> microseconds.
+	 * The last bucket counts all longer waits.
+	 */
+	unsigned long long waits[HILBERT_LOCK_BUCKETS];
+};
+
+/**
+ * Lock site type.
+ */
+typedef struct HilbertLockSite HilbertLockSite;
+
 /**
  * Error codes.
  *
@@ -124,6 +280,27 @@ typedef HilbertHandle (*HilbertMapperCallback)(HilbertModule * restrict dest, Hi
  */
 #define HILBERT_ERR_NO_EQUIVALENCE  (-8)
 
+/**
+ * Error code to indicate that reading from or writing to a stream failed.
+ */
+#define HILBERT_ERR_IO              (-9)
+
+/**
+ * Error code to indicate that a module image is malformed, truncated,
+ * or was written by an incompatible version or on a platform with a different byte order or word size.
+ */
+#define HILBERT_ERR_INVALID_IMAGE   (-10)
+
+/**
+ * Error code to indicate that a term is not of a kind equivalent to the kind expected at its place.
+ */
+#define HILBERT_ERR_KIND_MISMATCH   (-11)
+
+/**
+ * Error code to indicate that a proof does not prove what it claims to prove.
+ */
+#define HILBERT_ERR_INVALID_PROOF   (-12)
+
 /**
  * Error code to indicate a serious internal error in the Hilbert kernel library.
  *
@@ -183,6 +360,14 @@ typedef HilbertHandle (*HilbertMapperCallback)(HilbertModule * restrict dest, Hi
  */
 #define HILBERT_TYPE_FUNCTOR  0x0020u
 
+/**
+ * Flag to indicate that the corresponding object is a statement.
+ * This flag is mutually exclusive with <code>#HILBERT_TYPE_KIND</code>, <code>#HILBERT_TYPE_PARAM</code>, <code>#HILBERT_TYPE_VAR</code>, <code>#HILBERT_TYPE_VKIND</code> and <code>#HILBERT_TYPE_FUNCTOR</code>.
+ *
+ * @sa #hilbert_statement_create()
+ */
+#define HILBERT_TYPE_STATEMENT 0x0040u
+
 /**
  * Creates a new Hilbert module.
  *
@@ -227,6 +412,8 @@ enum HilbertModuleType hilbert_module_gettype(HilbertModule * module);
  * No new basic constitutents can be added to an immutable module.
  * Only immutable interface modules can be imported or exported,
  * or used as parameters.
+ * Read accesses to an immutable module do not lock the module,
+ * so that any number of threads may query it concurrently.
  *
  * @param module Pointer to a code>#HilbertModule</code> previously returned by a successful call to <code>#hilbert_module_create()</code>.
  * 	The module must be of type <code>#HILBERT_INTERFACE_MODULE</code>.
@@ -237,6 +424,8 @@ enum HilbertModuleType hilbert_module_gettype(HilbertModule * module);
  * 		The provided module is not an interface module.
  * 	- <code>#HILBERT_ERR_IMMUTABLE</code>:
  * 		The provided module is already immutable.
+ * 	- <code>#HILBERT_ERR_NOMEM</code>:
+ * 		There was not enough memory to prepare the module for lockless read access.
  *
  * @sa hilbert_module_gettype()
  * @sa hilbert_module_isimmutable()
@@ -260,6 +449,106 @@ int hilbert_module_makeimmutable(HilbertModule * module);
  */
 int hilbert_module_isimmutable(HilbertModule * restrict module, int * restrict errcode);
 
+/**
+ * Writes a binary image of an immutable interface module to a stream.
+ *
+ * The image contains the objects of the module, its kind equivalence classes, and its parameters.
+ * It does not contain the modules the parameters refer to (the dependencies).
+ * Instead, the dependencies must be supplied again when the image is loaded with <code>#hilbert_module_load()</code>.
+ * The dependencies are numbered in the order in which the parameters of the module first refer to them.
+ * Images use the native byte order and integer sizes of the platform,
+ * so that they can be used in place by <code>#hilbert_module_map()</code>.
+ * They are not portable across platforms with different byte orders or word sizes.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param stream Pointer to a stream open for binary writing.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, a negative value is returned, which may be one of the following error codes:
+ * 	- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 		The provided module is not an interface module.
+ * 	- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 		The provided module is not immutable.
+ * 	- <code>#HILBERT_ERR_NOMEM</code>:
+ * 		There was not enough memory available to perform the request.
+ * 	- <code>#HILBERT_ERR_IO</code>:
+ * 		Writing to the stream failed. The contents of the stream are unspecified.
+ *
+ * @sa hilbert_module_load()
+ */
+int hilbert_module_save(HilbertModule * restrict module, FILE * restrict stream);
+
+/**
+ * Creates an immutable interface module from a binary image previously written by <code>#hilbert_module_save()</code>.
+ *
+ * The image is read into a single block of memory, which then backs the module in place.
+ * It is validated completely before the module is returned,
+ * so that loading an untrusted image cannot produce an inconsistent module.
+ *
+ * @param stream Pointer to a stream open for binary reading.
+ * 	On success, the stream is positioned after the image.
+ * @param depc Number of dependencies.
+ * @param depv Pointer to the first element of an array of <code>depc</code> module pointers.
+ * 	The modules must be immutable interface modules with the same objects as the dependencies of the saved module,
+ * 	in the order described in <code>#hilbert_module_save()</code>.
+ * 	If <code>depc == 0</code>, this may be <code>NULL</code>.
+ * @param errcode Pointer to a location where an integer error code can be stored.
+ *
+ * @return On success, <code>0</code> is stored in <code>*errcode</code>,
+ * 	and a pointer to a new immutable interface module is returned.
+ * 	The module can be freed with <code>#hilbert_module_free()</code>.
+ * 	On error, <code>NULL</code> is returned, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 	- <code>#HILBERT_ERR_NOMEM</code>:
+ * 		There was not enough memory available to perform the request.
+ * 	- <code>#HILBERT_ERR_IO</code>:
+ * 		Reading from the stream failed.
+ * 	- <code>#HILBERT_ERR_INVALID_IMAGE</code>:
+ * 		The stream does not contain a valid module image.
+ * 	- <code>#HILBERT_ERR_COUNT_MISMATCH</code>:
+ * 		<code>depc</code> differs from the number of dependencies of the saved module.
+ * 	- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 		One of the modules in <code>depv</code> is not an interface module,
+ * 		or does not match the corresponding dependency of the saved module.
+ * 	- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 		One of the modules in <code>depv</code> is not immutable.
+ *
+ * @sa hilbert_module_save()
+ */
+HilbertModule * hilbert_module_load(FILE * restrict stream, size_t depc, HilbertModule * const * restrict depv,
+		int * restrict errcode);
+
+/**
+ * Creates an immutable interface module backed by a memory-mapped image file.
+ *
+ * The file must contain an image written by <code>#hilbert_module_save()</code> at its beginning.
+ * It is mapped read-only and shared, and the module reads its objects, equivalence classes and handle arrays
+ * directly from the mapping instead of copying them.
+ * Hence processes mapping the same file share a single copy of it through the page cache.
+ * Only the functor and statement records, the term nodes and the parameter handle maps are allocated.
+ * The image is validated in place before the module is returned.
+ * The file must not be modified while the module exists.
+ *
+ * @param path Pointer to the path of the image file.
+ * @param depc Number of dependencies.
+ * @param depv Pointer to the first element of an array of <code>depc</code> module pointers,
+ * 	as described in <code>#hilbert_module_load()</code>.
+ * 	If <code>depc == 0</code>, this may be <code>NULL</code>.
+ * @param errcode Pointer to a location where an integer error code can be stored.
+ *
+ * @return On success, <code>0</code> is stored in <code>*errcode</code>,
+ * 	and a pointer to a new immutable interface module is returned.
+ * 	The module can be freed with <code>#hilbert_module_free()</code>, which also unmaps the file.
+ * 	On error, <code>NULL</code> is returned, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the error codes described in <code>#hilbert_module_load()</code>.
+ * 	<code>#HILBERT_ERR_IO</code> indicates that the file could not be opened or mapped.
+ *
+ * @sa hilbert_module_save()
+ * @sa hilbert_module_load()
+ */
+HilbertModule * hilbert_module_map(const char * restrict path, size_t depc, HilbertModule * const * restrict depv,
+		int * restrict errcode);
+
 /**
  * Sets ancillary data for a module.
  * Users may install a pointer to arbitrary ancillary data in a module.
@@ -298,6 +587,40 @@ int hilbert_module_setancillary(HilbertModule * module, void * newdata, void **
  */
 int hilbert_module_getancillary(HilbertModule * module, void ** data);
 
+/**
+ * Obtains a snapshot of the statistics of a module.
+ * The counters of a module in concurrent use may be slightly out of step with each other.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param stats Pointer to a <code>#HilbertStats</code> structure to be filled in.
+ *
+ * @return On success, <code>0</code> is returned and <code>*stats</code> holds the statistics of <code>module</code>.
+ * 	On error, a negative value is returned and the contents of <code>*stats</code> are unspecified.
+ *
+ * @sa HilbertStats
+ */
+int hilbert_module_getstats(HilbertModule * restrict module, HilbertStats * restrict stats);
+
+/**
+ * Obtains the lock wait time histograms of a module, one per library function locking the module.
+ * The module lock and the dependency lock of the module are both covered.
+ * Histograms are only gathered if the library was configured with <code>--enable-stats</code>.
+ * Locks taken by functions beyond the first <code>#HILBERT_LOCK_SITES</code> are not recorded.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param sites Pointer to an array of <code>#HILBERT_LOCK_SITES</code> lock sites to be filled in.
+ * @param errcode Pointer to an integer used to convey an error code.
+ *
+ * @return On success, <code>0</code> is stored in <code>*errcode</code>,
+ * 	and the number of lock sites filled in at the beginning of <code>sites</code> is returned.
+ * 	This is <code>0</code> if statistics are not enabled.
+ * 	On error, a negative value is stored in <code>*errcode</code> and the return value is unspecified.
+ *
+ * @sa HilbertLockSite
+ */
+size_t hilbert_module_getlocksites(HilbertModule * restrict module, HilbertLockSite * restrict sites,
+		int * restrict errcode);
+
 /**
  * Creates a new Hilbert kind in the specified interface module.
  *
@@ -334,6 +657,54 @@ HilbertHandle hilbert_kind_create(HilbertModule * restrict module, int * restric
  */
 HilbertHandle hilbert_vkind_create(HilbertModule * restrict module, int * restrict errcode);
 
+/**
+ * Creates several new Hilbert kinds in the specified interface module.
+ * The module is locked only once, and either all kinds are created or none.
+ *
+ * @param module Pointer to a Hilbert interface module.
+ * @param count Number of kinds to create.
+ * @param kinds Pointer to the first element of an array of <code>count</code> kind handles,
+ * 	to which the handles of the new kinds are written in order of creation.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, no kinds are created, the contents of the array pointed to by <code>kinds</code> are unspecified,
+ * 	and a negative value is returned, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory to create the new kinds.
+ * 		- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 			The module pointed to by <code>module</code> is a proof module.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ *
+ * @sa #hilbert_kind_create()
+ */
+int hilbert_kind_create_n(HilbertModule * restrict module, size_t count, HilbertHandle * restrict kinds);
+
+/**
+ * Creates several new Hilbert variable kinds in the specified interface module.
+ * The module is locked only once, and either all variable kinds are created or none.
+ *
+ * @param module Pointer to a Hilbert interface module.
+ * @param count Number of variable kinds to create.
+ * @param kinds Pointer to the first element of an array of <code>count</code> kind handles,
+ * 	to which the handles of the new variable kinds are written in order of creation.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, no variable kinds are created, the contents of the array pointed to by <code>kinds</code> are unspecified,
+ * 	and a negative value is returned, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory to create the new variable kinds.
+ * 		- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 			The module pointed to by <code>module</code> is a proof module.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ *
+ * @sa #hilbert_vkind_create()
+ */
+int hilbert_vkind_create_n(HilbertModule * restrict module, size_t count, HilbertHandle * restrict kinds);
+
 /**
  * Creates an alias of an existing Hilbert kind.
  * The new alias kind will be equivalent to the specified kind.
@@ -421,6 +792,53 @@ int hilbert_kind_isequivalent(HilbertModule * restrict module, HilbertHandle kin
 HilbertHandle * hilbert_kind_equivalenceclass(HilbertModule * restrict module, HilbertHandle kind, size_t * restrict count,
 		int * restrict errcode);
 
+/**
+ * Returns a read-only view of the equivalence class of a Hilbert kind in an immutable module.
+ * Unlike <code>#hilbert_kind_equivalenceclass()</code>, this function neither allocates memory nor locks the module.
+ *
+ * @param module Pointer to an immutable Hilbert module.
+ * @param kind Kind handle of a kind in <code>module</code>.
+ * @param count Pointer to a <code>size_t</code> to convey the number of elements in the equivalence class.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, <code>NULL</code> is returned, the value of <code>*count</code> is unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is not immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>kind</code> is not a valid handle for a kind.
+ * 	On success, a pointer to the first element of an array of kind handles representing the equivalence class
+ * 	is returned, as with <code>#hilbert_kind_equivalenceclass()</code>, and <code>0</code> is stored in <code>*errcode</code>.
+ * 	The array is owned by the module and remains valid until the module is freed. It must not be modified or freed.
+ */
+const HilbertHandle * hilbert_kind_equivalenceclass_view(HilbertModule * restrict module, HilbertHandle kind,
+		size_t * restrict count, int * restrict errcode);
+
+/**
+ * Copies the equivalence class of a Hilbert kind to a caller-supplied buffer.
+ * Unlike <code>#hilbert_kind_equivalenceclass()</code>, this function does not allocate memory.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param kind Kind handle of a kind in <code>module</code>.
+ * @param buffer Pointer to the first element of an array of <code>bufsize</code> handles.
+ * 	If <code>bufsize == 0</code>, this may be <code>NULL</code>.
+ * @param bufsize Number of elements of the array pointed to by <code>buffer</code>.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value and the contents of the buffer are unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>kind</code> is not a valid handle for a kind.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>,
+ * 	and the number of elements in the equivalence class is returned.
+ * 	The kind handles of the equivalence class are copied to the buffer, up to the size of the buffer,
+ * 	in the same order as with <code>#hilbert_kind_equivalenceclass_view()</code> for immutable modules,
+ * 	and in no specific order otherwise.
+ * 	If the return value is larger than <code>bufsize</code>, the buffer was too small to hold the equivalence class.
+ */
+size_t hilbert_kind_equivalenceclass_buf(HilbertModule * restrict module, HilbertHandle kind, HilbertHandle * restrict buffer,
+		size_t bufsize, int * restrict errcode);
+
 /**
  * Frees an array of Hilbert handles previously returned by a Hilbert Kernel library function,
  * releasing any resources associated with it.
@@ -450,6 +868,34 @@ void hilbert_harray_free(HilbertHandle * handle_array);
  */
 HilbertHandle hilbert_var_create(HilbertModule * restrict module, HilbertHandle kind, int * restrict errcode);
 
+/**
+ * Creates several new variables in the specified module.
+ * The module is locked only once, and either all variables are created or none.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param count Number of variables to create.
+ * @param kinds Pointer to the first element of an array of <code>count</code> kind handles,
+ * 	the kinds of the new variables.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ * @param vars Pointer to the first element of an array of <code>count</code> handles,
+ * 	to which the handles of the new variables are written, in the order of <code>kinds</code>.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, no variables are created, the contents of the array pointed to by <code>vars</code> are unspecified,
+ * 	and a negative value is returned, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to create the new variables.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			One of the elements of the array pointed to by <code>kinds</code> is not a valid kind handle.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The specified module is immutable.
+ *
+ * @sa #hilbert_var_create()
+ */
+int hilbert_var_create_n(HilbertModule * restrict module, size_t count, const HilbertHandle * restrict kinds,
+		HilbertHandle * restrict vars);
+
 /**
  * Returns the kind of a variable.
  *
@@ -489,6 +935,43 @@ HilbertHandle hilbert_var_getkind(HilbertModule * restrict module, HilbertHandle
  */
 HilbertHandle hilbert_functor_create(HilbertModule * restrict module, HilbertHandle rkind, size_t count, const HilbertHandle * restrict ikinds, int * restrict errcode);
 
+/**
+ * Creates several new functors.
+ * The module is locked only once, and either all functors are created or none.
+ *
+ * @param module Pointer to a Hilbert interface module in which the functors are to be created.
+ * @param count Number of functors to create.
+ * @param rkinds Pointer to the first element of an array of <code>count</code> non-variable kind handles,
+ * 	the result kinds of the new functors.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ * @param placecounts Pointer to the first element of an array of <code>count</code> place counts of the new functors.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ * @param ikinds Pointer to the first element of an array of kind handles,
+ * 	holding the input kinds of the first functor, followed by the input kinds of the second functor, and so on.
+ * 	The array has as many elements as the sum of the place counts.
+ * 	If this sum is zero, this may be <code>NULL</code>.
+ * @param functors Pointer to the first element of an array of <code>count</code> handles,
+ * 	to which the handles of the new functors are written, in the order of <code>rkinds</code>.
+ * 	If <code>count == 0</code>, this may be <code>NULL</code>.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, no functors are created, the contents of the array pointed to by <code>functors</code> are unspecified,
+ * 	and a negative value is returned, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to create the new functors.
+ * 		- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 			The module specified by <code>module</code> is not an interface module.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			One of the elements of the array pointed to by <code>rkinds</code> is not a non-variable kind handle,
+ * 			or one of the elements in the array pointed to by <code>ikinds</code> is not a kind handle.
+ *
+ * @sa #hilbert_functor_create()
+ */
+int hilbert_functor_create_n(HilbertModule * restrict module, size_t count, const HilbertHandle * restrict rkinds,
+		const size_t * restrict placecounts, const HilbertHandle * restrict ikinds, HilbertHandle * restrict functors);
+
 /**
  * Returns the result kind of a functor.
  *
@@ -526,6 +1009,285 @@ HilbertHandle hilbert_functor_getkind(HilbertModule * restrict module, HilbertHa
  */
 HilbertHandle * hilbert_functor_getinputkinds(HilbertModule * restrict module, HilbertHandle functor, size_t * restrict size, int * restrict errcode);
 
+/**
+ * Returns a read-only view of the input kinds of a functor.
+ * Unlike <code>#hilbert_functor_getinputkinds()</code>, this function does not allocate memory.
+ *
+ * @param module Pointer to the Hilbert module in which the functor resides.
+ * @param functor Functor handle.
+ * @param size Pointer to a location where the place count of the functor can be stored.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, <code>NULL</code> is returned, <code>*size</code> is unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>functor</code> is not a functor handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>, the place count of the functor is stored in <code>*size</code>,
+ * 	and a pointer to an array of size <code>*size</code> containing the input kind handles in proper order is returned.
+ * 	If the place count is zero, the returned pointer may be <code>NULL</code>.
+ * 	The array is owned by the module and remains valid until the module is freed. It must not be modified or freed.
+ */
+const HilbertHandle * hilbert_functor_getinputkinds_view(HilbertModule * restrict module, HilbertHandle functor,
+		size_t * restrict size, int * restrict errcode);
+
+/**
+ * Copies the input kinds of a functor to a caller-supplied buffer.
+ * Unlike <code>#hilbert_functor_getinputkinds()</code>, this function does not allocate memory.
+ *
+ * @param module Pointer to the Hilbert module in which the functor resides.
+ * @param functor Functor handle.
+ * @param buffer Pointer to the first element of an array of <code>bufsize</code> handles.
+ * 	If <code>bufsize == 0</code>, this may be <code>NULL</code>.
+ * @param bufsize Number of elements of the array pointed to by <code>buffer</code>.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value and the contents of the buffer are unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>functor</code> is not a functor handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>, and the place count of the functor is returned.
+ * 	The input kind handles are copied to the buffer in proper order, up to the size of the buffer.
+ * 	If the return value is larger than <code>bufsize</code>, the buffer was too small to hold all input kinds.
+ */
+size_t hilbert_functor_getinputkinds_buf(HilbertModule * restrict module, HilbertHandle functor,
+		HilbertHandle * restrict buffer, size_t bufsize, int * restrict errcode);
+
+/**
+ * Terms.
+ *
+ * A term is either a variable, or a functor applied to terms of the input kinds of the functor.
+ * Terms are identified by term handles, which form a namespace of their own, separate from object handles.
+ * Terms are hash-consed: building a term structurally equal to an existing term yields the handle of the existing term.
+ * Hence two terms of the same module are equal if and only if their handles are equal.
+ */
+
+/**
+ * Returns the term consisting of a single variable.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param var Variable handle.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to create the term.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>var</code> is not a variable handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the term handle is returned.
+ *
+ * @sa #hilbert_term_create()
+ */
+HilbertHandle hilbert_term_var(HilbertModule * restrict module, HilbertHandle var, int * restrict errcode);
+
+/**
+ * Returns the term obtained by applying a functor to argument terms.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param functor Functor handle.
+ * @param argc Number of arguments. Must match the place count of <code>functor</code>.
+ * @param argv Pointer to an array of <code>argc</code> term handles.
+ * 	The kind of each term must be equivalent to the corresponding input kind of <code>functor</code>.
+ * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to create the term.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>functor</code> is not a functor handle in <code>module</code>,
+ * 			or one of the elements of the array pointed to by <code>argv</code> is not a term handle in <code>module</code>.
+ * 		- <code>#HILBERT_ERR_COUNT_MISMATCH</code>:
+ * 			<code>argc</code> differs from the place count of <code>functor</code>.
+ * 		- <code>#HILBERT_ERR_KIND_MISMATCH</code>:
+ * 			The kind of one of the argument terms is not equivalent to the corresponding input kind of <code>functor</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the term handle is returned.
+ *
+ * @sa #hilbert_term_var()
+ */
+HilbertHandle hilbert_term_create(HilbertModule * restrict module, HilbertHandle functor, size_t argc,
+		const HilbertHandle * restrict argv, int * restrict errcode);
+
+/**
+ * Returns the kind of a term.
+ * This is the kind of the variable or the result kind of the functor at the head of the term.
+ *
+ * @param module Pointer to the Hilbert module in which the term resides.
+ * @param term Term handle.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>term</code> is not a term handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the kind handle is returned.
+ */
+HilbertHandle hilbert_term_getkind(HilbertModule * restrict module, HilbertHandle term, int * restrict errcode);
+
+/**
+ * Returns the head of a term, that is, its variable or its outermost functor.
+ *
+ * @param module Pointer to the Hilbert module in which the term resides.
+ * @param term Term handle.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>term</code> is not a term handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the variable or functor handle is returned.
+ */
+HilbertHandle hilbert_term_gethead(HilbertModule * restrict module, HilbertHandle term, int * restrict errcode);
+
+/**
+ * Returns a read-only view of the argument terms of a term.
+ *
+ * @param module Pointer to the Hilbert module in which the term resides.
+ * @param term Term handle.
+ * @param size Pointer to a location where the number of arguments can be stored.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, <code>NULL</code> is returned, <code>*size</code> is unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>term</code> is not a term handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>, the number of arguments is stored in <code>*size</code>,
+ * 	and a pointer to an array of size <code>*size</code> containing the argument term handles in proper order is returned.
+ * 	If there are no arguments, the returned pointer may be <code>NULL</code>.
+ * 	The array is owned by the module and remains valid until the module is freed. It must not be modified or freed.
+ */
+const HilbertHandle * hilbert_term_getargs_view(HilbertModule * restrict module, HilbertHandle term,
+		size_t * restrict size, int * restrict errcode);
+
+/**
+ * Statements.
+ *
+ * A statement consists of a number of hypotheses and a conclusion, each of which is a term.
+ * It asserts that the conclusion holds whenever the hypotheses hold.
+ * In interface modules, statements are axioms.
+ * In proof modules, they are theorems created by <code>#hilbert_theorem_create()</code>.
+ */
+
+/**
+ * Creates a new statement.
+ *
+ * @param module Pointer to a Hilbert interface module.
+ * @param hypc Number of hypotheses.
+ * @param hypv Pointer to an array of <code>hypc</code> term handles serving as hypotheses.
+ * 	If <code>hypc == 0</code>, this may be <code>NULL</code>.
+ * @param conclusion Term handle of the conclusion.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to create the statement.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 			The module pointed to by <code>module</code> is not an interface module.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>conclusion</code> or one of the elements of the array pointed to by <code>hypv</code>
+ * 			is not a term handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the statement handle is returned.
+ */
+HilbertHandle hilbert_statement_create(HilbertModule * restrict module, size_t hypc, const HilbertHandle * restrict hypv,
+		HilbertHandle conclusion, int * restrict errcode);
+
+/**
+ * Returns the conclusion of a statement.
+ *
+ * @param module Pointer to the Hilbert module in which the statement resides.
+ * @param statement Statement handle.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, and a negative value is stored in <code>*errcode</code>,
+ * 	which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>statement</code> is not a statement handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the term handle of the conclusion is returned.
+ */
+HilbertHandle hilbert_statement_getconclusion(HilbertModule * restrict module, HilbertHandle statement,
+		int * restrict errcode);
+
+/**
+ * Returns a read-only view of the hypotheses of a statement.
+ *
+ * @param module Pointer to the Hilbert module in which the statement resides.
+ * @param statement Statement handle.
+ * @param size Pointer to a location where the number of hypotheses can be stored.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, <code>NULL</code> is returned, <code>*size</code> is unspecified,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>statement</code> is not a statement handle in <code>module</code>.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>, the number of hypotheses is stored in <code>*size</code>,
+ * 	and a pointer to an array of size <code>*size</code> containing the term handles of the hypotheses in proper order
+ * 	is returned. If there are no hypotheses, the returned pointer may be <code>NULL</code>.
+ * 	The array is owned by the module and remains valid until the module is freed. It must not be modified or freed.
+ */
+const HilbertHandle * hilbert_statement_gethyps_view(HilbertModule * restrict module, HilbertHandle statement,
+		size_t * restrict size, int * restrict errcode);
+
+/**
+ * Proofs.
+ *
+ * In proof modules, statements are theorems, each of which is created together with a proof checked by the library.
+ * A proof is an array of steps operating on a stack, whose entries are either facts or substitution values.
+ * A step of type <code>#HILBERT_STEP_HYP</code> pushes a hypothesis of the theorem as a fact,
+ * and a step of type <code>#HILBERT_STEP_TERM</code> pushes a term as a substitution value.
+ * A step of type <code>#HILBERT_STEP_APPLY</code> applies a statement with <code>n</code> hypotheses as follows.
+ * The topmost <code>n</code> entries must be facts, and the hypotheses of the statement must match them in order,
+ * the last hypothesis matching the topmost entry. Matching instantiates the variables of the hypotheses.
+ * The variables occurring only in the conclusion of the statement, ordered by their first occurrence
+ * in a left-to-right traversal of the conclusion, are instantiated with the substitution values below the facts,
+ * the last variable with the topmost value.
+ * A variable can only be instantiated with a term of equivalent kind.
+ * These entries are popped, and the instance of the conclusion is pushed as a fact.
+ * The proof is correct if it leaves a single entry on the stack, which is a fact equal to the conclusion of the theorem.
+ */
+
+/**
+ * Checks a proof and creates a new theorem.
+ *
+ * Proofs are checked by comparing term handles only, so that the time taken by each step depends on the size
+ * of the applied statement, but not on the size of the terms substituted into it.
+ *
+ * @param module Pointer to a Hilbert proof module.
+ * @param hypc Number of hypotheses.
+ * @param hypv Pointer to an array of <code>hypc</code> term handles serving as hypotheses.
+ * 	If <code>hypc == 0</code>, this may be <code>NULL</code>.
+ * @param conclusion Term handle of the conclusion.
+ * @param stepc Number of proof steps.
+ * @param stepv Pointer to an array of <code>stepc</code> proof steps.
+ * 	If <code>stepc == 0</code>, this may be <code>NULL</code>.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On error, the return value is unspecified, the module remains unchanged,
+ * 	and a negative value is stored in <code>*errcode</code>, which may be one of the following error codes:
+ * 		- <code>#HILBERT_ERR_NOMEM</code>:
+ * 			There was not enough memory available to check the proof or to create the theorem.
+ * 		- <code>#HILBERT_ERR_IMMUTABLE</code>:
+ * 			The module pointed to by <code>module</code> is immutable.
+ * 		- <code>#HILBERT_ERR_INVALID_MODULE</code>:
+ * 			The module pointed to by <code>module</code> is not a proof module.
+ * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
+ * 			<code>conclusion</code> or one of the elements of the array pointed to by <code>hypv</code>
+ * 			is not a term handle in <code>module</code>, or the handle of one of the proof steps
+ * 			is not a hypothesis index, term handle or statement handle, as required by the step type.
+ * 		- <code>#HILBERT_ERR_INVALID_PROOF</code>:
+ * 			The proof is incorrect.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code> and the statement handle of the theorem is returned.
+ */
+HilbertHandle hilbert_theorem_create(HilbertModule * restrict module, size_t hypc, const HilbertHandle * restrict hypv,
+		HilbertHandle conclusion, size_t stepc, const HilbertProofStep * restrict stepv, int * restrict errcode);
+
 /**
  * Parameterises a Hilbert interface module with another Hilbert interface module.
  *
@@ -535,7 +1297,10 @@ HilbertHandle * hilbert_functor_getinputkinds(HilbertModule * restrict module, H
  * @param argv Pointer to an array of parameter handles serving as arguments to <code>src</code>.
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param mapper User-provided callback function mapping objects coming from the parameters of <code>src</code> to the argument objects.
- * 	The callback is only called for kinds and functors external to <code>src</code>.
+ * 	The callback is only called for kinds, functors and statements external to <code>src</code>.
+ * 	The statements of <code>src</code> which are not external are carried over, together with fresh variables
+ * 	standing in for their variables.
+ * 	It may query, but not modify, the module pointed to by <code>dest</code> (see <code>#HilbertMapperCallback</code>).
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param userdata Pointer to user-defined data. It is passed as an argument to the userdata parameter of <code>mapper</code>, and is otherwise ignored.
  * @param errcode Pointer to an integer to convey an error code.
@@ -555,7 +1320,8 @@ HilbertHandle * hilbert_functor_getinputkinds(HilbertModule * restrict module, H
  * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
  * 			One of the handles in the array pointed to by <code>argv</code> is not a valid parameter handle.
  * 		- <code>#HILBERT_ERR_INVALID_MAPPING</code>:
- * 			The <code>mapper</code> callback function returned an invalid object handle.
+ * 			The <code>mapper</code> callback function returned an invalid object handle,
+ * 			or a statement carried over does not fit the kinds of the mapped functors.
  * 		- <code>#HILBERT_ERR_MAPPING_CLASH</code>:
  * 			The <code>mapper</code> callback function returned the same object handle for different source objects.
  * 	On success, <code>0</code> is stored in <code>*errcode</code>, and a handle for the new parameter is returned.
@@ -571,7 +1337,10 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
  * @param argv Pointer to an array of parameter handles serving as arguments to the module pointed to by <code>src</code>.
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param mapper User-provided callback function mapping objects coming from the parameters of the module pointed to by <code>src</code> to the argument objects.
- * 	The callback is only called for kinds, functors and statements <!--FIXME--> external to the module pointed to by <code>src</code>.
+ * 	The callback is only called for kinds, functors and statements external to the module pointed to by <code>src</code>.
+ * 	The statements of the module pointed to by <code>src</code> which are not external are carried over,
+ * 	together with fresh variables standing in for their variables.
+ * 	It may query, but not modify, the module pointed to by <code>dest</code> (see <code>#HilbertMapperCallback</code>).
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param userdata Pointer to user-defined data. It is passed as an argument to the userdata parameter of <code>mapper</code>, and is otherwise ignored.
  * @param errcode Pointer to an integer to convey an error code.
@@ -591,7 +1360,8 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
  * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
  * 			One of the handles in the array pointed to by <code>argv</code> is not a valid parameter handle.
  * 		- <code>#HILBERT_ERR_INVALID_MAPPING</code>:
- * 			The <code>mapper</code> callback function returned an invalid object handle.
+ * 			The <code>mapper</code> callback function returned an invalid object handle,
+ * 			or a statement carried over does not fit the kinds of the mapped functors.
  * 		- <code>#HILBERT_ERR_MAPPING_CLASH</code>:
  * 			The <code>mapper</code> callback function returned the same object handle for different source objects.
  * 	On success, <code>0</code> is stored in <code>*errcode</code>, and a handle for the new parameter is returned.
@@ -609,7 +1379,10 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param mapper User-provided callback function mapping objects from the module pointed to by <code>src</code> to the
  * 	objects in the module pointed to by <code>dest</code>.
- * 	The callback is called for kinds, functors and statements <!--FIXME-->.
+ * 	The callback is called for kinds, functors and statements.
+ * 	A statement must be mapped to a statement whose hypotheses and conclusion are those of the source statement
+ * 	up to the mapping and an injective renaming of variables to variables of equivalent kinds.
+ * 	It may query, but not modify, the module pointed to by <code>dest</code> (see <code>#HilbertMapperCallback</code>).
  * 	If <code>argc == 0</code>, this may be <code>NULL</code>.
  * @param userdata Pointer to user-defined data.
  * 	It is passed as an argument to the userdata parameter of <code>mapper</code>, and is otherwise ignored.
@@ -631,7 +1404,8 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
  * 		- <code>#HILBERT_ERR_INVALID_HANDLE</code>:
  * 			One of the handles in the array pointed to by <code>argv</code> is not a valid parameter handle.
  * 		- <code>#HILBERT_ERR_INVALID_MAPPING</code>:
- * 			The <code>mapper</code> callback function returned an invalid object handle.
+ * 			The <code>mapper</code> callback function returned an invalid object handle,
+ * 			or mapped a statement to a statement which does not match it.
  * 		- <code>#HILBERT_ERR_MAPPING_CLASH</code>:
  * 			The <code>mapper</code> callback function returned the same object handle
  * 			for different source objects.
@@ -669,6 +1443,26 @@ HilbertHandle hilbert_module_export(HilbertModule * restrict dest, HilbertModule
  */
 HilbertHandle * hilbert_module_getobjects(HilbertModule * restrict module, size_t * restrict size, int * restrict errcode);
 
+/**
+ * Copies the objects of a Hilbert module to a caller-supplied buffer.
+ * Unlike <code>#hilbert_module_getobjects()</code>, this function does not allocate memory.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param buffer Pointer to the first element of an array of <code>bufsize</code> handles.
+ * 	If <code>bufsize == 0</code>, this may be <code>NULL</code>.
+ * @param bufsize Number of elements of the array pointed to by <code>buffer</code>.
+ * @param errcode Pointer to a location where an integer error code can be stored.
+ *
+ * @return On error, a negative value is stored in <code>*errcode</code>,
+ * 	and the return value and the contents of the buffer are unspecified.
+ * 	On success, <code>0</code> is stored in <code>*errcode</code>, and the number of objects in the module is returned.
+ * 	The first handles of the objects, in the same order as with <code>#hilbert_module_getobjects()</code>,
+ * 	are copied to the buffer, up to the size of the buffer.
+ * 	If the return value is larger than <code>bufsize</code>, the buffer was too small to hold all handles.
+ */
+size_t hilbert_module_getobjects_buf(HilbertModule * restrict module, HilbertHandle * restrict buffer, size_t bufsize,
+		int * restrict errcode);
+
 /**
  * Returns the type flags of the object with the specified handle.
  *
@@ -0,0 +1,1147 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#include"private.h"
+#include"image.h"
+#include"param.h"
+
+#include<assert.h>
+#include<fcntl.h>
+#include<stdint.h>
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#include"cl/arena.h"
+#include"cl/ivector.h"
+#include"cl/otable.h"
+#include"cl/pmap.h"
+#include"cl/tstore.h"
+#include"cl/ufind.h"
+
+#include"threads/hthreads.h"
+
+/**
+ * Number of bytes buffered by an image writer.
+ */
+#define IMAGE_WRITER_BUFSIZE 8192
+
+/**
+ * Upper bound for the counts in an image header.
+ * It keeps the image size computation free of overflows.
+ */
+#define IMAGE_MAXCOUNT (SIZE_MAX / 256)
+
+/**
+ * Buffered writer for module images.
+ */
+struct ImageWriter {
+	/**
+	 * Stream to which the image is written.
+	 */
+	FILE * stream;
+
+	/**
+	 * Number of buffered bytes.
+	 */
+	size_t used;
+
+	/**
+	 * Error code of the first failed write, or <code>0</code>.
+	 */
+	int errcode;
+
+	/**
+	 * Buffered bytes.
+	 */
+	unsigned char buffer[IMAGE_WRITER_BUFSIZE];
+};
+
+/**
+ * Pointers to the sections of a module image.
+ */
+struct ImageSections {
+	/**
+	 * Object count, kind count and functor count of each dependency.
+	 */
+	size_t * deps;
+
+	/**
+	 * Object types.
+	 */
+	unsigned int * types;
+
+	/**
+	 * Object kinds.
+	 */
+	size_t * kinds;
+
+	/**
+	 * Object parameter indices.
+	 */
+	size_t * paramindices;
+
+	/**
+	 * Object equivalence class indices.
+	 */
+	size_t * eqcindices;
+
+	/**
+	 * Kind handles.
+	 */
+	HilbertHandle * kindhandles;
+
+	/**
+	 * Equivalence class roots.
+	 */
+	size_t * eqcroots;
+
+	/**
+	 * Equivalence class ranges.
+	 */
+	struct EqcRange * eqcranges;
+
+	/**
+	 * Kind handles grouped by equivalence class.
+	 */
+	HilbertHandle * eqckinds;
+
+	/**
+	 * Variable handles.
+	 */
+	HilbertHandle * varhandles;
+
+	/**
+	 * Functor handles.
+	 */
+	HilbertHandle * functorhandles;
+
+	/**
+	 * Functor place counts.
+	 */
+	size_t * placecounts;
+
+	/**
+	 * Functor input kinds.
+	 */
+	HilbertHandle * inputkinds;
+
+	/**
+	 * Term heads.
+	 */
+	HilbertHandle * termheads;
+
+	/**
+	 * Term argument counts.
+	 */
+	size_t * termargcounts;
+
+	/**
+	 * Term arguments.
+	 */
+	HilbertHandle * termargs;
+
+	/**
+	 * Statement handles.
+	 */
+	HilbertHandle * statementhandles;
+
+	/**
+	 * Statement hypothesis counts.
+	 */
+	size_t * hypcounts;
+
+	/**
+	 * Statement conclusions.
+	 */
+	HilbertHandle * conclusions;
+
+	/**
+	 * Statement hypotheses.
+	 */
+	HilbertHandle * hyps;
+
+	/**
+	 * Parameter handles.
+	 */
+	HilbertHandle * paramhandles;
+
+	/**
+	 * Parameter dependency indices.
+	 */
+	size_t * paramdeps;
+
+	/**
+	 * Parameter handle map sizes.
+	 */
+	size_t * mapcounts;
+
+	/**
+	 * Parameter handle map entries.
+	 */
+	HilbertHandle * mapentries;
+};
+
+/**
+ * Writes out the buffered bytes of an image writer.
+ *
+ * @param writer Pointer to an image writer.
+ */
+static void image_flush(struct ImageWriter * writer) {
+	if ((writer->used != 0) && (fwrite(writer->buffer, 1, writer->used, writer->stream) != writer->used))
+		writer->errcode = HILBERT_ERR_IO;
+	writer->used = 0;
+}
+
+/**
+ * Appends data to an image.
+ *
+ * @param writer Pointer to an image writer.
+ * @param data Pointer to the data to be appended.
+ * @param size Size of the data in bytes.
+ */
+static void image_write(struct ImageWriter * writer, const void * data, size_t size) {
+	const unsigned char * bytes = data;
+
+	while (size != 0) {
+		if (writer->used == IMAGE_WRITER_BUFSIZE)
+			image_flush(writer);
+		size_t chunk = IMAGE_WRITER_BUFSIZE - writer->used;
+		if (chunk > size)
+			chunk = size;
+		memcpy(writer->buffer + writer->used, bytes, chunk);
+		writer->used += chunk;
+		bytes += chunk;
+		size -= chunk;
+	}
+}
+
+/**
+ * Appends a word to an image.
+ *
+ * @param writer Pointer to an image writer.
+ * @param word Word to be appended.
+ */
+static void image_put(struct ImageWriter * writer, size_t word) {
+	image_write(writer, &word, sizeof(word));
+}
+
+/**
+ * Writes the handles of a handle vector to an image.
+ *
+ * @param writer Pointer to an image writer.
+ * @param vector Pointer to a handle vector.
+ */
+static void image_puthandles(struct ImageWriter * writer, const IndexVector * vector) {
+	size_t count = hilbert_ivector_count(vector);
+	for (size_t i = 0; i != count; ++i)
+		image_put(writer, hilbert_ivector_get(vector, i));
+}
+
+/**
+ * Returns the number of words taken up by the object type section of an image.
+ *
+ * @param objectcount Number of objects.
+ *
+ * @return The number of words taken up by <code>objectcount</code> object types, including padding.
+ */
+static size_t image_typewords(size_t objectcount) {
+	return (objectcount * sizeof(unsigned int) + sizeof(size_t) - 1) / sizeof(size_t);
+}
+
+int hilbert_module_save(struct HilbertModule * restrict module, FILE * restrict stream) {
+	assert (module != NULL);
+	assert (stream != NULL);
+
+	int errcode;
+	struct ImageWriter * writer;
+
+	if (hilbert_module_gettype(module) != HILBERT_INTERFACE_MODULE) {
+		errcode = HILBERT_ERR_INVALID_MODULE;
+		goto invalidmodule;
+	}
+
+	/* immutable modules are read without locking */
+	if (!atomic_load_explicit(&module->immutable, memory_order_acquire)) {
+		errcode = HILBERT_ERR_IMMUTABLE;
+		goto mutable;
+	}
+
+	writer = malloc(sizeof(*writer));
+	if (writer == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nowritermem;
+	}
+	*writer = (struct ImageWriter) { .stream = stream, .used = 0, .errcode = 0 };
+
+	/* number dependencies in order of first use */
+	size_t objectcount = cl_otable_count(module->objects);
+	size_t kindcount = hilbert_ivector_count(module->kindhandles);
+	size_t functorcount = hilbert_ivector_count(module->functorhandles);
+	size_t statementcount = hilbert_ivector_count(module->statementhandles);
+	size_t paramcount = hilbert_ivector_count(module->paramhandles);
+	size_t termcount = cl_tstore_count(module->terms);
+	struct HilbertModule ** deps = malloc((paramcount + 1) * sizeof(*deps));
+	if (deps == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nodepsmem;
+	}
+	size_t * paramdeps = malloc((paramcount + 1) * sizeof(*paramdeps));
+	if (paramdeps == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noparamdepsmem;
+	}
+	size_t depcount = 0;
+	size_t mapentrycount = 0;
+	for (size_t i = 0; i != paramcount; ++i) {
+		struct Param * param = &cl_otable_record(module->objects, hilbert_ivector_get(module->paramhandles, i))->param;
+		size_t j;
+		for (j = 0; (j != depcount) && (deps[j] != param->module); ++j);
+		if (j == depcount)
+			deps[depcount++] = param->module;
+		paramdeps[i] = j;
+		mapentrycount += hilbert_pmap_count(param->handle_map);
+	}
+	size_t inputkindcount = 0;
+	for (size_t i = 0; i != functorcount; ++i)
+		inputkindcount += cl_otable_record(module->objects, hilbert_ivector_get(module->functorhandles, i))
+				->basic_functor.place_count;
+	size_t termargcount = 0;
+	for (size_t i = 0; i != termcount; ++i)
+		termargcount += cl_tstore_get(module->terms, i)->argc;
+	size_t hypcount = 0;
+	for (size_t i = 0; i != statementcount; ++i)
+		hypcount += cl_otable_record(module->objects, hilbert_ivector_get(module->statementhandles, i))
+				->statement.hypcount;
+
+	/* header */
+	struct ImageHeader header = {
+		.version = HILBERT_IMAGE_VERSION,
+		.byteorder = HILBERT_IMAGE_BYTEORDER,
+		.wordsize = sizeof(size_t),
+		.typesize = sizeof(unsigned int),
+		.objectcount = objectcount,
+		.kindcount = kindcount,
+		.varcount = hilbert_ivector_count(module->varhandles),
+		.functorcount = functorcount,
+		.statementcount = statementcount,
+		.paramcount = paramcount,
+		.inputkindcount = inputkindcount,
+		.termcount = termcount,
+		.termargcount = termargcount,
+		.hypcount = hypcount,
+		.mapentrycount = mapentrycount,
+		.dependencycount = depcount
+	};
+	memcpy(header.magic, HILBERT_IMAGE_MAGIC, sizeof(header.magic));
+	image_write(writer, &header, sizeof(header));
+
+	/* dependencies */
+	for (size_t i = 0; i != depcount; ++i) {
+		image_put(writer, cl_otable_count(deps[i]->objects));
+		image_put(writer, hilbert_ivector_count(deps[i]->kindhandles));
+		image_put(writer, hilbert_ivector_count(deps[i]->functorhandles));
+	}
+
+	/* objects */
+	for (size_t i = 0; i != objectcount; ++i) {
+		unsigned int type = cl_otable_type(module->objects, i);
+		image_write(writer, &type, sizeof(type));
+	}
+	for (size_t i = objectcount * sizeof(unsigned int); i != image_typewords(objectcount) * sizeof(size_t); ++i)
+		image_write(writer, "", 1);
+	for (size_t i = 0; i != objectcount; ++i)
+		image_put(writer, cl_otable_kind(module->objects, i));
+	for (size_t i = 0; i != objectcount; ++i)
+		image_put(writer, cl_otable_paramindex(module->objects, i));
+	for (size_t i = 0; i != objectcount; ++i)
+		image_put(writer, cl_otable_eqcindex(module->objects, i));
+
+	/* kinds and variables */
+	image_puthandles(writer, module->kindhandles);
+	for (size_t i = 0; i != kindcount; ++i)
+		image_put(writer, cl_ufind_find_readonly(module->kindeqc, i));
+	for (size_t i = 0; i != kindcount; ++i) {
+		image_put(writer, module->eqcranges[i].first);
+		image_put(writer, module->eqcranges[i].count);
+	}
+	for (size_t i = 0; i != kindcount; ++i)
+		image_put(writer, module->eqckinds[i]);
+	image_puthandles(writer, module->varhandles);
+
+	/* functors */
+	image_puthandles(writer, module->functorhandles);
+	for (size_t i = 0; i != functorcount; ++i)
+		image_put(writer, cl_otable_record(module->objects, hilbert_ivector_get(module->functorhandles, i))
+				->basic_functor.place_count);
+	for (size_t i = 0; i != functorcount; ++i) {
+		const struct BasicFunctor * functor = &cl_otable_record(module->objects,
+				hilbert_ivector_get(module->functorhandles, i))->basic_functor;
+		const HilbertHandle * inputkinds = hilbert_functor_inputkinds(functor);
+		for (size_t j = 0; j != functor->place_count; ++j)
+			image_put(writer, inputkinds[j]);
+	}
+
+	/* terms */
+	for (size_t i = 0; i != termcount; ++i)
+		image_put(writer, cl_tstore_get(module->terms, i)->head);
+	for (size_t i = 0; i != termcount; ++i)
+		image_put(writer, cl_tstore_get(module->terms, i)->argc);
+	for (size_t i = 0; i != termcount; ++i) {
+		const struct Term * term = cl_tstore_get(module->terms, i);
+		for (size_t j = 0; j != term->argc; ++j)
+			image_put(writer, term->args[j]);
+	}
+
+	/* statements */
+	image_puthandles(writer, module->statementhandles);
+	for (size_t i = 0; i != statementcount; ++i)
+		image_put(writer, cl_otable_record(module->objects, hilbert_ivector_get(module->statementhandles, i))
+				->statement.hypcount);
+	for (size_t i = 0; i != statementcount; ++i)
+		image_put(writer, cl_otable_record(module->objects, hilbert_ivector_get(module->statementhandles, i))
+				->statement.conclusion);
+	for (size_t i = 0; i != statementcount; ++i) {
+		const struct Statement * statement = &cl_otable_record(module->objects,
+				hilbert_ivector_get(module->statementhandles, i))->statement;
+		for (size_t j = 0; j != statement->hypcount; ++j)
+			image_put(writer, statement->hyps[j]);
+	}
+
+	/* parameters */
+	image_puthandles(writer, module->paramhandles);
+	for (size_t i = 0; i != paramcount; ++i)
+		image_put(writer, paramdeps[i]);
+	for (size_t i = 0; i != paramcount; ++i)
+		image_put(writer, hilbert_pmap_count(cl_otable_record(module->objects,
+				hilbert_ivector_get(module->paramhandles, i))->param.handle_map));
+	for (size_t i = 0; i != paramcount; ++i) {
+		ParamMap * map = cl_otable_record(module->objects, hilbert_ivector_get(module->paramhandles, i))->param.handle_map;
+		for (ParamMapIterator j = hilbert_pmap_iterator_new(map); hilbert_pmap_iterator_hasnext(&j);) {
+			struct ParamMapEntry entry = hilbert_pmap_iterator_next(&j);
+			image_put(writer, entry.pre);
+			image_put(writer, entry.post);
+		}
+	}
+
+	image_flush(writer);
+	errcode = writer->errcode;
+
+	free(paramdeps);
+noparamdepsmem:
+	free(deps);
+nodepsmem:
+	free(writer);
+nowritermem:
+mutable:
+invalidmodule:
+	return errcode;
+}
+
+/**
+ * Checks whether an object type read from an image is valid.
+ *
+ * @param type Object type.
+ *
+ * @return If <code>type</code> is a valid object type, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static int image_type_isvalid(unsigned int type) {
+	switch (type & ~HILBERT_TYPE_EXTERNAL) {
+		case HILBERT_TYPE_KIND:
+		case HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND:
+		case HILBERT_TYPE_FUNCTOR:
+		case HILBERT_TYPE_STATEMENT:
+			return 1;
+		case HILBERT_TYPE_VAR:
+		case HILBERT_TYPE_PARAM:
+			return !(type & HILBERT_TYPE_EXTERNAL);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Checks the header of a module image.
+ *
+ * @param header Pointer to an image header.
+ * @param size Pointer to a location where the size of the image in bytes, including the header, is stored on success.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	If the header is not valid for this host, <code>#HILBERT_ERR_INVALID_IMAGE</code> is returned.
+ */
+static int image_checkheader(const struct ImageHeader * header, size_t * size) {
+	if ((memcmp(header->magic, HILBERT_IMAGE_MAGIC, sizeof(header->magic)) != 0)
+			|| (header->version != HILBERT_IMAGE_VERSION) || (header->byteorder != HILBERT_IMAGE_BYTEORDER)
+			|| (header->wordsize != sizeof(size_t)) || (header->typesize != sizeof(unsigned int)))
+		return HILBERT_ERR_INVALID_IMAGE;
+	if ((header->objectcount > IMAGE_MAXCOUNT) || (header->kindcount > IMAGE_MAXCOUNT)
+			|| (header->varcount > IMAGE_MAXCOUNT) || (header->functorcount > IMAGE_MAXCOUNT)
+			|| (header->statementcount > IMAGE_MAXCOUNT) || (header->paramcount > IMAGE_MAXCOUNT)
+			|| (header->inputkindcount > IMAGE_MAXCOUNT) || (header->termcount > IMAGE_MAXCOUNT)
+			|| (header->termargcount > IMAGE_MAXCOUNT) || (header->hypcount > IMAGE_MAXCOUNT)
+			|| (header->mapentrycount > IMAGE_MAXCOUNT) || (header->dependencycount > IMAGE_MAXCOUNT)
+			|| (header->kindcount + header->varcount + header->functorcount + header->statementcount
+				+ header->paramcount != header->objectcount))
+		return HILBERT_ERR_INVALID_IMAGE;
+
+	size_t words = 3 * header->dependencycount + image_typewords(header->objectcount) + 3 * header->objectcount
+			+ 5 * header->kindcount + header->varcount + 2 * header->functorcount + header->inputkindcount
+			+ 2 * header->termcount + header->termargcount + 3 * header->statementcount + header->hypcount
+			+ 3 * header->paramcount + 2 * header->mapentrycount;
+	*size = sizeof(*header) + words * sizeof(size_t);
+
+	return 0;
+}
+
+/**
+ * Locates the sections of a module image.
+ *
+ * @param sections Pointer to a structure in which the section pointers are stored.
+ * @param image Pointer to a suitably aligned module image with a valid header.
+ */
+static void image_locate(struct ImageSections * sections, void * image) {
+	const struct ImageHeader * header = image;
+	size_t * word = (size_t *) ((unsigned char *) image + sizeof(*header));
+
+	/* equivalence class ranges are stored as pairs of words */
+	assert (sizeof(struct EqcRange) == 2 * sizeof(size_t));
+
+	sections->deps = word;
+	word += 3 * header->dependencycount;
+	sections->types = (unsigned int *) word;
+	word += image_typewords(header->objectcount);
+	sections->kinds = word;
+	word += header->objectcount;
+	sections->paramindices = word;
+	word += header->objectcount;
+	sections->eqcindices = word;
+	word += header->objectcount;
+	sections->kindhandles = word;
+	word += header->kindcount;
+	sections->eqcroots = word;
+	word += header->kindcount;
+	sections->eqcranges = (struct EqcRange *) word;
+	word += 2 * header->kindcount;
+	sections->eqckinds = word;
+	word += header->kindcount;
+	sections->varhandles = word;
+	word += header->varcount;
+	sections->functorhandles = word;
+	word += header->functorcount;
+	sections->placecounts = word;
+	word += header->functorcount;
+	sections->inputkinds = word;
+	word += header->inputkindcount;
+	sections->termheads = word;
+	word += header->termcount;
+	sections->termargcounts = word;
+	word += header->termcount;
+	sections->termargs = word;
+	word += header->termargcount;
+	sections->statementhandles = word;
+	word += header->statementcount;
+	sections->hypcounts = word;
+	word += header->statementcount;
+	sections->conclusions = word;
+	word += header->statementcount;
+	sections->hyps = word;
+	word += header->hypcount;
+	sections->paramhandles = word;
+	word += header->paramcount;
+	sections->paramdeps = word;
+	word += header->paramcount;
+	sections->mapcounts = word;
+	word += header->paramcount;
+	sections->mapentries = word;
+}
+
+/**
+ * Checks the dependencies supplied for a module image.
+ *
+ * @param header Pointer to a valid image header.
+ * @param sections Pointer to the sections of the image.
+ * @param depc Number of dependencies.
+ * @param depv Pointer to the first element of an array of <code>depc</code> module pointers.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>#HILBERT_ERR_COUNT_MISMATCH</code>, <code>#HILBERT_ERR_INVALID_MODULE</code>
+ * 	or <code>#HILBERT_ERR_IMMUTABLE</code> is returned, as described in <code>#hilbert_module_load()</code>.
+ */
+static int image_checkdeps(const struct ImageHeader * header, const struct ImageSections * sections, size_t depc,
+		HilbertModule * const * depv) {
+	if (depc != header->dependencycount)
+		return HILBERT_ERR_COUNT_MISMATCH;
+
+	for (size_t i = 0; i != depc; ++i) {
+		if (hilbert_module_gettype(depv[i]) != HILBERT_INTERFACE_MODULE)
+			return HILBERT_ERR_INVALID_MODULE;
+		/* immutable modules are read without locking */
+		if (!atomic_load_explicit(&depv[i]->immutable, memory_order_acquire))
+			return HILBERT_ERR_IMMUTABLE;
+		if ((sections->deps[3 * i] != cl_otable_count(depv[i]->objects))
+				|| (sections->deps[3 * i + 1] != hilbert_ivector_count(depv[i]->kindhandles))
+				|| (sections->deps[3 * i + 2] != hilbert_ivector_count(depv[i]->functorhandles)))
+			return HILBERT_ERR_INVALID_MODULE;
+	}
+
+	return 0;
+}
+
+/**
+ * Checks that a handle list of a module image is strictly increasing and refers to objects of a given type.
+ *
+ * @param handles Pointer to the first element of an array of <code>count</code> handles.
+ * @param count Number of handles.
+ * @param types Pointer to the object types of the image.
+ * @param objectcount Number of objects of the image.
+ * @param mask Type flags to be compared.
+ * @param type Required type flags after masking with <code>mask</code>.
+ *
+ * @return If the handle list is valid, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static int image_checkhandles(const HilbertHandle * handles, size_t count, const unsigned int * types,
+		size_t objectcount, unsigned int mask, unsigned int type) {
+	for (size_t i = 0; i != count; ++i) {
+		if ((handles[i] >= objectcount) || ((i != 0) && (handles[i] <= handles[i - 1]))
+				|| ((types[handles[i]] & mask) != type))
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * Validates the sections of a module image.
+ * Afterwards, every index stored in the image is known to be in range,
+ * so that a module can read the image in place.
+ *
+ * @param header Pointer to a valid image header.
+ * @param sections Pointer to the sections of the image.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>#HILBERT_ERR_INVALID_IMAGE</code> or <code>#HILBERT_ERR_NOMEM</code> is returned.
+ */
+static int image_validate(const struct ImageHeader * header, const struct ImageSections * sections) {
+	size_t objectcount = header->objectcount;
+	size_t kindcount = header->kindcount;
+	size_t functorcount = header->functorcount;
+	size_t paramcount = header->paramcount;
+	size_t inputkindcount = header->inputkindcount;
+	size_t mapentrycount = header->mapentrycount;
+	const unsigned int * types = sections->types;
+	const size_t * roots = sections->eqcroots;
+	int errcode = HILBERT_ERR_INVALID_IMAGE;
+
+	/* objects */
+	for (size_t i = 0; i != objectcount; ++i) {
+		unsigned int type = types[i];
+		if (!image_type_isvalid(type))
+			goto invalid;
+		if (type & HILBERT_TYPE_EXTERNAL) {
+			if (sections->paramindices[i] >= paramcount)
+				goto invalid;
+		} else if (sections->paramindices[i] != 0) {
+			goto invalid;
+		}
+		if ((type & HILBERT_TYPE_KIND) ? (sections->eqcindices[i] >= kindcount) : (sections->eqcindices[i] != 0))
+			goto invalid;
+		if (type & (HILBERT_TYPE_VAR | HILBERT_TYPE_FUNCTOR)) {
+			size_t kind = sections->kinds[i];
+			if ((kind >= objectcount) || !(types[kind] & HILBERT_TYPE_KIND))
+				goto invalid;
+			if ((type & HILBERT_TYPE_FUNCTOR) && (types[kind] & HILBERT_TYPE_VKIND))
+				goto invalid;
+		} else if (sections->kinds[i] != 0) {
+			goto invalid;
+		}
+	}
+	/* kinds and their equivalence classes */
+	if (!image_checkhandles(sections->kindhandles, kindcount, types, objectcount, HILBERT_TYPE_KIND, HILBERT_TYPE_KIND))
+		goto invalid;
+	for (size_t i = 0; i != kindcount; ++i) {
+		if (sections->eqcindices[sections->kindhandles[i]] != i)
+			goto invalid;
+		if ((roots[i] >= kindcount) || (roots[roots[i]] != roots[i])
+				|| ((types[sections->kindhandles[i]] ^ types[sections->kindhandles[roots[i]]]) & HILBERT_TYPE_VKIND))
+			goto invalid;
+	}
+	size_t * classsizes = calloc(kindcount + 1, sizeof(*classsizes));
+	if (classsizes == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noclasssizesmem;
+	}
+	unsigned char * seen = calloc(kindcount + 1, sizeof(*seen));
+	if (seen == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noseenmem;
+	}
+	for (size_t i = 0; i != kindcount; ++i)
+		++classsizes[roots[i]];
+	for (size_t i = 0; i != kindcount; ++i) {
+		struct EqcRange range = sections->eqcranges[i];
+		struct EqcRange rootrange = sections->eqcranges[roots[i]];
+		if ((range.first != rootrange.first) || (range.count != rootrange.count)
+				|| (range.count != classsizes[roots[i]]) || (range.first > kindcount - range.count))
+			goto invalideqc;
+		if (roots[i] != i)
+			continue;
+		/* each class member exactly once */
+		for (size_t j = 0; j != range.count; ++j) {
+			HilbertHandle kind = sections->eqckinds[range.first + j];
+			if ((kind >= objectcount) || !(types[kind] & HILBERT_TYPE_KIND))
+				goto invalideqc;
+			size_t eqcindex = sections->eqcindices[kind];
+			if ((roots[eqcindex] != i) || seen[eqcindex])
+				goto invalideqc;
+			seen[eqcindex] = 1;
+		}
+	}
+	free(seen);
+	free(classsizes);
+
+	/* variables */
+	if (!image_checkhandles(sections->varhandles, header->varcount, types, objectcount, ~0u, HILBERT_TYPE_VAR))
+		goto invalid;
+
+	/* functors */
+	if (!image_checkhandles(sections->functorhandles, functorcount, types, objectcount,
+				HILBERT_TYPE_FUNCTOR, HILBERT_TYPE_FUNCTOR))
+		goto invalid;
+	size_t placecountsum = 0;
+	for (size_t i = 0; i != functorcount; ++i) {
+		if (sections->placecounts[i] > inputkindcount - placecountsum)
+			goto invalid;
+		placecountsum += sections->placecounts[i];
+	}
+	if (placecountsum != inputkindcount)
+		goto invalid;
+	for (size_t i = 0; i != inputkindcount; ++i) {
+		if ((sections->inputkinds[i] >= objectcount) || !(types[sections->inputkinds[i]] & HILBERT_TYPE_KIND))
+			goto invalid;
+	}
+
+	/* terms; arguments precede the terms applying them, and the arities are checked when the terms are built */
+	size_t termcount = header->termcount;
+	size_t termargcount = header->termargcount;
+	size_t argcountsum = 0;
+	for (size_t i = 0; i != termcount; ++i) {
+		HilbertHandle head = sections->termheads[i];
+		size_t argc = sections->termargcounts[i];
+		if ((head >= objectcount) || !(types[head] & (HILBERT_TYPE_VAR | HILBERT_TYPE_FUNCTOR))
+				|| ((types[head] & HILBERT_TYPE_VAR) && (argc != 0)) || (argc > termargcount - argcountsum))
+			goto invalid;
+		for (size_t j = 0; j != argc; ++j) {
+			if (sections->termargs[argcountsum + j] >= i)
+				goto invalid;
+		}
+		argcountsum += argc;
+	}
+	if (argcountsum != termargcount)
+		goto invalid;
+
+	/* statements */
+	size_t statementcount = header->statementcount;
+	size_t hypcount = header->hypcount;
+	if (!image_checkhandles(sections->statementhandles, statementcount, types, objectcount,
+				HILBERT_TYPE_STATEMENT, HILBERT_TYPE_STATEMENT))
+		goto invalid;
+	size_t hypcountsum = 0;
+	for (size_t i = 0; i != statementcount; ++i) {
+		if ((sections->conclusions[i] >= termcount) || (sections->hypcounts[i] > hypcount - hypcountsum))
+			goto invalid;
+		hypcountsum += sections->hypcounts[i];
+	}
+	if (hypcountsum != hypcount)
+		goto invalid;
+	for (size_t i = 0; i != hypcount; ++i) {
+		if (sections->hyps[i] >= termcount)
+			goto invalid;
+	}
+
+	/* parameters; handle map entries are checked against the dependencies when the maps are built */
+	if (!image_checkhandles(sections->paramhandles, paramcount, types, objectcount, ~0u, HILBERT_TYPE_PARAM))
+		goto invalid;
+	size_t mapcountsum = 0;
+	for (size_t i = 0; i != paramcount; ++i) {
+		if ((sections->paramdeps[i] >= header->dependencycount) || (sections->mapcounts[i] > mapentrycount - mapcountsum))
+			goto invalid;
+		mapcountsum += sections->mapcounts[i];
+	}
+	if (mapcountsum != mapentrycount)
+		goto invalid;
+
+	/* each map entry maps a distinct external object of its own parameter */
+	unsigned char * mapped = calloc(objectcount + 1, sizeof(*mapped));
+	if (mapped == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomappedmem;
+	}
+	const HilbertHandle * entries = sections->mapentries;
+	for (size_t i = 0; i != paramcount; ++i) {
+		for (size_t j = 0; j != sections->mapcounts[i]; ++j, entries += 2) {
+			HilbertHandle object = entries[0];
+			if ((object >= objectcount) || !(types[object] & HILBERT_TYPE_EXTERNAL)
+					|| (sections->paramindices[object] != i) || mapped[object])
+				goto invalidmap;
+			mapped[object] = 1;
+		}
+	}
+
+	/* The only external objects without entry are aliases of external kinds,
+	 * which are equivalent to a mapped kind of the same parameter. */
+	size_t * classmarks = calloc(paramcount + 1, sizeof(*classmarks));
+	if (classmarks == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto noclassmarksmem;
+	}
+	for (size_t i = 0; i != objectcount; ++i) {
+		if ((types[i] & HILBERT_TYPE_EXTERNAL) && !mapped[i] && !(types[i] & HILBERT_TYPE_KIND))
+			goto invalidalias;
+	}
+	for (size_t i = 0; i != kindcount; ++i) {
+		if (roots[i] != i)
+			continue;
+		struct EqcRange range = sections->eqcranges[i];
+		const HilbertHandle * members = sections->eqckinds + range.first;
+		for (size_t j = 0; j != range.count; ++j) {
+			if (mapped[members[j]])
+				classmarks[sections->paramindices[members[j]]] = i + 1;
+		}
+		for (size_t j = 0; j != range.count; ++j) {
+			HilbertHandle kind = members[j];
+			if ((types[kind] & HILBERT_TYPE_EXTERNAL) && !mapped[kind]
+					&& (classmarks[sections->paramindices[kind]] != i + 1))
+				goto invalidalias;
+		}
+	}
+	free(classmarks);
+	free(mapped);
+
+	return 0;
+
+invalidalias:
+	free(classmarks);
+noclassmarksmem:
+invalidmap:
+	free(mapped);
+nomappedmem:
+	return errcode;
+
+invalideqc:
+	free(seen);
+noseenmem:
+	free(classsizes);
+noclasssizesmem:
+invalid:
+	return errcode;
+}
+
+/**
+ * Creates a module from a validated module image.
+ * The columns and handle arrays of the module are backed by the image, which is not copied.
+ * Only the functor and statement records, the term nodes and the parameter handle maps are allocated.
+ *
+ * @param image Pointer to a module image whose header and sections have been validated.
+ * 	On success, the module takes ownership of the image.
+ * @param mapsize Size of the memory mapping holding the image,
+ * 	or <code>0</code> if the image was allocated with <code>malloc()</code>.
+ * @param sections Pointer to the sections of the image.
+ * @param depv Pointer to the dependencies of the image, checked with <code>#image_checkdeps()</code>.
+ * @param errcode Pointer to a location where an integer error code can be stored.
+ *
+ * @return On success, <code>0</code> is stored in <code>*errcode</code>, and a pointer to a new,
+ * 	immutable interface module is returned.
+ * 	On error, <code>#HILBERT_ERR_NOMEM</code>, <code>#HILBERT_ERR_INVALID_IMAGE</code>
+ * 	or <code>#HILBERT_ERR_INTERNAL</code> is stored in <code>*errcode</code>,
+ * 	and <code>NULL</code> is returned. The image remains owned by the caller.
+ */
+static struct HilbertModule * image_build(void * image, size_t mapsize, const struct ImageSections * sections,
+		HilbertModule * const * depv, int * errcode) {
+	const struct ImageHeader * header = image;
+	size_t objectcount = header->objectcount;
+	size_t functorcount = header->functorcount;
+	size_t statementcount = header->statementcount;
+	size_t paramcount = header->paramcount;
+
+	struct HilbertModule * module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (module == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nomodulemem;
+	}
+
+	/* columns and handle arrays */
+	if (cl_otable_borrow(module->objects, objectcount, sections->types, sections->kinds, sections->paramindices,
+				sections->eqcindices) != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto builderror;
+	}
+	hilbert_ivector_borrow(module->kindhandles, sections->kindhandles, header->kindcount);
+	cl_ufind_borrow(module->kindeqc, sections->eqcroots, header->kindcount);
+	module->eqckinds = sections->eqckinds;
+	module->eqcranges = sections->eqcranges;
+	hilbert_ivector_borrow(module->varhandles, sections->varhandles, header->varcount);
+	hilbert_ivector_borrow(module->functorhandles, sections->functorhandles, functorcount);
+	hilbert_ivector_borrow(module->statementhandles, sections->statementhandles, statementcount);
+
+	/* functor records */
+	union Object * functors = cl_arena_alloc(module->arena, functorcount * sizeof(*functors));
+	if (functors == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto builderror;
+	}
+	for (size_t i = 0, offset = 0; i != functorcount; offset += sections->placecounts[i++]) {
+		/* long input kind arrays stay in the image, short ones are copied into the record */
+		HilbertHandle * inputkinds = hilbert_functor_init(&functors[i].basic_functor, sections->placecounts[i],
+				sections->inputkinds + offset);
+		if ((sections->placecounts[i] != 0) && (inputkinds != sections->inputkinds + offset))
+			memcpy(inputkinds, sections->inputkinds + offset, sections->placecounts[i] * sizeof(*inputkinds));
+		cl_otable_setrecord(module->objects, sections->functorhandles[i], functors + i);
+	}
+
+	/* terms, checked against the functors; an image term equal to an earlier one is rejected */
+	for (size_t i = 0, offset = 0; i != header->termcount; offset += sections->termargcounts[i++]) {
+		HilbertHandle head = sections->termheads[i];
+		size_t argc = sections->termargcounts[i];
+		const HilbertHandle * args = sections->termargs + offset;
+		if (cl_otable_type(module->objects, head) & HILBERT_TYPE_FUNCTOR) {
+			const struct BasicFunctor * functor = &cl_otable_record(module->objects, head)->basic_functor;
+			if (functor->place_count != argc) {
+				*errcode = HILBERT_ERR_INVALID_IMAGE;
+				goto builderror;
+			}
+			const HilbertHandle * inputkinds = hilbert_functor_inputkinds(functor);
+			for (size_t j = 0; j != argc; ++j) {
+				HilbertHandle kind = cl_otable_kind(module->objects, sections->termheads[args[j]]);
+				if (!hilbert_kind_isequivalent_nocheck(module, kind, inputkinds[j])) {
+					*errcode = HILBERT_ERR_INVALID_IMAGE;
+					goto builderror;
+				}
+			}
+		}
+		HilbertHandle id;
+		if (cl_tstore_intern(module->terms, module->arena, head, argc, args, &id) != 0) {
+			*errcode = HILBERT_ERR_NOMEM;
+			goto builderror;
+		}
+		if (id != i) {
+			*errcode = HILBERT_ERR_INVALID_IMAGE;
+			goto builderror;
+		}
+	}
+
+	/* statement records, with their hypotheses left in the image */
+	union Object * statements = cl_arena_alloc(module->arena, statementcount * sizeof(*statements));
+	if (statements == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto builderror;
+	}
+	for (size_t i = 0, offset = 0; i != statementcount; offset += sections->hypcounts[i++]) {
+		statements[i].statement = (struct Statement) {
+			.conclusion = sections->conclusions[i],
+			.hypcount = sections->hypcounts[i],
+			.hyps = sections->hypcounts[i] != 0 ? sections->hyps + offset : NULL
+		};
+		cl_otable_setrecord(module->objects, sections->statementhandles[i], statements + i);
+	}
+
+	/* parameter records, owned by the module once the parameter handles are in place */
+	for (size_t i = 0; i != paramcount; ++i) {
+		union Object * param = param_create(module, depv[sections->paramdeps[i]]);
+		if (param == NULL) {
+			for (size_t j = 0; j != i; ++j)
+				hilbert_param_free(cl_otable_record(module->objects, sections->paramhandles[j]));
+			*errcode = HILBERT_ERR_NOMEM;
+			goto builderror;
+		}
+		cl_otable_setrecord(module->objects, sections->paramhandles[i], param);
+	}
+	hilbert_ivector_borrow(module->paramhandles, sections->paramhandles, paramcount);
+
+	/* parameter handle maps */
+	const HilbertHandle * entries = sections->mapentries;
+	for (size_t i = 0; i != paramcount; ++i) {
+		struct HilbertModule * dep = depv[sections->paramdeps[i]];
+		ParamMap * map = cl_otable_record(module->objects, sections->paramhandles[i])->param.handle_map;
+		*errcode = set_dependency(module, dep);
+		if (*errcode != 0)
+			goto builderror;
+		for (size_t j = 0; j != sections->mapcounts[i]; ++j, entries += 2) {
+			unsigned int typeflags = HILBERT_TYPE_KIND | HILBERT_TYPE_FUNCTOR | HILBERT_TYPE_STATEMENT;
+			if (!hilbert_object_check(module, entries[0], typeflags)
+					|| !hilbert_object_check(dep, entries[1], typeflags)
+					|| ((cl_otable_type(module->objects, entries[0]) ^ cl_otable_type(dep->objects, entries[1]))
+						& (typeflags | HILBERT_TYPE_VKIND))) {
+				*errcode = HILBERT_ERR_INVALID_IMAGE;
+				goto builderror;
+			}
+			if (hilbert_pmap_add(map, entries[0], entries[1]) != 0) {
+				*errcode = HILBERT_ERR_NOMEM;
+				goto builderror;
+			}
+		}
+		/* entries sharing a source object would have overwritten each other */
+		if (hilbert_pmap_count(map) != sections->mapcounts[i]) {
+			*errcode = HILBERT_ERR_INVALID_IMAGE;
+			goto builderror;
+		}
+	}
+
+	module->image = image;
+	module->mapsize = mapsize;
+	atomic_store_explicit(&module->immutable, 1, memory_order_release);
+	*errcode = 0;
+
+	return module;
+
+builderror:
+	hilbert_module_free(module);
+nomodulemem:
+	return NULL;
+}
+
+HilbertModule * hilbert_module_load(FILE * restrict stream, size_t depc, HilbertModule * const * restrict depv,
+		int * restrict errcode) {
+	assert (stream != NULL);
+	assert ((depc == 0) || (depv != NULL));
+	assert (errcode != NULL);
+
+	struct HilbertModule * module = NULL;
+	struct ImageHeader header;
+	struct ImageSections sections;
+	size_t size;
+
+	if (fread(&header, sizeof(header), 1, stream) != 1) {
+		*errcode = ferror(stream) ? HILBERT_ERR_IO : HILBERT_ERR_INVALID_IMAGE;
+		goto headererror;
+	}
+	*errcode = image_checkheader(&header, &size);
+	if (*errcode != 0)
+		goto headererror;
+
+	/* the module is backed by a private copy of the image */
+	void * image = malloc(size);
+	if (image == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto noimagemem;
+	}
+	memcpy(image, &header, sizeof(header));
+	if (fread((unsigned char *) image + sizeof(header), 1, size - sizeof(header), stream) != size - sizeof(header)) {
+		*errcode = ferror(stream) ? HILBERT_ERR_IO : HILBERT_ERR_INVALID_IMAGE;
+		goto loaderror;
+	}
+	image_locate(&sections, image);
+
+	*errcode = image_checkdeps(&header, &sections, depc, depv);
+	if (*errcode != 0)
+		goto loaderror;
+	*errcode = image_validate(&header, &sections);
+	if (*errcode != 0)
+		goto loaderror;
+	module = image_build(image, 0, &sections, depv, errcode);
+	if (module == NULL)
+		goto loaderror;
+
+	return module;
+
+loaderror:
+	free(image);
+noimagemem:
+headererror:
+	return NULL;
+}
+
+HilbertModule * hilbert_module_map(const char * restrict path, size_t depc, HilbertModule * const * restrict depv,
+		int * restrict errcode) {
+	assert (path != NULL);
+	assert ((depc == 0) || (depv != NULL));
+	assert (errcode != NULL);
+
+	struct HilbertModule * module = NULL;
+	struct ImageSections sections;
+	struct stat st;
+	size_t size;
+
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		*errcode = HILBERT_ERR_IO;
+		goto noopen;
+	}
+	if (fstat(fd, &st) != 0) {
+		*errcode = HILBERT_ERR_IO;
+		goto nostat;
+	}
+	if ((st.st_size < 0) || ((uintmax_t) st.st_size < sizeof(struct ImageHeader)) || ((uintmax_t) st.st_size > SIZE_MAX)) {
+		*errcode = HILBERT_ERR_INVALID_IMAGE;
+		goto nostat;
+	}
+	size_t mapsize = st.st_size;
+	void * image = mmap(NULL, mapsize, PROT_READ, MAP_SHARED, fd, 0);
+	if (image == MAP_FAILED) {
+		*errcode = HILBERT_ERR_IO;
+		goto nomap;
+	}
+
+	*errcode = image_checkheader(image, &size);
+	if (*errcode != 0)
+		goto maperror;
+	if (size > mapsize) {
+		*errcode = HILBERT_ERR_INVALID_IMAGE;
+		goto maperror;
+	}
+	image_locate(&sections, image);
+
+	*errcode = image_checkdeps(image, &sections, depc, depv);
+	if (*errcode != 0)
+		goto maperror;
+	*errcode = image_validate(image, &sections);
+	if (*errcode != 0)
+		goto maperror;
+	module = image_build(image, mapsize, &sections, depv, errcode);
+	if (module == NULL)
+		goto maperror;
+
+	close(fd);
+
+	return module;
+
+maperror:
+	munmap(image, mapsize);
+nomap:
+nostat:
+	close(fd);
+noopen:
+	return NULL;
+}
+
+void hilbert_image_release(void * image, size_t mapsize) {
+	assert (image != NULL);
+
+	if (mapsize != 0)
+		munmap(image, mapsize);
+	else
+		free(image);
+}
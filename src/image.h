@@ -0,0 +1,183 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#ifndef HILBERT_IMAGE_H__
+#define HILBERT_IMAGE_H__
+
+#include<stddef.h>
+#include<stdint.h>
+
+/**
+ * Module image format.
+ *
+ * A module image consists of a header followed by a number of sections.
+ * All header fields are 64-bit unsigned integers.
+ * Section elements are <code>size_t</code> words, except for the object types,
+ * which are <code>unsigned int</code> values padded with zeros to a whole number of words.
+ * Everything is stored in the byte order of the writing host.
+ * The sections mirror the in-memory layout of an immutable module,
+ * so that an image mapped into memory can back a module without being copied.
+ * The sections are, in this order:
+ * - dependencies: for each dependency, its object count, kind count and functor count,
+ * - object types, indexed by object handle,
+ * - object kinds, indexed by object handle,
+ * - object parameter indices, indexed by object handle,
+ * - object equivalence class indices, indexed by object handle,
+ * - kind handles,
+ * - equivalence class roots, indexed by equivalence class index,
+ * - equivalence class ranges as pairs of first index and count, indexed by equivalence class index,
+ * - kind handles grouped by equivalence class,
+ * - variable handles,
+ * - functor handles,
+ * - functor place counts, indexed like the functor handles,
+ * - functor input kinds, concatenated in the order of the functor handles,
+ * - term heads, indexed by term handle,
+ * - term argument counts, indexed by term handle,
+ * - term arguments, concatenated in the order of the term handles,
+ * - statement handles,
+ * - statement hypothesis counts, indexed like the statement handles,
+ * - statement conclusions, indexed like the statement handles,
+ * - statement hypotheses, concatenated in the order of the statement handles,
+ * - parameter handles,
+ * - parameter dependency indices, indexed like the parameter handles,
+ * - parameter handle map sizes, indexed like the parameter handles,
+ * - parameter handle map entries as pairs of destination and source handle,
+ *   concatenated in the order of the parameter handles.
+ *
+ * Dependencies are the source modules of the parameters, numbered in the order of their first use by a parameter.
+ */
+
+/**
+ * Module image magic.
+ */
+#define HILBERT_IMAGE_MAGIC "HKMODIMG"
+
+/**
+ * Current module image format version.
+ */
+#define HILBERT_IMAGE_VERSION UINT64_C(3)
+
+/**
+ * Byte order mark of a module image.
+ */
+#define HILBERT_IMAGE_BYTEORDER UINT64_C(0x0102030405060708)
+
+/**
+ * Module image header.
+ */
+struct ImageHeader {
+	/**
+	 * Magic, <code>#HILBERT_IMAGE_MAGIC</code> without the terminating null character.
+	 */
+	char magic[8];
+
+	/**
+	 * Format version.
+	 */
+	uint64_t version;
+
+	/**
+	 * Byte order mark, <code>#HILBERT_IMAGE_BYTEORDER</code>.
+	 */
+	uint64_t byteorder;
+
+	/**
+	 * Size of a section word, <code>sizeof(size_t)</code>.
+	 */
+	uint64_t wordsize;
+
+	/**
+	 * Size of an object type, <code>sizeof(unsigned int)</code>.
+	 */
+	uint64_t typesize;
+
+	/**
+	 * Number of objects.
+	 */
+	uint64_t objectcount;
+
+	/**
+	 * Number of kinds.
+	 */
+	uint64_t kindcount;
+
+	/**
+	 * Number of variables.
+	 */
+	uint64_t varcount;
+
+	/**
+	 * Number of functors.
+	 */
+	uint64_t functorcount;
+
+	/**
+	 * Number of statements.
+	 */
+	uint64_t statementcount;
+
+	/**
+	 * Number of parameters.
+	 */
+	uint64_t paramcount;
+
+	/**
+	 * Total number of functor input kinds.
+	 */
+	uint64_t inputkindcount;
+
+	/**
+	 * Number of terms.
+	 */
+	uint64_t termcount;
+
+	/**
+	 * Total number of term arguments.
+	 */
+	uint64_t termargcount;
+
+	/**
+	 * Total number of statement hypotheses.
+	 */
+	uint64_t hypcount;
+
+	/**
+	 * Total number of parameter handle map entries.
+	 */
+	uint64_t mapentrycount;
+
+	/**
+	 * Number of dependencies.
+	 */
+	uint64_t dependencycount;
+};
+
+/**
+ * Releases the memory backing a module created from an image.
+ *
+ * @param image Pointer to the image.
+ * @param mapsize Size of the memory mapping holding the image,
+ * 	or <code>0</code> if the image was allocated with <code>malloc()</code>.
+ */
+void hilbert_image_release(void * image, size_t mapsize);
+
+#endif
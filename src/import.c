@@ -27,148 +27,19 @@
 #include<stdlib.h>
 
 #include"cl/pmap.h"
-#include"cl/eset.h"
-#include"cl/iset.h"
 #include"cl/mset.h"
+#include"cl/ivector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+#include"cl/ufind.h"
 
 #include"threads/hthreads.h"
 
-/**
- * Creates a backup of existing kind equivalence classes.
- *
- * @param module Pointer to Hilbert module in which the kinds reside.
- * @param handle_map Pointer to parameter map, the domain of which contains the kinds whose equivalence classes
- * 	are to be backed up.
- *
- * @return On success, a pointer to a set of equivalence classes, the backup, is returned.
- * 	On error, <code>NULL</code> is returned.
- *
- * @sa #eqc_backup_restore()
- * @sa #eqc_backup_free()
- */
-static EQCSet * eqc_backup_create(struct HilbertModule * restrict module, ParamMap * restrict handle_map) {
-	assert (module != NULL);
-	assert (handle_map != NULL);
-
-	EQCSet * result = NULL;
-
-	IndexSet * already_handled = hilbert_iset_new(); /* already handled kind handles */
-	if (already_handled == NULL)
-		goto noisetmem;
-
-	result = hilbert_eset_new();
-	if (result == NULL)
-		goto noeqcsetmem;
-
-	for (ParamMapIterator i = hilbert_pmap_iterator_new(handle_map); hilbert_pmap_iterator_hasnext(&i);) {
-		struct ParamMapEntry entry = hilbert_pmap_iterator_next(&i);
-		if (hilbert_iset_contains(already_handled, entry.pre))
-			continue;
-		union Object * object = hilbert_object_retrieve(module, entry.pre, HILBERT_TYPE_KIND);
-		assert (object != NULL);
-		struct Kind * kind = &object->kind;
-		if (kind->equivalence_class == NULL)
-			continue;
-		IndexSet * equivalence_class = hilbert_iset_clone(kind->equivalence_class);
-		if (equivalence_class == NULL)
-			goto noeqcmem;
-		if (hilbert_eset_add(result, equivalence_class) != 0) {
-			hilbert_iset_del(equivalence_class);
-			goto noeqcmem;
-		}
-		if (hilbert_iset_addall(already_handled, equivalence_class) != 0)
-			goto noeqcmem;
-	}
-
-	goto success;
-
-noeqcmem:
-	for (EQCSetIterator i = hilbert_eset_iterator_new(result); hilbert_eset_iterator_hasnext(&i);)
-		hilbert_iset_del(hilbert_eset_iterator_next(&i));
-	hilbert_eset_del(result);
-	result = NULL;
-success:
-noeqcsetmem:
-	hilbert_iset_del(already_handled);
-noisetmem:
-	return result;
-}
-
-/**
- * Restores existing kind equivalence classes from a backup.
- *
- * @param module Pointer to the Hilbert module in which the kind equivalence classes are to be restored.
- * @param handle_map Pointer to parameter map, the domain of which contains the handles of the kinds
- * 	whose equivalence classes are to be restored.
- * @param backup Pointer to a set of equivalence classes, the backup. After the backup has been restored,
- * 	the set will be freed.
- *
- * @sa #eqc_backup_create()
- * @sa #eqc_backup_free()
- */
-static void eqc_backup_restore(struct HilbertModule * restrict module, ParamMap * restrict handle_map,
-		EQCSet * restrict backup) {
-	assert (module != NULL);
-	assert (handle_map != NULL);
-	assert (backup != NULL);
-
-	/* reset current equivalence classes to NULL */
-	for (ParamMapIterator i = hilbert_pmap_iterator_new(handle_map); hilbert_pmap_iterator_hasnext(&i);) {
-		struct ParamMapEntry entry = hilbert_pmap_iterator_next(&i);
-		union Object * object = hilbert_object_retrieve(module, entry.pre, HILBERT_TYPE_KIND);
-		assert (object != NULL);
-		IndexSet * equivalence_class = object->kind.equivalence_class;
-		if (equivalence_class == NULL)
-			continue;
-		for (IndexSetIterator j = hilbert_iset_iterator_new(equivalence_class);
-				hilbert_iset_iterator_hasnext(&j);) {
-			HilbertHandle kindhandle = hilbert_iset_iterator_next(&j);
-			union Object * object2 = hilbert_object_retrieve(module, kindhandle, HILBERT_TYPE_KIND);
-			assert (object2 != NULL);
-			object2->kind.equivalence_class = NULL;
-		}
-		hilbert_iset_del(equivalence_class);
-	}
-
-	/* restore backup */
-	for (EQCSetIterator i = hilbert_eset_iterator_new(backup); hilbert_eset_iterator_hasnext(&i);) {
-		IndexSet * equivalence_class = hilbert_eset_iterator_next(&i);
-		assert (equivalence_class != NULL);
-		for (IndexSetIterator j = hilbert_iset_iterator_new(equivalence_class);
-				hilbert_iset_iterator_hasnext(&j);) {
-			HilbertHandle kindhandle = hilbert_iset_iterator_next(&j);
-			union Object * object = hilbert_object_retrieve(module, kindhandle, HILBERT_TYPE_KIND);
-			assert (object != NULL);
-			object->kind.equivalence_class = equivalence_class;
-		}
-	}
-
-	/* delete backup set */
-	hilbert_eset_del(backup);
-}
-
-/**
- * Frees a backup of existing kind equivalence classes which is no longer needed.
- *
- * @param backup Pointer to backup set.
- *
- * @sa #eqc_backup_create()
- * @sa #eqc_backup_restore()
- */
-static void eqc_backup_free(EQCSet * backup) {
-	assert (backup != NULL);
-
-	for (EQCSetIterator i = hilbert_eset_iterator_new(backup); hilbert_eset_iterator_hasnext(&i);)
-		hilbert_iset_del(hilbert_eset_iterator_next(&i));
-
-	hilbert_eset_del(backup);
-}
-
 /**
  * Loads kinds from a source module into a destination module, creating proper equivalence classes.
  *
  * @param dest Pointer to destination module, assumed to be locked.
- * @param src Pointer to source module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
  * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
  * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
  * @param mapper Pointer to parameter handle to argument handle mapper function.
@@ -177,8 +48,9 @@ static void eqc_backup_free(EQCSet * backup) {
  * @param param Pointer to the new parameter.
  * @param paramindex Index of the new parameter in <code>dest</code>.
  *
- * Warning: this function adds elements to <code>dest->objects</code> and <code>dest->kindhandles</code>
- * without deleting them on error. It is up to the caller to do that.
+ * Warning: this function adds elements to <code>dest->objects</code>, <code>dest->kindhandles</code>
+ * and <code>dest->kindeqc</code>, and allocates from <code>dest->arena</code> without undoing this on error.
+ * It is up to the caller to do that.
  *
  * @return On success, <code>0</code> is returned. On error, a nonzero value is returned.
  */
@@ -191,32 +63,25 @@ static int load_kinds(HilbertModule * restrict dest, HilbertModule * restrict sr
 	assert (param != NULL);
 	int errcode;
 
-	IndexSet * already_handled = hilbert_iset_new(); /* kind handles which have already been handled */
-	if (already_handled == NULL) {
-		errcode = HILBERT_ERR_NOMEM;
-		goto noahsetmem;
-	}
-
 	/* inspect all source kinds */
 	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->kindhandles);
 			hilbert_ivector_iterator_hasnext(&i);) {
 		HilbertHandle srckindhandle = hilbert_ivector_iterator_next(&i);
-		union Object * srcobject = hilbert_ovector_get(src->objects, srckindhandle);
-		assert (srcobject->generic.type & HILBERT_TYPE_KIND);
-		if (srcobject->generic.type & HILBERT_TYPE_EXTERNAL) {
+		unsigned int srctype = cl_otable_type(src->objects, srckindhandle);
+		assert (srctype & HILBERT_TYPE_KIND);
+		if (srctype & HILBERT_TYPE_EXTERNAL) {
 			/* map to existing kind */
-			struct ExternalKind * srckind = &srcobject->external_kind;
-			HilbertHandle arghandle = argv[srckind->paramindex];
+			HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srckindhandle)];
 			HilbertHandle destkindhandle = mapper(dest, src, srckindhandle, userdata, &errcode);
 			if (errcode != 0)
 				goto error;
-			union Object * destobject = hilbert_object_retrieve(dest, destkindhandle, HILBERT_TYPE_KIND);
-			if ((destobject == NULL) || (!(destobject->generic.type & HILBERT_TYPE_EXTERNAL))) {
+			if ((!hilbert_object_check(dest, destkindhandle, HILBERT_TYPE_KIND))
+					|| (!(cl_otable_type(dest->objects, destkindhandle) & HILBERT_TYPE_EXTERNAL))) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
 			}
-			struct ExternalKind * destkind = &destobject->external_kind;
-			size_t destparamhandle = hilbert_ivector_get(dest->paramhandles, destkind->paramindex);
+			size_t destparamhandle = hilbert_ivector_get(dest->paramhandles,
+					cl_otable_paramindex(dest->objects, destkindhandle));
 			if (destparamhandle != arghandle) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
@@ -226,33 +91,30 @@ static int load_kinds(HilbertModule * restrict dest, HilbertModule * restrict sr
 				errcode = HILBERT_ERR_MAPPING_CLASH;
 				goto error;
 			}
-			assert (((srckind->type ^ destkind->type) & HILBERT_TYPE_VKIND) == 0);
+			assert (((srctype ^ cl_otable_type(dest->objects, destkindhandle)) & HILBERT_TYPE_VKIND) == 0);
 			if (hilbert_pmap_add(param->handle_map, destkindhandle, srckindhandle) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
 		} else {
 			/* map to new kind */
-			HilbertHandle destkindhandle = hilbert_ovector_count(dest->objects);
-			union Object * destkind = malloc(sizeof(*destkind));
-			if (destkind == NULL) {
+			HilbertHandle destkindhandle = cl_otable_count(dest->objects);
+			if (cl_otable_pushback(dest->objects, (struct ObjectRow) {
+				.type = srctype | HILBERT_TYPE_EXTERNAL,
+				.paramindex = paramindex,
+				.eqcindex = hilbert_ivector_count(dest->kindhandles)
+			}) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
-			if (hilbert_ovector_pushback(dest->objects, destkind) != 0) {
-				free(destkind);
+			if (hilbert_ivector_pushback(dest->kindhandles, destkindhandle) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
-			if (hilbert_ivector_pushback(dest->kindhandles, destkindhandle) != 0) {
+			if (cl_ufind_add(dest->kindeqc) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
-			destkind->external_kind = (struct ExternalKind) {
-				.type = srcobject->generic.type | HILBERT_TYPE_EXTERNAL,
-				.equivalence_class = NULL,
-				.paramindex = paramindex
-			};
 			if (hilbert_pmap_add(param->handle_map, destkindhandle, srckindhandle) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
@@ -261,43 +123,24 @@ static int load_kinds(HilbertModule * restrict dest, HilbertModule * restrict sr
 	}
 
 	/* coarsen kind equivalence relation in dest to become compatible with src */
-	EQCSet * backup = eqc_backup_create(dest, param->handle_map);
-	if (backup == NULL) {
-		errcode = HILBERT_ERR_NOMEM;
-		goto nobackupmem;
-	}
-	for (ParamMapIterator i = hilbert_pmap_iterator_new(param->handle_map); hilbert_pmap_iterator_hasnext(&i);) {
-		struct ParamMapEntry entry = hilbert_pmap_iterator_next(&i);
-		if (hilbert_iset_contains(already_handled, entry.post))
+	size_t srckindcount = hilbert_ivector_count(src->kindhandles);
+	for (size_t i = 0; i != srckindcount; ++i) {
+		size_t root = cl_ufind_find_readonly(src->kindeqc, i);
+		if (root == i)
 			continue;
-		union Object * srcobject = hilbert_object_retrieve(src, entry.post, HILBERT_TYPE_KIND);
-		assert (srcobject != NULL);
-		struct Kind * srckind = &srcobject->kind;
-		if (srckind->equivalence_class != NULL) {
-			for (IndexSetIterator j = hilbert_iset_iterator_new(srckind->equivalence_class); hilbert_iset_iterator_hasnext(&j);) {
-				HilbertHandle srckindhandle = hilbert_iset_iterator_next(&j);
-				const HilbertHandle * destkindhandle = hilbert_pmap_pre(param->handle_map, srckindhandle);
-				assert (destkindhandle != NULL);
-				errcode = hilbert_kind_identify_nocheck(dest, entry.pre, *destkindhandle);
-				assert ((errcode != HILBERT_ERR_INVALID_MODULE)
-						&& (errcode != HILBERT_ERR_IMMUTABLE)
-						&& (errcode != HILBERT_ERR_INVALID_HANDLE));
-				if (errcode != 0) {
-					eqc_backup_restore(dest, param->handle_map, backup);
-					goto iderror;
-				}
-			}
-		}
+		const HilbertHandle * destkindhandle1 = hilbert_pmap_pre(param->handle_map,
+				hilbert_ivector_get(src->kindhandles, i));
+		const HilbertHandle * destkindhandle2 = hilbert_pmap_pre(param->handle_map,
+				hilbert_ivector_get(src->kindhandles, root));
+		assert (destkindhandle1 != NULL);
+		assert (destkindhandle2 != NULL);
+		errcode = hilbert_kind_identify_nocheck(dest, *destkindhandle1, *destkindhandle2);
+		assert (errcode == 0);
 	}
 
 	errcode = 0;
 
-	eqc_backup_free(backup);
-iderror:
-nobackupmem:
 error:
-	hilbert_iset_del(already_handled);
-noahsetmem:
 	return errcode;
 }
 
@@ -305,7 +148,7 @@ noahsetmem:
  * Loads functors from a source module into a destination module.
  *
  * @param dest Pointer to destination module, assumed to be locked.
- * @param src Pointer to source module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
  * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
  * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
  * @param mapper Pointer to parameter handle to argument handle mapper function.
@@ -314,7 +157,8 @@ noahsetmem:
  * @param param Pointer to the new parameter.
  * @param paramindex Index of the new parameter in <code>dest</code>.
  *
- * Warning: this function adds elements to <code>dest->objects</code> and <code>dest->functorhandles</code> without deleting them on error.
+ * Warning: this function adds elements to <code>dest->objects</code> and <code>dest->functorhandles</code>,
+ * and allocates from <code>dest->arena</code> without undoing this on error.
  * It is up to the caller to do that.
  *
  * @return On success, <code>0</code> is returned. On error, a nonzero value is returned.
@@ -331,22 +175,21 @@ static int load_functors(HilbertModule * restrict dest, HilbertModule * restrict
 	/* Inspect all source functors */
 	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->functorhandles); hilbert_ivector_iterator_hasnext(&i);) {
 		HilbertHandle srcfunctorhandle = hilbert_ivector_iterator_next(&i);
-		union Object * srcobject = hilbert_ovector_get(src->objects, srcfunctorhandle);
-		assert (srcobject->generic.type & HILBERT_TYPE_FUNCTOR);
-		if (srcobject->generic.type & HILBERT_TYPE_EXTERNAL) {
+		unsigned int srctype = cl_otable_type(src->objects, srcfunctorhandle);
+		assert (srctype & HILBERT_TYPE_FUNCTOR);
+		if (srctype & HILBERT_TYPE_EXTERNAL) {
 			/* map to existing functor */
-			struct ExternalBasicFunctor * srcfunctor = &srcobject->external_basic_functor;
-			HilbertHandle arghandle = argv[srcfunctor->paramindex];
+			HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srcfunctorhandle)];
 			HilbertHandle destfunctorhandle = mapper(dest, src, srcfunctorhandle, userdata, &errcode);
 			if (errcode != 0)
 				goto error;
-			union Object * destobject = hilbert_object_retrieve(dest, destfunctorhandle, HILBERT_TYPE_FUNCTOR);
-			if ((destobject == NULL) || (!(destobject->generic.type & HILBERT_TYPE_EXTERNAL))) { // FIXME: abbreviation, definitions?
+			if ((!hilbert_object_check(dest, destfunctorhandle, HILBERT_TYPE_FUNCTOR))
+					|| (!(cl_otable_type(dest->objects, destfunctorhandle) & HILBERT_TYPE_EXTERNAL))) { // FIXME: abbreviation, definitions?
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
 			}
-			struct ExternalBasicFunctor * destfunctor = &destobject->external_basic_functor;
-			size_t destparamhandle = hilbert_ivector_get(dest->paramhandles, destfunctor->paramindex);
+			size_t destparamhandle = hilbert_ivector_get(dest->paramhandles,
+					cl_otable_paramindex(dest->objects, destfunctorhandle));
 			if (destparamhandle != arghandle) {
 				errcode = HILBERT_ERR_INVALID_MAPPING;
 				goto error;
@@ -362,17 +205,44 @@ static int load_functors(HilbertModule * restrict dest, HilbertModule * restrict
 			}
 		} else {
 			/* map to new functor */
-			HilbertHandle destfunctorhandle = hilbert_ovector_count(dest->objects);
-			union Object * destobject = malloc(sizeof(*destobject));
+			HilbertHandle destfunctorhandle = cl_otable_count(dest->objects);
+			union Object * destobject = cl_arena_alloc(dest->arena, sizeof(*destobject));
 			if (destobject == NULL) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
-			const struct BasicFunctor * srcfunctor = &srcobject->basic_functor;
-			destobject->external_basic_functor = (struct ExternalBasicFunctor) { .type = srcfunctor->type | HILBERT_TYPE_EXTERNAL, .input_kinds = NULL, .paramindex = paramindex }; // FIXME: abbrev, def?
-			struct ExternalBasicFunctor * destfunctor = &destobject->external_basic_functor;
-			if (hilbert_ovector_pushback(dest->objects, destobject) != 0) {
-				free(destfunctor);
+			const struct BasicFunctor * srcfunctor = &cl_otable_record(src->objects, srcfunctorhandle)->basic_functor;
+			struct BasicFunctor * destfunctor = &destobject->basic_functor;
+			// FIXME: abbrev, def?
+			size_t placecount = srcfunctor->place_count;
+			HilbertHandle * destkinds = NULL;
+			if (placecount > HILBERT_FUNCTOR_INLINE) {
+				assert (placecount < SIZE_MAX / sizeof(*destkinds));
+				destkinds = cl_arena_alloc(dest->arena, placecount * sizeof(*destkinds));
+				if (destkinds == NULL) {
+					errcode = HILBERT_ERR_NOMEM;
+					goto error;
+				}
+			}
+			destkinds = hilbert_functor_init(destfunctor, placecount, destkinds);
+			const HilbertHandle * srckinds = hilbert_functor_inputkinds(srcfunctor);
+			for (size_t i = 0; i != placecount; ++i) {
+				const HilbertHandle * handle = hilbert_pmap_pre(param->handle_map, srckinds[i]);
+				assert (handle != NULL);
+				assert (hilbert_object_check(dest, *handle, HILBERT_TYPE_KIND));
+				destkinds[i] = *handle;
+			}
+			const HilbertHandle * handle = hilbert_pmap_pre(param->handle_map,
+					cl_otable_kind(src->objects, srcfunctorhandle));
+			assert (handle != NULL);
+			assert (hilbert_object_check(dest, *handle, HILBERT_TYPE_KIND));
+			assert (!(cl_otable_type(dest->objects, *handle) & HILBERT_TYPE_VKIND));
+			if (cl_otable_pushback(dest->objects, (struct ObjectRow) {
+				.type = srctype | HILBERT_TYPE_EXTERNAL,
+				.kind = *handle,
+				.paramindex = paramindex,
+				.record = destobject
+			}) != 0) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
@@ -380,40 +250,302 @@ static int load_functors(HilbertModule * restrict dest, HilbertModule * restrict
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
-			const HilbertHandle * handle = hilbert_pmap_pre(param->handle_map, srcfunctor->result_kind);
-			assert (handle != NULL);
-			assert (hilbert_object_retrieve(dest, *handle, HILBERT_TYPE_KIND) != NULL);
-			assert (!(hilbert_object_retrieve(dest, *handle, HILBERT_TYPE_KIND)->generic.type & HILBERT_TYPE_VKIND));
-			destfunctor->result_kind = *handle;
-			destfunctor->place_count = srcfunctor->place_count;
-			assert (destfunctor->place_count < SIZE_MAX / sizeof(*destfunctor->input_kinds));
-			size_t allocsize = destfunctor->place_count * sizeof(*destfunctor->input_kinds);
-			if (allocsize != 0) {
-				destfunctor->input_kinds = malloc(allocsize);
-				if (destfunctor->input_kinds == NULL) {
-					errcode = HILBERT_ERR_NOMEM;
+			if (hilbert_pmap_add(param->handle_map, destfunctorhandle, srcfunctorhandle) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto error;
+			}
+		}
+	}
+
+	errcode = 0;
+
+error:
+	return errcode;
+}
+
+/**
+ * Loads statements from a source module into a destination module.
+ *
+ * External source statements are mapped to existing statements and checked against them.
+ * The other source statements are carried over to new statements.
+ * Their terms are translated in bulk: the source terms reachable from these statements are marked first,
+ * and then translated in the order of their ids, in which arguments precede the terms applying them,
+ * so that each source term is translated and type-checked only once.
+ * Each source variable is replaced with a fresh variable.
+ *
+ * @param dest Pointer to destination module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
+ * @param argv Pointer to array of arguments to the parameters of the module pointed to by <code>src</code>.
+ * 	If the number of elements in the array does not match the number of parameters, the behaviour is undefined.
+ * @param mapper Pointer to parameter handle to argument handle mapper function.
+ * 	If the number of parameters is zero, <code>mapper</code> may be <code>NULL</code>.
+ * @param userdata Pointer to user-defined data passed as an argument to the userdata parameter of <code>mapper</code>.
+ * @param param Pointer to the new parameter, whose handle map already contains the kinds and functors.
+ * @param paramindex Index of the new parameter in <code>dest</code>.
+ *
+ * Warning: this function adds elements to <code>dest->objects</code>, <code>dest->varhandles</code>,
+ * <code>dest->statementhandles</code> and <code>dest->terms</code>,
+ * and allocates from <code>dest->arena</code> without undoing this on error.
+ * It is up to the caller to do that.
+ *
+ * @return On success, <code>0</code> is returned. On error, a nonzero value is returned.
+ */
+static int load_statements(HilbertModule * restrict dest, HilbertModule * restrict src,
+		const HilbertHandle * restrict argv, HilbertMapperCallback mapper, void * userdata, struct Param * param,
+		size_t paramindex) {
+	assert (dest != NULL);
+	assert (src != NULL);
+	assert ((hilbert_ivector_count(src->paramhandles) == 0) || (argv != NULL));
+	assert ((hilbert_ivector_count(src->paramhandles) == 0) || (mapper != NULL));
+	assert (param != NULL);
+
+	int errcode;
+	struct StatementMatcher matcher;
+	int matching = 0;
+	HilbertHandle * termmap = NULL;
+	HilbertHandle * args = NULL;
+	size_t localcount = 0;
+
+	/* map external source statements to existing statements */
+	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->statementhandles);
+			hilbert_ivector_iterator_hasnext(&i);) {
+		HilbertHandle srcstatementhandle = hilbert_ivector_iterator_next(&i);
+		unsigned int srctype = cl_otable_type(src->objects, srcstatementhandle);
+		assert (srctype & HILBERT_TYPE_STATEMENT);
+		if (!(srctype & HILBERT_TYPE_EXTERNAL)) {
+			++localcount;
+			continue;
+		}
+		if (!matching) {
+			errcode = statement_matcher_init(&matcher, src);
+			if (errcode != 0)
+				goto error;
+			matching = 1;
+		}
+		HilbertHandle arghandle = argv[cl_otable_paramindex(src->objects, srcstatementhandle)];
+		HilbertHandle deststatementhandle = mapper(dest, src, srcstatementhandle, userdata, &errcode);
+		if (errcode != 0)
+			goto error;
+		if ((!hilbert_object_check(dest, deststatementhandle, HILBERT_TYPE_STATEMENT))
+				|| (!(cl_otable_type(dest->objects, deststatementhandle) & HILBERT_TYPE_EXTERNAL))) {
+			errcode = HILBERT_ERR_INVALID_MAPPING;
+			goto error;
+		}
+		size_t destparamhandle = hilbert_ivector_get(dest->paramhandles,
+				cl_otable_paramindex(dest->objects, deststatementhandle));
+		if (destparamhandle != arghandle) {
+			errcode = HILBERT_ERR_INVALID_MAPPING;
+			goto error;
+		}
+		const HilbertHandle * test = hilbert_pmap_post(param->handle_map, deststatementhandle);
+		if (test != NULL) {
+			errcode = HILBERT_ERR_MAPPING_CLASH;
+			goto error;
+		}
+		errcode = statement_match(&matcher, dest, src, param->handle_map, srcstatementhandle, deststatementhandle);
+		if (errcode != 0)
+			goto error;
+		if (hilbert_pmap_add(param->handle_map, deststatementhandle, srcstatementhandle) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+	}
+	if (localcount == 0) {
+		errcode = 0;
+		goto success;
+	}
+
+	/* mark the source terms reachable from the other statements with 0 until they are translated */
+	size_t srctermcount = cl_tstore_count(src->terms);
+	assert (srctermcount != 0);
+	if (srctermcount > SIZE_MAX / sizeof(*termmap)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto error;
+	}
+	termmap = malloc(srctermcount * sizeof(*termmap));
+	if (termmap == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto error;
+	}
+	for (size_t i = 0; i != srctermcount; ++i)
+		termmap[i] = PARAM_TERM_NONE;
+	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->statementhandles);
+			hilbert_ivector_iterator_hasnext(&i);) {
+		HilbertHandle srcstatementhandle = hilbert_ivector_iterator_next(&i);
+		if (cl_otable_type(src->objects, srcstatementhandle) & HILBERT_TYPE_EXTERNAL)
+			continue;
+		const struct Statement * srcstatement = &cl_otable_record(src->objects, srcstatementhandle)->statement;
+		termmap[srcstatement->conclusion] = 0;
+		for (size_t j = 0; j != srcstatement->hypcount; ++j)
+			termmap[srcstatement->hyps[j]] = 0;
+	}
+	size_t maxargc = 0;
+	for (size_t i = srctermcount; i != 0; --i) {
+		if (termmap[i - 1] == PARAM_TERM_NONE)
+			continue;
+		const struct Term * node = cl_tstore_get(src->terms, i - 1);
+		if (node->argc > maxargc)
+			maxargc = node->argc;
+		for (size_t j = 0; j != node->argc; ++j)
+			termmap[node->args[j]] = 0;
+	}
+
+	/* translate the marked terms */
+	if (maxargc >= SIZE_MAX / sizeof(*args)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto error;
+	}
+	args = malloc((maxargc + 1) * sizeof(*args));
+	if (args == NULL) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto error;
+	}
+	for (size_t i = 0; i != srctermcount; ++i) {
+		if (termmap[i] == PARAM_TERM_NONE)
+			continue;
+		const struct Term * node = cl_tstore_get(src->terms, i);
+		HilbertHandle head;
+		if (cl_otable_type(src->objects, node->head) & HILBERT_TYPE_VAR) {
+			/* each source variable has exactly one term, so it is replaced exactly once */
+			const HilbertHandle * kind = hilbert_pmap_pre(param->handle_map, cl_otable_kind(src->objects, node->head));
+			assert (kind != NULL);
+			head = cl_otable_count(dest->objects);
+			if (cl_otable_pushback(dest->objects, (struct ObjectRow) { .type = HILBERT_TYPE_VAR, .kind = *kind }) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto error;
+			}
+			if (hilbert_ivector_pushback(dest->varhandles, head) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto error;
+			}
+		} else {
+			const HilbertHandle * functor = hilbert_pmap_pre(param->handle_map, node->head);
+			assert (functor != NULL);
+			head = *functor;
+			/* the functor may have been mapped by the caller, so check the argument kinds in dest */
+			const struct BasicFunctor * record = &cl_otable_record(dest->objects, head)->basic_functor;
+			if (record->place_count != node->argc) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto error;
+			}
+			const HilbertHandle * inputkinds = hilbert_functor_inputkinds(record);
+			for (size_t j = 0; j != node->argc; ++j) {
+				args[j] = termmap[node->args[j]];
+				HilbertHandle kind = cl_otable_kind(dest->objects, cl_tstore_get(dest->terms, args[j])->head);
+				if (!hilbert_kind_isequivalent_nocheck(dest, kind, inputkinds[j])) {
+					errcode = HILBERT_ERR_INVALID_MAPPING;
 					goto error;
 				}
 			}
-			for (size_t i = 0; i != destfunctor->place_count; ++i) {
-				const HilbertHandle * handle = hilbert_pmap_pre(param->handle_map, srcfunctor->input_kinds[i]);
-				assert (handle != NULL);
-				assert (hilbert_object_retrieve(dest, *handle, HILBERT_TYPE_KIND) != NULL);
-				destfunctor->input_kinds[i] = *handle;
-			}
-			if (hilbert_pmap_add(param->handle_map, destfunctorhandle, srcfunctorhandle) != 0) {
+		}
+		if (cl_tstore_intern(dest->terms, dest->arena, head, node->argc, args, termmap + i) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+	}
+
+	/* create the statements */
+	for (IndexVectorIterator i = hilbert_ivector_iterator_new(src->statementhandles);
+			hilbert_ivector_iterator_hasnext(&i);) {
+		HilbertHandle srcstatementhandle = hilbert_ivector_iterator_next(&i);
+		unsigned int srctype = cl_otable_type(src->objects, srcstatementhandle);
+		if (srctype & HILBERT_TYPE_EXTERNAL)
+			continue;
+		const struct Statement * srcstatement = &cl_otable_record(src->objects, srcstatementhandle)->statement;
+		union Object * destobject = cl_arena_alloc(dest->arena, sizeof(*destobject));
+		if (destobject == NULL) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+		HilbertHandle * hyps = NULL;
+		if (srcstatement->hypcount != 0) {
+			assert (srcstatement->hypcount < SIZE_MAX / sizeof(*hyps));
+			hyps = cl_arena_alloc(dest->arena, srcstatement->hypcount * sizeof(*hyps));
+			if (hyps == NULL) {
 				errcode = HILBERT_ERR_NOMEM;
 				goto error;
 			}
+			for (size_t j = 0; j != srcstatement->hypcount; ++j)
+				hyps[j] = termmap[srcstatement->hyps[j]];
+		}
+		destobject->statement = (struct Statement) {
+			.conclusion = termmap[srcstatement->conclusion],
+			.hypcount = srcstatement->hypcount,
+			.hyps = hyps
+		};
+		HilbertHandle deststatementhandle = cl_otable_count(dest->objects);
+		if (cl_otable_pushback(dest->objects, (struct ObjectRow) {
+			.type = srctype | HILBERT_TYPE_EXTERNAL,
+			.paramindex = paramindex,
+			.record = destobject
+		}) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+		if (hilbert_ivector_pushback(dest->statementhandles, deststatementhandle) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
+		}
+		if (hilbert_pmap_add(param->handle_map, deststatementhandle, srcstatementhandle) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto error;
 		}
 	}
 
 	errcode = 0;
 
+success:
 error:
+	free(args);
+	free(termmap);
+	if (matching)
+		statement_matcher_fini(&matcher);
 	return errcode;
 }
 
+/**
+ * Reserves space in a destination module for loading the objects of a source module.
+ * Loading creates at most one object for the new parameter and one for each source kind, variable, functor
+ * and statement, so afterwards the object table and the handle vectors of the destination module
+ * need not be grown while loading.
+ *
+ * @param dest Pointer to destination module, assumed to be locked.
+ * @param src Pointer to source module, assumed to be immutable.
+ *
+ * @return On success, <code>0</code> is returned. On error, a nonzero value is returned.
+ * 	Only the allocated space of the destination module is changed, regardless of success.
+ */
+static int reserve_load(HilbertModule * restrict dest, HilbertModule * restrict src) {
+	assert (dest != NULL);
+	assert (src != NULL);
+
+	/* all source objects are counted, so the sum cannot overflow */
+	size_t kindcount = hilbert_ivector_count(src->kindhandles);
+	size_t varcount = hilbert_ivector_count(src->varhandles);
+	size_t functorcount = hilbert_ivector_count(src->functorhandles);
+	size_t statementcount = hilbert_ivector_count(src->statementhandles);
+	size_t loadcount = kindcount + varcount + functorcount + statementcount;
+	size_t objectcount = cl_otable_count(dest->objects);
+	size_t destkindcount = hilbert_ivector_count(dest->kindhandles);
+	size_t destvarcount = hilbert_ivector_count(dest->varhandles);
+	size_t destfunctorcount = hilbert_ivector_count(dest->functorhandles);
+	size_t deststatementcount = hilbert_ivector_count(dest->statementhandles);
+	if ((loadcount >= SIZE_MAX - objectcount) || (kindcount > SIZE_MAX - destkindcount)
+			|| (varcount > SIZE_MAX - destvarcount) || (functorcount > SIZE_MAX - destfunctorcount)
+			|| (statementcount > SIZE_MAX - deststatementcount))
+		return HILBERT_ERR_NOMEM;
+	if ((cl_otable_reserve(dest->objects, objectcount + 1 + loadcount) != 0)
+			|| (hilbert_ivector_reserve(dest->kindhandles, destkindcount + kindcount) != 0)
+			|| (cl_ufind_reserve(dest->kindeqc, destkindcount + kindcount) != 0)
+			|| (hilbert_ivector_reserve(dest->varhandles, destvarcount + varcount) != 0)
+			|| (hilbert_ivector_reserve(dest->functorhandles, destfunctorcount + functorcount) != 0)
+			|| (hilbert_ivector_reserve(dest->statementhandles, deststatementcount + statementcount) != 0))
+		return HILBERT_ERR_NOMEM;
+
+	return 0;
+}
+
+
 HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule * restrict src, size_t argc,
 		const HilbertHandle * restrict argv, HilbertMapperCallback mapper, void * userdata, int * restrict errcode) {
 	assert (dest != NULL);
@@ -436,14 +568,23 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
 		goto invalidmodule;
 	}
 
-	if (mtx_lock(&dest->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto nodestlock;
+	/* dest must be mutable and src immutable, so they cannot be the same. */
+	if (dest == src) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		goto invalidmodule;
 	}
 
-	if (mtx_lock(&src->mutex) != thrd_success) {
+	/* src is immutable and hence read without locking it */
+	rc = hilbert_module_isimmutable(src, errcode);
+	if ((*errcode == 0) && (!rc))
+		*errcode = HILBERT_ERR_IMMUTABLE;
+	if (*errcode != 0)
+		goto invalidmodule;
+
+	unsigned long long start = hilbert_stats_clock();
+	if (hilbert_module_wrlock(dest) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
-		goto nosrclock;
+		goto nodestlock;
 	}
 
 	rc = hilbert_module_isimmutable(dest, errcode);
@@ -452,41 +593,44 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
 	if (*errcode != 0)
 		goto immutable;
 
-	rc = hilbert_module_isimmutable(src, errcode);
-	if ((*errcode == 0) && (!rc))
-		*errcode = HILBERT_ERR_IMMUTABLE;
-	if (*errcode != 0)
-		goto immutable;
-
 	if (hilbert_ivector_count(src->paramhandles) != argc) {
 		*errcode = HILBERT_ERR_COUNT_MISMATCH;
 		goto argerror;
 	}
 
 	for (size_t i = 0; i != argc; ++i) {
-		if (hilbert_object_retrieve(dest, argv[i], HILBERT_TYPE_PARAM) == NULL) {
+		if (!hilbert_object_check(dest, argv[i], HILBERT_TYPE_PARAM)) {
 			*errcode = HILBERT_ERR_INVALID_HANDLE;
 			goto argerror;
 		}
 	}
 
+	*errcode = reserve_load(dest, src);
+	if (*errcode != 0)
+		goto reserveerror;
+
 	/* parameter creation and loading */
-	union Object * param = param_create(src);
+	ArenaMark mark = cl_arena_mark(dest->arena);
+	union Object * param = param_create(dest, src);
 	if (param == NULL) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparammem;
 	}
 
-	size_t oldcount = hilbert_ovector_count(dest->objects);
+	size_t oldcount = cl_otable_count(dest->objects);
 	result = oldcount;
 
-	if (hilbert_ovector_pushback(dest->objects, param) != 0) {
+	if (cl_otable_pushback(dest->objects, (struct ObjectRow) { .type = HILBERT_TYPE_PARAM, .record = param }) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
 	}
 
 	size_t paramindex = hilbert_ivector_count(dest->paramhandles);
 	size_t oldkcount = hilbert_ivector_count(dest->kindhandles);
+	if (cl_ufind_journal_begin(dest->kindeqc) != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nojournalmem;
+	}
 	*errcode = load_kinds(dest, src, argv, mapper, userdata, &param->param, paramindex);
 	if (*errcode != 0)
 		goto kindloaderror;
@@ -494,7 +638,13 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
 	*errcode = load_functors(dest, src, argv, mapper, userdata, &param->param, paramindex); // FIXME: abbrev, def?
 	if (*errcode != 0)
 		goto functorloaderror;
-	
+	size_t oldvcount = hilbert_ivector_count(dest->varhandles);
+	size_t oldscount = hilbert_ivector_count(dest->statementhandles);
+	size_t oldtcount = cl_tstore_count(dest->terms);
+	*errcode = load_statements(dest, src, argv, mapper, userdata, &param->param, paramindex);
+	if (*errcode != 0)
+		goto statementloaderror;
+
 	if (hilbert_ivector_pushback(dest->paramhandles, result) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparamhandlemem;
@@ -504,32 +654,39 @@ HilbertHandle hilbert_module_param(HilbertModule * restrict dest, HilbertModule
 	if (*errcode != 0)
 		goto deperror;
 
+	cl_ufind_journal_commit(dest->kindeqc);
+	hilbert_stats_add(dest, transfers, 1);
+	hilbert_stats_add(dest, transfernanos, hilbert_stats_clock() - start);
 	goto success;
 
 deperror:
+	hilbert_ivector_popback(dest->paramhandles);
 noparamhandlemem:
+statementloaderror:
+	cl_tstore_downsize(dest->terms, oldtcount);
+	if (hilbert_ivector_downsize(dest->statementhandles, oldscount) != 0)
+		*errcode = HILBERT_ERR_INTERNAL;
+	if (hilbert_ivector_downsize(dest->varhandles, oldvcount) != 0)
+		*errcode = HILBERT_ERR_INTERNAL;
 functorloaderror:
 	if (hilbert_ivector_downsize(dest->functorhandles, oldfcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
 kindloaderror:
+	cl_ufind_journal_rollback(dest->kindeqc);
+nojournalmem:
 	if (hilbert_ivector_downsize(dest->kindhandles, oldkcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
-	size_t newcount = hilbert_ovector_count(dest->objects);
-	for (size_t i = oldcount + 1; i < newcount; ++i) { /* param is freed below */
-		hilbert_object_free(hilbert_ovector_get(dest->objects, i));
-	}
-	if (hilbert_ovector_downsize(dest->objects, oldcount) != 0)
+	if (cl_otable_downsize(dest->objects, oldcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
 noobjectmem:
 	hilbert_param_free(param);
+	cl_arena_rewind(dest->arena, mark);
 noparammem:
+reserveerror:
 argerror:
 immutable:
 success:
-	if (mtx_unlock(&src->mutex) != thrd_success)
-		*errcode = HILBERT_ERR_INTERNAL;
-nosrclock:
-	if (mtx_unlock(&dest->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(dest) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nodestlock:
 invalidmodule:
@@ -558,21 +715,18 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
 		goto invalidmodule;
 	}
 
-	if (mtx_lock(&dest->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto nodestlock;
-	}
-
-	if (mtx_lock(&src->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto nosrclock;
-	}
-
+	/* src is immutable and hence read without locking it */
 	rc = hilbert_module_isimmutable(src, errcode);
 	if ((*errcode == 0) && (!rc))
 		*errcode = HILBERT_ERR_IMMUTABLE;
 	if (*errcode != 0)
-		goto immutable;
+		goto invalidmodule;
+
+	unsigned long long start = hilbert_stats_clock();
+	if (hilbert_module_wrlock(dest) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nodestlock;
+	}
 
 	if (hilbert_ivector_count(src->paramhandles) != argc) {
 		*errcode = HILBERT_ERR_COUNT_MISMATCH;
@@ -580,29 +734,38 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
 	}
 
 	for (size_t i = 0; i != argc; ++i) {
-		if (hilbert_object_retrieve(dest, argv[i], HILBERT_TYPE_PARAM) == NULL) {
+		if (!hilbert_object_check(dest, argv[i], HILBERT_TYPE_PARAM)) {
 			*errcode = HILBERT_ERR_INVALID_HANDLE;
 			goto argerror;
 		}
 	}
 
+	*errcode = reserve_load(dest, src);
+	if (*errcode != 0)
+		goto reserveerror;
+
 	/* parameter creation and loading */
-	union Object * param = param_create(src);
+	ArenaMark mark = cl_arena_mark(dest->arena);
+	union Object * param = param_create(dest, src);
 	if (param == NULL) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparammem;
 	}
 
-	size_t oldcount = hilbert_ovector_count(dest->objects);
+	size_t oldcount = cl_otable_count(dest->objects);
 	result = oldcount;
 
-	if (hilbert_ovector_pushback(dest->objects, param) != 0) {
+	if (cl_otable_pushback(dest->objects, (struct ObjectRow) { .type = HILBERT_TYPE_PARAM, .record = param }) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
 	}
 
 	size_t paramindex = hilbert_ivector_count(dest->paramhandles);
 	size_t oldkcount = hilbert_ivector_count(dest->kindhandles);
+	if (cl_ufind_journal_begin(dest->kindeqc) != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nojournalmem;
+	}
 	*errcode = load_kinds(dest, src, argv, mapper, userdata, &param->param, paramindex);
 	if (*errcode != 0)
 		goto kindloaderror;
@@ -610,8 +773,13 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
 	*errcode = load_functors(dest, src, argv, mapper, userdata, &param->param, paramindex); // FIXME: abbrev, def?
 	if (*errcode != 0)
 		goto functorloaderror;
-	// FIXME: statements
-	
+	size_t oldvcount = hilbert_ivector_count(dest->varhandles);
+	size_t oldscount = hilbert_ivector_count(dest->statementhandles);
+	size_t oldtcount = cl_tstore_count(dest->terms);
+	*errcode = load_statements(dest, src, argv, mapper, userdata, &param->param, paramindex);
+	if (*errcode != 0)
+		goto statementloaderror;
+
 	if (hilbert_ivector_pushback(dest->paramhandles, result) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noparamhandlemem;
@@ -621,32 +789,38 @@ HilbertHandle hilbert_module_import(HilbertModule * restrict dest, HilbertModule
 	if (*errcode != 0)
 		goto deperror;
 
+	cl_ufind_journal_commit(dest->kindeqc);
+	hilbert_stats_add(dest, transfers, 1);
+	hilbert_stats_add(dest, transfernanos, hilbert_stats_clock() - start);
 	goto success;
 
 deperror:
+	hilbert_ivector_popback(dest->paramhandles);
 noparamhandlemem:
+statementloaderror:
+	cl_tstore_downsize(dest->terms, oldtcount);
+	if (hilbert_ivector_downsize(dest->statementhandles, oldscount) != 0)
+		*errcode = HILBERT_ERR_INTERNAL;
+	if (hilbert_ivector_downsize(dest->varhandles, oldvcount) != 0)
+		*errcode = HILBERT_ERR_INTERNAL;
 functorloaderror:
 	if (hilbert_ivector_downsize(dest->functorhandles, oldfcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
 kindloaderror:
+	cl_ufind_journal_rollback(dest->kindeqc);
+nojournalmem:
 	if (hilbert_ivector_downsize(dest->kindhandles, oldkcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
-	size_t newcount = hilbert_ovector_count(dest->objects);
-	for (size_t i = oldcount + 1; i < newcount; ++i) { /* param is freed below */
-		hilbert_object_free(hilbert_ovector_get(dest->objects, i));
-	}
-	if (hilbert_ovector_downsize(dest->objects, oldcount) != 0)
+	if (cl_otable_downsize(dest->objects, oldcount) != 0)
 		*errcode = HILBERT_ERR_INTERNAL;
 noobjectmem:
 	hilbert_param_free(param);
+	cl_arena_rewind(dest->arena, mark);
 noparammem:
+reserveerror:
 argerror:
-immutable:
 success:
-	if (mtx_unlock(&src->mutex) != thrd_success)
-		*errcode = HILBERT_ERR_INTERNAL;
-nosrclock:
-	if (mtx_unlock(&dest->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(dest) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nodestlock:
 invalidmodule:
@@ -24,10 +24,11 @@
 
 #include<assert.h>
 #include<stdlib.h>
+#include<string.h>
 
-#include"cl/iset.h"
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
+#include"cl/ufind.h"
 
 #include"threads/hthreads.h"
 
@@ -38,7 +39,6 @@ static HilbertHandle kind_create_by_type(struct HilbertModule * restrict module,
 	assert (module != NULL);
 	assert (errcode != NULL);
 
-	union Object * object;
 	int rc;
 	size_t result = 0;
 
@@ -47,7 +47,7 @@ static HilbertHandle kind_create_by_type(struct HilbertModule * restrict module,
 		goto invalid_module;
 	}
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
@@ -60,20 +60,16 @@ static HilbertHandle kind_create_by_type(struct HilbertModule * restrict module,
 		goto immutable;
 	}
 
-	object = malloc(sizeof(*object));
-	if (object == NULL) {
-		*errcode = HILBERT_ERR_NOMEM;
-		goto nokindmem;
-	}
-	object->kind = (struct Kind) { .type = type, .equivalence_class = NULL };
-
-	result = hilbert_ovector_count(module->objects);
+	result = cl_otable_count(module->objects);
 	if (result > HILBERT_HANDLE_MAX) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nohandle;
 	}
 
-	*errcode = hilbert_ovector_pushback(module->objects, object);
+	*errcode = cl_otable_pushback(module->objects, (struct ObjectRow) {
+		.type = type,
+		.eqcindex = hilbert_ivector_count(module->kindhandles)
+	});
 	if (*errcode != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noconsmem;
@@ -85,17 +81,23 @@ static HilbertHandle kind_create_by_type(struct HilbertModule * restrict module,
 		goto nohandlemem;
 	}
 
+	*errcode = cl_ufind_add(module->kindeqc);
+	if (*errcode != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto noeqcmem;
+	}
+
 	goto success;
 
+noeqcmem:
+	hilbert_ivector_popback(module->kindhandles);
 nohandlemem:
-	hilbert_ovector_popback(module->objects);
+	cl_otable_popback(module->objects);
 noconsmem:
 nohandle:
-	free(object);
-nokindmem:
 immutable:
 success:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 invalid_module:
@@ -110,6 +112,78 @@ HilbertHandle hilbert_vkind_create(HilbertModule * restrict module, int * restri
 	return kind_create_by_type(module, errcode, HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND);
 }
 
+/**
+ * Implements #hilbert_kind_create_n() or #hilbert_vkind_create_n() by type.
+ */
+static int kind_create_n_by_type(struct HilbertModule * restrict module, size_t count, HilbertHandle * restrict kinds,
+		unsigned int type) {
+	assert (module != NULL);
+	assert ((count == 0) || (kinds != NULL));
+
+	int errcode;
+	int rc;
+
+	if (hilbert_module_gettype(module) != HILBERT_INTERFACE_MODULE) {
+		errcode = HILBERT_ERR_INVALID_MODULE;
+		goto invalid_module;
+	}
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, &errcode);
+	if (errcode != 0)
+		goto immutable;
+	if (rc) {
+		errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	/* reserve all space up front, so that the objects can be added without failure */
+	size_t first = cl_otable_count(module->objects);
+	size_t eqcindex = hilbert_ivector_count(module->kindhandles);
+	if ((count > HILBERT_HANDLE_MAX - first) || (count > SIZE_MAX - eqcindex)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
+	}
+	if ((cl_otable_reserve(module->objects, first + count) != 0)
+			|| (hilbert_ivector_reserve(module->kindhandles, eqcindex + count) != 0)
+			|| (cl_ufind_reserve(module->kindeqc, eqcindex + count) != 0)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
+	}
+
+	for (size_t i = 0; i != count; ++i) {
+		rc = cl_otable_pushback(module->objects, (struct ObjectRow) { .type = type, .eqcindex = eqcindex + i });
+		assert (rc == 0);
+		rc = hilbert_ivector_pushback(module->kindhandles, first + i);
+		assert (rc == 0);
+		rc = cl_ufind_add(module->kindeqc);
+		assert (rc == 0);
+		kinds[i] = first + i;
+	}
+
+	errcode = 0;
+
+nomem:
+immutable:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+nolock:
+invalid_module:
+	return errcode;
+}
+
+int hilbert_kind_create_n(HilbertModule * restrict module, size_t count, HilbertHandle * restrict kinds) {
+	return kind_create_n_by_type(module, count, kinds, HILBERT_TYPE_KIND);
+}
+
+int hilbert_vkind_create_n(HilbertModule * restrict module, size_t count, HilbertHandle * restrict kinds) {
+	return kind_create_n_by_type(module, count, kinds, HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND);
+}
+
 HilbertHandle hilbert_kind_alias(HilbertModule * restrict module, HilbertHandle kindhandle, int * restrict errcode) {
 	assert (module != NULL);
 	assert (errcode != NULL);
@@ -117,7 +191,7 @@ HilbertHandle hilbert_kind_alias(HilbertModule * restrict module, HilbertHandle
 	int rc;
 	size_t result = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
@@ -130,67 +204,44 @@ HilbertHandle hilbert_kind_alias(HilbertModule * restrict module, HilbertHandle
 		goto immutable;
 	}
 
-	union Object * newobject = malloc(sizeof(*newobject));
-	if (newobject == NULL) {
-		*errcode = HILBERT_ERR_NOMEM;
-		goto nokindmem;
-	}
-
-	union Object * object = hilbert_object_retrieve(module, kindhandle, HILBERT_TYPE_KIND);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, kindhandle, HILBERT_TYPE_KIND)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
-	newobject->kind.type = object->kind.type;
-
-	IndexSet * equivalence_class;
-	if (object->kind.equivalence_class != NULL) {
-		equivalence_class = object->kind.equivalence_class;
-	} else {
-		equivalence_class = hilbert_iset_new();
-		if (equivalence_class == NULL) {
-			*errcode = HILBERT_ERR_NOMEM;
-			goto noeqcmem;
-		}
-	}
+	size_t eqcindex = hilbert_ivector_count(module->kindhandles);
 
-	result = hilbert_ovector_count(module->objects);
+	result = cl_otable_count(module->objects);
 	if (hilbert_ivector_pushback(module->kindhandles, result) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto nokindhandlemem;
 	}
-	if (hilbert_ovector_pushback(module->objects, newobject) != 0) {
+	if (cl_otable_pushback(module->objects, (struct ObjectRow) {
+		.type = cl_otable_type(module->objects, kindhandle),
+		.paramindex = cl_otable_paramindex(module->objects, kindhandle),
+		.eqcindex = eqcindex
+	}) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
 	}
-	if (hilbert_iset_add(equivalence_class, kindhandle) != 0) {
-		*errcode = HILBERT_ERR_NOMEM;
-		goto noeqeltmem;
-	}
-	if (hilbert_iset_add(equivalence_class, result) != 0) {
+	if (cl_ufind_add(module->kindeqc) != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
-		goto noeqeltmem;
+		goto noeqcmem;
 	}
 
-	object->kind.equivalence_class = equivalence_class;
-	newobject->kind.equivalence_class = equivalence_class;
+	cl_ufind_union(module->kindeqc, cl_otable_eqcindex(module->objects, kindhandle), eqcindex);
+	hilbert_stats_add(module, merges, 1);
 
 	goto success;
 
-noeqeltmem:
-	hilbert_ovector_popback(module->objects);
+noeqcmem:
+	cl_otable_popback(module->objects);
 noobjectmem:
 	hilbert_ivector_popback(module->kindhandles);
 nokindhandlemem:
-	if (object->kind.equivalence_class == NULL)
-		hilbert_iset_del(equivalence_class);
-noeqcmem:
 wronghandle:
-	free(newobject);
-nokindmem:
 immutable:
 success:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
@@ -207,7 +258,7 @@ int hilbert_kind_identify(struct HilbertModule * module, HilbertHandle kindhandl
 		goto invalidmodule;
 	}
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
@@ -223,7 +274,7 @@ int hilbert_kind_identify(struct HilbertModule * module, HilbertHandle kindhandl
 	errcode = hilbert_kind_identify_nocheck(module, kindhandle1, kindhandle2);
 
 immutable:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		errcode = HILBERT_ERR_INTERNAL;
 nolock:
 invalidmodule:
@@ -237,40 +288,63 @@ int hilbert_kind_isequivalent(struct HilbertModule * restrict module, HilbertHan
 
 	int rc = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object1 = hilbert_object_retrieve(module, kindhandle1, HILBERT_TYPE_KIND);
-	union Object * object2 = hilbert_object_retrieve(module, kindhandle2, HILBERT_TYPE_KIND);
-	if ((object1 == NULL) || (object2 == NULL)) {
+	if ((!hilbert_object_check(module, kindhandle1, HILBERT_TYPE_KIND))
+			|| (!hilbert_object_check(module, kindhandle2, HILBERT_TYPE_KIND))) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
 
 	*errcode = 0;
 
-	if (object1 == object2) {
-		rc = 1;
-		goto equality;
-	}
-	if ((object1->kind.equivalence_class == NULL)
-			|| (object1->kind.equivalence_class != object2->kind.equivalence_class)) {
-		goto inequivalent;
-	}
-
-	rc = 1;
+	rc = (cl_ufind_find_readonly(module->kindeqc, cl_otable_eqcindex(module->objects, kindhandle1))
+			== cl_ufind_find_readonly(module->kindeqc, cl_otable_eqcindex(module->objects, kindhandle2)));
 
-inequivalent:
-equality:
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return rc;
 }
 
+/**
+ * Copies the beginning of an equivalence class of kinds to a buffer.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be locked for reading.
+ * @param eqcindex Equivalence class index of a kind in <code>module</code>.
+ * @param buffer Pointer to the first element of an array of <code>bufsize</code> handles.
+ * 	If <code>bufsize == 0</code>, this may be <code>NULL</code>.
+ * @param bufsize Maximum number of handles to be copied.
+ *
+ * @return The number of kinds in the equivalence class is returned.
+ */
+static size_t eqc_copy(struct HilbertModule * module, size_t eqcindex, HilbertHandle * buffer, size_t bufsize) {
+	if (module->eqcranges != NULL) {
+		/* immutable module, classes are laid out in order */
+		struct EqcRange range = module->eqcranges[eqcindex];
+		if (bufsize > range.count)
+			bufsize = range.count;
+		if (bufsize != 0)
+			memcpy(buffer, module->eqckinds + range.first, bufsize * sizeof(*buffer));
+		return range.count;
+	}
+
+	size_t count = 0;
+	size_t i = eqcindex;
+	do {
+		if (count < bufsize)
+			buffer[count] = hilbert_ivector_get(module->kindhandles, i);
+		++count;
+		i = cl_ufind_next(module->kindeqc, i);
+	} while (i != eqcindex);
+
+	return count;
+}
+
 HilbertHandle * hilbert_kind_equivalenceclass(struct HilbertModule * restrict module, HilbertHandle kindhandle,
 		size_t * restrict count, int * restrict errcode) {
 	assert (module != NULL);
@@ -279,38 +353,30 @@ HilbertHandle * hilbert_kind_equivalenceclass(struct HilbertModule * restrict mo
 
 	HilbertHandle * result = NULL;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object = hilbert_object_retrieve(module, kindhandle, HILBERT_TYPE_KIND);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, kindhandle, HILBERT_TYPE_KIND)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
 
-	*errcode = HILBERT_ERR_NOMEM;
-	if (object->kind.equivalence_class == NULL) {
-		*count = 1;
-		result = malloc(sizeof(*result));
-		if (result == NULL)
-			goto nomem;
-		result[0] = kindhandle;
-	} else {
-		*count = hilbert_iset_count(object->kind.equivalence_class);
-		result = malloc(*count * sizeof(*result));
-		if (result == NULL)
-			goto nomem;
-		IndexSetIterator iterator = hilbert_iset_iterator_new(object->kind.equivalence_class);
-		for (size_t i = 0; i != *count; ++i)
-			result[i] = hilbert_iset_iterator_next(&iterator);
+	size_t eqcindex = cl_otable_eqcindex(module->objects, kindhandle);
+	*count = eqc_copy(module, eqcindex, NULL, 0);
+
+	result = malloc(*count * sizeof(*result));
+	if (result == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
 	}
+	eqc_copy(module, eqcindex, result, *count);
 	*errcode = 0;
 
 nomem:
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdunlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		free(result);
 		result = NULL;
@@ -319,3 +385,55 @@ nolock:
 	return result;
 }
 
+const HilbertHandle * hilbert_kind_equivalenceclass_view(struct HilbertModule * restrict module, HilbertHandle kindhandle,
+		size_t * restrict count, int * restrict errcode) {
+	assert (module != NULL);
+	assert (count != NULL);
+	assert (errcode != NULL);
+
+	/* views are only handed out for immutable modules, which need not be locked */
+	if (!atomic_load_explicit(&module->immutable, memory_order_acquire)) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		return NULL;
+	}
+
+	if (!hilbert_object_check(module, kindhandle, HILBERT_TYPE_KIND)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		return NULL;
+	}
+
+	struct EqcRange range = module->eqcranges[cl_otable_eqcindex(module->objects, kindhandle)];
+	*count = range.count;
+	*errcode = 0;
+
+	return module->eqckinds + range.first;
+}
+
+size_t hilbert_kind_equivalenceclass_buf(struct HilbertModule * restrict module, HilbertHandle kindhandle,
+		HilbertHandle * restrict buffer, size_t bufsize, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((bufsize == 0) || (buffer != NULL));
+	assert (errcode != NULL);
+
+	size_t result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (!hilbert_object_check(module, kindhandle, HILBERT_TYPE_KIND)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+
+	result = eqc_copy(module, cl_otable_eqcindex(module->objects, kindhandle), buffer, bufsize);
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
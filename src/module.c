@@ -21,17 +21,40 @@
  */
 
 #include"private.h"
+#include"image.h"
 
 #include<assert.h>
 #include<stdlib.h>
 
-#include"cl/iset.h"
+#include"cl/arena.h"
 #include"cl/mset.h"
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+#include"cl/ufind.h"
 
 #include"threads/hthreads.h"
 
+tss_t hilbert_module_writer;
+
+/**
+ * Guards the creation of <code>#hilbert_module_writer</code>.
+ */
+static once_flag writer_once = ONCE_FLAG_INIT;
+
+/**
+ * Nonzero if <code>#hilbert_module_writer</code> could not be created.
+ */
+static int writer_keyerror;
+
+/**
+ * Creates <code>#hilbert_module_writer</code>.
+ */
+static void writer_keyinit(void) {
+	if (tss_create(&hilbert_module_writer, NULL) != thrd_success)
+		writer_keyerror = 1;
+}
+
 HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 	struct HilbertModule * module;
 	int errcode;
@@ -39,6 +62,11 @@ HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 	if ((type != HILBERT_INTERFACE_MODULE) && (type != HILBERT_PROOF_MODULE))
 		goto wrongtype;
 
+	/* every module is created before it is locked */
+	call_once(&writer_once, writer_keyinit);
+	if (writer_keyerror)
+		goto nokey;
+
 	module = malloc(sizeof(*module));
 	if (module == NULL)
 		goto allocfail;
@@ -47,15 +75,23 @@ HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 
 	module->type = type;
 
-	errcode = mtx_init(&module->mutex, mtx_plain | mtx_recursive);
+	errcode = rwl_init(&module->lock);
 	if (errcode != thrd_success)
-		goto mutexfail;
+		goto lockfail;
+
+	errcode = mtx_init(&module->deplock, mtx_plain);
+	if (errcode != thrd_success)
+		goto deplockfail;
 
 	module->immutable = 0;
 	module->freeable = 0;
 	module->ancillary = NULL;
 
-	module->objects = hilbert_ovector_new();
+	module->arena = cl_arena_new();
+	if (module->arena == NULL)
+		goto noarenamem;
+
+	module->objects = cl_otable_new();
 	if (module->objects == NULL)
 		goto noobjectmem;
 
@@ -63,6 +99,12 @@ HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 	if (module->kindhandles == NULL)
 		goto nokindhandlesmem;
 
+	module->kindeqc = cl_ufind_new();
+	if (module->kindeqc == NULL)
+		goto nokindeqcmem;
+	module->eqckinds = NULL;
+	module->eqcranges = NULL;
+
 	module->varhandles = hilbert_ivector_new();
 	if (module->varhandles == NULL)
 		goto novarhandlesmem;
@@ -75,6 +117,14 @@ HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 	if (module->paramhandles == NULL)
 		goto noparamhandlesmem;
 
+	module->statementhandles = hilbert_ivector_new();
+	if (module->statementhandles == NULL)
+		goto nostatementhandlesmem;
+
+	module->terms = cl_tstore_new();
+	if (module->terms == NULL)
+		goto notermsmem;
+
 	module->dependencies = hilbert_mset_new();
 	if (module->dependencies == NULL)
 		goto nodepmem;
@@ -83,25 +133,41 @@ HilbertModule * hilbert_module_create(enum HilbertModuleType type) {
 	if (module->reverse_dependencies == NULL)
 		goto noreversedepmem;
 
+	module->image = NULL;
+	module->mapsize = 0;
+
+	hilbert_stats_init(module);
+
 	return module;
 
 noreversedepmem:
 	hilbert_mset_del(module->dependencies);
 nodepmem:
+	cl_tstore_del(module->terms);
+notermsmem:
+	hilbert_ivector_del(module->statementhandles);
+nostatementhandlesmem:
 	hilbert_ivector_del(module->paramhandles);
 noparamhandlesmem:
 	hilbert_ivector_del(module->functorhandles);
 nofunctorhandlesmem:
 	hilbert_ivector_del(module->varhandles);
 novarhandlesmem:
+	cl_ufind_del(module->kindeqc);
+nokindeqcmem:
 	hilbert_ivector_del(module->kindhandles);
 nokindhandlesmem:
-	hilbert_ovector_del(module->objects);
+	cl_otable_del(module->objects);
 noobjectmem:
-	mtx_destroy(&module->mutex);
-mutexfail:
+	cl_arena_del(module->arena);
+noarenamem:
+	mtx_destroy(&module->deplock);
+deplockfail:
+	rwl_destroy(&module->lock);
+lockfail:
 	free(module);
 allocfail:
+nokey:
 wrongtype:
 	return NULL;
 }
@@ -110,67 +176,60 @@ void hilbert_module_free(struct HilbertModule * module) {
 	assert (module != NULL);
 	int rc;
 
-	/* Remove module from dependencies and possibly deallocate them */
-	rc = mtx_lock(&module->mutex);
+	/* Remove module from dependencies and possibly deallocate them.
+	 * Only the dependency locks are taken here, so that this cannot deadlock with concurrent imports
+	 * or with the freeing of modules depending on this one. */
+	rc = hilbert_module_deplock(module);
 	assert (rc == thrd_success);
 
 	module->freeable = 1;
 
 	for (ModuleSetIterator i = hilbert_mset_iterator_new(module->dependencies); hilbert_mset_iterator_hasnext(&i);) {
 		struct HilbertModule * dependency = hilbert_mset_iterator_next(&i);
-		rc = mtx_lock(&dependency->mutex);
+		rc = hilbert_module_deplock(dependency);
 		assert (rc == thrd_success);
 		rc = hilbert_mset_remove(dependency->reverse_dependencies, module);
 		assert (rc);
 		int freeable = dependency->freeable;
 		size_t count = hilbert_mset_count(dependency->reverse_dependencies);
-		rc = mtx_unlock(&dependency->mutex);
+		rc = hilbert_module_depunlock(dependency);
 		assert (rc == thrd_success);
-		hilbert_mset_remove(module->dependencies, dependency);
 		if (freeable && (count == 0)) {
 			/* dependency is freeable and its dependencies and reverse dependencies are empty.
 			 * Hence it can be freed definitely this time. */
 			hilbert_module_free(dependency);
 		}
 	}
+	/* removing elements while iterating is not allowed, so the dependencies are cleared only now */
+	hilbert_mset_clear(module->dependencies);
 
 	/* return if we still have reverse dependencies and leave final freeing to them */
 	size_t count = hilbert_mset_count(module->reverse_dependencies);
-	rc = mtx_unlock(&module->mutex);
+	rc = hilbert_module_depunlock(module);
 	assert (rc == thrd_success);
 	if (count != 0)
 		return;
 
-	/* free kind equivalence classes */
-	for (IndexVectorIterator i = hilbert_ivector_iterator_new(module->kindhandles);
-			hilbert_ivector_iterator_hasnext(&i);) {
-		union Object * object = hilbert_ovector_get(module->objects, hilbert_ivector_iterator_next(&i));
-		assert (object->generic.type & HILBERT_TYPE_KIND);
-		IndexSet * equivalence_class = object->kind.equivalence_class;
-		if (equivalence_class == NULL)
-			continue;
-		for (IndexSetIterator j = hilbert_iset_iterator_new(equivalence_class);
-				hilbert_iset_iterator_hasnext(&j);) {
-			union Object * object2 = hilbert_ovector_get(module->objects, hilbert_iset_iterator_next(&j));
-			assert (object2->generic.type & HILBERT_TYPE_KIND);
-			object2->kind.equivalence_class = NULL;
-		}
-		hilbert_iset_del(equivalence_class);
-	}
-
 	/* free objects */
-	for (ObjectVectorIterator i = hilbert_ovector_iterator_new(module->objects); hilbert_ovector_iterator_hasnext(&i);)
-		hilbert_object_free(hilbert_ovector_iterator_next(&i));
+	for (IndexVectorIterator i = hilbert_ivector_iterator_new(module->paramhandles); hilbert_ivector_iterator_hasnext(&i);)
+		hilbert_param_free(cl_otable_record(module->objects, hilbert_ivector_iterator_next(&i)));
 
 	/* free other stuff */
 	hilbert_mset_del(module->reverse_dependencies);
 	hilbert_mset_del(module->dependencies);
+	cl_tstore_del(module->terms);
+	hilbert_ivector_del(module->statementhandles);
 	hilbert_ivector_del(module->paramhandles);
 	hilbert_ivector_del(module->functorhandles);
 	hilbert_ivector_del(module->varhandles);
+	cl_ufind_del(module->kindeqc);
 	hilbert_ivector_del(module->kindhandles);
-	hilbert_ovector_del(module->objects);
-	mtx_destroy(&module->mutex);
+	cl_otable_del(module->objects);
+	cl_arena_del(module->arena);
+	if (module->image != NULL)
+		hilbert_image_release(module->image, module->mapsize);
+	mtx_destroy(&module->deplock);
+	rwl_destroy(&module->lock);
 	free(module);
 }
 
@@ -191,7 +250,7 @@ int hilbert_module_makeimmutable(struct HilbertModule * module) {
 		goto wrongtype;
 	}
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		errcode = HILBERT_ERR_INTERNAL;
 		goto lockerror;
 	}
@@ -199,10 +258,22 @@ int hilbert_module_makeimmutable(struct HilbertModule * module) {
 	if (module->immutable) {
 		errcode = HILBERT_ERR_IMMUTABLE;
 	} else {
-		module->immutable = 1;
+		/* readers may access the module without locking from now on, so freeze everything they might write to */
+		errcode = hilbert_module_group_eqcs(module);
+		if (errcode == 0) {
+			cl_ufind_freeze(module->kindeqc);
+			/* no more objects will be added */
+			cl_otable_shrinktofit(module->objects);
+			hilbert_ivector_shrinktofit(module->kindhandles);
+			hilbert_ivector_shrinktofit(module->varhandles);
+			hilbert_ivector_shrinktofit(module->functorhandles);
+			hilbert_ivector_shrinktofit(module->paramhandles);
+			hilbert_ivector_shrinktofit(module->statementhandles);
+			atomic_store_explicit(&module->immutable, 1, memory_order_release);
+		}
 	}
 
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		errcode = HILBERT_ERR_INTERNAL;
 
 lockerror:
@@ -214,22 +285,10 @@ int hilbert_module_isimmutable(struct HilbertModule * restrict module, int * res
 	assert (module != NULL);
 	assert (errcode != NULL);
 
-	int rc = 0;
-
-	if (mtx_lock(&module->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto lockerror;
-	}
-
-	rc = module->immutable;
-
-	if (mtx_unlock(&module->mutex) != thrd_success) {
-		*errcode = HILBERT_ERR_INTERNAL;
-		goto lockerror;
-	}
+	/* No locking necessary, as the immutable flag never changes back */
+	int rc = atomic_load_explicit(&module->immutable, memory_order_acquire);
 
 	*errcode = 0;
-lockerror:
 	return rc;
 }
 
@@ -238,7 +297,7 @@ int hilbert_module_setancillary(struct HilbertModule * module, void * newdata, v
 
 	int errcode;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		errcode = HILBERT_ERR_INTERNAL;
 		goto lockerror;
 	}
@@ -247,7 +306,7 @@ int hilbert_module_setancillary(struct HilbertModule * module, void * newdata, v
 		*olddata = module->ancillary;
 	module->ancillary = newdata;
 
-	if (mtx_unlock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrunlock(module) != thrd_success) {
 		errcode = HILBERT_ERR_INTERNAL;
 		goto lockerror;
 	}
@@ -263,17 +322,94 @@ int hilbert_module_getancillary(struct HilbertModule * module, void ** data) {
 
 	int errcode = 0; // no error
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	/* the ancillary data may change even if the module is immutable, but not while we hold the write lock */
+	int writer = tss_get(hilbert_module_writer) == module;
+	if (!writer && (rwl_rdlock(&module->lock) != thrd_success)) {
 		errcode = HILBERT_ERR_INTERNAL;
 		goto lockerror;
 	}
 
 	*data = module->ancillary;
 
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (!writer && (rwl_unlock(&module->lock) != thrd_success))
+		errcode = HILBERT_ERR_INTERNAL;
+
+lockerror:
+	return errcode;
+}
+
+
+int hilbert_module_getstats(HilbertModule * restrict module, HilbertStats * restrict stats) {
+	assert (module != NULL);
+	assert (stats != NULL);
+
+	int errcode = 0; // no error
+	struct CLStats clstats = { .probes = 0, .rehashes = 0 };
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		errcode = HILBERT_ERR_INTERNAL;
+		goto lockerror;
+	}
+
+	stats->objects = cl_otable_count(module->objects);
+	stats->bytes = cl_otable_memsize(module->objects) + cl_arena_memsize(module->arena) + module->mapsize;
+	clstats = cl_tstore_stats(module->terms);
+	for (size_t i = 0, count = hilbert_ivector_count(module->paramhandles); i != count; ++i) {
+		union Object * param = cl_otable_record(module->objects, hilbert_ivector_get(module->paramhandles, i));
+		clstats = cl_stats_sum(clstats, hilbert_pmap_stats(param->param.handle_map));
+	}
+
+	if (hilbert_module_rdunlock(module) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto lockerror;
+	}
+
+	if (hilbert_module_deplock(module) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto lockerror;
+	}
+
+	clstats = cl_stats_sum(clstats, hilbert_mset_stats(module->dependencies));
+	clstats = cl_stats_sum(clstats, hilbert_mset_stats(module->reverse_dependencies));
+
+	if (hilbert_module_depunlock(module) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+
+	stats->rdlocks = hilbert_stats_get(module, rdlocks);
+	stats->wrlocks = hilbert_stats_get(module, wrlocks);
+	stats->contended = hilbert_stats_get(module, contended);
+	stats->probes = clstats.probes;
+	stats->rehashes = clstats.rehashes;
+	stats->merges = hilbert_stats_get(module, merges);
+	stats->transfers = hilbert_stats_get(module, transfers);
+	stats->transfernanos = hilbert_stats_get(module, transfernanos);
+	stats->proofsteps = hilbert_stats_get(module, proofsteps);
 
 lockerror:
 	return errcode;
 }
 
+size_t hilbert_module_getlocksites(HilbertModule * restrict module, HilbertLockSite * restrict sites,
+		int * restrict errcode) {
+	assert (module != NULL);
+	assert (sites != NULL);
+	assert (errcode != NULL);
+
+	size_t count = 0;
+
+#ifdef HILBERT_STATS
+	for (size_t i = 0; i != HILBERT_LOCK_SITES; ++i) {
+		const struct HilbertLockSite * entry = module->stats.sites + i;
+		const char * name = atomic_load_explicit(&entry->name, memory_order_acquire);
+		if (name == NULL)
+			continue;
+		sites[count].name = name;
+		for (size_t j = 0; j != HILBERT_LOCK_BUCKETS; ++j)
+			sites[count].waits[j] = atomic_load_explicit(&entry->waits[j], memory_order_relaxed);
+		++count;
+	}
+#endif
+
+	*errcode = 0;
+	return count;
+}
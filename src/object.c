@@ -26,7 +26,7 @@
 #include<stdlib.h>
 
 #include"cl/pmap.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
 
 #include"threads/hthreads.h"
 
@@ -38,12 +38,12 @@ HilbertHandle * hilbert_module_getobjects(struct HilbertModule * restrict module
 
 	HilbertHandle * result = NULL;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	*size = hilbert_ovector_count(module->objects);
+	*size = cl_otable_count(module->objects);
 	result = malloc(*size * sizeof(*result));
 	if (result == NULL) {
 		*errcode = HILBERT_ERR_NOMEM;
@@ -56,7 +56,7 @@ HilbertHandle * hilbert_module_getobjects(struct HilbertModule * restrict module
 	*errcode = 0;
 
 nomem:
-	if (mtx_unlock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdunlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		free(result);
 		result = NULL;
@@ -65,27 +65,53 @@ nolock:
 	return result;
 }
 
+size_t hilbert_module_getobjects_buf(struct HilbertModule * restrict module, HilbertHandle * restrict buffer,
+		size_t bufsize, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((bufsize == 0) || (buffer != NULL));
+	assert (errcode != NULL);
+
+	size_t result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	result = cl_otable_count(module->objects);
+	if (bufsize > result)
+		bufsize = result;
+	for (size_t i = 0; i != bufsize; ++i)
+		buffer[i] = i;
+
+	*errcode = 0;
+
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
 unsigned int hilbert_object_gettype(struct HilbertModule * restrict module, HilbertHandle handle, int * restrict errcode) {
 	assert (module != NULL);
 	assert (errcode != NULL);
 
 	unsigned int type = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object = hilbert_object_retrieve(module, handle, ~0U);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, handle, ~0U)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto invalidhandle;
 	}
-	type = object->generic.type;
+	type = cl_otable_type(module->objects, handle);
 	*errcode = 0;
 
 invalidhandle:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return type;
@@ -98,27 +124,22 @@ HilbertHandle hilbert_object_getparam(struct HilbertModule * restrict module, Hi
 
 	HilbertHandle result = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object = hilbert_object_retrieve(module, handle, HILBERT_TYPE_EXTERNAL);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, handle, HILBERT_TYPE_EXTERNAL)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
 
-	if (object->generic.type & HILBERT_TYPE_KIND) {
-		result = hilbert_ivector_get(module->paramhandles, object->external_kind.paramindex);
-	} else { // FIXME: functors, etc.
-		assert (0);
-	}
+	result = hilbert_ivector_get(module->paramhandles, cl_otable_paramindex(module->objects, handle));
 
 	*errcode = 0;
 
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
@@ -135,18 +156,18 @@ HilbertModule * hilbert_object_getsource(struct HilbertModule * restrict module,
 	if (*errcode != 0)
 		goto noparam;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object = hilbert_object_retrieve(module, param, HILBERT_TYPE_PARAM);
-	assert (object != NULL);
+	assert (hilbert_object_check(module, param, HILBERT_TYPE_PARAM));
+	union Object * object = cl_otable_record(module->objects, param);
 
 	result = object->param.module;
 	*errcode = 0;
 
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 
 nolock:
@@ -165,18 +186,18 @@ HilbertHandle hilbert_object_getsourcehandle(struct HilbertModule * restrict mod
 	if (*errcode != 0)
 		goto noparam;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * object = hilbert_object_retrieve(module, param, HILBERT_TYPE_PARAM);
-	assert (object != NULL);
+	assert (hilbert_object_check(module, param, HILBERT_TYPE_PARAM));
+	union Object * object = cl_otable_record(module->objects, param);
 
 	result = *hilbert_pmap_post(object->param.handle_map, handle);
 	*errcode = 0;
 
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 
 nolock:
@@ -191,16 +212,16 @@ HilbertHandle hilbert_object_getdesthandle(struct HilbertModule * restrict modul
 
 	HilbertHandle result = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	union Object * param = hilbert_object_retrieve(module, paramhandle, HILBERT_TYPE_PARAM);
-	if (param == NULL) {
+	if (!hilbert_object_check(module, paramhandle, HILBERT_TYPE_PARAM)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto noparam;
 	}
+	union Object * param = cl_otable_record(module->objects, paramhandle);
 
 	const HilbertHandle * resultp = hilbert_pmap_pre(param->param.handle_map, handle);
 	if (resultp == NULL) {
@@ -213,7 +234,7 @@ HilbertHandle hilbert_object_getdesthandle(struct HilbertModule * restrict modul
 
 nohandle:
 noparam:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
@@ -28,29 +28,39 @@
 #include<assert.h>
 #include<stdlib.h>
 
+#include"cl/arena.h"
+#include"cl/ihset.h"
+#include"cl/ivector.h"
+#include"cl/otable.h"
 #include"cl/pmap.h"
+#include"cl/tstore.h"
+
+#include"threads/hthreads.h"
 
 /**
  * Creates a parameter with empty handle map.
  *
+ * @param dest Pointer to destination module, assumed to be locked.
+ * 	The parameter is allocated from the arena of this module.
  * @param src Pointer to source module.
  *
  * @return On success, a pointer to the newly created parameter is returned.
  * 	On error, <code>NULL</code> is returned.
  */
-static inline union Object * param_create(struct HilbertModule * src) {
-	union Object * result = malloc(sizeof(*result));
+static inline union Object * param_create(struct HilbertModule * dest, struct HilbertModule * src) {
+	ArenaMark mark = cl_arena_mark(dest->arena);
+	union Object * result = cl_arena_alloc(dest->arena, sizeof(*result));
 	if (result == NULL)
 		goto noparammem;
 
-	result->param = (struct Param) { .type = HILBERT_TYPE_PARAM, .module = src, .handle_map = hilbert_pmap_new() };
+	result->param = (struct Param) { .module = src, .handle_map = hilbert_pmap_new() };
 	if (result->param.handle_map == NULL)
 		goto nomapmem;
 
 	return result;
 
 nomapmem:
-	free(result);
+	cl_arena_rewind(dest->arena, mark);
 noparammem:
 	return NULL;
 }
@@ -60,31 +70,256 @@ noparammem:
  * such that the destination module depends on the source module,
  * and the source module reverse-depends on the destination module.
  *
+ * The dependency locks of both modules are taken by this function, in dependency order.
+ * The source module itself need not be locked.
+ *
  * @param dest Pointer to the destination module, assumed to be locked.
- * @param src Pointer to the source module, assumed to be locked.
+ * @param src Pointer to the source module.
  *
  * @return On success, <code>0</code> is returned.
  * 	On error, a negative value is returned, which may be one of the following error codes:
  * 		- <code>#HILBERT_ERR_NOMEM</code>:
  * 			There was not enough memory to perform the operation.
+ * 		- <code>#HILBERT_ERR_INTERNAL</code>:
+ * 			A dependency lock could not be taken or released.
  */
 static inline int set_dependency(struct HilbertModule * restrict dest, struct HilbertModule * restrict src) {
 	assert (src != NULL);
 	assert (dest != NULL);
 
+	int errcode = 0;
+
+	if (hilbert_module_deplock(dest) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto nodestlock;
+	}
+	if (hilbert_module_deplock(src) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto nosrclock;
+	}
+
 	int contains_dep  = hilbert_mset_contains(dest->dependencies, src);
 	int contains_rdep = hilbert_mset_contains(src->reverse_dependencies, dest);
 
-	if ((!contains_dep) && (hilbert_mset_add(dest->dependencies, src) != 0))
-		return HILBERT_ERR_NOMEM;
+	if ((!contains_dep) && (hilbert_mset_add(dest->dependencies, src) != 0)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
+	}
 
 	if ((!contains_rdep) && (hilbert_mset_add(src->reverse_dependencies, dest) != 0)) {
 		if (!contains_dep)
 			hilbert_mset_remove(dest->dependencies, src);
-		return HILBERT_ERR_NOMEM;
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
 	}
 
+nomem:
+	if (hilbert_module_depunlock(src) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+nosrclock:
+	if (hilbert_module_depunlock(dest) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+nodestlock:
+	return errcode;
+}
+
+/**
+ * Term id standing for no term, used in term id maps.
+ */
+#define PARAM_TERM_NONE ((HilbertHandle) SIZE_MAX)
+
+/**
+ * Scratch space for matching statements of a source module against statements of a destination module.
+ */
+struct StatementMatcher {
+	/**
+	 * Destination term id matched by each source term id, or <code>#PARAM_TERM_NONE</code>.
+	 */
+	HilbertHandle * memo;
+
+	/**
+	 * Pending pairs of source and destination term ids.
+	 */
+	IndexVector * stack;
+
+	/**
+	 * Source term ids with an entry in <code>memo</code>.
+	 */
+	IndexVector * touched;
+
+	/**
+	 * Destination variable terms matched so far.
+	 */
+	IndexHashSet * vars;
+};
+
+/**
+ * Initialises a statement matcher.
+ *
+ * @param matcher Pointer to the statement matcher to be initialised.
+ * @param src Pointer to the source module, assumed to be immutable.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>#HILBERT_ERR_NOMEM</code> is returned.
+ */
+static inline int statement_matcher_init(struct StatementMatcher * matcher, struct HilbertModule * src) {
+	assert (matcher != NULL);
+	assert (src != NULL);
+
+	size_t termcount = cl_tstore_count(src->terms);
+	if (termcount >= SIZE_MAX / sizeof(*matcher->memo))
+		goto nomemomem;
+	matcher->memo = malloc((termcount + 1) * sizeof(*matcher->memo));
+	if (matcher->memo == NULL)
+		goto nomemomem;
+	for (size_t i = 0; i != termcount; ++i)
+		matcher->memo[i] = PARAM_TERM_NONE;
+	matcher->stack = hilbert_ivector_new();
+	if (matcher->stack == NULL)
+		goto nostackmem;
+	matcher->touched = hilbert_ivector_new();
+	if (matcher->touched == NULL)
+		goto notouchedmem;
+	matcher->vars = hilbert_ihset_new();
+	if (matcher->vars == NULL)
+		goto novarsmem;
+
 	return 0;
+
+novarsmem:
+	hilbert_ivector_del(matcher->touched);
+notouchedmem:
+	hilbert_ivector_del(matcher->stack);
+nostackmem:
+	free(matcher->memo);
+nomemomem:
+	return HILBERT_ERR_NOMEM;
+}
+
+/**
+ * Releases the resources held by a statement matcher.
+ *
+ * @param matcher Pointer to an initialised statement matcher.
+ */
+static inline void statement_matcher_fini(struct StatementMatcher * matcher) {
+	assert (matcher != NULL);
+
+	hilbert_ihset_del(matcher->vars);
+	hilbert_ivector_del(matcher->touched);
+	hilbert_ivector_del(matcher->stack);
+	free(matcher->memo);
+}
+
+/**
+ * Checks whether a destination statement is an instance of a source statement under the handle map of a parameter.
+ *
+ * This is the case if both statements have the same number of hypotheses, and the hypotheses and the conclusion
+ * of the destination statement are those of the source statement with each functor replaced by its image
+ * under the handle map, and the variables renamed injectively to variables of equivalent kinds.
+ * Shared subterms are compared only once.
+ *
+ * @param matcher Pointer to a statement matcher initialised for <code>src</code>.
+ * @param dest Pointer to the destination module, assumed to be locked.
+ * @param src Pointer to the source module, assumed to be immutable.
+ * @param map Pointer to a handle map from <code>dest</code> to <code>src</code>,
+ * 	containing at least all kinds and functors of <code>src</code>.
+ * @param srcstatement Statement handle in <code>src</code>.
+ * @param deststatement Statement handle in <code>dest</code>.
+ *
+ * @return If the statements match, <code>0</code> is returned.
+ * 	If they do not match, <code>#HILBERT_ERR_INVALID_MAPPING</code> is returned.
+ * 	If there is not enough memory to complete the check, <code>#HILBERT_ERR_NOMEM</code> is returned.
+ */
+static inline int statement_match(struct StatementMatcher * restrict matcher, struct HilbertModule * restrict dest,
+		struct HilbertModule * restrict src, const ParamMap * map, HilbertHandle srcstatement,
+		HilbertHandle deststatement) {
+	assert (matcher != NULL);
+	assert (hilbert_object_check(src, srcstatement, HILBERT_TYPE_STATEMENT));
+	assert (hilbert_object_check(dest, deststatement, HILBERT_TYPE_STATEMENT));
+
+	const struct Statement * srcrecord = &cl_otable_record(src->objects, srcstatement)->statement;
+	const struct Statement * destrecord = &cl_otable_record(dest->objects, deststatement)->statement;
+	if (srcrecord->hypcount != destrecord->hypcount)
+		return HILBERT_ERR_INVALID_MAPPING;
+
+	int errcode = 0;
+	size_t varcount = 0;
+
+	if ((hilbert_ivector_pushback(matcher->stack, srcrecord->conclusion) != 0)
+			|| (hilbert_ivector_pushback(matcher->stack, destrecord->conclusion) != 0)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto reset;
+	}
+	for (size_t i = 0; i != srcrecord->hypcount; ++i) {
+		if ((hilbert_ivector_pushback(matcher->stack, srcrecord->hyps[i]) != 0)
+				|| (hilbert_ivector_pushback(matcher->stack, destrecord->hyps[i]) != 0)) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+	}
+
+	while (hilbert_ivector_count(matcher->stack) != 0) {
+		HilbertHandle destterm = hilbert_ivector_popback(matcher->stack);
+		HilbertHandle srcterm = hilbert_ivector_popback(matcher->stack);
+		if (matcher->memo[srcterm] != PARAM_TERM_NONE) {
+			if (matcher->memo[srcterm] != destterm) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto reset;
+			}
+			continue;
+		}
+		if (hilbert_ivector_pushback(matcher->touched, srcterm) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+		matcher->memo[srcterm] = destterm;
+
+		const struct Term * srcnode = cl_tstore_get(src->terms, srcterm);
+		const struct Term * destnode = cl_tstore_get(dest->terms, destterm);
+		if (cl_otable_type(src->objects, srcnode->head) & HILBERT_TYPE_VAR) {
+			/* variable: kinds must correspond, and the renaming must be injective */
+			const HilbertHandle * kind = hilbert_pmap_pre(map, cl_otable_kind(src->objects, srcnode->head));
+			assert (kind != NULL);
+			if (!(cl_otable_type(dest->objects, destnode->head) & HILBERT_TYPE_VAR)
+					|| !hilbert_kind_isequivalent_nocheck(dest, *kind,
+						cl_otable_kind(dest->objects, destnode->head))) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto reset;
+			}
+			if (hilbert_ihset_add(matcher->vars, destterm) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto reset;
+			}
+			++varcount;
+		} else {
+			/* functor application: heads must correspond, then compare the arguments */
+			const HilbertHandle * head = hilbert_pmap_pre(map, srcnode->head);
+			assert (head != NULL);
+			if ((*head != destnode->head) || (srcnode->argc != destnode->argc)) {
+				errcode = HILBERT_ERR_INVALID_MAPPING;
+				goto reset;
+			}
+			for (size_t i = 0; i != srcnode->argc; ++i) {
+				if ((hilbert_ivector_pushback(matcher->stack, srcnode->args[i]) != 0)
+						|| (hilbert_ivector_pushback(matcher->stack, destnode->args[i]) != 0)) {
+					errcode = HILBERT_ERR_NOMEM;
+					goto reset;
+				}
+			}
+		}
+	}
+	if (hilbert_ihset_count(matcher->vars) != varcount)
+		errcode = HILBERT_ERR_INVALID_MAPPING;
+
+reset:
+	for (size_t i = 0; i != hilbert_ivector_count(matcher->touched); ++i)
+		matcher->memo[hilbert_ivector_get(matcher->touched, i)] = PARAM_TERM_NONE;
+	hilbert_ivector_downsize(matcher->touched, 0);
+	hilbert_ivector_downsize(matcher->stack, 0);
+	if (hilbert_ihset_count(matcher->vars) != 0)
+		hilbert_ihset_clear(matcher->vars);
+
+	return errcode;
 }
 
 #endif
@@ -24,240 +24,297 @@
 #define HILBERT_PRIVATE_H__
 
 #include<assert.h>
+#include<string.h>
 
 #include"hilbert.h"
 
+#include"cl/arena.h"
 #include"cl/pmap.h"
-#include"cl/iset.h"
 #include"cl/mset.h"
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+#include"cl/ufind.h"
 
 #include"threads/hthreads.h"
 
 /**
- * Generic object type.
+ * Maximum number of input kinds kept inside a functor record.
  */
-struct Generic {
+#define HILBERT_FUNCTOR_INLINE 3
+
+/**
+ * Functor record.
+ */
+struct BasicFunctor {
 	/**
-	 * Object type.
+	 * Place count of functor.
 	 */
-	unsigned int type;
+	size_t place_count;
+
+	/**
+	 * Input kinds.
+	 * If <code>place_count</code> is at most <code>#HILBERT_FUNCTOR_INLINE</code>,
+	 * the input kinds are stored in <code>local</code>.
+	 * Otherwise, <code>external</code> points to an array of <code>place_count</code> input kinds.
+	 * Use <code>#hilbert_functor_inputkinds()</code> to access them.
+	 */
+	union {
+		HilbertHandle * external;
+		HilbertHandle local[HILBERT_FUNCTOR_INLINE];
+	} input_kinds;
 };
 
 /**
- * Kind.
+ * Parameter record.
  */
-struct Kind {
+struct Param {
 	/**
-	 * Kind type (#HILBERT_TYPE_KIND and possibly #HILBERT_TYPE_VKIND set).
+	 * Module with which we parameterise.
 	 */
-	unsigned int type;
+	struct HilbertModule * module;
 
 	/**
-	 * Equivalence class.
-	 * If this kind is a singleton, the equivalence class is <code>NULL</code>.
+	 * Map mapping local handles to handles of <code>module</code>.
 	 */
-	IndexSet * equivalence_class;
+	ParamMap * handle_map;
 };
 
 /**
- * External kind (parameter, import, or export)
+ * Statement record.
  */
-struct ExternalKind {
+struct Statement {
 	/**
-	 * External kind type (#HILBERT_TYPE_KIND | #HILBERT_TYPE_EXTERNAL), and possibly #HILBERT_TYPE_VKIND.
+	 * Term id of the conclusion.
 	 */
-	unsigned int type;
+	HilbertHandle conclusion;
 
 	/**
-	 * Equivalence class.
-	 * If this kind is a singleton, the equivalence class is <code>NULL</code>.
+	 * Number of hypotheses.
 	 */
-	IndexSet * equivalence_class;
+	size_t hypcount;
 
 	/**
-	 * Index into <code>#struct HilbertModule::paramhandles</code>
+	 * Term ids of the hypotheses, allocated from the module arena or backed by the module image.
+	 * May be <code>NULL</code> if <code>hypcount</code> is zero.
 	 */
-	size_t paramindex;
+	const HilbertHandle * hyps;
 };
 
 /**
- * Variable.
+ * Object record.
+ * Holds the object data which does not fit into the columns of <code>#struct ObjectTable</code>.
  */
-struct Variable {
-	/**
-	 * Variable type (#HILBERT_TYPE_VAR)
-	 */
-	unsigned int type;
-
-	/**
-	 * Kind of variable.
-	 */
-	HilbertHandle kind;
+union Object {
+	struct BasicFunctor basic_functor;
+	struct Param param;
+	struct Statement statement;
 };
 
 /**
- * Basic functor.
+ * Initialises a functor record.
+ *
+ * @param functor Pointer to the functor record to be initialised.
+ * @param count Place count of the functor.
+ * @param external Pointer to an array of <code>count</code> handles which is used to store the input kinds
+ * 	if <code>count</code> exceeds <code>#HILBERT_FUNCTOR_INLINE</code>.
+ * 	It must outlive <code>functor</code>. Otherwise, it is ignored and may be <code>NULL</code>.
+ *
+ * @return A pointer to the storage for the input kinds of <code>functor</code>,
+ * 	which the caller must fill in.
  */
-struct BasicFunctor {
-	/**
-	 * Basic functor type (#HILBERT_TYPE_FUNCTOR)
-	 */
-	unsigned int type;
+static inline HilbertHandle * hilbert_functor_init(struct BasicFunctor * functor, size_t count, HilbertHandle * external) {
+	assert (functor != NULL);
 
-	/**
-	 * Result kind of functor.
-	 */
-	HilbertHandle result_kind;
+	functor->place_count = count;
+	if (count <= HILBERT_FUNCTOR_INLINE)
+		return functor->input_kinds.local;
+	assert (external != NULL);
+	functor->input_kinds.external = external;
 
+	return external;
+}
+
+/**
+ * Returns the input kinds of a functor.
+ *
+ * @param functor Pointer to a functor record.
+ *
+ * @return A pointer to the array of the <code>functor->place_count</code> input kinds of <code>functor</code>.
+ */
+static inline const HilbertHandle * hilbert_functor_inputkinds(const struct BasicFunctor * functor) {
+	assert (functor != NULL);
+
+	return functor->place_count <= HILBERT_FUNCTOR_INLINE ? functor->input_kinds.local : functor->input_kinds.external;
+}
+
+/**
+ * Releases the resources held by a parameter outside of the module arena.
+ *
+ * @param param Pointer to a parameter.
+ */
+static inline void hilbert_param_free(union Object * param) {
+	hilbert_pmap_del(param->param.handle_map);
+}
+
+/**
+ * Range of an equivalence class within the grouped kind handles of an immutable module.
+ */
+struct EqcRange {
 	/**
-	 * Place count of functor.
+	 * Index of the first kind handle of the class.
 	 */
-	size_t place_count;
+	size_t first;
 
 	/**
-	 * Input kinds.
+	 * Number of kinds in the class.
 	 */
-	HilbertHandle * input_kinds;
+	size_t count;
 };
 
 /**
- * External basic functor.
+ * Module statistics.
+ *
+ * These are only gathered if the library is built with <code>HILBERT_STATS</code> defined.
+ * Some of the counters change while the module is merely locked for reading, so they are updated atomically.
  */
-struct ExternalBasicFunctor {
+struct ModuleStats {
 	/**
-	 * External basic functor type (#HILBERT_TYPE_FUNCTOR | #HILBERT_TYPE_EXTERNAL)
+	 * Number of read lock acquisitions.
 	 */
-	unsigned int type;
+	unsigned long long rdlocks;
 
 	/**
-	 * Result kind of functor.
+	 * Number of write lock acquisitions.
 	 */
-	HilbertHandle result_kind;
+	unsigned long long wrlocks;
 
 	/**
-	 * Place count of functor.
+	 * Number of lock acquisitions which had to wait for another thread.
 	 */
-	size_t place_count;
+	unsigned long long contended;
 
 	/**
-	 * Input kinds.
+	 * Number of kind equivalence class merges.
 	 */
-	HilbertHandle * input_kinds;
+	unsigned long long merges;
 
 	/**
-	 * Index into <code>#struct HilbertModule::paramhandles</code>.
+	 * Number of parameterisations, imports and exports performed with this module as destination.
 	 */
-	size_t paramindex;
-};
+	unsigned long long transfers;
 
-/**
- * Parameter.
- */
-struct Param {
 	/**
-	 * Parameter type (#HILBERT_TYPE_PARAM)
+	 * Time spent in <code>transfers</code>, in nanoseconds.
 	 */
-	unsigned int type;
+	unsigned long long transfernanos;
 
 	/**
-	 * Module with which we parameterise.
+	 * Number of proof steps checked.
 	 */
-	struct HilbertModule * module;
+	unsigned long long proofsteps;
 
 	/**
-	 * Map mapping local handles to handles of <code>module</code>.
+	 * Lock wait time histograms by call site.
+	 * Entries are claimed by setting their name, so the claimed entries may be scattered.
 	 */
-	ParamMap * handle_map;
+	struct HilbertLockSite sites[HILBERT_LOCK_SITES];
 };
 
+#ifdef HILBERT_STATS
+
+#include<stdint.h>
+#include<time.h>
+
 /**
- * Object.
+ * Declares the statistics member of a module, including the terminating semicolon.
  */
-union Object {
-	struct Generic generic;
-	struct Kind kind;
-	struct ExternalKind external_kind;
-	struct Variable var;
-	struct BasicFunctor basic_functor;
-	struct ExternalBasicFunctor external_basic_functor;
-	struct Param param;
-};
+#define HILBERT_STATS_DECL(x) struct ModuleStats x;
 
 /**
- * Frees a kind.
- *
- * @param kind Pointer to a previously allocated kind.
+ * Resets the statistics of a module.
  */
-static inline void hilbert_kind_free(union Object * kind) {
-	/* kind->equivalence_class handled in hilbert_module_free() */
-	free(kind);
-}
+#define hilbert_stats_init(module) ((void) ((module)->stats = (struct ModuleStats) { .rdlocks = 0 }))
 
 /**
- * Frees a variable.
- *
- * @param var Pointer to a previously allocated variable.
+ * Adds <code>n</code> to a statistics counter of a module.
  */
-static inline void hilbert_var_free(union Object * var) {
-	free(var);
-}
+#define hilbert_stats_add(module, counter, n) \
+	((void) atomic_fetch_add_explicit(&(module)->stats.counter, (n), memory_order_relaxed))
 
 /**
- * Frees a functor.
- *
- * @param functor Pointer to a previously allocated functor.
+ * Returns the value of a statistics counter of a module.
  */
-static inline void hilbert_functor_free(union Object * functor) {
-	free(functor->basic_functor.input_kinds);
-	free(functor);
-}
+#define hilbert_stats_get(module, counter) atomic_load_explicit(&(module)->stats.counter, memory_order_relaxed)
 
 /**
- * Frees a parameter.
+ * Returns a monotonic time stamp for timing statistics.
  *
- * @param param Pointer to a previously allocated parameter.
+ * @return The current time in nanoseconds since some unspecified point, or <code>0</code> if the clock fails.
  */
-static inline void hilbert_param_free(union Object * param) {
-	hilbert_pmap_del(param->param.handle_map);
-	free(param);
+static inline unsigned long long hilbert_stats_clock(void) {
+	struct timespec now;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+		return 0;
+	return (unsigned long long) now.tv_sec * 1000000000ull + (unsigned long long) now.tv_nsec;
 }
 
 /**
- * Frees an object.
- *
- * @param pointer to constituent to be freed.
- */
-static inline void hilbert_object_free(union Object * object) {
-	assert (object != NULL);
-	unsigned int type = object->generic.type;
-	switch (type) {
-		case HILBERT_TYPE_KIND:
-		case HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND:
-		case HILBERT_TYPE_KIND | HILBERT_TYPE_EXTERNAL:
-		case HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND | HILBERT_TYPE_EXTERNAL:
-			hilbert_kind_free(object);
-			break;
-		case HILBERT_TYPE_VAR:
-			hilbert_var_free(object);
-			break;
-		case HILBERT_TYPE_FUNCTOR:
-		case HILBERT_TYPE_FUNCTOR | HILBERT_TYPE_EXTERNAL:
-			hilbert_functor_free(object);
-			break;
-		case HILBERT_TYPE_PARAM:
-			hilbert_param_free(object);
-			break;
-		/* FIXME: case ... */
-		default:
-			assert ("Unexpected constituent type" == NULL);
-			break;
+ * Records a lock acquisition in the lock site histograms of a module.
+ *
+ * @param stats Pointer to the statistics of a module.
+ * @param site Name of the locking function. Names are compared by address.
+ * @param nanos Time spent waiting for the lock, in nanoseconds.
+ */
+static inline void hilbert_stats_wait(struct ModuleStats * stats, const char * site, unsigned long long nanos) {
+	assert (stats != NULL);
+	assert (site != NULL);
+
+	size_t bucket = 0;
+	for (unsigned long long micros = nanos / 1000; (micros != 0) && (bucket != HILBERT_LOCK_BUCKETS - 1); micros >>= 1)
+		++bucket;
+
+	size_t start = ((uintptr_t) site >> 4) % HILBERT_LOCK_SITES;
+	for (size_t i = 0; i != HILBERT_LOCK_SITES; ++i) {
+		struct HilbertLockSite * entry = stats->sites + (start + i) % HILBERT_LOCK_SITES;
+		const char * name = atomic_load_explicit(&entry->name, memory_order_acquire);
+		if ((name == NULL) && (atomic_compare_exchange_strong_explicit(&entry->name, &name, site,
+				memory_order_acq_rel, memory_order_acquire)))
+			name = site;
+		if (name == site) {
+			(void) atomic_fetch_add_explicit(&entry->waits[bucket], 1, memory_order_relaxed);
+			return;
+		}
 	}
+	/* all entries taken by other sites */
 }
 
+#else /* HILBERT_STATS is not defined */
+
+#define HILBERT_STATS_DECL(x)
+
+#define hilbert_stats_init(module) ((void) 0)
+
+#define hilbert_stats_add(module, counter, n) ((void) (n))
+
+#define hilbert_stats_get(module, counter) 0ull
+
+#define hilbert_stats_clock() 0ull
+
+#endif /* HILBERT_STATS */
+
 /**
  * Private Hilbert module structure.
+ *
+ * Lock hierarchy:
+ * a thread holds at most one module <code>lock</code> at a time.
+ * The thread holding the write lock may read the module again without locking it,
+ * as mapper callbacks do with the destination module (see <code>#hilbert_module_writer</code>).
+ * Immutable source modules are read without locking them.
+ * The <code>deplock</code> mutexes are leaves with respect to the module locks,
+ * and are nested only along dependency edges, the depending module being locked first.
+ * Since the dependency graph is acyclic, this order cannot deadlock.
  */
 struct HilbertModule {
 	/**
@@ -266,14 +323,24 @@ struct HilbertModule {
 	enum HilbertModuleType type;
 
 	/**
-	 * Mutual exclusion device.
+	 * Reader/writer lock.
+	 * Reading accessors lock it for reading, or not at all if the module is immutable
+	 * (see <code>#hilbert_module_rdlock()</code>).
+	 * Everything else locks it for writing.
 	 */
-	HILBERT_MUTEX_DECL(mutex);
+	HILBERT_RWLOCK_DECL(lock);
 
 	/**
 	 * Whether this module is immutable.
+	 * Only ever changes from <code>0</code> to <code>1</code>, with release semantics, while the write lock is held.
+	 * May be read without holding the lock with acquire semantics.
+	 */
+	int immutable;
+
+	/**
+	 * Lock protecting <code>freeable</code>, <code>dependencies</code> and <code>reverse_dependencies</code>.
 	 */
-	unsigned int immutable: 1;
+	HILBERT_MUTEX_DECL(deplock);
 
 	/**
 	 * Whether user has requested this module to be freed.
@@ -285,16 +352,38 @@ struct HilbertModule {
 	 */
 	void * ancillary;
 
+	/**
+	 * Arena holding the module constituents and their auxiliary arrays.
+	 */
+	Arena * arena;
+
 	/**
 	 * Module constituents.
 	 */
-	ObjectVector * objects;
+	ObjectTable * objects;
 
 	/**
 	 * Kind handles.
 	 */
 	IndexVector * kindhandles;
 
+	/**
+	 * Kind equivalence classes, indexed like <code>kindhandles</code>.
+	 */
+	UnionFind * kindeqc;
+
+	/**
+	 * Kind handles grouped by equivalence class, allocated from <code>arena</code>.
+	 * Only available once the module is immutable, <code>NULL</code> before.
+	 */
+	HilbertHandle * eqckinds;
+
+	/**
+	 * Equivalence class ranges within <code>eqckinds</code>, indexed like <code>kindhandles</code>.
+	 * Only available once the module is immutable, <code>NULL</code> before.
+	 */
+	struct EqcRange * eqcranges;
+
 	/**
 	 * Variable handles.
 	 */
@@ -310,6 +399,16 @@ struct HilbertModule {
 	 */
 	IndexVector * paramhandles;
 
+	/**
+	 * Statement handles.
+	 */
+	IndexVector * statementhandles;
+
+	/**
+	 * Hash-consed terms, with their nodes allocated from <code>arena</code>.
+	 */
+	TermStore * terms;
+
 	/**
 	 * Set of modules this module depends on.
 	 */
@@ -319,29 +418,229 @@ struct HilbertModule {
 	 * Set of modules depending on this module.
 	 */
 	ModuleSet * reverse_dependencies;
+
+	/**
+	 * Image backing the columns and handle arrays of a module created from an image, or <code>NULL</code>.
+	 */
+	void * image;
+
+	/**
+	 * Size of the memory mapping holding <code>image</code>,
+	 * or <code>0</code> if the image was allocated with <code>malloc()</code>.
+	 */
+	size_t mapsize;
+
+	/**
+	 * Statistics, see <code>#hilbert_module_getstats()</code>.
+	 */
+	HILBERT_STATS_DECL(stats)
 };
 
 /**
- * Retrieves an object if it has the specified type.
+ * Thread-specific pointer to the module write-locked by the current thread, or <code>NULL</code>.
+ * Created by the first call to <code>#hilbert_module_create()</code>.
+ */
+extern tss_t hilbert_module_writer;
+
+/**
+ * Locks a module for reading.
+ *
+ * Immutable modules are not locked at all: once the immutable flag has been observed,
+ * all module data except for the ancillary data and the dependencies is guaranteed to remain unchanged.
+ * Hence this function must only be used by accessors which do not read such data.
+ * Neither is a module locked again by the thread holding its write lock.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param site Name of the calling function, for the lock statistics.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int hilbert_module_rdlock_at(struct HilbertModule * module, const char * site) {
+	assert (module != NULL);
+
+	if (atomic_load_explicit(&module->immutable, memory_order_acquire))
+		return thrd_success;
+	if (tss_get(hilbert_module_writer) == module)
+		return thrd_success;
+#ifdef HILBERT_STATS
+	unsigned long long wait = 0;
+	int rc = rwl_tryrdlock(&module->lock);
+	if (rc == thrd_busy) {
+		hilbert_stats_add(module, contended, 1);
+		unsigned long long start = hilbert_stats_clock();
+		rc = rwl_rdlock(&module->lock);
+		wait = hilbert_stats_clock() - start;
+	}
+	if (rc != thrd_success)
+		return thrd_error;
+	hilbert_stats_add(module, rdlocks, 1);
+	hilbert_stats_wait(&module->stats, site, wait);
+#else
+	(void) site;
+	if (rwl_rdlock(&module->lock) != thrd_success)
+		return thrd_error;
+#endif
+	/* the module may have been made immutable while we were waiting for the lock */
+	if (atomic_load_explicit(&module->immutable, memory_order_relaxed))
+		return rwl_unlock(&module->lock);
+	return thrd_success;
+}
+
+/**
+ * Locks a module for reading, recording the calling function as lock site.
+ */
+#define hilbert_module_rdlock(module) hilbert_module_rdlock_at(module, __func__)
+
+/**
+ * Unlocks a module locked by <code>#hilbert_module_rdlock()</code>.
+ *
+ * @param module Pointer to a Hilbert module.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int hilbert_module_rdunlock(struct HilbertModule * module) {
+	assert (module != NULL);
+
+	/* The immutable flag cannot have been set while we were holding the read lock */
+	if (atomic_load_explicit(&module->immutable, memory_order_acquire))
+		return thrd_success;
+	if (tss_get(hilbert_module_writer) == module)
+		return thrd_success;
+	return rwl_unlock(&module->lock);
+}
+
+/**
+ * Locks a module for writing.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param site Name of the calling function, for the lock statistics.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ * 	In particular, the write lock cannot be taken again by the thread holding it.
+ */
+static inline int hilbert_module_wrlock_at(struct HilbertModule * module, const char * site) {
+	assert (module != NULL);
+
+	if (tss_get(hilbert_module_writer) == module)
+		return thrd_error;
+#ifdef HILBERT_STATS
+	unsigned long long wait = 0;
+	int rc = rwl_trywrlock(&module->lock);
+	if (rc == thrd_busy) {
+		hilbert_stats_add(module, contended, 1);
+		unsigned long long start = hilbert_stats_clock();
+		rc = rwl_wrlock(&module->lock);
+		wait = hilbert_stats_clock() - start;
+	}
+	if (rc != thrd_success)
+		return thrd_error;
+	hilbert_stats_add(module, wrlocks, 1);
+	hilbert_stats_wait(&module->stats, site, wait);
+#else
+	(void) site;
+	if (rwl_wrlock(&module->lock) != thrd_success)
+		return thrd_error;
+#endif
+	if (tss_set(hilbert_module_writer, module) != thrd_success) {
+		(void) rwl_unlock(&module->lock);
+		return thrd_error;
+	}
+	return thrd_success;
+}
+
+/**
+ * Locks a module for writing, recording the calling function as lock site.
+ */
+#define hilbert_module_wrlock(module) hilbert_module_wrlock_at(module, __func__)
+
+/**
+ * Unlocks a module locked by <code>#hilbert_module_wrlock()</code>.
+ *
+ * @param module Pointer to a Hilbert module.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int hilbert_module_wrunlock(struct HilbertModule * module) {
+	assert (module != NULL);
+	assert (tss_get(hilbert_module_writer) == module);
+
+	int rc = tss_set(hilbert_module_writer, NULL);
+	if (rwl_unlock(&module->lock) != thrd_success)
+		return thrd_error;
+	return rc;
+}
+
+/**
+ * Locks the dependency lock of a module.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param site Name of the calling function, for the lock statistics.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int hilbert_module_deplock_at(struct HilbertModule * module, const char * site) {
+	assert (module != NULL);
+
+#ifdef HILBERT_STATS
+	unsigned long long wait = 0;
+	int rc = mtx_trylock(&module->deplock);
+	if (rc == thrd_busy) {
+		hilbert_stats_add(module, contended, 1);
+		unsigned long long start = hilbert_stats_clock();
+		rc = mtx_lock(&module->deplock);
+		wait = hilbert_stats_clock() - start;
+	}
+	if (rc != thrd_success)
+		return thrd_error;
+	hilbert_stats_wait(&module->stats, site, wait);
+	return thrd_success;
+#else
+	(void) site;
+	return mtx_lock(&module->deplock);
+#endif
+}
+
+/**
+ * Locks the dependency lock of a module, recording the calling function as lock site.
+ */
+#define hilbert_module_deplock(module) hilbert_module_deplock_at(module, __func__)
+
+/**
+ * Unlocks a dependency lock locked by <code>#hilbert_module_deplock()</code>.
+ *
+ * @param module Pointer to a Hilbert module.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int hilbert_module_depunlock(struct HilbertModule * module) {
+	assert (module != NULL);
+
+	return mtx_unlock(&module->deplock);
+}
+
+/**
+ * Checks whether a handle refers to an object of the specified type.
  *
  * @param module pointer to a Hilbert module.
  * 	Any necessary locking on the module must be done by the caller!
  * @param handle object handle.
  * @param typeflags sought type flags.
  *
- * @return If <code>handle</code> is in the range of <code>module->objects</code> and the specified object's type has at least one bit in common with <code>typeflags</code>, a pointer to that object is returned.
- * 	Otherwise, <code>NULL</code> is returned.
+ * @return If <code>handle</code> is in the range of <code>module->objects</code> and the specified object's type has at least one bit in common with <code>typeflags</code>, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
  */
-static inline union Object * hilbert_object_retrieve(const struct HilbertModule * module, HilbertHandle handle, unsigned int typeflags) {
+static inline int hilbert_object_check(const struct HilbertModule * module, HilbertHandle handle, unsigned int typeflags) {
 	assert (module != NULL);
 
-	size_t numobjects = hilbert_ovector_count(module->objects);
-	if (handle >= numobjects)
-		return NULL;
-	union Object * result = hilbert_ovector_get(module->objects, handle);
-	if (!(result->generic.type & typeflags))
-		return NULL;
-	return result;
+	if (handle >= cl_otable_count(module->objects))
+		return 0;
+	return (cl_otable_type(module->objects, handle) & typeflags) != 0;
 }
 
 /**
@@ -351,9 +650,8 @@ static inline union Object * hilbert_object_retrieve(const struct HilbertModule
  * @param kindhandle1 Kind handle.
  * @param kindhandle2 Kind handle.
  *
- * @return On error, a negative value is returned, which may be one of the following error codes:
- * 	- <code>HILBERT_ERR_NOMEM</code>:
- * 		There was not enough memory to perform the operation.
+ * @return On success, <code>0</code> is returned.
+ * 	On error, a negative value is returned, which may be one of the following error codes:
  * 	- <code>HILBERT_ERR_INVALID_HANDLE</code>
  * 		One of <code>kind1</code>, <code>kind2</code> is not a valid kind handle in the module pointed
  * 		to by <code>module</code>.
@@ -362,62 +660,178 @@ static inline int hilbert_kind_identify_nocheck(struct HilbertModule * module, H
 		HilbertHandle kindhandle2) {
 	assert (module != NULL);
 
-	int errcode;
+	if ((!hilbert_object_check(module, kindhandle1, HILBERT_TYPE_KIND))
+			|| (!hilbert_object_check(module, kindhandle2, HILBERT_TYPE_KIND))
+			|| ((cl_otable_type(module->objects, kindhandle1) ^ cl_otable_type(module->objects, kindhandle2))
+				& HILBERT_TYPE_VKIND))
+		return HILBERT_ERR_INVALID_HANDLE;
+
+	size_t index1 = cl_otable_eqcindex(module->objects, kindhandle1);
+	size_t index2 = cl_otable_eqcindex(module->objects, kindhandle2);
+#ifdef HILBERT_STATS
+	if (cl_ufind_find(module->kindeqc, index1) != cl_ufind_find(module->kindeqc, index2))
+		hilbert_stats_add(module, merges, 1);
+#endif
+	cl_ufind_union(module->kindeqc, index1, index2);
+
+	return 0;
+}
+
+/**
+ * Kind equivalence check without locks and checks.
+ * It does not write to the module, so a read lock suffices.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param kindhandle1 Kind handle.
+ * 	If this is not a valid kind handle in the module pointed to by <code>module</code>, the behaviour is undefined.
+ * @param kindhandle2 Kind handle.
+ * 	If this is not a valid kind handle in the module pointed to by <code>module</code>, the behaviour is undefined.
+ *
+ * @return If the specified kinds are equivalent, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int hilbert_kind_isequivalent_nocheck(struct HilbertModule * module, HilbertHandle kindhandle1,
+		HilbertHandle kindhandle2) {
+	assert (module != NULL);
+	assert (hilbert_object_check(module, kindhandle1, HILBERT_TYPE_KIND));
+	assert (hilbert_object_check(module, kindhandle2, HILBERT_TYPE_KIND));
+
+	return cl_ufind_find_readonly(module->kindeqc, cl_otable_eqcindex(module->objects, kindhandle1))
+			== cl_ufind_find_readonly(module->kindeqc, cl_otable_eqcindex(module->objects, kindhandle2));
+}
 
-	union Object * object1 = hilbert_object_retrieve(module, kindhandle1, HILBERT_TYPE_KIND);
-	union Object * object2 = hilbert_object_retrieve(module, kindhandle2, HILBERT_TYPE_KIND);
-	if ((object1 == NULL) || (object2 == NULL) || ((object1->kind.type ^ object2->kind.type) & HILBERT_TYPE_VKIND)) {
-		errcode = HILBERT_ERR_INVALID_HANDLE;
-		goto invalidhandle;
+/**
+ * Groups the kind handles of a module by equivalence class,
+ * so that the equivalence classes of an immutable module can be handed out as views.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be write-locked.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>#HILBERT_ERR_NOMEM</code> is returned and the module remains unchanged.
+ */
+static inline int hilbert_module_group_eqcs(struct HilbertModule * module) {
+	assert (module != NULL);
+
+	size_t count = hilbert_ivector_count(module->kindhandles);
+	if (count > SIZE_MAX / sizeof(*module->eqcranges))
+		return HILBERT_ERR_NOMEM;
+
+	ArenaMark mark = cl_arena_mark(module->arena);
+	HilbertHandle * eqckinds = cl_arena_alloc(module->arena, count * sizeof(*eqckinds));
+	if (eqckinds == NULL)
+		goto nomem;
+	struct EqcRange * eqcranges = cl_arena_alloc(module->arena, count * sizeof(*eqcranges));
+	if (eqcranges == NULL)
+		goto nomem;
+
+	for (size_t i = 0; i != count; ++i)
+		eqcranges[i].count = 0;
+	size_t pos = 0;
+	for (size_t i = 0; i != count; ++i) {
+		size_t root = cl_ufind_find(module->kindeqc, i);
+		if (eqcranges[root].count == 0) {
+			/* first member of this class encountered, lay out the whole class */
+			size_t first = pos;
+			size_t j = root;
+			do {
+				eqckinds[pos++] = hilbert_ivector_get(module->kindhandles, j);
+				j = cl_ufind_next(module->kindeqc, j);
+			} while (j != root);
+			eqcranges[root] = (struct EqcRange) { .first = first, .count = pos - first };
+		}
+		eqcranges[i] = eqcranges[root];
 	}
-	/* check if already equivalent */
-	errcode = 0;
-	if (object1 == object2)
-		goto equivalent;
-	if ((object1->kind.equivalence_class != NULL)
-			&& (object1->kind.equivalence_class == object2->kind.equivalence_class))
-		goto equivalent;
-
-	errcode = HILBERT_ERR_NOMEM;
-	IndexSet * equivalence_class = hilbert_iset_new();
-	if (equivalence_class == NULL)
-		goto noeqcmem;
-	/* create union of equivalence classes */
-	if (object1->kind.equivalence_class != NULL) {
-		if (hilbert_iset_addall(equivalence_class, object1->kind.equivalence_class) != 0)
-			goto nounionmem;
+	assert (pos == count);
+
+	module->eqckinds = eqckinds;
+	module->eqcranges = eqcranges;
+
+	return 0;
+
+nomem:
+	cl_arena_rewind(module->arena, mark);
+	return HILBERT_ERR_NOMEM;
+}
+
+/**
+ * Appends a statement to a module.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be write-locked and mutable.
+ * @param hypc Number of hypotheses.
+ * @param hypv Array of <code>hypc</code> valid term handles, the hypotheses.
+ * 	The handles are copied.
+ * @param conclusion Valid term handle, the conclusion.
+ * @param errcode Pointer to an error code.
+ *
+ * @return On success, the handle of the new statement is returned and <code>*errcode</code> is set to <code>0</code>.
+ * 	On error, <code>0</code> is returned, the module remains unchanged and <code>*errcode</code> is set to one of
+ * 	the following values:
+ * 	- <code>#HILBERT_ERR_NOMEM</code>
+ * 	- <code>#HILBERT_ERR_INTERNAL</code>
+ * 		The handle space of the module is exhausted.
+ */
+static inline HilbertHandle hilbert_statement_push(struct HilbertModule * module, size_t hypc,
+		const HilbertHandle * hypv, HilbertHandle conclusion, int * errcode) {
+	assert (module != NULL);
+	assert ((hypc == 0) || (hypv != NULL));
+	assert (errcode != NULL);
+
+	HilbertHandle * hyps = NULL;
+	HilbertHandle result;
+
+	if (hypc > SIZE_MAX / sizeof(*hypv)) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto counttoobig;
+	}
+
+	ArenaMark mark = cl_arena_mark(module->arena);
+	union Object * object = cl_arena_alloc(module->arena, sizeof(*object));
+	if (object == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto noobjectmem;
+	}
+	if (hypc != 0) {
+		hyps = cl_arena_alloc(module->arena, hypc * sizeof(*hyps));
+		if (hyps == NULL) {
+			*errcode = HILBERT_ERR_NOMEM;
+			goto nohypsmem;
+		}
+		memcpy(hyps, hypv, hypc * sizeof(*hyps));
 	}
-	if (object2->kind.equivalence_class != NULL) {
-		if (hilbert_iset_addall(equivalence_class, object2->kind.equivalence_class) != 0)
-			goto nounionmem;
+	object->statement = (struct Statement) { .conclusion = conclusion, .hypcount = hypc, .hyps = hyps };
+
+	result = cl_otable_count(module->objects);
+	if (result > HILBERT_HANDLE_MAX) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nohandle;
 	}
-	if (hilbert_iset_add(equivalence_class, kindhandle1) != 0)
-		goto nounionmem;
-	if (hilbert_iset_add(equivalence_class, kindhandle2) != 0)
-		goto nounionmem;
-	/* delete old equivalence classes */
-	if (object1->kind.equivalence_class != NULL)
-		hilbert_iset_del(object1->kind.equivalence_class);
-	if (object2->kind.equivalence_class != NULL)
-		hilbert_iset_del(object2->kind.equivalence_class);
-	/* update all affected equivalence classes */
-	for (IndexSetIterator i = hilbert_iset_iterator_new(equivalence_class); hilbert_iset_iterator_hasnext(&i);) {
-		HilbertHandle handle = hilbert_iset_iterator_next(&i);
-		union Object * object = hilbert_object_retrieve(module, handle, ~0U);
-		assert (object->generic.type & HILBERT_TYPE_KIND);
-		object->kind.equivalence_class = equivalence_class;
+
+	*errcode = cl_otable_pushback(module->objects, (struct ObjectRow) {
+		.type = HILBERT_TYPE_STATEMENT,
+		.record = object
+	});
+	if (*errcode != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto noconsmem;
 	}
 
-	errcode = 0;
-	goto success;
+	*errcode = hilbert_ivector_pushback(module->statementhandles, result);
+	if (*errcode != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nohandlemem;
+	}
+
+	return result;
 
-nounionmem:
-	hilbert_iset_del(equivalence_class);
-success:
-noeqcmem:
-equivalent:
-invalidhandle:
-	return errcode;
+nohandlemem:
+	cl_otable_popback(module->objects);
+noconsmem:
+nohandle:
+nohypsmem:
+	cl_arena_rewind(module->arena, mark);
+noobjectmem:
+counttoobig:
+	return 0;
 }
 
 #endif
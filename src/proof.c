@@ -0,0 +1,556 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#include"private.h"
+
+#include<assert.h>
+#include<stdlib.h>
+
+#include"cl/arena.h"
+#include"cl/ivector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+
+#include"threads/hthreads.h"
+
+/**
+ * Memo entry of a statement term which has not been instantiated.
+ */
+#define PROOF_TERM_NONE ((HilbertHandle) SIZE_MAX)
+
+/**
+ * Memo entry of a statement term which has been reached while collecting the variables
+ * occurring only in the conclusion, and which still has to be instantiated.
+ */
+#define PROOF_TERM_PENDING ((HilbertHandle) SIZE_MAX - 1)
+
+/**
+ * Proof stack entry.
+ */
+struct ProofEntry {
+	/**
+	 * Term handle.
+	 */
+	HilbertHandle term;
+
+	/**
+	 * Nonzero if the entry is a fact, zero if it is a substitution value.
+	 */
+	int fact;
+};
+
+/**
+ * Scratch space for proof checking.
+ * Each thread has its own, which is reused across proofs and modules.
+ */
+struct ProofScratch {
+	/**
+	 * Instances of the statement terms under the current substitution, indexed by term handle.
+	 * Entries not in use are <code>#PROOF_TERM_NONE</code>.
+	 */
+	HilbertHandle * memo;
+
+	/**
+	 * Number of entries of <code>memo</code>.
+	 */
+	size_t memosize;
+
+	/**
+	 * Statement terms whose <code>memo</code> entries are in use.
+	 */
+	IndexVector * touched;
+
+	/**
+	 * Traversal stack.
+	 */
+	IndexVector * work;
+
+	/**
+	 * Variable terms occurring only in the conclusion of the applied statement, in order of first occurrence.
+	 */
+	IndexVector * fresh;
+
+	/**
+	 * Arena for the proof stack and argument buffers, reset after each proof.
+	 */
+	Arena * arena;
+};
+
+/**
+ * Key of the scratch space of the current thread.
+ */
+static tss_t scratch_key;
+
+/**
+ * Guards the creation of <code>scratch_key</code>.
+ */
+static once_flag scratch_once = ONCE_FLAG_INIT;
+
+/**
+ * Nonzero if <code>scratch_key</code> could not be created.
+ */
+static int scratch_keyerror;
+
+/**
+ * Frees the scratch space of a thread.
+ *
+ * @param scratch Pointer to the scratch space.
+ */
+static void scratch_del(void * scratch) {
+	struct ProofScratch * s = scratch;
+
+	free(s->memo);
+	hilbert_ivector_del(s->touched);
+	hilbert_ivector_del(s->work);
+	hilbert_ivector_del(s->fresh);
+	cl_arena_del(s->arena);
+	free(s);
+}
+
+/**
+ * Creates <code>scratch_key</code>.
+ */
+static void scratch_keyinit(void) {
+	if (tss_create(&scratch_key, scratch_del) != thrd_success)
+		scratch_keyerror = 1;
+}
+
+/**
+ * Returns the scratch space of the current thread, creating it if necessary.
+ *
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return On success, a pointer to the scratch space is returned.
+ * 	On error, <code>NULL</code> is returned and <code>#HILBERT_ERR_NOMEM</code> or <code>#HILBERT_ERR_INTERNAL</code>
+ * 	is stored in <code>*errcode</code>.
+ */
+static struct ProofScratch * scratch_get(int * errcode) {
+	call_once(&scratch_once, scratch_keyinit);
+	if (scratch_keyerror) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nokey;
+	}
+
+	struct ProofScratch * result = tss_get(scratch_key);
+	if (result != NULL)
+		return result;
+
+	result = malloc(sizeof(*result));
+	if (result == NULL)
+		goto noscratchmem;
+	result->memo = NULL;
+	result->memosize = 0;
+	result->touched = hilbert_ivector_new();
+	if (result->touched == NULL)
+		goto notouchedmem;
+	result->work = hilbert_ivector_new();
+	if (result->work == NULL)
+		goto noworkmem;
+	result->fresh = hilbert_ivector_new();
+	if (result->fresh == NULL)
+		goto nofreshmem;
+	result->arena = cl_arena_new();
+	if (result->arena == NULL)
+		goto noarenamem;
+	if (tss_set(scratch_key, result) != thrd_success)
+		goto nosetmem;
+
+	return result;
+
+nosetmem:
+	cl_arena_del(result->arena);
+noarenamem:
+	hilbert_ivector_del(result->fresh);
+nofreshmem:
+	hilbert_ivector_del(result->work);
+noworkmem:
+	hilbert_ivector_del(result->touched);
+notouchedmem:
+	free(result);
+noscratchmem:
+	*errcode = HILBERT_ERR_NOMEM;
+nokey:
+	return NULL;
+}
+
+/**
+ * Makes sure the memo of a scratch space covers a number of terms.
+ *
+ * @param scratch Pointer to a scratch space.
+ * @param count Number of terms.
+ *
+ * @return On success, <code>0</code> is returned.
+ * 	On error, <code>#HILBERT_ERR_NOMEM</code> is returned and the scratch space remains unchanged.
+ */
+static int scratch_reserve(struct ProofScratch * scratch, size_t count) {
+	if (count <= scratch->memosize)
+		return 0;
+
+	size_t newsize = scratch->memosize <= SIZE_MAX / 2 ? 2 * scratch->memosize : SIZE_MAX;
+	if (newsize < count)
+		newsize = count;
+	if (newsize > SIZE_MAX / sizeof(*scratch->memo))
+		return HILBERT_ERR_NOMEM;
+	HilbertHandle * memo = realloc(scratch->memo, newsize * sizeof(*memo));
+	if (memo == NULL)
+		return HILBERT_ERR_NOMEM;
+	for (size_t i = scratch->memosize; i != newsize; ++i)
+		memo[i] = PROOF_TERM_NONE;
+	scratch->memo = memo;
+	scratch->memosize = newsize;
+
+	return 0;
+}
+
+/**
+ * Checks whether a term may be substituted for a variable.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be locked.
+ * @param var Variable handle.
+ * @param term Term handle.
+ *
+ * @return If the kind of <code>term</code> is equivalent to the kind of <code>var</code>, a nonzero value is returned.
+ * 	Otherwise, <code>0</code> is returned.
+ */
+static inline int proof_substitutable(struct HilbertModule * module, HilbertHandle var, HilbertHandle term) {
+	HilbertHandle varkind = cl_otable_kind(module->objects, var);
+	HilbertHandle termkind = cl_otable_kind(module->objects, cl_tstore_get(module->terms, term)->head);
+
+	return (varkind == termkind) || hilbert_kind_isequivalent_nocheck(module, varkind, termkind);
+}
+
+/**
+ * Applies a statement to the top of a proof stack.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be write-locked.
+ * @param scratch Pointer to the scratch space of the current thread,
+ * 	whose memo covers all terms of <code>statement</code>.
+ * @param statement Pointer to the statement record.
+ * @param stack Pointer to the proof stack.
+ * @param top Pointer to the number of entries of the proof stack.
+ *
+ * @return On success, <code>0</code> is returned, and the stack has been updated.
+ * 	On error, <code>#HILBERT_ERR_INVALID_PROOF</code> or <code>#HILBERT_ERR_NOMEM</code> is returned.
+ * 	New terms may have been added to the module in either case.
+ */
+static int proof_apply(struct HilbertModule * restrict module, struct ProofScratch * restrict scratch,
+		const struct Statement * restrict statement, struct ProofEntry * restrict stack, size_t * restrict top) {
+	HilbertHandle * memo = scratch->memo;
+	int errcode = 0;
+
+	/* match the hypotheses against the topmost facts */
+	if (*top < statement->hypcount) {
+		errcode = HILBERT_ERR_INVALID_PROOF;
+		goto reset;
+	}
+	size_t base = *top - statement->hypcount;
+	for (size_t i = 0; i != statement->hypcount; ++i) {
+		if (!stack[base + i].fact) {
+			errcode = HILBERT_ERR_INVALID_PROOF;
+			goto reset;
+		}
+		if ((hilbert_ivector_pushback(scratch->work, statement->hyps[i]) != 0)
+				|| (hilbert_ivector_pushback(scratch->work, stack[base + i].term) != 0)) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+	}
+	while (hilbert_ivector_count(scratch->work) != 0) {
+		HilbertHandle term = hilbert_ivector_popback(scratch->work);
+		HilbertHandle pattern = hilbert_ivector_popback(scratch->work);
+		if (memo[pattern] != PROOF_TERM_NONE) {
+			if (memo[pattern] != term) {
+				errcode = HILBERT_ERR_INVALID_PROOF;
+				goto reset;
+			}
+			continue;
+		}
+		if (hilbert_ivector_pushback(scratch->touched, pattern) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+		memo[pattern] = term;
+
+		const struct Term * patternnode = cl_tstore_get(module->terms, pattern);
+		if (cl_otable_type(module->objects, patternnode->head) & HILBERT_TYPE_VAR) {
+			if (!proof_substitutable(module, patternnode->head, term)) {
+				errcode = HILBERT_ERR_INVALID_PROOF;
+				goto reset;
+			}
+			continue;
+		}
+		/* same functor implies same number of arguments */
+		const struct Term * termnode = cl_tstore_get(module->terms, term);
+		if (termnode->head != patternnode->head) {
+			errcode = HILBERT_ERR_INVALID_PROOF;
+			goto reset;
+		}
+		for (size_t i = 0; i != patternnode->argc; ++i) {
+			if ((hilbert_ivector_pushback(scratch->work, patternnode->args[i]) != 0)
+					|| (hilbert_ivector_pushback(scratch->work, termnode->args[i]) != 0)) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto reset;
+			}
+		}
+	}
+
+	/* collect the variables occurring only in the conclusion, in preorder */
+	if (hilbert_ivector_pushback(scratch->work, statement->conclusion) != 0) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto reset;
+	}
+	while (hilbert_ivector_count(scratch->work) != 0) {
+		HilbertHandle pattern = hilbert_ivector_popback(scratch->work);
+		if (memo[pattern] != PROOF_TERM_NONE)
+			continue;
+		if (hilbert_ivector_pushback(scratch->touched, pattern) != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+		memo[pattern] = PROOF_TERM_PENDING;
+
+		const struct Term * patternnode = cl_tstore_get(module->terms, pattern);
+		if (cl_otable_type(module->objects, patternnode->head) & HILBERT_TYPE_VAR) {
+			if (hilbert_ivector_pushback(scratch->fresh, pattern) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto reset;
+			}
+			continue;
+		}
+		for (size_t i = patternnode->argc; i != 0; --i) {
+			if (hilbert_ivector_pushback(scratch->work, patternnode->args[i - 1]) != 0) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto reset;
+			}
+		}
+	}
+
+	/* instantiate them with the substitution values below the facts */
+	size_t freshcount = hilbert_ivector_count(scratch->fresh);
+	if (base < freshcount) {
+		errcode = HILBERT_ERR_INVALID_PROOF;
+		goto reset;
+	}
+	base -= freshcount;
+	for (size_t i = 0; i != freshcount; ++i) {
+		HilbertHandle pattern = hilbert_ivector_get(scratch->fresh, i);
+		if (stack[base + i].fact
+				|| !proof_substitutable(module, cl_tstore_get(module->terms, pattern)->head, stack[base + i].term)) {
+			errcode = HILBERT_ERR_INVALID_PROOF;
+			goto reset;
+		}
+		memo[pattern] = stack[base + i].term;
+	}
+
+	/* build the instance of the conclusion bottom up */
+	if (hilbert_ivector_pushback(scratch->work, statement->conclusion) != 0) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto reset;
+	}
+	while (hilbert_ivector_count(scratch->work) != 0) {
+		HilbertHandle pattern = hilbert_ivector_last(scratch->work);
+		if (memo[pattern] != PROOF_TERM_PENDING) {
+			hilbert_ivector_popback(scratch->work);
+			continue;
+		}
+		const struct Term * patternnode = cl_tstore_get(module->terms, pattern);
+		int ready = 1;
+		for (size_t i = 0; i != patternnode->argc; ++i) {
+			if (memo[patternnode->args[i]] == PROOF_TERM_PENDING) {
+				ready = 0;
+				if (hilbert_ivector_pushback(scratch->work, patternnode->args[i]) != 0) {
+					errcode = HILBERT_ERR_NOMEM;
+					goto reset;
+				}
+			}
+		}
+		if (!ready)
+			continue;
+		hilbert_ivector_popback(scratch->work);
+
+		ArenaMark mark = cl_arena_mark(scratch->arena);
+		HilbertHandle * args = NULL;
+		if (patternnode->argc != 0) {
+			args = cl_arena_alloc(scratch->arena, patternnode->argc * sizeof(*args));
+			if (args == NULL) {
+				errcode = HILBERT_ERR_NOMEM;
+				goto reset;
+			}
+			for (size_t i = 0; i != patternnode->argc; ++i)
+				args[i] = memo[patternnode->args[i]];
+		}
+		HilbertHandle instance;
+		int rc = cl_tstore_intern(module->terms, module->arena, patternnode->head, patternnode->argc, args, &instance);
+		cl_arena_rewind(scratch->arena, mark);
+		if (rc != 0) {
+			errcode = HILBERT_ERR_NOMEM;
+			goto reset;
+		}
+		memo[pattern] = instance;
+	}
+
+	stack[base] = (struct ProofEntry) { .term = memo[statement->conclusion], .fact = 1 };
+	*top = base + 1;
+
+reset:
+	for (size_t i = 0, count = hilbert_ivector_count(scratch->touched); i != count; ++i)
+		memo[hilbert_ivector_get(scratch->touched, i)] = PROOF_TERM_NONE;
+	hilbert_ivector_downsize(scratch->touched, 0);
+	hilbert_ivector_downsize(scratch->work, 0);
+	hilbert_ivector_downsize(scratch->fresh, 0);
+
+	return errcode;
+}
+
+HilbertHandle hilbert_theorem_create(struct HilbertModule * restrict module, size_t hypc,
+		const HilbertHandle * restrict hypv, HilbertHandle conclusion, size_t stepc,
+		const HilbertProofStep * restrict stepv, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((hypc == 0) || (hypv != NULL));
+	assert ((stepc == 0) || (stepv != NULL));
+	assert (errcode != NULL);
+
+	struct ProofScratch * scratch;
+	struct ProofEntry * stack;
+	size_t top = 0;
+	size_t step;
+	int rc;
+	HilbertHandle result = 0;
+
+	if (hilbert_module_gettype(module) != HILBERT_PROOF_MODULE) {
+		*errcode = HILBERT_ERR_INVALID_MODULE;
+		goto invalid_module;
+	}
+
+	scratch = scratch_get(errcode);
+	if (scratch == NULL)
+		goto noscratch;
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, errcode);
+	if (*errcode != 0)
+		goto immutable;
+	if (rc) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	size_t termcount = cl_tstore_count(module->terms);
+	if (conclusion >= termcount) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	for (size_t i = 0; i != hypc; ++i) {
+		if (hypv[i] >= termcount) {
+			*errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wronghandle;
+		}
+	}
+
+	if ((hypc > SIZE_MAX / sizeof(*hypv)) || (stepc > SIZE_MAX / sizeof(*stack))) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto counttoobig;
+	}
+
+	/* statement terms are never newer than the proof */
+	if (scratch_reserve(scratch, termcount) != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nomemomem;
+	}
+
+	/* each step pushes at most one entry */
+	ArenaMark mark = cl_arena_mark(module->arena);
+	stack = cl_arena_alloc(scratch->arena, stepc * sizeof(*stack));
+	if (stack == NULL) {
+		*errcode = HILBERT_ERR_NOMEM;
+		goto nostackmem;
+	}
+
+	for (step = 0; step != stepc; ++step) {
+		HilbertHandle handle = stepv[step].handle;
+		switch (stepv[step].type) {
+			case HILBERT_STEP_HYP:
+				if (handle >= hypc) {
+					*errcode = HILBERT_ERR_INVALID_HANDLE;
+					goto proofinvalid;
+				}
+				stack[top++] = (struct ProofEntry) { .term = hypv[handle], .fact = 1 };
+				break;
+			case HILBERT_STEP_TERM:
+				if (handle >= termcount) {
+					*errcode = HILBERT_ERR_INVALID_HANDLE;
+					goto proofinvalid;
+				}
+				stack[top++] = (struct ProofEntry) { .term = handle, .fact = 0 };
+				break;
+			case HILBERT_STEP_APPLY:
+				if (!hilbert_object_check(module, handle, HILBERT_TYPE_STATEMENT)) {
+					*errcode = HILBERT_ERR_INVALID_HANDLE;
+					goto proofinvalid;
+				}
+				*errcode = proof_apply(module, scratch, &cl_otable_record(module->objects, handle)->statement,
+						stack, &top);
+				if (*errcode != 0)
+					goto proofinvalid;
+				break;
+			default:
+				*errcode = HILBERT_ERR_INVALID_PROOF;
+				goto proofinvalid;
+		}
+	}
+	if ((top != 1) || !stack[0].fact || (stack[0].term != conclusion)) {
+		*errcode = HILBERT_ERR_INVALID_PROOF;
+		goto proofinvalid;
+	}
+	hilbert_stats_add(module, proofsteps, stepc);
+
+	/* the intermediate terms are not needed beyond the proof */
+	cl_tstore_downsize(module->terms, termcount);
+	cl_arena_rewind(module->arena, mark);
+	cl_arena_reset(scratch->arena);
+
+	result = hilbert_statement_push(module, hypc, hypv, conclusion, errcode);
+
+	goto success;
+
+proofinvalid:
+	hilbert_stats_add(module, proofsteps, step);
+	cl_tstore_downsize(module->terms, termcount);
+	cl_arena_reset(scratch->arena);
+	cl_arena_rewind(module->arena, mark);
+nostackmem:
+nomemomem:
+counttoobig:
+wronghandle:
+immutable:
+success:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+noscratch:
+invalid_module:
+	return result;
+}
@@ -0,0 +1,146 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#include"private.h"
+
+#include<assert.h>
+#include<stdlib.h>
+
+#include"cl/arena.h"
+#include"cl/ivector.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+
+#include"threads/hthreads.h"
+
+HilbertHandle hilbert_statement_create(struct HilbertModule * restrict module, size_t hypc,
+		const HilbertHandle * restrict hypv, HilbertHandle conclusion, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((hypc == 0) || (hypv != NULL));
+	assert (errcode != NULL);
+
+	int rc;
+	HilbertHandle result = 0;
+
+	if (hilbert_module_gettype(module) != HILBERT_INTERFACE_MODULE) {
+		*errcode = HILBERT_ERR_INVALID_MODULE;
+		goto invalid_module;
+	}
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, errcode);
+	if (*errcode != 0)
+		goto immutable;
+	if (rc) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	size_t termcount = cl_tstore_count(module->terms);
+	if (conclusion >= termcount) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	for (size_t i = 0; i != hypc; ++i) {
+		if (hypv[i] >= termcount) {
+			*errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wronghandle;
+		}
+	}
+
+	result = hilbert_statement_push(module, hypc, hypv, conclusion, errcode);
+
+	goto success;
+
+wronghandle:
+immutable:
+success:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+invalid_module:
+	return result;
+}
+
+HilbertHandle hilbert_statement_getconclusion(struct HilbertModule * restrict module, HilbertHandle statement,
+		int * restrict errcode) {
+	assert (module != NULL);
+	assert (errcode != NULL);
+
+	HilbertHandle result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (!hilbert_object_check(module, statement, HILBERT_TYPE_STATEMENT)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	result = cl_otable_record(module->objects, statement)->statement.conclusion;
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
+const HilbertHandle * hilbert_statement_gethyps_view(struct HilbertModule * restrict module, HilbertHandle statement,
+		size_t * restrict size, int * restrict errcode) {
+	assert (module != NULL);
+	assert (size != NULL);
+	assert (errcode != NULL);
+
+	const HilbertHandle * result = NULL;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (!hilbert_object_check(module, statement, HILBERT_TYPE_STATEMENT)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	/* statement records never change, so the view remains valid after unlocking */
+	const struct Statement * record = &cl_otable_record(module->objects, statement)->statement;
+	*size = record->hypcount;
+	result = record->hyps;
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		result = NULL;
+	}
+nolock:
+	return result;
+}
@@ -0,0 +1,235 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+#include"private.h"
+
+#include<assert.h>
+#include<stdlib.h>
+
+#include"cl/arena.h"
+#include"cl/otable.h"
+#include"cl/tstore.h"
+
+#include"threads/hthreads.h"
+
+/**
+ * Interns a term in a module.
+ *
+ * @param module Pointer to a Hilbert module, assumed to be write-locked.
+ * @param head Functor or variable handle, already checked.
+ * @param argc Number of arguments.
+ * @param argv Pointer to an array of <code>argc</code> argument term handles, already checked.
+ * @param errcode Pointer to an integer to convey an error code.
+ *
+ * @return The term handle.
+ */
+static HilbertHandle term_intern(struct HilbertModule * restrict module, HilbertHandle head, size_t argc,
+		const HilbertHandle * restrict argv, int * restrict errcode) {
+	HilbertHandle result = 0;
+
+	if (cl_tstore_count(module->terms) > HILBERT_HANDLE_MAX) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		return result;
+	}
+	if (cl_tstore_intern(module->terms, module->arena, head, argc, argv, &result) != 0) {
+		*errcode = HILBERT_ERR_NOMEM;
+		return result;
+	}
+
+	*errcode = 0;
+	return result;
+}
+
+HilbertHandle hilbert_term_var(struct HilbertModule * restrict module, HilbertHandle var, int * restrict errcode) {
+	assert (module != NULL);
+	assert (errcode != NULL);
+
+	int rc;
+	HilbertHandle result = 0;
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, errcode);
+	if (*errcode != 0)
+		goto immutable;
+	if (rc) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	if (!hilbert_object_check(module, var, HILBERT_TYPE_VAR)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+
+	result = term_intern(module, var, 0, NULL, errcode);
+
+wronghandle:
+immutable:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
+HilbertHandle hilbert_term_create(struct HilbertModule * restrict module, HilbertHandle functor, size_t argc,
+		const HilbertHandle * restrict argv, int * restrict errcode) {
+	assert (module != NULL);
+	assert ((argc == 0) || (argv != NULL));
+	assert (errcode != NULL);
+
+	int rc;
+	HilbertHandle result = 0;
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, errcode);
+	if (*errcode != 0)
+		goto immutable;
+	if (rc) {
+		*errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	if (!hilbert_object_check(module, functor, HILBERT_TYPE_FUNCTOR)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	const struct BasicFunctor * record = &cl_otable_record(module->objects, functor)->basic_functor;
+	if (record->place_count != argc) {
+		*errcode = HILBERT_ERR_COUNT_MISMATCH;
+		goto wronghandle;
+	}
+	const HilbertHandle * inputkinds = hilbert_functor_inputkinds(record);
+	size_t termcount = cl_tstore_count(module->terms);
+	for (size_t i = 0; i != argc; ++i) {
+		if (argv[i] >= termcount) {
+			*errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wronghandle;
+		}
+		HilbertHandle kind = cl_otable_kind(module->objects, cl_tstore_get(module->terms, argv[i])->head);
+		if (!hilbert_kind_isequivalent_nocheck(module, kind, inputkinds[i])) {
+			*errcode = HILBERT_ERR_KIND_MISMATCH;
+			goto wronghandle;
+		}
+	}
+
+	result = term_intern(module, functor, argc, argv, errcode);
+
+wronghandle:
+immutable:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
+HilbertHandle hilbert_term_getkind(struct HilbertModule * restrict module, HilbertHandle term, int * restrict errcode) {
+	assert (module != NULL);
+	assert (errcode != NULL);
+
+	HilbertHandle result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (term >= cl_tstore_count(module->terms)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	result = cl_otable_kind(module->objects, cl_tstore_get(module->terms, term)->head);
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
+HilbertHandle hilbert_term_gethead(struct HilbertModule * restrict module, HilbertHandle term, int * restrict errcode) {
+	assert (module != NULL);
+	assert (errcode != NULL);
+
+	HilbertHandle result = 0;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (term >= cl_tstore_count(module->terms)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	result = cl_tstore_get(module->terms, term)->head;
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success)
+		*errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return result;
+}
+
+const HilbertHandle * hilbert_term_getargs_view(struct HilbertModule * restrict module, HilbertHandle term,
+		size_t * restrict size, int * restrict errcode) {
+	assert (module != NULL);
+	assert (size != NULL);
+	assert (errcode != NULL);
+
+	const HilbertHandle * result = NULL;
+
+	if (hilbert_module_rdlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	if (term >= cl_tstore_count(module->terms)) {
+		*errcode = HILBERT_ERR_INVALID_HANDLE;
+		goto wronghandle;
+	}
+	/* term nodes live in the module arena and never change, so the view remains valid after unlocking */
+	const struct Term * node = cl_tstore_get(module->terms, term);
+	*size = node->argc;
+	result = node->argc != 0 ? node->args : NULL;
+
+	*errcode = 0;
+
+wronghandle:
+	if (hilbert_module_rdunlock(module) != thrd_success) {
+		*errcode = HILBERT_ERR_INTERNAL;
+		result = NULL;
+	}
+nolock:
+	return result;
+}
@@ -0,0 +1,85 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/* Partial standard C atomics emulation through GCC builtins until C1X is ready */
+
+#ifndef HILBERT_THREADS_ATOMIC_H__
+#define HILBERT_THREADS_ATOMIC_H__
+
+/**
+ * Memory orderings.
+ */
+typedef enum {
+	memory_order_relaxed = __ATOMIC_RELAXED,
+	memory_order_consume = __ATOMIC_CONSUME,
+	memory_order_acquire = __ATOMIC_ACQUIRE,
+	memory_order_release = __ATOMIC_RELEASE,
+	memory_order_acq_rel = __ATOMIC_ACQ_REL,
+	memory_order_seq_cst = __ATOMIC_SEQ_CST
+} memory_order;
+
+/**
+ * Atomically loads a value.
+ *
+ * @param object Pointer to the object to be loaded.
+ * @param order Memory ordering of the load.
+ *
+ * @return The value of the object pointed to by <code>object</code>.
+ */
+#define atomic_load_explicit(object, order) __atomic_load_n(object, order)
+
+/**
+ * Atomically stores a value.
+ *
+ * @param object Pointer to the object to be stored to.
+ * @param desired Value to be stored.
+ * @param order Memory ordering of the store.
+ */
+#define atomic_store_explicit(object, desired, order) __atomic_store_n(object, desired, order)
+
+/**
+ * Atomically adds to a value.
+ *
+ * @param object Pointer to the object to be added to.
+ * @param operand Value to be added.
+ * @param order Memory ordering of the addition.
+ *
+ * @return The value of the object pointed to by <code>object</code> before the addition.
+ */
+#define atomic_fetch_add_explicit(object, operand, order) __atomic_fetch_add(object, operand, order)
+
+/**
+ * Atomically compares and exchanges a value.
+ *
+ * @param object Pointer to the object to be compared and exchanged.
+ * @param expected Pointer to the expected value, which receives the actual value on failure.
+ * @param desired Value to be stored on success.
+ * @param success Memory ordering on success.
+ * @param failure Memory ordering on failure.
+ *
+ * @return If the object pointed to by <code>object</code> had the value pointed to by <code>expected</code>,
+ * 	a nonzero value is returned. Otherwise, <code>0</code> is returned.
+ */
+#define atomic_compare_exchange_strong_explicit(object, expected, desired, success, failure) \
+	__atomic_compare_exchange_n(object, expected, desired, 0, success, failure)
+
+#endif
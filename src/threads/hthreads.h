@@ -34,6 +34,11 @@
  */
 #define HILBERT_MUTEX_DECL(x)
 
+/**
+ * Dummy reader/writer lock declaration macro
+ */
+#define HILBERT_RWLOCK_DECL(x)
+
 /**
  * Dummy enumeration constants.
  */
@@ -41,7 +46,8 @@ enum {
 	mtx_plain,
 	mtx_recursive,
 	thrd_success,
-	thrd_error
+	thrd_error,
+	thrd_busy
 };
 
 /**
@@ -70,6 +76,15 @@ enum {
  */
 #define mtx_lock(mtx) thrd_success
 
+/**
+ * Dummy mutex test and lock.
+ *
+ * @param mtx Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define mtx_trylock(mtx) thrd_success
+
 /**
  * Dummy mutex unlock.
  *
@@ -79,14 +94,194 @@ enum {
  */
 #define mtx_unlock(mtx) thrd_success
 
+/**
+ * Dummy reader/writer lock destruction.
+ *
+ * @param rwl Dummy parameter.
+ */
+#define rwl_destroy(rwl)
+
+/**
+ * Dummy reader/writer lock init.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_init(rwl) thrd_success
+
+/**
+ * Dummy reader/writer lock read lock.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_rdlock(rwl) thrd_success
+
+/**
+ * Dummy reader/writer lock write lock.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_wrlock(rwl) thrd_success
+
+/**
+ * Dummy reader/writer lock test and read lock.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_tryrdlock(rwl) thrd_success
+
+/**
+ * Dummy reader/writer lock test and write lock.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_trywrlock(rwl) thrd_success
+
+/**
+ * Dummy reader/writer lock unlock.
+ *
+ * @param rwl Dummy parameter.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define rwl_unlock(rwl) thrd_success
+
+/**
+ * Dummy thread-specific storage pointer type.
+ * Without threads, the pointer is simply a global.
+ */
+typedef void * tss_t;
+
+/**
+ * Dummy thread-specific storage destructor type.
+ */
+typedef void (*tss_dtor_t)(void *);
+
+/**
+ * Dummy thread-specific storage pointer creation.
+ *
+ * @param key Pointer to the thread-specific storage pointer.
+ * @param dtor Dummy parameter, evaluated but not used.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define tss_create(key, dtor) ((void) (dtor), (void) (*(key) = NULL), thrd_success)
+
+/**
+ * Dummy thread-specific storage pointer read.
+ *
+ * @param key Thread-specific storage pointer.
+ *
+ * @return The value of <code>key</code>.
+ */
+#define tss_get(key) (key)
+
+/**
+ * Dummy thread-specific storage pointer write.
+ *
+ * @param key Thread-specific storage pointer.
+ * @param val New value of the pointer.
+ *
+ * @return Dummy function always returns <code>#thrd_success</code>.
+ */
+#define tss_set(key, val) ((void) ((key) = (val)), thrd_success)
+
+/**
+ * Dummy once flag type.
+ */
+typedef int once_flag;
+
+/**
+ * Dummy once flag initialiser.
+ */
+#define ONCE_FLAG_INIT 0
+
+/**
+ * Dummy call once.
+ *
+ * @param flag Pointer to a flag initialised with <code>#ONCE_FLAG_INIT</code>.
+ * @param func Function to be called if <code>*flag</code> is still clear.
+ */
+#define call_once(flag, func) ((void) (*(flag) ? 0 : (*(flag) = 1, (func)(), 0)))
+
+/**
+ * Dummy memory orderings.
+ */
+typedef enum {
+	memory_order_relaxed,
+	memory_order_consume,
+	memory_order_acquire,
+	memory_order_release,
+	memory_order_acq_rel,
+	memory_order_seq_cst
+} memory_order;
+
+/**
+ * Dummy atomic load.
+ *
+ * @param object Pointer to the object to be loaded.
+ * @param order Dummy parameter.
+ *
+ * @return The value of the object pointed to by <code>object</code>.
+ */
+#define atomic_load_explicit(object, order) (*(object))
+
+/**
+ * Dummy atomic store.
+ *
+ * @param object Pointer to the object to be stored to.
+ * @param desired Value to be stored.
+ * @param order Dummy parameter.
+ */
+#define atomic_store_explicit(object, desired, order) ((void) (*(object) = (desired)))
+
+/**
+ * Dummy atomic addition.
+ *
+ * @param object Pointer to the object to be added to.
+ * @param operand Value to be added.
+ * @param order Dummy parameter.
+ *
+ * @return The value of the object pointed to by <code>object</code> before the addition.
+ */
+#define atomic_fetch_add_explicit(object, operand, order) ((*(object) += (operand)) - (operand))
+
+/**
+ * Dummy atomic compare and exchange.
+ *
+ * @param object Pointer to the object to be compared and exchanged.
+ * @param expected Pointer to the expected value, which receives the actual value on failure.
+ * @param desired Value to be stored on success.
+ * @param success Dummy parameter.
+ * @param failure Dummy parameter.
+ *
+ * @return If the object pointed to by <code>object</code> had the value pointed to by <code>expected</code>,
+ * 	a nonzero value is returned. Otherwise, <code>0</code> is returned.
+ */
+#define atomic_compare_exchange_strong_explicit(object, expected, desired, success, failure) \
+	(*(object) == *(expected) ? (*(object) = (desired), 1) : (*(expected) = *(object), 0))
+
 #else /* HILBERT_THREADSAFE is defined */
 
 #define HILBERT_MUTEX_DECL(x) mtx_t x
 
+#define HILBERT_RWLOCK_DECL(x) rwl_t x
+
 // #ifdef __STDC_NO_THREADS__ 
 #include"threads.h"
+#include"atomic.h"
 // #else
 // #include<threads.h>
+// #include<stdatomic.h>
 // #endif
 
 #endif /* !defined HILBERT_THREADSAFE */
@@ -25,6 +25,7 @@
 #ifndef HILBERT_THREADS_THREADS_H__
 #define HILBERT_THREADS_THREADS_H__
 
+#include<errno.h>
 #include<pthread.h>
 
 /**
@@ -34,6 +35,35 @@
  */
 typedef pthread_mutex_t mtx_t;
 
+/**
+ * Reader/writer lock type (extension).
+ *
+ * A variable of this type can hold the identifier for a reader/writer lock.
+ */
+typedef pthread_rwlock_t rwl_t;
+
+/**
+ * Thread-specific storage pointer type.
+ *
+ * A variable of this type can hold the identifier for a thread-specific storage pointer.
+ */
+typedef pthread_key_t tss_t;
+
+/**
+ * Thread-specific storage destructor type.
+ */
+typedef void (*tss_dtor_t)(void *);
+
+/**
+ * Flag type for <code>#call_once()</code>.
+ */
+typedef pthread_once_t once_flag;
+
+/**
+ * Initialiser for a <code>#once_flag</code>.
+ */
+#define ONCE_FLAG_INIT PTHREAD_ONCE_INIT
+
 /**
  * Enumeration constants.
  */
@@ -61,6 +91,12 @@ enum {
 	 * that the requested operation has failed.
 	 */
 	thrd_error,
+
+	/**
+	 * Enumeration constant returned by a test and return function to indicate
+	 * that the requested resource is already in use.
+	 */
+	thrd_busy,
 };
 
 /**
@@ -136,6 +172,26 @@ static inline int mtx_lock(mtx_t * mtx) {
 	return thrd_error;
 }
 
+/**
+ * Tries to lock a mutex without blocking.
+ *
+ * @param mtx Pointer to mutex to be locked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	If the mutex is already locked, <code>#thrd_busy</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int mtx_trylock(mtx_t * mtx) {
+	switch (pthread_mutex_trylock(mtx)) {
+		case 0:
+			return thrd_success;
+		case EBUSY:
+			return thrd_busy;
+		default:
+			return thrd_error;
+	}
+}
+
 /**
  * Unlocks a mutex.
  *
@@ -153,4 +209,175 @@ static inline int mtx_unlock(mtx_t * mtx) {
 	return thrd_error;
 }
 
+/**
+ * Destroys a reader/writer lock (extension).
+ *
+ * Releases any resources used by the lock pointed to by <code>rwl</code>.
+ * No threads can be blocked waiting for the lock pointed to by <code>rwl</code>.
+ *
+ * @param rwl Pointer to the reader/writer lock to be destroyed.
+ */
+static inline void rwl_destroy(rwl_t * rwl) {
+	pthread_rwlock_destroy(rwl);
+}
+
+/**
+ * Initialises a reader/writer lock (extension).
+ *
+ * Reader/writer locks are not recursive:
+ * a thread holding the lock in either mode shall not lock it again.
+ *
+ * @param rwl Pointer to the reader/writer lock to be initialised.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_init(rwl_t * rwl) {
+	if (pthread_rwlock_init(rwl, NULL) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
+/**
+ * Locks a reader/writer lock for reading, possibly blocking the current thread.
+ *
+ * Any number of threads may hold the lock for reading at the same time,
+ * provided no thread holds it for writing.
+ *
+ * @param rwl Pointer to the reader/writer lock to be locked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_rdlock(rwl_t * rwl) {
+	if (pthread_rwlock_rdlock(rwl) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
+/**
+ * Locks a reader/writer lock for writing, possibly blocking the current thread.
+ *
+ * @param rwl Pointer to the reader/writer lock to be locked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_wrlock(rwl_t * rwl) {
+	if (pthread_rwlock_wrlock(rwl) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
+/**
+ * Tries to lock a reader/writer lock for reading without blocking.
+ *
+ * @param rwl Pointer to the reader/writer lock to be locked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	If the lock is held for writing, <code>#thrd_busy</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_tryrdlock(rwl_t * rwl) {
+	switch (pthread_rwlock_tryrdlock(rwl)) {
+		case 0:
+			return thrd_success;
+		case EBUSY:
+			return thrd_busy;
+		default:
+			return thrd_error;
+	}
+}
+
+/**
+ * Tries to lock a reader/writer lock for writing without blocking.
+ *
+ * @param rwl Pointer to the reader/writer lock to be locked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	If the lock is held in either mode, <code>#thrd_busy</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_trywrlock(rwl_t * rwl) {
+	switch (pthread_rwlock_trywrlock(rwl)) {
+		case 0:
+			return thrd_success;
+		case EBUSY:
+			return thrd_busy;
+		default:
+			return thrd_error;
+	}
+}
+
+/**
+ * Unlocks a reader/writer lock held by the calling thread in either mode.
+ *
+ * @param rwl Pointer to the reader/writer lock to be unlocked.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int rwl_unlock(rwl_t * rwl) {
+	if (pthread_rwlock_unlock(rwl) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
+/**
+ * Calls a function exactly once.
+ *
+ * The first call with a given flag calls <code>func</code>. Later calls with the same flag do not,
+ * but they wait until the first call has completed.
+ *
+ * @param flag Pointer to a flag initialised with <code>#ONCE_FLAG_INIT</code>.
+ * @param func Function to be called.
+ */
+static inline void call_once(once_flag * flag, void (*func)(void)) {
+	pthread_once(flag, func);
+}
+
+/**
+ * Creates a thread-specific storage pointer.
+ *
+ * The pointer is initially <code>NULL</code> in all threads.
+ *
+ * @param key Pointer to the location where the identifier of the new pointer is stored.
+ * @param dtor Function called with the value of the pointer when a thread with a non-<code>NULL</code> value exits,
+ * 	or <code>NULL</code>.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int tss_create(tss_t * key, tss_dtor_t dtor) {
+	if (pthread_key_create(key, dtor) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
+/**
+ * Returns the value of a thread-specific storage pointer for the current thread.
+ *
+ * @param key Identifier of a thread-specific storage pointer.
+ *
+ * @return The value of the pointer in the current thread.
+ */
+static inline void * tss_get(tss_t key) {
+	return pthread_getspecific(key);
+}
+
+/**
+ * Sets the value of a thread-specific storage pointer for the current thread.
+ *
+ * @param key Identifier of a thread-specific storage pointer.
+ * @param val New value of the pointer.
+ *
+ * @return On success, <code>#thrd_success</code> is returned.
+ * 	On error, <code>#thrd_error</code> is returned.
+ */
+static inline int tss_set(tss_t key, void * val) {
+	if (pthread_setspecific(key, val) == 0)
+		return thrd_success;
+	return thrd_error;
+}
+
 #endif
@@ -26,7 +26,7 @@
 #include<stdlib.h>
 
 #include"cl/ivector.h"
-#include"cl/ovector.h"
+#include"cl/otable.h"
 
 #include"threads/hthreads.h"
 
@@ -34,12 +34,10 @@ HilbertHandle hilbert_var_create(struct HilbertModule * restrict module, Hilbert
 	assert (module != NULL);
 	assert (errcode != NULL);
 
-	union Object * kindobject;
-	union Object * object;
 	int rc;
 	size_t result = 0;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_wrlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
@@ -52,26 +50,18 @@ HilbertHandle hilbert_var_create(struct HilbertModule * restrict module, Hilbert
 		goto immutable;
 	}
 
-	kindobject = hilbert_object_retrieve(module, kind, HILBERT_TYPE_KIND);
-	if (kindobject == NULL) {
+	if (!hilbert_object_check(module, kind, HILBERT_TYPE_KIND)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wrongkind;
 	}
 
-	object = malloc(sizeof(*object));
-	if (object == NULL) {
-		*errcode = HILBERT_ERR_NOMEM;
-		goto novarmem;
-	}
-	object->var = (struct Variable) { .type = HILBERT_TYPE_VAR, .kind = kind };
-
-	result = hilbert_ovector_count(module->objects);
+	result = cl_otable_count(module->objects);
 	if (result > HILBERT_HANDLE_MAX) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nohandle;
 	}
 
-	*errcode = hilbert_ovector_pushback(module->objects, object);
+	*errcode = cl_otable_pushback(module->objects, (struct ObjectRow) { .type = HILBERT_TYPE_VAR, .kind = kind });
 	if (*errcode != 0) {
 		*errcode = HILBERT_ERR_NOMEM;
 		goto noobjectmem;
@@ -86,43 +76,99 @@ HilbertHandle hilbert_var_create(struct HilbertModule * restrict module, Hilbert
 	goto success;
 
 nohandlemem:
-	hilbert_ovector_popback(module->objects);
+	cl_otable_popback(module->objects);
 noobjectmem:
 nohandle:
-	free(object);
-novarmem:
 wrongkind:
 immutable:
 success:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_wrunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
 }
 
+int hilbert_var_create_n(struct HilbertModule * restrict module, size_t count, const HilbertHandle * restrict kinds,
+		HilbertHandle * restrict vars) {
+	assert (module != NULL);
+	assert ((count == 0) || ((kinds != NULL) && (vars != NULL)));
+
+	int errcode;
+	int rc;
+
+	if (hilbert_module_wrlock(module) != thrd_success) {
+		errcode = HILBERT_ERR_INTERNAL;
+		goto nolock;
+	}
+
+	rc = hilbert_module_isimmutable(module, &errcode);
+	if (errcode != 0)
+		goto immutable;
+	if (rc) {
+		errcode = HILBERT_ERR_IMMUTABLE;
+		goto immutable;
+	}
+
+	for (size_t i = 0; i != count; ++i) {
+		if (!hilbert_object_check(module, kinds[i], HILBERT_TYPE_KIND)) {
+			errcode = HILBERT_ERR_INVALID_HANDLE;
+			goto wrongkind;
+		}
+	}
+
+	/* reserve all space up front, so that the objects can be added without failure */
+	size_t first = cl_otable_count(module->objects);
+	size_t varcount = hilbert_ivector_count(module->varhandles);
+	if ((count > HILBERT_HANDLE_MAX - first) || (count > SIZE_MAX - varcount)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
+	}
+	if ((cl_otable_reserve(module->objects, first + count) != 0)
+			|| (hilbert_ivector_reserve(module->varhandles, varcount + count) != 0)) {
+		errcode = HILBERT_ERR_NOMEM;
+		goto nomem;
+	}
+
+	for (size_t i = 0; i != count; ++i) {
+		rc = cl_otable_pushback(module->objects, (struct ObjectRow) { .type = HILBERT_TYPE_VAR, .kind = kinds[i] });
+		assert (rc == 0);
+		rc = hilbert_ivector_pushback(module->varhandles, first + i);
+		assert (rc == 0);
+		vars[i] = first + i;
+	}
+
+	errcode = 0;
+
+nomem:
+wrongkind:
+immutable:
+	if (hilbert_module_wrunlock(module) != thrd_success)
+		errcode = HILBERT_ERR_INTERNAL;
+nolock:
+	return errcode;
+}
+
 HilbertHandle hilbert_var_getkind(struct HilbertModule * restrict module, HilbertHandle varhandle, int * restrict errcode) {
 	assert (module != NULL);
 	assert (errcode != NULL);
 
 	HilbertHandle result = 0;
-	union Object * object;
 
-	if (mtx_lock(&module->mutex) != thrd_success) {
+	if (hilbert_module_rdlock(module) != thrd_success) {
 		*errcode = HILBERT_ERR_INTERNAL;
 		goto nolock;
 	}
 
-	object = hilbert_object_retrieve(module, varhandle, HILBERT_TYPE_VAR);
-	if (object == NULL) {
+	if (!hilbert_object_check(module, varhandle, HILBERT_TYPE_VAR)) {
 		*errcode = HILBERT_ERR_INVALID_HANDLE;
 		goto wronghandle;
 	}
 
-	result = object->var.kind;
+	result = cl_otable_kind(module->objects, varhandle);
 	*errcode = 0;
 
 wronghandle:
-	if (mtx_unlock(&module->mutex) != thrd_success)
+	if (hilbert_module_rdunlock(module) != thrd_success)
 		*errcode = HILBERT_ERR_INTERNAL;
 nolock:
 	return result;
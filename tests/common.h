@@ -0,0 +1,54 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Helpers shared by the tests.
+ */
+
+#ifndef HILBERT_TESTS_COMMON_H__
+#define HILBERT_TESTS_COMMON_H__
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/* checks an error code */
+static void check(int errcode, int expected, const char * what) {
+	if (errcode != expected) {
+		fprintf(stderr, "%s returned errcode=%i, expected %i\n", what, errcode, expected);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* creates a term from a functor application */
+static HilbertHandle apply(HilbertModule * module, HilbertHandle functor, HilbertHandle arg0, HilbertHandle arg1) {
+	int errcode;
+	HilbertHandle args[2] = { arg0, arg1 };
+
+	HilbertHandle result = hilbert_term_create(module, functor, 2, args, &errcode);
+	check(errcode, 0, "Term creation");
+
+	return result;
+}
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check batch creation of kinds, variables and functors.
+ */
+
+#include<assert.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/* checks that module has the expected number of objects */
+static void count_check(HilbertModule * module, size_t expected) {
+	int errcode;
+	size_t count;
+
+	HilbertHandle * objects = hilbert_module_getobjects(module, &count, &errcode);
+	if (objects == NULL) {
+		fprintf(stderr, "Unable to obtain objects (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_harray_free(objects);
+	if (count != expected) {
+		fprintf(stderr, "Module has %zu objects, expected %zu\n", count, expected);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	int errcode;
+	HilbertHandle kinds[4], vkinds[2], vars[3], functors[3];
+
+	/* in proof modules */
+	HilbertModule * pmodule = hilbert_module_create(HILBERT_PROOF_MODULE);
+	assert (pmodule != NULL);
+	errcode = hilbert_kind_create_n(pmodule, 4, kinds);
+	if (errcode != HILBERT_ERR_INVALID_MODULE) {
+		fprintf(stderr, "Expected invalid module error while creating kinds in proof module, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_functor_create_n(pmodule, 0, NULL, NULL, NULL, NULL);
+	if (errcode != HILBERT_ERR_INVALID_MODULE) {
+		fprintf(stderr, "Expected invalid module error while creating functors in proof module, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_module_free(pmodule);
+
+	/* kinds */
+	HilbertModule * module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	assert (module != NULL);
+	errcode = hilbert_kind_create_n(module, 0, NULL);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create zero kinds (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_kind_create_n(module, 4, kinds);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create kinds (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_vkind_create_n(module, 2, vkinds);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create variable kinds (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 6);
+	for (size_t i = 0; i != 4; ++i) {
+		if (hilbert_object_gettype(module, kinds[i], &errcode) != HILBERT_TYPE_KIND) {
+			fprintf(stderr, "kind%zu has wrong type\n", i);
+			exit(EXIT_FAILURE);
+		}
+		for (size_t j = 0; j != i; ++j) {
+			if (hilbert_kind_isequivalent(module, kinds[i], kinds[j], &errcode)) {
+				fprintf(stderr, "kind%zu and kind%zu are equivalent\n", i, j);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+	for (size_t i = 0; i != 2; ++i) {
+		if (hilbert_object_gettype(module, vkinds[i], &errcode) != (HILBERT_TYPE_KIND | HILBERT_TYPE_VKIND)) {
+			fprintf(stderr, "vkind%zu has wrong type\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* variables */
+	HilbertHandle varkinds[3] = { vkinds[0], 666, kinds[1] };
+	errcode = hilbert_var_create_n(module, 3, varkinds, vars);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error while creating variables with invalid kind, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 6);
+	varkinds[1] = vkinds[1];
+	errcode = hilbert_var_create_n(module, 3, varkinds, vars);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create variables (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 9);
+	for (size_t i = 0; i != 3; ++i) {
+		if (hilbert_var_getkind(module, vars[i], &errcode) != varkinds[i]) {
+			fprintf(stderr, "var%zu has wrong kind\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* functors */
+	HilbertHandle rkinds[3] = { kinds[0], kinds[1], vkinds[0] };
+	size_t placecounts[3] = { 0, 2, 1 };
+	HilbertHandle ikinds[3] = { kinds[2], vkinds[1], kinds[3] };
+	errcode = hilbert_functor_create_n(module, 3, rkinds, placecounts, ikinds, functors);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error while creating functors with variable result kind, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 9);
+	rkinds[2] = kinds[2];
+	ikinds[1] = vars[0];
+	errcode = hilbert_functor_create_n(module, 3, rkinds, placecounts, ikinds, functors);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error while creating functors with invalid input kind, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 9);
+	ikinds[1] = vkinds[1];
+	errcode = hilbert_functor_create_n(module, 3, rkinds, placecounts, ikinds, functors);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create functors (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 12);
+	for (size_t i = 0, offset = 0; i != 3; offset += placecounts[i++]) {
+		if (hilbert_functor_getkind(module, functors[i], &errcode) != rkinds[i]) {
+			fprintf(stderr, "functor%zu has wrong result kind\n", i);
+			exit(EXIT_FAILURE);
+		}
+		size_t size;
+		HilbertHandle * inputkinds = hilbert_functor_getinputkinds(module, functors[i], &size, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to obtain input kinds of functor%zu (errcode=%d)\n", i, errcode);
+			exit(EXIT_FAILURE);
+		}
+		if (size != placecounts[i]) {
+			fprintf(stderr, "functor%zu has place count %zu, expected %zu\n", i, size, placecounts[i]);
+			exit(EXIT_FAILURE);
+		}
+		for (size_t j = 0; j != size; ++j) {
+			if (inputkinds[j] != ikinds[offset + j]) {
+				fprintf(stderr, "functor%zu has wrong input kind %zu\n", i, j);
+				exit(EXIT_FAILURE);
+			}
+		}
+		hilbert_harray_free(inputkinds);
+	}
+
+	/* immutable modules */
+	errcode = hilbert_module_makeimmutable(module);
+	assert (errcode == 0);
+	errcode = hilbert_kind_create_n(module, 4, kinds);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error while creating kinds in immutable module, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_var_create_n(module, 3, varkinds, vars);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error while creating variables in immutable module, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_functor_create_n(module, 3, rkinds, placecounts, ikinds, functors);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error while creating functors in immutable module, got errcode=%d instead\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count_check(module, 12);
+
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+}
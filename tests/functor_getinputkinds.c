@@ -30,6 +30,29 @@
 
 #include"hilbert.h"
 
+/* checks the input kinds of a functor with more places than fit into a functor record */
+static void check_long(HilbertModule * module, HilbertHandle functor, const HilbertHandle * expected, size_t count, const char * where) {
+	int errcode;
+	size_t size;
+
+	HilbertHandle * ikinds = hilbert_functor_getinputkinds(module, functor, &size, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain input kinds from long functor in %s module (errcode=%d)\n", where, errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (size != count) {
+		fprintf(stderr, "Wrong number of input kinds from long functor in %s module (expected: %zu, got: %zu)\n", where, count, size);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != count; ++i) {
+		if (ikinds[i] != expected[i]) {
+			fprintf(stderr, "Got back wrong input kind %zu from long functor in %s module\n", i, where);
+			exit(EXIT_FAILURE);
+		}
+	}
+	hilbert_harray_free(ikinds);
+}
+
 int main(void) {
 	int errcode;
 	size_t size;
@@ -75,6 +98,10 @@ int main(void) {
 		exit(EXIT_FAILURE);
 	}
 	hilbert_harray_free(ikinds);
+	HilbertHandle longarray[5] = { vkind, kind, kind, vkind, kind };
+	HilbertHandle f5 = hilbert_functor_create(imodule, kind, 5, longarray, &errcode);
+	assert (errcode == 0);
+	check_long(imodule, f5, longarray, 5, "interface");
 
 	/* in proof modules */
 	HilbertModule * pmodule = hilbert_module_create(HILBERT_PROOF_MODULE);
@@ -91,6 +118,8 @@ int main(void) {
 	assert (errcode == 0);
 	f2 = hilbert_object_getdesthandle(pmodule, param, f2, &errcode);
 	assert (errcode == 0);
+	f5 = hilbert_object_getdesthandle(pmodule, param, f5, &errcode);
+	assert (errcode == 0);
 	ikinds = hilbert_functor_getinputkinds(pmodule, f0, &size, &errcode);
 	if (errcode != 0) {
 		fprintf(stderr, "Unable to obtain input kinds from constant functor in proof module (errcode=%d)\n", errcode);
@@ -114,6 +143,9 @@ int main(void) {
 		fprintf(stderr, "Got back wrong input kinds in proof module (expected: {%u, %u}, got: {%u, %u})\n", (unsigned int) kind, (unsigned int) vkind, (unsigned int) ikinds[0], (unsigned int) ikinds[1]);
 		exit(EXIT_FAILURE);
 	}
+	longarray[0] = longarray[3] = vkind;
+	longarray[1] = longarray[2] = longarray[4] = kind;
+	check_long(pmodule, f5, longarray, 5, "proof");
 
 	hilbert_module_free(imodule);
 	hilbert_module_free(pmodule);
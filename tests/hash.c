@@ -0,0 +1,132 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to measure the quality of the integer hash functions used for handle and pointer keys.
+ */
+
+#include<assert.h>
+#include<stdint.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"cl/hash.h"
+
+#define N_SAMPLES 20000
+#define N_KEYS    (1 << 16)
+#define LOG_SLOTS 16
+
+/* simple xorshift generator for test inputs */
+static uint64_t next(uint64_t * state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/* checks that flipping any input bit flips any output bit with probability close to one half */
+static void check_avalanche(const char * name, size_t (*hash)(uint64_t), unsigned int inbits) {
+	static unsigned long flips[64][64];
+	unsigned int outbits = sizeof(size_t) * 8 < 64 ? sizeof(size_t) * 8 : 64;
+	uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+
+	for (unsigned int i = 0; i != 64; ++i)
+		for (unsigned int j = 0; j != 64; ++j)
+			flips[i][j] = 0;
+	for (unsigned long n = 0; n != N_SAMPLES; ++n) {
+		uint64_t x = next(&state);
+		if (inbits < 64)
+			x &= (UINT64_C(1) << inbits) - 1;
+		size_t h = hash(x);
+		for (unsigned int i = 0; i != inbits; ++i) {
+			size_t d = h ^ hash(x ^ (UINT64_C(1) << i));
+			for (unsigned int j = 0; j != outbits; ++j)
+				flips[i][j] += (d >> j) & 1;
+		}
+	}
+	for (unsigned int i = 0; i != inbits; ++i) {
+		for (unsigned int j = 0; j != outbits; ++j) {
+			double p = (double) flips[i][j] / N_SAMPLES;
+			if ((p < 0.45) || (p > 0.55)) {
+				fprintf(stderr, "%s: input bit %u flips output bit %u with probability %.3f\n", name, i, j, p);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+}
+
+/* checks that a key sequence spreads over a table about as well as random keys would, using low or high index bits */
+static void check_spread(const char * name, size_t (*hash)(uint64_t), uint64_t base, uint64_t stride, unsigned int shift) {
+	static unsigned char used[1 << LOG_SLOTS];
+	size_t mask = ((size_t) 1 << LOG_SLOTS) - 1;
+	unsigned long collisions = 0;
+
+	for (size_t i = 0; i <= mask; ++i)
+		used[i] = 0;
+	for (uint64_t i = 0; i != N_KEYS; ++i) {
+		size_t slot = (hash(base + i * stride) >> shift) & mask;
+		collisions += used[slot];
+		used[slot] = 1;
+	}
+	/* expected number of collisions for uniformly random slots */
+	double m = (double) mask + 1;
+	double empty = 1;
+	for (unsigned long i = 0; i != N_KEYS; ++i)
+		empty *= 1 - 1 / m;
+	double expected = N_KEYS - m * (1 - empty);
+	if (collisions > 1.05 * expected) {
+		fprintf(stderr, "%s: %lu collisions for stride %llu and shift %u, expected about %.0f\n", name, collisions,
+				(unsigned long long) stride, shift, expected);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static size_t hash64(uint64_t x) {
+	return cl_hash64((uint_fast64_t) x);
+}
+
+static size_t hash_index(uint64_t x) {
+	return cl_hash_index((size_t) x);
+}
+
+static size_t hash_pointer(uint64_t x) {
+	return cl_hash_pointer((const void *) (uintptr_t) x);
+}
+
+int main(void) {
+	/* handles are small, densely allocated indices */
+	check_spread("cl_hash_index", hash_index, 0, 1, 0);
+	check_spread("cl_hash_index", hash_index, 0, 1, 7);
+	if (sizeof(size_t) >= sizeof(uint64_t)) {
+		check_avalanche("cl_hash64", hash64, 64);
+		check_avalanche("cl_hash_index", hash_index, 64);
+		/* pointers are aligned and often page or allocation size strided */
+		check_spread("cl_hash64", hash64, UINT64_C(0x7f3a12345000), 16, 0);
+		check_spread("cl_hash64", hash64, UINT64_C(0x7f3a12345000), 16, 7);
+		check_spread("cl_hash64", hash64, UINT64_C(0x7f3a12345000), 4096, 0);
+		check_spread("cl_hash64", hash64, UINT64_C(0x7f3a12345000), 4096, 7);
+	}
+	check_spread("cl_hash_pointer", hash_pointer, 0x10000, 16, 0);
+	check_spread("cl_hash_pointer", hash_pointer, 0x10000, 16, 7);
+
+	exit(EXIT_SUCCESS);
+}
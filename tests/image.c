@@ -0,0 +1,361 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check that module images can be saved, loaded and mapped.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<unistd.h>
+
+#include"hilbert.h"
+
+/**
+ * setting:
+ * lib2: kind0, vkind1, var0 of vkind1, functor0 of kind0 with places kind0, vkind1
+ * lib: param with lib2, kind2 identified with kind0, functor1 of kind2 with place kind2
+ * alias: param with lib2, alias of kind0
+ * Expected: lib2 and lib can be saved and loaded or mapped again, with the same objects, equivalences and functors.
+ * 	alias can be saved and loaded or mapped again, although its alias of an external kind has no source handle.
+ */
+
+/* aborts with a message unless errcode is zero */
+static void check(int errcode, const char * what) {
+	if (errcode != 0) {
+		fprintf(stderr, "%s failed, errcode=%i\n", what, errcode);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* compares the objects of two modules */
+static void compare(HilbertModule * module1, HilbertModule * module2) {
+	int errcode;
+	size_t size1, size2;
+
+	HilbertHandle * objects1 = hilbert_module_getobjects(module1, &size1, &errcode);
+	check(errcode, "Obtaining objects");
+	HilbertHandle * objects2 = hilbert_module_getobjects(module2, &size2, &errcode);
+	check(errcode, "Obtaining objects");
+	if ((size1 != size2) || (memcmp(objects1, objects2, size1 * sizeof(*objects1)) != 0)) {
+		fputs("Loaded module has different objects\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != size1; ++i) {
+		HilbertHandle object = objects1[i];
+		unsigned int type = hilbert_object_gettype(module1, object, &errcode);
+		check(errcode, "Obtaining type");
+		if (hilbert_object_gettype(module2, object, &errcode) != type) {
+			fprintf(stderr, "Object %zu has a different type\n", (size_t) object);
+			exit(EXIT_FAILURE);
+		}
+		check(errcode, "Obtaining type");
+		if (type & HILBERT_TYPE_FUNCTOR) {
+			if (hilbert_functor_getkind(module1, object, &errcode) != hilbert_functor_getkind(module2, object, &errcode)) {
+				fprintf(stderr, "Functor %zu has a different kind\n", (size_t) object);
+				exit(EXIT_FAILURE);
+			}
+			check(errcode, "Obtaining functor kind");
+			size_t places1, places2;
+			HilbertHandle * ikinds1 = hilbert_functor_getinputkinds(module1, object, &places1, &errcode);
+			check(errcode, "Obtaining input kinds");
+			HilbertHandle * ikinds2 = hilbert_functor_getinputkinds(module2, object, &places2, &errcode);
+			check(errcode, "Obtaining input kinds");
+			if ((places1 != places2) || ((places1 != 0) && (memcmp(ikinds1, ikinds2, places1 * sizeof(*ikinds1)) != 0))) {
+				fprintf(stderr, "Functor %zu has different input kinds\n", (size_t) object);
+				exit(EXIT_FAILURE);
+			}
+			hilbert_harray_free(ikinds1);
+			hilbert_harray_free(ikinds2);
+		}
+		if (type & HILBERT_TYPE_KIND) {
+			for (size_t j = 0; j != size1; ++j) {
+				unsigned int type2 = hilbert_object_gettype(module1, objects1[j], &errcode);
+				check(errcode, "Obtaining type");
+				if (!(type2 & HILBERT_TYPE_KIND) || ((type ^ type2) & HILBERT_TYPE_VKIND))
+					continue;
+				int eq1 = hilbert_kind_isequivalent(module1, object, objects1[j], &errcode);
+				check(errcode, "Checking equivalence");
+				int eq2 = hilbert_kind_isequivalent(module2, object, objects1[j], &errcode);
+				check(errcode, "Checking equivalence");
+				if (!eq1 != !eq2) {
+					fputs("Loaded module has different equivalences\n", stderr);
+					exit(EXIT_FAILURE);
+				}
+			}
+		}
+		if (type & HILBERT_TYPE_EXTERNAL) {
+			HilbertHandle source1 = hilbert_object_getsourcehandle(module1, object, &errcode);
+			check(errcode, "Obtaining source handle");
+			HilbertHandle source2 = hilbert_object_getsourcehandle(module2, object, &errcode);
+			check(errcode, "Obtaining source handle");
+			if (source1 != source2) {
+				fprintf(stderr, "Object %zu has a different source\n", (size_t) object);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+	hilbert_harray_free(objects1);
+	hilbert_harray_free(objects2);
+}
+
+/* checks a loaded or mapped alias module */
+static void check_alias(HilbertModule * module, HilbertHandle kind, HilbertHandle alias) {
+	int errcode;
+
+	unsigned int type = hilbert_object_gettype(module, alias, &errcode);
+	check(errcode, "Obtaining type");
+	if (type != (HILBERT_TYPE_KIND | HILBERT_TYPE_EXTERNAL)) {
+		fprintf(stderr, "Alias has type %u\n", type);
+		exit(EXIT_FAILURE);
+	}
+	int eq = hilbert_kind_isequivalent(module, kind, alias, &errcode);
+	check(errcode, "Checking equivalence");
+	if (!eq) {
+		fputs("Alias is not equivalent to its kind\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* saves a module to a file */
+static void save(HilbertModule * module, const char * path) {
+	FILE * stream = fopen(path, "wb");
+	if (stream == NULL) {
+		fprintf(stderr, "Unable to open %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+	check(hilbert_module_save(module, stream), "Saving module");
+	if (fclose(stream) != 0) {
+		fprintf(stderr, "Unable to close %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	HilbertModule * lib2, * lib, * alias, * mutable, * newlib2, * newlib, * maplib2, * maplib;
+	int errcode;
+
+	lib2 = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	lib = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	alias = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	mutable = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if ((lib2 == NULL) || (lib == NULL) || (alias == NULL) || (mutable == NULL)) {
+		fputs("Unable to create modules\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* setup lib2 */
+	HilbertHandle kind0 = hilbert_kind_create(lib2, &errcode);
+	check(errcode, "Creating kind");
+	HilbertHandle vkind1 = hilbert_vkind_create(lib2, &errcode);
+	check(errcode, "Creating vkind");
+	hilbert_var_create(lib2, vkind1, &errcode);
+	check(errcode, "Creating variable");
+	HilbertHandle places[2] = { kind0, vkind1 };
+	HilbertHandle functor0 = hilbert_functor_create(lib2, kind0, 2, places, &errcode);
+	check(errcode, "Creating functor");
+	check(hilbert_module_makeimmutable(lib2), "Making lib2 immutable");
+
+	/* setup lib */
+	HilbertHandle param = hilbert_module_param(lib, lib2, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, "Parameterising lib");
+	HilbertHandle lkind0 = hilbert_object_getdesthandle(lib, param, kind0, &errcode);
+	check(errcode, "Obtaining destination handle");
+	hilbert_object_getdesthandle(lib, param, functor0, &errcode);
+	check(errcode, "Obtaining destination handle");
+	HilbertHandle kind2 = hilbert_kind_create(lib, &errcode);
+	check(errcode, "Creating kind");
+	check(hilbert_kind_identify(lib, kind2, lkind0), "Identifying kinds");
+	hilbert_functor_create(lib, kind2, 1, &kind2, &errcode);
+	check(errcode, "Creating functor");
+
+	/* setup alias */
+	param = hilbert_module_param(alias, lib2, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, "Parameterising alias");
+	HilbertHandle akind0 = hilbert_object_getdesthandle(alias, param, kind0, &errcode);
+	check(errcode, "Obtaining destination handle");
+	HilbertHandle akind0alias = hilbert_kind_alias(alias, akind0, &errcode);
+	check(errcode, "Aliasing kind");
+	check(hilbert_module_makeimmutable(alias), "Making alias immutable");
+
+	/* only immutable interface modules can be saved */
+	FILE * stream = tmpfile();
+	if (stream == NULL) {
+		fputs("Unable to create temporary file\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_module_save(lib, stream);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	check(hilbert_module_makeimmutable(lib), "Making lib immutable");
+
+	/* save and load */
+	check(hilbert_module_save(lib2, stream), "Saving lib2");
+	long lib2end = ftell(stream);
+	check(hilbert_module_save(lib, stream), "Saving lib");
+	long libend = ftell(stream);
+	rewind(stream);
+	newlib2 = hilbert_module_load(stream, 0, NULL, &errcode);
+	check(errcode, "Loading lib2");
+	if (!hilbert_module_isimmutable(newlib2, &errcode)) {
+		fputs("Loaded module is not immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	compare(lib2, newlib2);
+	newlib = hilbert_module_load(stream, 1, &newlib2, &errcode);
+	check(errcode, "Loading lib");
+	compare(lib, newlib);
+	if (hilbert_object_getsource(newlib, lkind0, &errcode) != newlib2) {
+		fputs("Loaded parameter has the wrong source\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* aliases of external kinds have no map entry */
+	FILE * aliasstream = tmpfile();
+	if (aliasstream == NULL) {
+		fputs("Unable to create temporary file\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	check(hilbert_module_save(alias, aliasstream), "Saving alias");
+	rewind(aliasstream);
+	HilbertModule * newalias = hilbert_module_load(aliasstream, 1, &newlib2, &errcode);
+	check(errcode, "Loading alias");
+	check_alias(newalias, akind0, akind0alias);
+	hilbert_module_free(newalias);
+	fclose(aliasstream);
+
+	/* loaded modules can be used as parameters */
+	hilbert_module_param(mutable, newlib2, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, "Parameterising with loaded module");
+
+	/* map */
+	save(lib2, "image_lib2.img");
+	save(lib, "image_lib.img");
+	maplib2 = hilbert_module_map("image_lib2.img", 0, NULL, &errcode);
+	check(errcode, "Mapping lib2");
+	compare(lib2, maplib2);
+	maplib = hilbert_module_map("image_lib.img", 1, &maplib2, &errcode);
+	check(errcode, "Mapping lib");
+	compare(lib, maplib);
+	if (hilbert_object_getsource(maplib, lkind0, &errcode) != maplib2) {
+		fputs("Mapped parameter has the wrong source\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_module_param(mutable, maplib2, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, "Parameterising with mapped module");
+	save(alias, "image_alias.img");
+	HilbertModule * mapalias = hilbert_module_map("image_alias.img", 1, &maplib2, &errcode);
+	check(errcode, "Mapping alias");
+	check_alias(mapalias, akind0, akind0alias);
+	hilbert_module_free(mapalias);
+	remove("image_alias.img");
+	hilbert_module_free(maplib2);
+	hilbert_module_free(maplib);
+	if ((hilbert_module_map("image_lib.img", 0, NULL, &errcode) != NULL) || (errcode != HILBERT_ERR_COUNT_MISMATCH)) {
+		fprintf(stderr, "Expected count mismatch error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (truncate("image_lib2.img", 64) != 0) {
+		fputs("Unable to truncate image\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if ((hilbert_module_map("image_lib2.img", 0, NULL, &errcode) != NULL) || (errcode != HILBERT_ERR_INVALID_IMAGE)) {
+		fprintf(stderr, "Expected invalid image error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	remove("image_lib2.img");
+	remove("image_lib.img");
+	if ((hilbert_module_map("image_lib.img", 0, NULL, &errcode) != NULL) || (errcode != HILBERT_ERR_IO)) {
+		fprintf(stderr, "Expected I/O error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* wrong dependencies */
+	fseek(stream, lib2end, SEEK_SET);
+	if ((hilbert_module_load(stream, 0, NULL, &errcode) != NULL) || (errcode != HILBERT_ERR_COUNT_MISMATCH)) {
+		fprintf(stderr, "Expected count mismatch error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	fseek(stream, lib2end, SEEK_SET);
+	if ((hilbert_module_load(stream, 1, &mutable, &errcode) != NULL) || (errcode != HILBERT_ERR_IMMUTABLE)) {
+		fprintf(stderr, "Expected immutable error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	fseek(stream, lib2end, SEEK_SET);
+	if ((hilbert_module_load(stream, 1, &newlib, &errcode) != NULL) || (errcode != HILBERT_ERR_INVALID_MODULE)) {
+		fprintf(stderr, "Expected invalid module error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* truncated image */
+	char * image = malloc(libend);
+	if (image == NULL) {
+		fputs("Unable to allocate memory\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	rewind(stream);
+	if (fread(image, 1, libend, stream) != (size_t) libend) {
+		fputs("Unable to read image\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	fclose(stream);
+	for (long length = lib2end; length < libend; length += 8) {
+		stream = tmpfile();
+		if ((stream == NULL) || (fwrite(image + lib2end, 1, length - lib2end, stream) != (size_t) (length - lib2end))) {
+			fputs("Unable to write temporary file\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		rewind(stream);
+		if ((hilbert_module_load(stream, 1, &newlib2, &errcode) != NULL) || (errcode != HILBERT_ERR_INVALID_IMAGE)) {
+			fprintf(stderr, "Expected invalid image error at length %ld, got errcode=%i\n", length - lib2end, errcode);
+			exit(EXIT_FAILURE);
+		}
+		fclose(stream);
+	}
+
+	/* bad magic */
+	image[0] ^= 1;
+	stream = tmpfile();
+	if ((stream == NULL) || (fwrite(image, 1, lib2end, stream) != (size_t) lib2end)) {
+		fputs("Unable to write temporary file\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	rewind(stream);
+	if ((hilbert_module_load(stream, 0, NULL, &errcode) != NULL) || (errcode != HILBERT_ERR_INVALID_IMAGE)) {
+		fprintf(stderr, "Expected invalid image error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	fclose(stream);
+	free(image);
+
+	hilbert_module_free(mutable);
+	hilbert_module_free(newlib);
+	hilbert_module_free(newlib2);
+	hilbert_module_free(alias);
+	hilbert_module_free(lib);
+	hilbert_module_free(lib2);
+
+	exit(EXIT_SUCCESS);
+}
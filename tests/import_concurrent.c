@@ -0,0 +1,158 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check concurrent imports of a shared library module and concurrent freeing of the importing modules.
+ */
+
+#include<pthread.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/**
+ * setting:
+ * lib: N_KINDS kinds, N_FUNCTORS functors, immutable
+ * N_THREADS threads, each: N_MODULES modules alternately importing (proof) or parameterising (interface) lib
+ * main: free lib, then N_THREADS threads freeing their modules concurrently
+ * Expected: every module holds a copy of each lib object, and lib is freed together with the last module.
+ */
+#define N_KINDS     16
+#define N_FUNCTORS  16
+#define N_THREADS   8
+#define N_MODULES   32
+static HilbertModule * lib;
+static HilbertHandle functors[N_FUNCTORS];
+static HilbertModule * modules[N_THREADS][N_MODULES];
+
+/* imports lib into N_MODULES new modules */
+static void * importer(void * arg) {
+	HilbertModule ** mods = arg;
+	int errcode;
+
+	for (size_t i = 0; i != N_MODULES; ++i) {
+		HilbertHandle param;
+		if (i % 2 == 0) {
+			mods[i] = hilbert_module_create(HILBERT_PROOF_MODULE);
+			if (mods[i] == NULL)
+				goto moderror;
+			param = hilbert_module_import(mods[i], lib, 0, NULL, NULL, NULL, &errcode);
+		} else {
+			mods[i] = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+			if (mods[i] == NULL)
+				goto moderror;
+			param = hilbert_module_param(mods[i], lib, 0, NULL, NULL, NULL, &errcode);
+		}
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to import lib, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+		size_t count;
+		HilbertHandle * objects = hilbert_module_getobjects(mods[i], &count, &errcode);
+		if (objects == NULL) {
+			fprintf(stderr, "Unable to obtain objects, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+		hilbert_harray_free(objects);
+		if (count != N_KINDS + N_FUNCTORS + 1) {
+			fprintf(stderr, "Module has %zu objects, expected %i\n", count, N_KINDS + N_FUNCTORS + 1);
+			exit(EXIT_FAILURE);
+		}
+		for (size_t j = 0; j != N_FUNCTORS; ++j) {
+			HilbertHandle functor = hilbert_object_getdesthandle(mods[i], param, functors[j], &errcode);
+			if (errcode != 0) {
+				fprintf(stderr, "Unable to obtain destination handle, errcode=%i\n", errcode);
+				exit(EXIT_FAILURE);
+			}
+			if (hilbert_object_getsourcehandle(mods[i], functor, &errcode) != functors[j]) {
+				fputs("Source handle mismatch\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	return NULL;
+
+moderror:
+	fputs("Unable to create module\n", stderr);
+	exit(EXIT_FAILURE);
+}
+
+/* frees N_MODULES modules */
+static void * freer(void * arg) {
+	HilbertModule ** mods = arg;
+
+	for (size_t i = 0; i != N_MODULES; ++i)
+		hilbert_module_free(mods[i]);
+
+	return NULL;
+}
+
+/* runs function in N_THREADS threads, passing each its own module array */
+static void run(void * (*function)(void *)) {
+	pthread_t threads[N_THREADS];
+
+	for (size_t i = 0; i != N_THREADS; ++i) {
+		if (pthread_create(&threads[i], NULL, function, modules[i]) != 0) {
+			fputs("Unable to create thread\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (size_t i = 0; i != N_THREADS; ++i)
+		pthread_join(threads[i], NULL);
+}
+
+int main(void) {
+	HilbertHandle kinds[N_KINDS];
+	int errcode;
+
+	lib = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (lib == NULL) {
+		fputs("Unable to create lib\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != N_KINDS; ++i) {
+		kinds[i] = hilbert_kind_create(lib, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (size_t i = 0; i != N_FUNCTORS; ++i) {
+		functors[i] = hilbert_functor_create(lib, kinds[i], 1, kinds + (i + 1) % N_KINDS, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create functor, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (hilbert_module_makeimmutable(lib) != 0) {
+		fputs("Unable to make lib immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	run(importer);
+	hilbert_module_free(lib);
+	run(freer);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,183 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check that a failed import leaves kind equivalences in the destination module untouched.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/**
+ * setting:
+ * src2: kind0, kind1, functor0 of kind0
+ * src: param with src2, id kind0 and kind1
+ * dest: import src2, import src (fails in functor mapping, after kinds have been coarsened),
+ * 	import src (succeeds)
+ * Expected: kind0 and kind1 in dest are inequivalent after the failed import and equivalent after the successful one.
+ */
+static HilbertHandle s2kind0, s2kind1, s2f0;
+static HilbertHandle skind0, skind1, sf0;
+static HilbertHandle dkind0, dkind1, df0;
+
+/* mapper callback; maps functors to an invalid handle if *userdata is nonzero */
+static HilbertHandle callback(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject, void * userdata, int * restrict errcode) {
+	*errcode = 0;
+	if (srcObject == skind0)
+		return dkind0;
+	if (srcObject == skind1)
+		return dkind1;
+	if (srcObject == sf0)
+		return *(int *) userdata ? 666 : df0;
+	fprintf(stderr, "Got invalid source object %u\n", (unsigned int) srcObject);
+	exit(EXIT_FAILURE);
+}
+
+/* checks equivalence of dkind0 and dkind1 */
+static void check_equivalence(HilbertModule * dest, int expected) {
+	int errcode;
+	int rc = hilbert_kind_isequivalent(dest, dkind0, dkind1, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to check kind equivalence, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (!rc != !expected) {
+		fprintf(stderr, "Kinds are%s equivalent, expected otherwise\n", rc ? "" : " not");
+		exit(EXIT_FAILURE);
+	}
+	size_t count;
+	HilbertHandle * eqc = hilbert_kind_equivalenceclass(dest, dkind0, &count, &errcode);
+	if (eqc == NULL) {
+		fprintf(stderr, "Unable to obtain equivalence class, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_harray_free(eqc);
+	if (count != (expected ? 2 : 1)) {
+		fprintf(stderr, "Equivalence class has size %zu, expected %i\n", count, expected ? 2 : 1);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	HilbertModule * src2, * src, * dest;
+	int errcode;
+	int invalid;
+
+	src2 = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	src = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	dest = hilbert_module_create(HILBERT_PROOF_MODULE);
+	if ((src2 == NULL) || (src == NULL) || (dest == NULL)) {
+		fputs("Unable to create modules\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* setup src2 */
+	s2kind0 = hilbert_kind_create(src2, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	s2kind1 = hilbert_kind_create(src2, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	s2f0 = hilbert_functor_create(src2, s2kind0, 0, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create functor, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (hilbert_module_makeimmutable(src2) != 0)
+		goto immutableerror;
+
+	/* setup src */
+	HilbertHandle sparam = hilbert_module_param(src, src2, 0, NULL, NULL, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to parameterise src, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	skind0 = hilbert_object_getdesthandle(src, sparam, s2kind0, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	skind1 = hilbert_object_getdesthandle(src, sparam, s2kind1, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	sf0 = hilbert_object_getdesthandle(src, sparam, s2f0, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	errcode = hilbert_kind_identify(src, skind0, skind1);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to identify kinds, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (hilbert_module_makeimmutable(src) != 0)
+		goto immutableerror;
+
+	/* setup dest */
+	HilbertHandle dparam = hilbert_module_import(dest, src2, 0, NULL, NULL, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to import src2, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	dkind0 = hilbert_object_getdesthandle(dest, dparam, s2kind0, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	dkind1 = hilbert_object_getdesthandle(dest, dparam, s2kind1, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	df0 = hilbert_object_getdesthandle(dest, dparam, s2f0, &errcode);
+	if (errcode != 0)
+		goto desterror;
+	check_equivalence(dest, 0);
+
+	/* failed import */
+	invalid = 1;
+	hilbert_module_import(dest, src, 1, &dparam, callback, &invalid, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_MAPPING) {
+		fprintf(stderr, "Expected invalid mapping error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	check_equivalence(dest, 0);
+
+	/* successful import */
+	invalid = 0;
+	hilbert_module_import(dest, src, 1, &dparam, callback, &invalid, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to import src, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	check_equivalence(dest, 1);
+
+	hilbert_module_free(dest);
+	hilbert_module_free(src);
+	hilbert_module_free(src2);
+
+	exit(EXIT_SUCCESS);
+
+kinderror:
+	fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+immutableerror:
+	fputs("Unable to make module immutable\n", stderr);
+	exit(EXIT_FAILURE);
+desterror:
+	fprintf(stderr, "Unable to obtain destination handle, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+}
@@ -0,0 +1,110 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check concurrent kind equivalence queries on a mutable module.
+ */
+
+#include<pthread.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/**
+ * setting:
+ * module: N_KINDS kinds, mutable, identified into classes of CLASS_SIZE consecutive kinds
+ * 	by merging classes of doubling size, so that the class trees are several levels deep
+ * N_THREADS threads, each: N_QUERIES equivalence queries on pseudo random kind pairs
+ * Expected: every query agrees with the classes, and no query writes to the module
+ * 	(which ThreadSanitizer would report as a data race).
+ */
+#define N_KINDS    4096
+#define CLASS_SIZE 64
+#define N_THREADS  4
+#define N_QUERIES  100000
+static HilbertModule * module;
+static HilbertHandle kinds[N_KINDS];
+
+/* performs N_QUERIES equivalence queries */
+static void * reader(void * arg) {
+	unsigned int seed = (unsigned int) (size_t) arg;
+	int errcode;
+
+	for (size_t i = 0; i != N_QUERIES; ++i) {
+		seed = seed * 1103515245u + 12345u;
+		size_t k1 = (seed >> 4) % N_KINDS;
+		seed = seed * 1103515245u + 12345u;
+		size_t k2 = i % 2 == 0 ? (seed >> 4) % N_KINDS : k1 / CLASS_SIZE * CLASS_SIZE + (seed >> 4) % CLASS_SIZE;
+		int rc = hilbert_kind_isequivalent(module, kinds[k1], kinds[k2], &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to check kind equivalence, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+		if (!rc != (k1 / CLASS_SIZE != k2 / CLASS_SIZE)) {
+			fprintf(stderr, "Kinds %zu and %zu are%s equivalent, expected otherwise\n", k1, k2, rc ? "" : " not");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	return NULL;
+}
+
+int main(void) {
+	pthread_t threads[N_THREADS];
+	int errcode;
+
+	module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (module == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != N_KINDS; ++i) {
+		kinds[i] = hilbert_kind_create(module, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (size_t stride = 1; stride != CLASS_SIZE; stride *= 2) {
+		for (size_t i = 0; i != N_KINDS; i += 2 * stride) {
+			errcode = hilbert_kind_identify(module, kinds[i + stride], kinds[i]);
+			if (errcode != 0) {
+				fprintf(stderr, "Unable to identify kinds, errcode=%i\n", errcode);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	for (size_t i = 0; i != N_THREADS; ++i) {
+		if (pthread_create(&threads[i], NULL, reader, (void *) (i + 1)) != 0) {
+			fputs("Unable to create thread\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (size_t i = 0; i != N_THREADS; ++i)
+		pthread_join(threads[i], NULL);
+
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+}
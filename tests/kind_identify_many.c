@@ -0,0 +1,123 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check kind identification with many kinds.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+#define NUM_KINDS 1000
+
+#define NUM_CLASSES 7
+
+/**
+ * Checks that the equivalence class of a kind consists of precisely the kinds with the same residue.
+ * If the result is not as expected, the program is terminated indicating failure.
+ *
+ * @param module Pointer to a Hilbert module.
+ * @param kinds Pointer to an array of <code>NUM_KINDS</code> kind handles.
+ * @param i Index into <code>kinds</code>.
+ */
+static void check_eqc(HilbertModule * restrict module, const HilbertHandle * restrict kinds, size_t i) {
+	int errcode;
+	size_t count;
+	HilbertHandle * eqc = hilbert_kind_equivalenceclass(module, kinds[i], &count, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain equivalence class of kind %zu (error code=%d)\n", i, errcode);
+		exit(EXIT_FAILURE);
+	}
+	size_t expected = (NUM_KINDS - 1 - i % NUM_CLASSES) / NUM_CLASSES + 1;
+	if (count != expected) {
+		fprintf(stderr, "Expected equivalence class of kind %zu to have size %zu, got %zu\n", i, expected, count);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t j = 0; j != count; ++j) {
+		if ((eqc[j] >= NUM_KINDS) || (eqc[j] % NUM_CLASSES != i % NUM_CLASSES)) {
+			fprintf(stderr, "Unexpected kind %zu in equivalence class of kind %zu\n", (size_t) eqc[j], i);
+			exit(EXIT_FAILURE);
+		}
+	}
+	hilbert_harray_free(eqc);
+}
+
+int main(void) {
+	HilbertModule * module;
+	HilbertHandle kinds[NUM_KINDS];
+	int errcode;
+	int rc;
+
+	module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (module == NULL) {
+		fputs("Unable to create Hilbert interface module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* kind i is created as an alias of kind i - NUM_CLASSES every other time */
+	for (size_t i = 0; i != NUM_KINDS; ++i) {
+		if ((i >= NUM_CLASSES) && (i % 2 == 0)) {
+			kinds[i] = hilbert_kind_alias(module, kinds[i - NUM_CLASSES], &errcode);
+		} else {
+			kinds[i] = hilbert_kind_create(module, &errcode);
+		}
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create kind %zu (error code=%d)\n", i, errcode);
+			exit(EXIT_FAILURE);
+		}
+		if (kinds[i] != i) {
+			fprintf(stderr, "Expected kind %zu to have handle %zu, got %zu\n", i, i, (size_t) kinds[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* identify remaining kinds in reverse order, so that classes of different sizes are merged */
+	for (size_t i = NUM_KINDS - 1; i >= NUM_CLASSES; --i) {
+		errcode = hilbert_kind_identify(module, kinds[i], kinds[i % NUM_CLASSES]);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to identify kinds %zu and %zu (error code=%d)\n", i, i % NUM_CLASSES,
+					errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (size_t i = 0; i < NUM_KINDS; i += 13) {
+		for (size_t j = 0; j < NUM_KINDS; j += 11) {
+			rc = hilbert_kind_isequivalent(module, kinds[i], kinds[j], &errcode);
+			if (errcode != 0) {
+				fprintf(stderr, "Unable to check kinds %zu and %zu for equivalence (error code=%d)\n",
+						i, j, errcode);
+				exit(EXIT_FAILURE);
+			}
+			if ((!rc) != (i % NUM_CLASSES != j % NUM_CLASSES)) {
+				fprintf(stderr, "Unexpected equivalence result %d for kinds %zu and %zu\n", rc, i, j);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+	for (size_t i = 0; i < NUM_KINDS; i += 17)
+		check_eqc(module, kinds, i);
+
+	hilbert_module_free(module);
+}
@@ -0,0 +1,195 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check that mapper callbacks may query the destination module.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/**
+ * setting:
+ * lib: kinds k0, k1
+ * src: param with lib
+ * dest: param, import or export of src, with the externals of src mapped through a parameter of dest with lib.
+ * Expected: the mapper can read dest, but cannot modify it.
+ */
+#define N_KINDS 2
+
+/**
+ * Mapper state.
+ */
+struct Mapping {
+	/**
+	 * Parameter of dest with lib.
+	 */
+	HilbertHandle destparam;
+
+	/**
+	 * Number of mapper calls.
+	 */
+	size_t calls;
+};
+
+/* ancillary data of dest */
+static int ANCILLARY = 54321;
+
+/* maps an object of src to dest through lib, querying dest */
+static HilbertHandle callback(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject,
+		void * userdata, int * restrict errcode) {
+	struct Mapping * mapping = userdata;
+	int rc;
+
+	HilbertHandle libObject = hilbert_object_getsourcehandle(src, srcObject, errcode);
+	if (*errcode != 0) {
+		fprintf(stderr, "Unable to get source handle in src (errcode=%d)\n", *errcode);
+		exit(EXIT_FAILURE);
+	}
+	HilbertHandle result = hilbert_object_getdesthandle(dest, mapping->destparam, libObject, errcode);
+	if (*errcode != 0) {
+		fprintf(stderr, "Unable to get destination handle in dest (errcode=%d)\n", *errcode);
+		exit(EXIT_FAILURE);
+	}
+	unsigned int type = hilbert_object_gettype(dest, result, errcode);
+	if (*errcode != 0) {
+		fprintf(stderr, "Unable to get object type in dest (errcode=%d)\n", *errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (type & HILBERT_TYPE_KIND) {
+		rc = hilbert_kind_isequivalent(dest, result, result, errcode);
+		if ((*errcode != 0) || (rc != 1)) {
+			fprintf(stderr, "Unable to check kind equivalence in dest (errcode=%d, rc=%d)\n", *errcode, rc);
+			exit(EXIT_FAILURE);
+		}
+	}
+	void * data;
+	*errcode = hilbert_module_getancillary(dest, &data);
+	if ((*errcode != 0) || (data != &ANCILLARY)) {
+		fprintf(stderr, "Unable to get ancillary data of dest (errcode=%d)\n", *errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* dest is locked by the caller, so it cannot be modified */
+	*errcode = hilbert_module_setancillary(dest, NULL, NULL);
+	if (*errcode != HILBERT_ERR_INTERNAL) {
+		fprintf(stderr, "Expected internal error from setting ancillary data of dest, got %d\n", *errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	++mapping->calls;
+	*errcode = 0;
+	return result;
+}
+
+/* creates a module with ancillary data */
+static HilbertModule * create(enum HilbertModuleType type) {
+	HilbertModule * module = hilbert_module_create(type);
+	if (module == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	int errcode = hilbert_module_setancillary(module, &ANCILLARY, NULL);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to set ancillary data (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	return module;
+}
+
+/* checks the outcome of a parameterisation, import or export */
+static void check(int errcode, const struct Mapping * mapping, const char * what) {
+	if (errcode != 0) {
+		fprintf(stderr, "%s with querying mapper failed (errcode=%d)\n", what, errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (mapping->calls != N_KINDS) {
+		fprintf(stderr, "%s called the mapper %zu times, expected %d\n", what, mapping->calls, N_KINDS);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	HilbertModule * lib, * src, * dest;
+	struct Mapping mapping;
+	int errcode;
+
+	lib = create(HILBERT_INTERFACE_MODULE);
+	for (size_t i = 0; i != N_KINDS; ++i) {
+		hilbert_kind_create(lib, &errcode);
+		if (errcode != 0) {
+			fprintf(stderr, "Unable to create kind in lib (errcode=%d)\n", errcode);
+			exit(EXIT_FAILURE);
+		}
+	}
+	errcode = hilbert_module_makeimmutable(lib);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to make lib immutable (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	src = create(HILBERT_INTERFACE_MODULE);
+	hilbert_module_param(src, lib, 0, NULL, NULL, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to parameterise src with lib (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	errcode = hilbert_module_makeimmutable(src);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to make src immutable (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* parameterisation */
+	dest = create(HILBERT_INTERFACE_MODULE);
+	mapping = (struct Mapping) { .destparam = hilbert_module_param(dest, lib, 0, NULL, NULL, NULL, &errcode) };
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to parameterise dest with lib (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_module_param(dest, src, 1, &mapping.destparam, callback, &mapping, &errcode);
+	check(errcode, &mapping, "Parameterisation");
+	hilbert_module_free(dest);
+
+	/* import */
+	dest = create(HILBERT_PROOF_MODULE);
+	mapping = (struct Mapping) { .destparam = hilbert_module_import(dest, lib, 0, NULL, NULL, NULL, &errcode) };
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to import lib into dest (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_module_import(dest, src, 1, &mapping.destparam, callback, &mapping, &errcode);
+	check(errcode, &mapping, "Import");
+
+	/* export, in the same proof module */
+	mapping.calls = 0;
+	hilbert_module_export(dest, src, 1, &mapping.destparam, callback, &mapping, &errcode);
+	check(errcode, &mapping, "Export");
+	hilbert_module_free(dest);
+
+	hilbert_module_free(src);
+	hilbert_module_free(lib);
+
+	exit(EXIT_SUCCESS);
+}
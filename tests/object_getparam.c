@@ -32,7 +32,7 @@
 int main(void) {
 	HilbertModule * src;
 	HilbertModule * dest;
-	HilbertHandle skind, dkind, param, handle;
+	HilbertHandle skind, dkind, sfunctor, dfunctor, param, handle;
 	int errcode;
 
 	src = hilbert_module_create(HILBERT_INTERFACE_MODULE);
@@ -46,6 +46,11 @@ int main(void) {
 		fprintf(stderr, "Unable to create kind in source module (errcode=%d)\n", errcode);
 		exit(EXIT_FAILURE);
 	}
+	sfunctor = hilbert_functor_create(src, skind, 0, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create functor in source module (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
 	errcode = hilbert_module_makeimmutable(src);
 	if (errcode != 0) {
 		fprintf(stderr, "Unable to make source module immutable (errcode=%d)\n", errcode);
@@ -61,6 +66,11 @@ int main(void) {
 		fprintf(stderr, "Unable to obtain kind in destination module (errcode=%d)\n", errcode);
 		exit(EXIT_FAILURE);
 	}
+	dfunctor = hilbert_object_getdesthandle(dest, param, sfunctor, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain functor in destination module (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
 	handle = hilbert_object_getparam(dest, 666, &errcode);
 	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
 		fprintf(stderr, "Expected invalid handle error, got errcode=%d instead\n", errcode);
@@ -80,6 +90,15 @@ int main(void) {
 		fprintf(stderr, "Got wrong parameter handle (expected=%u, got=%u)\n", (unsigned int) param, (unsigned int) handle);
 		exit(EXIT_FAILURE);
 	}
+	handle = hilbert_object_getparam(dest, dfunctor, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain functor parameter handle (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (handle != param) {
+		fprintf(stderr, "Got wrong functor parameter handle (expected=%u, got=%u)\n", (unsigned int) param, (unsigned int) handle);
+		exit(EXIT_FAILURE);
+	}
 	hilbert_module_free(src);
 	hilbert_module_free(dest);
 }
@@ -0,0 +1,249 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check parameter maps against a reference map,
+ * covering entries in the runs, in the hash bimap, and overwrites and removals across both.
+ */
+
+#include<stdint.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"cl/pmap.h"
+
+#define N_KEYS  4096
+#define N_OPS   50000
+#define NONE    ((HilbertHandle) SIZE_MAX)
+
+/* reference map over the keys base + 0, ..., base + N_KEYS - 1 */
+static HilbertHandle refpost[N_KEYS];
+static HilbertHandle refpre[N_KEYS];
+static size_t refcount;
+static HilbertHandle prebase, postbase;
+
+/* simple xorshift generator for test inputs */
+static uint64_t next(uint64_t * state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/* clears the reference map */
+static void ref_clear(HilbertHandle newprebase, HilbertHandle newpostbase) {
+	for (size_t i = 0; i != N_KEYS; ++i)
+		refpost[i] = refpre[i] = NONE;
+	refcount = 0;
+	prebase = newprebase;
+	postbase = newpostbase;
+}
+
+/* removes the reference entry with preimage index pre */
+static void ref_remove(size_t pre) {
+	if (refpost[pre] == NONE)
+		return;
+	refpre[refpost[pre]] = NONE;
+	refpost[pre] = NONE;
+	--refcount;
+}
+
+/* adds an entry to the reference map, overwriting entries with the same preimage or postimage */
+static void ref_add(size_t pre, size_t post) {
+	ref_remove(pre);
+	if (refpre[post] != NONE)
+		ref_remove(refpre[post]);
+	refpost[pre] = post;
+	refpre[post] = pre;
+	++refcount;
+}
+
+/* checks a parameter map against the reference map */
+static void check(ParamMap * map, const char * pattern, size_t op) {
+	if (hilbert_pmap_count(map) != refcount) {
+		fprintf(stderr, "%s, op %zu: map has %zu entries, expected %zu\n", pattern, op, hilbert_pmap_count(map),
+				refcount);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != N_KEYS; ++i) {
+		const HilbertHandle * post = hilbert_pmap_post(map, prebase + i);
+		if ((post == NULL) != (refpost[i] == NONE) || ((post != NULL) && (*post != postbase + refpost[i]))) {
+			fprintf(stderr, "%s, op %zu: wrong postimage of %zu\n", pattern, op, i);
+			exit(EXIT_FAILURE);
+		}
+		const HilbertHandle * pre = hilbert_pmap_pre(map, postbase + i);
+		if ((pre == NULL) != (refpre[i] == NONE) || ((pre != NULL) && (*pre != prebase + refpre[i]))) {
+			fprintf(stderr, "%s, op %zu: wrong preimage of %zu\n", pattern, op, i);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* every entry must be visited exactly once */
+	static unsigned char seen[N_KEYS];
+	size_t count = 0;
+	for (size_t i = 0; i != N_KEYS; ++i)
+		seen[i] = 0;
+	for (ParamMapIterator i = hilbert_pmap_iterator_new(map); hilbert_pmap_iterator_hasnext(&i);) {
+		struct ParamMapEntry entry = hilbert_pmap_iterator_next(&i);
+		if ((entry.pre < prebase) || (entry.pre - prebase >= N_KEYS) || seen[entry.pre - prebase]
+				|| (refpost[entry.pre - prebase] == NONE)
+				|| (entry.post != postbase + refpost[entry.pre - prebase])) {
+			fprintf(stderr, "%s, op %zu: wrong entry (%zu, %zu) in iteration\n", pattern, op, entry.pre, entry.post);
+			exit(EXIT_FAILURE);
+		}
+		seen[entry.pre - prebase] = 1;
+		++count;
+	}
+	if (count != refcount) {
+		fprintf(stderr, "%s, op %zu: iteration visited %zu entries, expected %zu\n", pattern, op, count, refcount);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* adds an entry to both maps */
+static void add(ParamMap * map, size_t pre, size_t post) {
+	if (hilbert_pmap_add(map, prebase + pre, postbase + post) != 0) {
+		fputs("Unable to add entry\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	ref_add(pre, post);
+}
+
+/* removes an entry from both maps */
+static void remove_entry(ParamMap * map, size_t pre) {
+	int expected = refpost[pre] != NONE;
+	if (!hilbert_pmap_remove(map, prebase + pre) != !expected) {
+		fprintf(stderr, "Removal of %zu returned the wrong result\n", pre);
+		exit(EXIT_FAILURE);
+	}
+	ref_remove(pre);
+}
+
+/* creates a parameter map */
+static ParamMap * create(HilbertHandle newprebase, HilbertHandle newpostbase) {
+	ParamMap * map = hilbert_pmap_new();
+	if (map == NULL) {
+		fputs("Unable to create parameter map\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	ref_clear(newprebase, newpostbase);
+
+	return map;
+}
+
+/**
+ * Contiguous pattern, as in an import without externals:
+ * preimages and postimages both count up, so everything stays in the runs.
+ */
+static void contiguous(void) {
+	ParamMap * map = create(1000, 0);
+
+	for (size_t i = 0; i != N_KEYS; ++i) {
+		add(map, i, i);
+		if (i % 257 == 0)
+			check(map, "contiguous", i);
+	}
+	check(map, "contiguous", N_KEYS);
+	if (map->sparse != NULL) {
+		fputs("contiguous: entries spilled into the hash bimap\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < N_KEYS; i += 3)
+		remove_entry(map, i);
+	check(map, "contiguous removal", N_KEYS);
+
+	hilbert_pmap_del(map);
+}
+
+/**
+ * Shifted pattern, as in an import with mapped externals:
+ * a contiguous block whose postimages are shifted, interleaved with far away entries which spill into the hash bimap,
+ * and overwrites of run entries by hash entries and vice-versa.
+ */
+static void shifted(void) {
+	ParamMap * map = create(5, 77);
+
+	for (size_t i = 0; i != N_KEYS / 2; ++i) {
+		add(map, i, i + 100);
+		if (i % 7 == 0)
+			add(map, N_KEYS - 1 - i / 7, i / 7);
+		if (i % 61 == 0)
+			check(map, "shifted", i);
+	}
+	check(map, "shifted", N_KEYS / 2);
+	if (map->sparse == NULL) {
+		fputs("shifted: no entries spilled into the hash bimap\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* overwrite run entries with far away postimages, and hash entries with run postimages */
+	for (size_t i = 0; i < N_KEYS / 2; i += 5)
+		add(map, i, N_KEYS - 1 - i);
+	check(map, "shifted overwrite", 1);
+	for (size_t i = 0; i < N_KEYS / 14; i += 3)
+		add(map, N_KEYS - 1 - i, i + 100);
+	check(map, "shifted overwrite", 2);
+	for (size_t i = 0; i < N_KEYS; i += 2)
+		remove_entry(map, i);
+	check(map, "shifted removal", 3);
+	for (size_t i = 0; i < N_KEYS / 2; ++i)
+		add(map, i, i + 100);
+	check(map, "shifted refill", 4);
+
+	hilbert_pmap_del(map);
+}
+
+/**
+ * Random pattern: random additions, overwrites and removals.
+ */
+static void random_ops(void) {
+	ParamMap * map = create(0, 3);
+	uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+
+	for (size_t op = 0; op != N_OPS; ++op) {
+		uint64_t r = next(&state);
+		size_t pre = r % N_KEYS;
+		size_t post = (r >> 20) % N_KEYS;
+		/* mostly small keys, so that the runs are used as well */
+		if ((r >> 40) % 4 != 0) {
+			pre %= 64;
+			post %= 64;
+		}
+		if ((r >> 44) % 3 == 0)
+			remove_entry(map, pre);
+		else
+			add(map, pre, post);
+		if (op % 997 == 0)
+			check(map, "random", op);
+	}
+	check(map, "random", N_OPS);
+
+	hilbert_pmap_del(map);
+}
+
+int main(void) {
+	contiguous();
+	shifted();
+	random_ops();
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,244 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test for proof checking.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+#include"common.h"
+
+/**
+ * setting:
+ * iface: kinds k and s, variables p, q and r of kind k, functor imp: k k -> k,
+ * 	statements ax1: |- imp(p, imp(q, p)), ax2: |- imp(imp(p, imp(q, r)), imp(imp(p, q), imp(p, r))),
+ * 	mp: p, imp(p, q) |- q
+ * proof: import iface, variables a, b of kind k and c of kind s
+ * Expected: a |- a, |- imp(a, a) and a, imp(a, b) |- b are proven, the latter two can be used in later proofs,
+ * 	and incorrect proofs are rejected without changing the module.
+ */
+static HilbertHandle dk, ds, dimp, dax1, dax2, dmp;
+static HilbertHandle a, b, c;
+
+/* creates a variable term */
+static HilbertHandle var(HilbertModule * module, HilbertHandle kind) {
+	int errcode;
+
+	HilbertHandle v = hilbert_var_create(module, kind, &errcode);
+	check(errcode, 0, "Variable creation");
+	HilbertHandle result = hilbert_term_var(module, v, &errcode);
+	check(errcode, 0, "Variable term creation");
+
+	return result;
+}
+
+/* creates the interface module */
+static HilbertModule * setup(HilbertHandle * k, HilbertHandle * s, HilbertHandle * imp, HilbertHandle * ax1,
+		HilbertHandle * ax2, HilbertHandle * mp) {
+	int errcode;
+
+	HilbertModule * iface = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (iface == NULL) {
+		fputs("Unable to create interface module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	*k = hilbert_kind_create(iface, &errcode);
+	check(errcode, 0, "Kind creation");
+	*s = hilbert_kind_create(iface, &errcode);
+	check(errcode, 0, "Kind creation");
+	HilbertHandle ikinds[2] = { *k, *k };
+	*imp = hilbert_functor_create(iface, *k, 2, ikinds, &errcode);
+	check(errcode, 0, "Functor creation");
+	HilbertHandle p = var(iface, *k);
+	HilbertHandle q = var(iface, *k);
+	HilbertHandle r = var(iface, *k);
+
+	*ax1 = hilbert_statement_create(iface, 0, NULL, apply(iface, *imp, p, apply(iface, *imp, q, p)), &errcode);
+	check(errcode, 0, "Statement creation");
+	HilbertHandle conclusion = apply(iface, *imp, apply(iface, *imp, p, apply(iface, *imp, q, r)),
+			apply(iface, *imp, apply(iface, *imp, p, q), apply(iface, *imp, p, r)));
+	*ax2 = hilbert_statement_create(iface, 0, NULL, conclusion, &errcode);
+	check(errcode, 0, "Statement creation");
+	HilbertHandle hyps[2] = { p, apply(iface, *imp, p, q) };
+	*mp = hilbert_statement_create(iface, 2, hyps, q, &errcode);
+	check(errcode, 0, "Statement creation");
+
+	if (hilbert_module_makeimmutable(iface) != 0) {
+		fputs("Unable to make module immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return iface;
+}
+
+/* checks a theorem */
+static void check_theorem(HilbertModule * module, HilbertHandle theorem, size_t hypc, const HilbertHandle * hypv,
+		HilbertHandle conclusion) {
+	int errcode;
+	size_t size;
+
+	unsigned int type = hilbert_object_gettype(module, theorem, &errcode);
+	check(errcode, 0, "Obtaining the type of a theorem");
+	if (type != HILBERT_TYPE_STATEMENT) {
+		fprintf(stderr, "Theorem has type %u\n", type);
+		exit(EXIT_FAILURE);
+	}
+	const HilbertHandle * hyps = hilbert_statement_gethyps_view(module, theorem, &size, &errcode);
+	check(errcode, 0, "Obtaining the hypotheses");
+	if (size != hypc) {
+		fprintf(stderr, "Theorem has %zu hypotheses, expected %zu\n", size, hypc);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != hypc; ++i) {
+		if (hyps[i] != hypv[i]) {
+			fprintf(stderr, "Hypothesis %zu differs\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (hilbert_statement_getconclusion(module, theorem, &errcode) != conclusion) {
+		fputs("Conclusion differs\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	check(errcode, 0, "Obtaining the conclusion");
+}
+
+/* checks that a proof is rejected and the number of objects stays the same */
+static void check_reject(HilbertModule * module, size_t hypc, const HilbertHandle * hypv, HilbertHandle conclusion,
+		size_t stepc, const HilbertProofStep * stepv, int expected, const char * what) {
+	int errcode;
+	HilbertStats before, after;
+
+	check(hilbert_module_getstats(module, &before), 0, "Obtaining statistics");
+	hilbert_theorem_create(module, hypc, hypv, conclusion, stepc, stepv, &errcode);
+	check(errcode, expected, what);
+	check(hilbert_module_getstats(module, &after), 0, "Obtaining statistics");
+	if ((after.objects != before.objects) || (after.bytes != before.bytes)) {
+		fprintf(stderr, "%s changed the module\n", what);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	HilbertHandle k, s, imp, ax1, ax2, mp;
+	int errcode;
+
+	HilbertModule * iface = setup(&k, &s, &imp, &ax1, &ax2, &mp);
+	HilbertModule * proof = hilbert_module_create(HILBERT_PROOF_MODULE);
+	if (proof == NULL) {
+		fputs("Unable to create proof module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	HilbertHandle param = hilbert_module_import(proof, iface, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, 0, "Import");
+	HilbertHandle * handles[6] = { &dk, &ds, &dimp, &dax1, &dax2, &dmp };
+	HilbertHandle srchandles[6] = { k, s, imp, ax1, ax2, mp };
+	for (size_t i = 0; i != 6; ++i) {
+		*handles[i] = hilbert_object_getdesthandle(proof, param, srchandles[i], &errcode);
+		check(errcode, 0, "Obtaining a destination handle");
+	}
+	a = var(proof, dk);
+	b = var(proof, dk);
+	c = var(proof, ds);
+	HilbertHandle aa = apply(proof, dimp, a, a);
+	HilbertHandle ab = apply(proof, dimp, a, b);
+
+	/* statements are only created in interface modules without proof, and theorems only in proof modules */
+	hilbert_statement_create(proof, 0, NULL, aa, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_MODULE, "Statement creation in a proof module");
+	hilbert_theorem_create(iface, 0, NULL, aa, 0, NULL, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_MODULE, "Theorem creation in an interface module");
+
+	/* a |- a */
+	HilbertProofStep trivial[1] = { { HILBERT_STEP_HYP, 0 } };
+	HilbertHandle thtrivial = hilbert_theorem_create(proof, 1, &a, a, 1, trivial, &errcode);
+	check(errcode, 0, "Proof of a |- a");
+	check_theorem(proof, thtrivial, 1, &a, a);
+
+	/* |- imp(a, a) */
+	HilbertProofStep id[12] = {
+		{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, a }, { HILBERT_STEP_APPLY, dax1 },
+		{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, aa }, { HILBERT_STEP_APPLY, dax1 },
+		{ HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, aa }, { HILBERT_STEP_TERM, a }, { HILBERT_STEP_APPLY, dax2 },
+		{ HILBERT_STEP_APPLY, dmp }, { HILBERT_STEP_APPLY, dmp }
+	};
+	HilbertHandle thid = hilbert_theorem_create(proof, 0, NULL, aa, 12, id, &errcode);
+	check(errcode, 0, "Proof of |- imp(a, a)");
+	check_theorem(proof, thid, 0, NULL, aa);
+
+	/* a, imp(a, b) |- b */
+	HilbertHandle mphyps[2] = { a, ab };
+	HilbertProofStep mpsteps[3] = { { HILBERT_STEP_HYP, 0 }, { HILBERT_STEP_HYP, 1 }, { HILBERT_STEP_APPLY, dmp } };
+	HilbertHandle thmp = hilbert_theorem_create(proof, 2, mphyps, b, 3, mpsteps, &errcode);
+	check(errcode, 0, "Proof of a, imp(a, b) |- b");
+	check_theorem(proof, thmp, 2, mphyps, b);
+
+	/* theorems can be applied like axioms: |- imp(imp(b, b), imp(b, b)) and b |- b */
+	HilbertHandle bb = apply(proof, dimp, b, b);
+	HilbertHandle bbbb = apply(proof, dimp, bb, bb);
+	HilbertProofStep reuse[2] = { { HILBERT_STEP_TERM, bb }, { HILBERT_STEP_APPLY, thid } };
+	hilbert_theorem_create(proof, 0, NULL, bbbb, 2, reuse, &errcode);
+	check(errcode, 0, "Proof using a theorem");
+	HilbertHandle bhyps[2] = { b, bb };
+	HilbertProofStep reuse2[3] = { { HILBERT_STEP_HYP, 0 }, { HILBERT_STEP_HYP, 1 }, { HILBERT_STEP_APPLY, thmp } };
+	hilbert_theorem_create(proof, 2, bhyps, b, 3, reuse2, &errcode);
+	check(errcode, 0, "Proof using a theorem with hypotheses");
+
+	/* invalid handles */
+	HilbertProofStep badhyp[1] = { { HILBERT_STEP_HYP, 1 } };
+	check_reject(proof, 1, &a, a, 1, badhyp, HILBERT_ERR_INVALID_HANDLE, "Proof with an invalid hypothesis index");
+	HilbertProofStep badterm[1] = { { HILBERT_STEP_TERM, 12345 } };
+	check_reject(proof, 0, NULL, a, 1, badterm, HILBERT_ERR_INVALID_HANDLE, "Proof with an invalid term");
+	HilbertProofStep badstmt[1] = { { HILBERT_STEP_APPLY, dimp } };
+	check_reject(proof, 0, NULL, a, 1, badstmt, HILBERT_ERR_INVALID_HANDLE, "Proof with an invalid statement");
+	check_reject(proof, 0, NULL, 12345, 0, NULL, HILBERT_ERR_INVALID_HANDLE, "Proof with an invalid conclusion");
+
+	/* incorrect proofs */
+	check_reject(proof, 0, NULL, aa, 0, NULL, HILBERT_ERR_INVALID_PROOF, "Empty proof");
+	check_reject(proof, 0, NULL, aa, 11, id, HILBERT_ERR_INVALID_PROOF, "Proof leaving two facts");
+	check_reject(proof, 0, NULL, ab, 12, id, HILBERT_ERR_INVALID_PROOF, "Proof of the wrong conclusion");
+	HilbertProofStep value[1] = { { HILBERT_STEP_TERM, aa } };
+	check_reject(proof, 0, NULL, aa, 1, value, HILBERT_ERR_INVALID_PROOF, "Proof ending in a substitution value");
+	HilbertProofStep underflow[2] = { { HILBERT_STEP_HYP, 0 }, { HILBERT_STEP_APPLY, dmp } };
+	check_reject(proof, 1, &a, b, 2, underflow, HILBERT_ERR_INVALID_PROOF, "Proof with too few facts");
+	HilbertProofStep nofact[3] = { { HILBERT_STEP_TERM, a }, { HILBERT_STEP_HYP, 0 }, { HILBERT_STEP_APPLY, dmp } };
+	check_reject(proof, 1, &ab, b, 3, nofact, HILBERT_ERR_INVALID_PROOF, "Proof using a value as a fact");
+	HilbertProofStep wrongorder[3] = { { HILBERT_STEP_HYP, 1 }, { HILBERT_STEP_HYP, 0 }, { HILBERT_STEP_APPLY, dmp } };
+	check_reject(proof, 2, mphyps, b, 3, wrongorder, HILBERT_ERR_INVALID_PROOF, "Proof with facts in the wrong order");
+	HilbertHandle abhyps[2] = { a, apply(proof, dimp, b, b) };
+	check_reject(proof, 2, abhyps, b, 3, mpsteps, HILBERT_ERR_INVALID_PROOF, "Proof with a mismatching fact");
+	HilbertProofStep nofresh[2] = { { HILBERT_STEP_TERM, a }, { HILBERT_STEP_APPLY, dax1 } };
+	check_reject(proof, 0, NULL, aa, 2, nofresh, HILBERT_ERR_INVALID_PROOF, "Proof with too few values");
+	HilbertProofStep wrongkind[3] = { { HILBERT_STEP_TERM, a }, { HILBERT_STEP_TERM, c }, { HILBERT_STEP_APPLY, dax1 } };
+	check_reject(proof, 0, NULL, aa, 3, wrongkind, HILBERT_ERR_INVALID_PROOF, "Proof substituting a term of the wrong kind");
+	HilbertProofStep badtype[1] = { { 42, 0 } };
+	check_reject(proof, 1, &a, a, 1, badtype, HILBERT_ERR_INVALID_PROOF, "Proof with an invalid step type");
+
+	hilbert_module_free(proof);
+	hilbert_module_free(iface);
+
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,237 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test for statements and their transfer between modules.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+#include"common.h"
+
+/**
+ * setting:
+ * src: kind k, variables p and q of kind k, functor imp: k k -> k,
+ * 	statements mp: p, imp(p, q) |- q and ax: |- imp(p, imp(q, p))
+ * dest: import src
+ * iface: kind k2, variables a and b of kind k2, functor imp2: k2 k2 -> k2,
+ * 	statements mp2: a, imp2(a, b) |- b and ax2: |- imp2(b, imp2(a, b))
+ * Expected: the statements of src are carried over to dest, and iface can be exported from dest
+ * 	by mapping mp2 to mp and ax2 to ax, but not by mapping ax2 to mp.
+ */
+static HilbertHandle k, imp, mp, ax;
+static HilbertHandle k2, imp2, mp2, ax2;
+static HilbertHandle dparam, dk, dimp, dmp, dax;
+
+/* creates the kinds, variables, functors and statements of src and iface */
+static void setup(HilbertModule * module, HilbertHandle * kind, HilbertHandle * functor, HilbertHandle * mpstmt,
+		HilbertHandle * axstmt, int swap) {
+	int errcode;
+
+	*kind = hilbert_kind_create(module, &errcode);
+	check(errcode, 0, "Kind creation");
+	HilbertHandle var0 = hilbert_var_create(module, *kind, &errcode);
+	check(errcode, 0, "Variable creation");
+	HilbertHandle var1 = hilbert_var_create(module, *kind, &errcode);
+	check(errcode, 0, "Variable creation");
+	HilbertHandle ikinds[2] = { *kind, *kind };
+	*functor = hilbert_functor_create(module, *kind, 2, ikinds, &errcode);
+	check(errcode, 0, "Functor creation");
+
+	HilbertHandle x = hilbert_term_var(module, var0, &errcode);
+	check(errcode, 0, "Variable term creation");
+	HilbertHandle y = hilbert_term_var(module, var1, &errcode);
+	check(errcode, 0, "Variable term creation");
+	HilbertHandle hyps[2] = { x, apply(module, *functor, x, y) };
+	*mpstmt = hilbert_statement_create(module, 2, hyps, y, &errcode);
+	check(errcode, 0, "Statement creation");
+	/* with swapped variables, the second statement is the same up to renaming */
+	if (swap) {
+		HilbertHandle t = x;
+		x = y;
+		y = t;
+	}
+	*axstmt = hilbert_statement_create(module, 0, NULL, apply(module, *functor, x, apply(module, *functor, y, x)),
+			&errcode);
+	check(errcode, 0, "Statement creation");
+}
+
+/* mapper callback; maps ax2 to mp if *userdata is nonzero */
+static HilbertHandle callback(HilbertModule * restrict dest, HilbertModule * restrict src, HilbertHandle srcObject,
+		void * userdata, int * restrict errcode) {
+	*errcode = 0;
+	if (srcObject == k2)
+		return dk;
+	if (srcObject == imp2)
+		return dimp;
+	if (srcObject == mp2)
+		return dmp;
+	if (srcObject == ax2)
+		return *(int *) userdata ? dmp : dax;
+	fprintf(stderr, "Got invalid source object %u\n", (unsigned int) srcObject);
+	exit(EXIT_FAILURE);
+}
+
+/* checks that a statement in dest is the image of mp */
+static void check_mp(HilbertModule * dest, HilbertHandle stmt) {
+	int errcode;
+	size_t size;
+
+	unsigned int type = hilbert_object_gettype(dest, stmt, &errcode);
+	check(errcode, 0, "Obtaining the type of a statement");
+	if (type != (HILBERT_TYPE_STATEMENT | HILBERT_TYPE_EXTERNAL)) {
+		fprintf(stderr, "Statement has type %u\n", type);
+		exit(EXIT_FAILURE);
+	}
+	const HilbertHandle * hyps = hilbert_statement_gethyps_view(dest, stmt, &size, &errcode);
+	check(errcode, 0, "Obtaining the hypotheses");
+	HilbertHandle conclusion = hilbert_statement_getconclusion(dest, stmt, &errcode);
+	check(errcode, 0, "Obtaining the conclusion");
+	if (size != 2) {
+		fprintf(stderr, "Statement has %zu hypotheses, expected 2\n", size);
+		exit(EXIT_FAILURE);
+	}
+	const HilbertHandle * args = hilbert_term_getargs_view(dest, hyps[1], &size, &errcode);
+	check(errcode, 0, "Obtaining the arguments");
+	HilbertHandle head = hilbert_term_gethead(dest, hyps[1], &errcode);
+	check(errcode, 0, "Obtaining the head");
+	HilbertHandle dimp = hilbert_object_getdesthandle(dest, dparam, imp, &errcode);
+	check(errcode, 0, "Obtaining the destination functor");
+	if ((head != dimp) || (size != 2) || (args[0] != hyps[0]) || (args[1] != conclusion) || (hyps[0] == conclusion)) {
+		fputs("Statement carried over incorrectly\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	head = hilbert_term_gethead(dest, conclusion, &errcode);
+	check(errcode, 0, "Obtaining the head");
+	type = hilbert_object_gettype(dest, head, &errcode);
+	check(errcode, 0, "Obtaining the type of a variable");
+	HilbertHandle kind = hilbert_term_getkind(dest, conclusion, &errcode);
+	check(errcode, 0, "Obtaining the kind of a term");
+	if ((type != HILBERT_TYPE_VAR) || (kind != hilbert_object_getdesthandle(dest, dparam, k, &errcode))) {
+		fputs("Variable carried over incorrectly\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	HilbertModule * src, * dest, * iface, * proof, * loaded;
+	int errcode;
+	int invalid;
+	size_t size;
+
+	src = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	dest = hilbert_module_create(HILBERT_PROOF_MODULE);
+	iface = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if ((src == NULL) || (dest == NULL) || (iface == NULL)) {
+		fputs("Unable to create modules\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* creation and accessors */
+	setup(src, &k, &imp, &mp, &ax, 0);
+	if ((hilbert_object_gettype(src, mp, &errcode) != HILBERT_TYPE_STATEMENT) || (errcode != 0)) {
+		fputs("Wrong statement type\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if ((hilbert_statement_gethyps_view(src, ax, &size, &errcode), errcode != 0) || (size != 0)) {
+		fputs("Statement without hypotheses has hypotheses\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	HilbertHandle term = hilbert_statement_getconclusion(src, mp, &errcode);
+	check(errcode, 0, "Obtaining the conclusion");
+	hilbert_statement_create(src, 1, &term, 666, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_HANDLE, "Statement creation with invalid conclusion");
+	HilbertHandle bad = 666;
+	hilbert_statement_create(src, 1, &bad, term, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_HANDLE, "Statement creation with invalid hypothesis");
+	hilbert_statement_create(dest, 0, NULL, 0, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_MODULE, "Statement creation in a proof module");
+	hilbert_statement_getconclusion(src, k, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_HANDLE, "Obtaining the conclusion of a kind");
+	hilbert_statement_gethyps_view(src, imp, &size, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_HANDLE, "Obtaining the hypotheses of a functor");
+	check(hilbert_module_makeimmutable(src), 0, "Making src immutable");
+	hilbert_statement_create(src, 0, NULL, term, &errcode);
+	check(errcode, HILBERT_ERR_IMMUTABLE, "Statement creation in an immutable module");
+
+	/* import */
+	dparam = hilbert_module_import(dest, src, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, 0, "Import");
+	dk = hilbert_object_getdesthandle(dest, dparam, k, &errcode);
+	check(errcode, 0, "Obtaining the destination kind");
+	dimp = hilbert_object_getdesthandle(dest, dparam, imp, &errcode);
+	check(errcode, 0, "Obtaining the destination functor");
+	dmp = hilbert_object_getdesthandle(dest, dparam, mp, &errcode);
+	check(errcode, 0, "Obtaining the destination statement");
+	dax = hilbert_object_getdesthandle(dest, dparam, ax, &errcode);
+	check(errcode, 0, "Obtaining the destination statement");
+	check_mp(dest, dmp);
+	if ((hilbert_object_getsourcehandle(dest, dmp, &errcode) != mp) || (errcode != 0)) {
+		fputs("Wrong source statement\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* export */
+	setup(iface, &k2, &imp2, &mp2, &ax2, 1);
+	check(hilbert_module_makeimmutable(iface), 0, "Making iface immutable");
+	invalid = 1;
+	hilbert_module_export(dest, iface, 0, NULL, callback, &invalid, &errcode);
+	check(errcode, HILBERT_ERR_INVALID_MAPPING, "Export with a mismatching statement");
+	invalid = 0;
+	hilbert_module_export(dest, iface, 0, NULL, callback, &invalid, &errcode);
+	check(errcode, 0, "Export");
+
+	/* parameterisation and image round trip */
+	proof = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (proof == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	HilbertHandle pparam = hilbert_module_param(proof, src, 0, NULL, NULL, NULL, &errcode);
+	check(errcode, 0, "Parameterisation");
+	check(hilbert_module_makeimmutable(proof), 0, "Making proof immutable");
+	FILE * stream = tmpfile();
+	if (stream == NULL) {
+		fputs("Unable to create temporary file\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	check(hilbert_module_save(proof, stream), 0, "Saving module");
+	rewind(stream);
+	loaded = hilbert_module_load(stream, 1, &src, &errcode);
+	check(errcode, 0, "Loading module");
+	fclose(stream);
+	dparam = pparam;
+	HilbertHandle lmp = hilbert_object_getdesthandle(loaded, pparam, mp, &errcode);
+	check(errcode, 0, "Obtaining the loaded statement");
+	check_mp(loaded, lmp);
+
+	hilbert_module_free(loaded);
+	hilbert_module_free(dest);
+	hilbert_module_free(proof);
+	hilbert_module_free(iface);
+	hilbert_module_free(src);
+
+	exit(EXIT_SUCCESS);
+}
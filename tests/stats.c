@@ -0,0 +1,172 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test for module statistics.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include"hilbert.h"
+
+/* obtains the statistics of a module */
+static HilbertStats getstats(HilbertModule * module) {
+	HilbertStats stats;
+	int errcode = hilbert_module_getstats(module, &stats);
+
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain module statistics, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	return stats;
+}
+
+/* checks whether the instrumented counters are zero */
+static int iszero(const HilbertStats * stats) {
+	return (stats->rdlocks == 0) && (stats->wrlocks == 0) && (stats->contended == 0) && (stats->probes == 0)
+			&& (stats->rehashes == 0) && (stats->merges == 0) && (stats->transfers == 0)
+			&& (stats->transfernanos == 0);
+}
+
+/* returns the number of lock acquisitions recorded for a site */
+static unsigned long long sitecount(HilbertModule * module, const char * name) {
+	HilbertLockSite sites[HILBERT_LOCK_SITES];
+	int errcode;
+	unsigned long long result = 0;
+
+	size_t count = hilbert_module_getlocksites(module, sites, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain lock sites, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != count; ++i) {
+		if (strcmp(sites[i].name, name) != 0)
+			continue;
+		for (size_t j = 0; j != HILBERT_LOCK_BUCKETS; ++j)
+			result += sites[i].waits[j];
+	}
+
+	return result;
+}
+
+int main(void) {
+	HilbertModule * module, * dest;
+	HilbertHandle kind0, kind1, kind2;
+	HilbertStats stats;
+	int errcode;
+
+	module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	dest = hilbert_module_create(HILBERT_PROOF_MODULE);
+	if ((module == NULL) || (dest == NULL)) {
+		fputs("Unable to create modules\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	stats = getstats(module);
+	if (stats.objects != 0) {
+		fprintf(stderr, "New module has %llu objects\n", stats.objects);
+		exit(EXIT_FAILURE);
+	}
+
+	kind0 = hilbert_kind_create(module, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	kind1 = hilbert_kind_create(module, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	kind2 = hilbert_kind_create(module, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	/* one merge, the second identification is redundant */
+	if ((hilbert_kind_identify(module, kind0, kind1) != 0) || (hilbert_kind_identify(module, kind1, kind0) != 0)) {
+		fputs("Unable to identify kinds\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	/* one merge */
+	hilbert_kind_alias(module, kind2, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to create kind alias, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	stats = getstats(module);
+	if (stats.objects != 4) {
+		fprintf(stderr, "Module has %llu objects, expected 4\n", stats.objects);
+		exit(EXIT_FAILURE);
+	}
+	if (stats.bytes == 0) {
+		fputs("Module reports no memory in use\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	int enabled = stats.wrlocks != 0;
+	if (!enabled && !iszero(&stats)) {
+		fputs("Statistics not enabled, but counters are nonzero\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if (enabled && ((stats.wrlocks < 6) || (stats.merges != 2))) {
+		fprintf(stderr, "Got %llu write locks and %llu merges, expected at least 6 and 2\n",
+				stats.wrlocks, stats.merges);
+		exit(EXIT_FAILURE);
+	}
+
+	unsigned long long creates = sitecount(module, "kind_create_by_type");
+	if (creates != (enabled ? 3 : 0)) {
+		fprintf(stderr, "Got %llu lock acquisitions by kind_create_by_type, expected %i\n", creates, enabled ? 3 : 0);
+		exit(EXIT_FAILURE);
+	}
+
+	if (hilbert_module_makeimmutable(module) != 0) {
+		fputs("Unable to make module immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_module_import(dest, module, 0, NULL, NULL, NULL, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to import module, errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	stats = getstats(dest);
+	if (stats.objects != 5) {
+		fprintf(stderr, "Destination module has %llu objects, expected 5\n", stats.objects);
+		exit(EXIT_FAILURE);
+	}
+	if (!enabled && !iszero(&stats)) {
+		fputs("Statistics not enabled, but destination counters are nonzero\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if (enabled && ((stats.transfers != 1) || (stats.merges != 2))) {
+		fprintf(stderr, "Got %llu transfers and %llu merges, expected 1 and 2\n", stats.transfers, stats.merges);
+		exit(EXIT_FAILURE);
+	}
+
+	hilbert_module_free(dest);
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+
+kinderror:
+	fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+}
@@ -0,0 +1,199 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test for term creation and hash-consing.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+/* creates a term from a functor application and checks the error code */
+static HilbertHandle apply(HilbertModule * module, HilbertHandle functor, size_t argc, const HilbertHandle * argv,
+		int expected) {
+	int errcode;
+
+	HilbertHandle result = hilbert_term_create(module, functor, argc, argv, &errcode);
+	if (errcode != expected) {
+		fprintf(stderr, "Term creation returned errcode=%i, expected %i\n", errcode, expected);
+		exit(EXIT_FAILURE);
+	}
+
+	return result;
+}
+
+int main(void) {
+	HilbertModule * module;
+	HilbertHandle kind0, kind1, kind2, var0, var1, imp, neg, c;
+	HilbertHandle x, y, t1, t2, t3;
+	int errcode;
+
+	module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	if (module == NULL) {
+		fputs("Unable to create module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* kind1 is equivalent to kind0, kind2 is not */
+	kind0 = hilbert_kind_create(module, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	kind1 = hilbert_kind_alias(module, kind0, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	kind2 = hilbert_kind_create(module, &errcode);
+	if (errcode != 0)
+		goto kinderror;
+	var0 = hilbert_var_create(module, kind0, &errcode);
+	if (errcode != 0)
+		goto varerror;
+	var1 = hilbert_var_create(module, kind1, &errcode);
+	if (errcode != 0)
+		goto varerror;
+	HilbertHandle ikinds[2] = { kind0, kind1 };
+	imp = hilbert_functor_create(module, kind0, 2, ikinds, &errcode);
+	if (errcode != 0)
+		goto functorerror;
+	neg = hilbert_functor_create(module, kind1, 1, ikinds, &errcode);
+	if (errcode != 0)
+		goto functorerror;
+	c = hilbert_functor_create(module, kind2, 0, NULL, &errcode);
+	if (errcode != 0)
+		goto functorerror;
+
+	/* variable terms */
+	x = hilbert_term_var(module, var0, &errcode);
+	if (errcode != 0)
+		goto termerror;
+	y = hilbert_term_var(module, var1, &errcode);
+	if (errcode != 0)
+		goto termerror;
+	if ((x == y) || (hilbert_term_var(module, var0, &errcode) != x) || (errcode != 0)) {
+		fputs("Variable terms not hash-consed properly\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_term_var(module, kind0, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error for kind as variable, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* functor applications */
+	HilbertHandle args[2] = { x, y };
+	t1 = apply(module, imp, 2, args, 0);
+	args[0] = apply(module, neg, 1, &t1, 0);
+	args[1] = t1;
+	t2 = apply(module, imp, 2, args, 0);
+	/* rebuild t2 from scratch */
+	args[0] = x;
+	args[1] = y;
+	t3 = apply(module, imp, 2, args, 0);
+	if (t3 != t1) {
+		fputs("Equal terms have different handles\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	args[0] = apply(module, neg, 1, &t3, 0);
+	args[1] = t3;
+	if (apply(module, imp, 2, args, 0) != t2) {
+		fputs("Equal nested terms have different handles\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	args[0] = y;
+	args[1] = x;
+	if (apply(module, imp, 2, args, 0) == t1) {
+		fputs("Different terms have equal handles\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* errors */
+	apply(module, imp, 1, args, HILBERT_ERR_COUNT_MISMATCH);
+	args[1] = 666;
+	apply(module, imp, 2, args, HILBERT_ERR_INVALID_HANDLE);
+	apply(module, kind0, 0, NULL, HILBERT_ERR_INVALID_HANDLE);
+	args[1] = apply(module, c, 0, NULL, 0);
+	apply(module, imp, 2, args, HILBERT_ERR_KIND_MISMATCH);
+
+	/* accessors */
+	if ((hilbert_term_gethead(module, t2, &errcode) != imp) || (errcode != 0)) {
+		fputs("Wrong head\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if ((hilbert_term_getkind(module, t2, &errcode) != kind0) || (errcode != 0)) {
+		fputs("Wrong kind of functor term\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if ((hilbert_term_getkind(module, y, &errcode) != kind1) || (errcode != 0)) {
+		fputs("Wrong kind of variable term\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	size_t size;
+	const HilbertHandle * view = hilbert_term_getargs_view(module, t2, &size, &errcode);
+	if ((errcode != 0) || (size != 2) || (view[1] != t1)
+			|| (hilbert_term_gethead(module, view[0], &errcode) != neg)) {
+		fputs("Wrong arguments\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_term_getargs_view(module, x, &size, &errcode);
+	if ((errcode != 0) || (size != 0)) {
+		fputs("Variable term has arguments\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_term_getkind(module, 666, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error for term, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* immutable modules */
+	if (hilbert_module_makeimmutable(module) != 0) {
+		fputs("Unable to make module immutable\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	hilbert_term_var(module, var0, &errcode);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error, got errcode=%i\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if ((hilbert_term_gethead(module, t1, &errcode) != imp) || (errcode != 0)) {
+		fputs("Wrong head in immutable module\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+
+kinderror:
+	fprintf(stderr, "Unable to create kind, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+varerror:
+	fprintf(stderr, "Unable to create variable, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+functorerror:
+	fprintf(stderr, "Unable to create functor, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+termerror:
+	fprintf(stderr, "Unable to create term, errcode=%i\n", errcode);
+	exit(EXIT_FAILURE);
+}
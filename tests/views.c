@@ -0,0 +1,156 @@
+/*
+ *  The Hilbert Kernel Library, a library for verifying formal proofs.
+ *  Copyright © 2011 Alexander Klauer
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  To contact the author
+ *     by email: Graf.Zahl@gmx.net
+ *     on wiki : http://www.wikiproofs.org/w/index.php?title=User_talk:GrafZahl
+ */
+
+/**
+ * Test to check handle array views and buffer variants.
+ */
+
+#include<assert.h>
+#include<stdio.h>
+#include<stdlib.h>
+
+#include"hilbert.h"
+
+#define N_KINDS 5
+
+static HilbertHandle kinds[N_KINDS];
+
+/* checks that an array holds the kinds with the given indices, in any order */
+static void kinds_check(const char * what, const HilbertHandle * array, size_t count, size_t n, const size_t * indices) {
+	if (count != n) {
+		fprintf(stderr, "%s: got %zu kinds, expected %zu\n", what, count, n);
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i != n; ++i) {
+		size_t j;
+		for (j = 0; j != count; ++j) {
+			if (array[j] == kinds[indices[i]])
+				break;
+		}
+		if (j == count) {
+			fprintf(stderr, "%s: kind%zu missing\n", what, indices[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+/* checks the buffer variants on module */
+static void buf_check(HilbertModule * module, HilbertHandle functor) {
+	HilbertHandle buffer[N_KINDS];
+	int errcode;
+	size_t count;
+
+	count = hilbert_module_getobjects_buf(module, NULL, 0, &errcode);
+	if ((errcode != 0) || (count != N_KINDS + 1)) {
+		fprintf(stderr, "Got %zu objects (errcode=%d), expected %d\n", count, errcode, N_KINDS + 1);
+		exit(EXIT_FAILURE);
+	}
+	count = hilbert_module_getobjects_buf(module, buffer, 2, &errcode);
+	if ((errcode != 0) || (count != N_KINDS + 1) || (buffer[0] != kinds[0]) || (buffer[1] != kinds[1])) {
+		fprintf(stderr, "Unable to copy first objects (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	hilbert_kind_equivalenceclass_buf(module, functor, buffer, N_KINDS, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error for equivalence class of functor, got errcode=%d\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count = hilbert_kind_equivalenceclass_buf(module, kinds[1], buffer, 1, &errcode);
+	if ((errcode != 0) || (count != 3)) {
+		fprintf(stderr, "Got equivalence class of size %zu (errcode=%d), expected 3\n", count, errcode);
+		exit(EXIT_FAILURE);
+	}
+	count = hilbert_kind_equivalenceclass_buf(module, kinds[1], buffer, N_KINDS, &errcode);
+	assert (errcode == 0);
+	kinds_check("equivalence class buffer", buffer, count, 3, (size_t []) { 1, 3, 4 });
+
+	count = hilbert_functor_getinputkinds_buf(module, kinds[0], buffer, N_KINDS, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error for input kinds of kind, got errcode=%d\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	count = hilbert_functor_getinputkinds_buf(module, functor, buffer, N_KINDS, &errcode);
+	if ((errcode != 0) || (count != 3) || (buffer[0] != kinds[2]) || (buffer[1] != kinds[0]) || (buffer[2] != kinds[2])) {
+		fprintf(stderr, "Got wrong input kinds from buffer variant (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(void) {
+	int errcode;
+	size_t count;
+
+	HilbertModule * module = hilbert_module_create(HILBERT_INTERFACE_MODULE);
+	assert (module != NULL);
+	errcode = hilbert_kind_create_n(module, N_KINDS, kinds);
+	assert (errcode == 0);
+	errcode = hilbert_kind_identify(module, kinds[0], kinds[2]);
+	assert (errcode == 0);
+	errcode = hilbert_kind_identify(module, kinds[3], kinds[4]);
+	assert (errcode == 0);
+	errcode = hilbert_kind_identify(module, kinds[4], kinds[1]);
+	assert (errcode == 0);
+	HilbertHandle functor = hilbert_functor_create(module, kinds[1], 3, (HilbertHandle []) { kinds[2], kinds[0], kinds[2] },
+			&errcode);
+	assert (errcode == 0);
+
+	/* mutable module */
+	buf_check(module, functor);
+	hilbert_kind_equivalenceclass_view(module, kinds[0], &count, &errcode);
+	if (errcode != HILBERT_ERR_IMMUTABLE) {
+		fprintf(stderr, "Expected immutable error for equivalence class view of mutable module, got errcode=%d\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	const HilbertHandle * ikinds = hilbert_functor_getinputkinds_view(module, functor, &count, &errcode);
+	if ((errcode != 0) || (count != 3) || (ikinds[0] != kinds[2]) || (ikinds[1] != kinds[0]) || (ikinds[2] != kinds[2])) {
+		fprintf(stderr, "Got wrong input kinds view (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+
+	/* immutable module */
+	errcode = hilbert_module_makeimmutable(module);
+	assert (errcode == 0);
+	buf_check(module, functor);
+	const HilbertHandle * eqc = hilbert_kind_equivalenceclass_view(module, kinds[2], &count, &errcode);
+	if (errcode != 0) {
+		fprintf(stderr, "Unable to obtain equivalence class view (errcode=%d)\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	kinds_check("equivalence class view", eqc, count, 2, (size_t []) { 0, 2 });
+	eqc = hilbert_kind_equivalenceclass_view(module, kinds[3], &count, &errcode);
+	assert (errcode == 0);
+	kinds_check("equivalence class view", eqc, count, 3, (size_t []) { 1, 3, 4 });
+	hilbert_kind_equivalenceclass_view(module, functor, &count, &errcode);
+	if (errcode != HILBERT_ERR_INVALID_HANDLE) {
+		fprintf(stderr, "Expected invalid handle error for equivalence class view of functor, got errcode=%d\n", errcode);
+		exit(EXIT_FAILURE);
+	}
+	if (hilbert_functor_getinputkinds_view(module, functor, &count, &errcode) != ikinds) {
+		fputs("Input kinds view changed\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	hilbert_module_free(module);
+
+	exit(EXIT_SUCCESS);
+}